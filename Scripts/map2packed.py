@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+
+# This script takes an image map file (as consumed by the ImageDeserializer) and
+# packs all referenced images together with their labels into a single file that
+# can be read by the PackedImageDeserializer.
+#
+# Each line of the map file must be in one of the following formats:
+#   <path to image> <tab> <numerical label (0-based class id)>
+#   <sequence key> <tab> <path to image> <tab> <numerical label (0-based class id)>
+#
+# A leading "..." in the image path is replaced with the directory of the map file.
+# Images are stored as is (i.e., they are not decoded or re-encoded).
+#
+# The layout of the resulting file (all numbers are little-endian):
+#   Header: magic (uint64), version (uint32), reserved (uint32),
+#           number of images (uint64), offset of the image table (uint64)
+#   Encoded images stored back to back
+#   Image table: for each image offset (uint64), size (uint32), class id (uint32),
+#                key size (uint32), reserved (uint32); followed by all keys (utf-8)
+#
+
+import argparse
+import struct
+import os
+
+MAGIC_NUMBER = 0x636e746b5f70696d;
+PACKED_VERSION = 1;
+
+HEADER_FORMAT = '<QIIQQ'
+ENTRY_FORMAT = '<QIIII'
+
+def parse_line(line, index, directory):
+    fields = line.rstrip('\r\n').split('\t')
+    if len(fields) == 2:
+        key, path, label = str(index), fields[0], fields[1]
+    elif len(fields) == 3:
+        key, path, label = fields
+    else:
+        raise ValueError("Invalid map file format, must contain 2 or 3 tab-delimited columns, line %d." % (index + 1))
+
+    if '@' in path:
+        raise ValueError("Images inside zip archives are not supported, line %d." % (index + 1))
+
+    if path.startswith('...'):
+        path = directory + path[3:]
+
+    return key, path, int(label)
+
+def process(input_name, output_name):
+    directory = os.path.dirname(os.path.abspath(input_name))
+    entries = []
+    keys = []
+
+    with open(input_name, 'r') as map_file, open(output_name, 'wb') as output:
+        # The header is written again once the offset of the table is known.
+        output.write(struct.pack(HEADER_FORMAT, MAGIC_NUMBER, PACKED_VERSION, 0, 0, 0))
+
+        index = 0
+        for line in map_file:
+            if not line.strip():
+                continue
+
+            key, path, label = parse_line(line, index, directory)
+            with open(path, 'rb') as image:
+                data = image.read()
+
+            encoded_key = key.encode('utf-8')
+            entries.append((output.tell(), len(data), label, len(encoded_key)))
+            keys.append(encoded_key)
+            output.write(data)
+            index += 1
+
+        table_offset = output.tell()
+        for offset, size, label, key_size in entries:
+            output.write(struct.pack(ENTRY_FORMAT, offset, size, label, key_size, 0))
+        output.write(b''.join(keys))
+
+        output.seek(0)
+        output.write(struct.pack(HEADER_FORMAT, MAGIC_NUMBER, PACKED_VERSION, 0, len(entries), table_offset))
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Packs images referenced by an image map file into a single file for the PackedImageDeserializer.")
+    parser.add_argument('--input', help="Image map file.", required=True)
+    parser.add_argument('--output', help="Name of the output file.", required=True)
+    args = parser.parse_args()
+
+    process(args.input, args.output)
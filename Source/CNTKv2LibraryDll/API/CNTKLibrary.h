@@ -670,6 +670,8 @@ namespace CNTK
         friend class BlockMomentumDistributedLearner;
         friend class Internal::VariableResolver;
         friend class Trainer;
+        friend class Serializer;
+        friend class ONNXToCNTKHelper;
 
         template <typename T, typename ...CtorArgTypes>
         friend inline std::shared_ptr<T> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
@@ -1025,6 +1027,9 @@ namespace CNTK
         bool m_isReadOnly;
 
         std::shared_ptr<void> m_tensorView; // Microsoft::MSR::CNTK::TensorView<ElemType>*
+
+        // Keeps the storage of the view alive when it is not owned by the view, e.g. a memory-mapped tensor file.
+        std::shared_ptr<void> m_externalStorage;
     };
 
     enum class MaskKind : char
@@ -2642,6 +2647,35 @@ namespace CNTK
             return CreateSequence(sampleShape, sequenceData, true, device, readOnly);
         }
 
+        ///
+        /// Creates a new read-only Value object containing a batch of samples, which uses the caller owned data buffer as its storage instead of a copy.
+        /// The buffer is only copied if the Value object is created on a device other than the CPU.
+        /// The buffer must be aligned to the element type, and must be neither modified nor freed while the created Value object,
+        /// or any Value or NDArrayView object aliasing its data, exists; 'bufferOwner', if not null, is kept alive by all of them.
+        /// Parameters:
+        ///     sampleShape: the tensor shape of the Value object.
+        ///     batchData: the data buffer of the samples, its number of elements must be a multiple of the size of sampleShape.
+        ///     numElements: the number of elements in batchData.
+        ///     device: on which device the Value object should be created.
+        ///     bufferOwner: an optional object that owns batchData.
+        ///
+        template <typename ElementType>
+        CNTK_API static ValuePtr CreateBatchView(const NDShape& sampleShape, const ElementType* batchData, size_t numElements, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner = nullptr);
+
+        ///
+        /// Creates a new read-only Value object containing a sequence of samples, which uses the caller owned data buffer as its storage instead of a copy.
+        /// The same rules as for CreateBatchView apply to the buffer.
+        /// Parameters:
+        ///     sampleShape: the tensor shape of the Value.
+        ///     sequenceData: the data buffer of the sequence, its number of elements must be a multiple of the size of sampleShape.
+        ///     numElements: the number of elements in sequenceData.
+        ///     sequenceStartFlag: true indicates that it is a new sequence. false means a continuation of a previous sequence.
+        ///     device: on which device the Value object should be created.
+        ///     bufferOwner: an optional object that owns sequenceData.
+        ///
+        template <typename ElementType>
+        CNTK_API static ValuePtr CreateSequenceView(const NDShape& sampleShape, const ElementType* sequenceData, size_t numElements, bool sequenceStartFlag, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner = nullptr);
+
         ///
         /// Creates a new Value object containing a batch of variable length sequences.
         /// The created Value object contains a copy of the specified data in batchOfSequences.
@@ -3607,6 +3641,9 @@ namespace CNTK
 
         ///
         /// Save this Function graph into a model file.
+        /// With 'useExternalFilesToStoreParameters', the CNTKv2 format stores the values of the parameters and constants
+        /// page-aligned in the file 'filepath' + ".tensors"; Load maps that file into memory and uses the values on the CPU
+        /// in place, sharing the pages between all processes that load the same model.
         ///
         CNTK_API void Save(const std::wstring& filepath, ModelFormat format = ModelFormat::CNTKv2,
             bool useExternalFilesToStoreParameters = false);
@@ -5115,6 +5152,14 @@ namespace CNTK
         /// A special value that can be used for the minibatchSize to indicate that the reference minibatch size is not specified.
         ///
         CNTK_API static const size_t IgnoredMinibatchSize;
+        ///
+        /// A key that is associated with the fused multi-tensor update, see SetFusedUpdate().
+        ///
+        CNTK_API static const std::wstring FusedUpdateKey;
+        ///
+        /// A key that is associated with the lazy update of parameters with sparse gradients, see SetLazySparseUpdate().
+        ///
+        CNTK_API static const std::wstring LazySparseUpdateKey;
 
     public:
         //
@@ -5210,6 +5255,28 @@ namespace CNTK
         CNTK_API void SetMinibatchSize(std::size_t minibatchSize) { GetOptions().Add(MinibatchSizeKey, minibatchSize); }
         CNTK_API std::size_t GetMinibatchSize() const { return GetOptions().GetOrElse(MinibatchSizeKey, IgnoredMinibatchSize); }
 
+        ///
+        /// Enables the fused multi-tensor update: the learner applies the complete update rule (regularization, clipping,
+        /// smoothed gradients and parameter write) to all of its parameters in a single parallel sweep, instead of issuing
+        /// a sequence of matrix operations per parameter. The results are the same as those of the per-parameter update.
+        /// Learners and options without a fused update rule (GPU or sparse values, noise injection, clipping by norm)
+        /// keep updating their parameters one by one.
+        ///
+        CNTK_API void SetFusedUpdate(bool enabled) { GetOptions().Add(FusedUpdateKey, enabled); }
+        CNTK_API bool IsFusedUpdateEnabled() const { return GetOptions().GetOrElse(FusedUpdateKey, false); }
+
+        ///
+        /// Enables the lazy update of parameters with block sparse column gradients (such as embeddings) on the CPU:
+        /// the momentum SGD and Adam learners only update the columns with a gradient in the current minibatch, instead
+        /// of decaying the smoothed gradients and moving all columns of the parameter. The smoothed gradients of a column
+        /// are caught up for the skipped minibatches when the column is updated again, and those of all columns before
+        /// a checkpoint is created. Untouched columns do not move with their remaining momentum, so the results differ
+        /// from those of the dense update unless every column has a gradient in every minibatch.
+        /// Learners and options without a lazy update rule (GPU values, L1 regularization, noise injection) keep the dense update.
+        ///
+        CNTK_API void SetLazySparseUpdate(bool enabled) { GetOptions().Add(LazySparseUpdateKey, enabled); }
+        CNTK_API bool IsLazySparseUpdateEnabled() const { return GetOptions().GetOrElse(LazySparseUpdateKey, false); }
+
         CNTK_API void SetLearningRateSchedule(const LearningRateSchedule& learningRateSchedule) { m_learningRateSchedule = learningRateSchedule; }
         CNTK_API const LearningRateSchedule& GetLearningRateSchedule() const { return m_learningRateSchedule; }
 
@@ -5430,6 +5497,28 @@ namespace CNTK
         {
         }
 
+        //
+        // Overlapping of the gradient aggregation with backpropagation, see Internal::SetGradientAggregationBucketSizeInBytes.
+        // The trainer calls BeginBackprop before backpropagation; if it returns true, the trainer passes each gradient
+        // to OnGradientReady as soon as backpropagation has computed it, before calling Update with all of them.
+        //
+        virtual bool BeginBackprop()
+        {
+            return false;
+        }
+
+        virtual void OnGradientReady(const Parameter& /*parameter*/, const NDArrayViewPtr& /*gradient*/)
+        {
+        }
+
+        //
+        // Fraction of the aggregation time of the last minibatch that was hidden behind backpropagation.
+        //
+        virtual double LastOverlapEfficiency() const
+        {
+            return 0;
+        }
+
         //
         // Sets as the metric aggregator learner for the trainer in the case of
         // multiple distributed learner training scenarios. The trainer will use 
@@ -5475,6 +5564,19 @@ namespace CNTK
 
     CNTK_API DistributedLearnerPtr CreateQuantizedDataParallelDistributedLearner(QuantizedDistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, bool useAsyncBufferedParameterUpdate = false);
 
+    ///
+    /// Creates a data parallel distributed learner that only exchanges the 1 / compressionRatio entries of the largest
+    /// magnitude of each gradient; the entries not sent are accumulated locally and added to the next gradient.
+    ///
+    CNTK_API DistributedLearnerPtr CreateSparsifiedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, double compressionRatio = 100);
+
+    ///
+    /// Creates a data parallel distributed learner that partitions the parameters across the workers. 'createLearner' is
+    /// called with the parameters of the shard of the current worker, so that each worker only keeps the learner state
+    /// (e.g. momentum or Adam moments) of its shard; the updated parameter values are exchanged after every update.
+    ///
+    CNTK_API DistributedLearnerPtr CreateShardedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, const std::vector<Parameter>& parameters, const std::function<LearnerPtr(const std::vector<Parameter>&)>& createLearner);
+
     CNTK_API DistributedLearnerPtr CreateBlockMomentumDistributedLearner(
         DistributedCommunicatorPtr communicator,
         LearnerPtr learner,
@@ -5606,6 +5708,162 @@ namespace CNTK
     ///
     CNTK_API EvaluatorPtr CreateEvaluator(const FunctionPtr& evaluationFunction, const std::vector<ProgressWriterPtr>& progressWriters = {});
 
+    ///
+    /// BatchingEvaluator evaluates a model for requests that are made concurrently from many threads.
+    /// Requests that arrive close in time are coalesced into one batch, so that the model is evaluated once for the
+    /// sequences of many requests instead of once per request.
+    ///
+    class BatchingEvaluator : public std::enable_shared_from_this<BatchingEvaluator>
+    {
+    public:
+        ///
+        /// Evaluates the model for the sequences of one request and returns the values of the specified 'outputs'
+        /// (all outputs of the model if empty) for these sequences, located on the CPU.
+        /// 'arguments' must contain a dense Value for each argument of the model, with the same number of sequences.
+        /// Blocks until the batch containing the request has been evaluated; can be called from any number of threads.
+        ///
+        CNTK_API virtual std::unordered_map<Variable, ValuePtr> Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, const std::vector<Variable>& outputs = {}) = 0;
+
+        ///
+        /// Model evaluated by 'this' BatchingEvaluator.
+        ///
+        CNTK_API virtual FunctionPtr Model() const = 0;
+
+        ///
+        /// Maximum number of sequences in a batch.
+        ///
+        CNTK_API virtual size_t MaxBatchSize() const = 0;
+
+        ///
+        /// Maximum time in microseconds that a request waits for other requests before its batch is evaluated.
+        ///
+        CNTK_API virtual size_t MaxLatencyInMicroseconds() const = 0;
+
+        CNTK_API virtual ~BatchingEvaluator() {}
+    };
+
+    ///
+    /// Construct a BatchingEvaluator for the specified model. A batch is evaluated on 'device' as soon as it contains
+    /// 'maxBatchSize' sequences, or when its first request has waited for 'maxLatencyInMicroseconds'.
+    ///
+    CNTK_API BatchingEvaluatorPtr CreateBatchingEvaluator(const FunctionPtr& model, const DeviceDescriptor& device, size_t maxBatchSize, size_t maxLatencyInMicroseconds);
+
+    ///
+    /// Execution context of an EvaluationSession. A context owns the activation buffers for evaluating the model of its session
+    /// and must only be used by one thread at a time; the weights are shared with all other contexts of the session.
+    ///
+    class EvaluationContext : public std::enable_shared_from_this<EvaluationContext>
+    {
+    public:
+        ///
+        /// Evaluates the model of the session for the specified 'arguments' and computes the values of the specified 'outputs'.
+        /// The Variables are those of the model returned by EvaluationSession::Model(), the same for all contexts of the session.
+        ///
+        CNTK_API virtual void Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputs) = 0;
+
+        ///
+        /// Session 'this' context belongs to.
+        ///
+        CNTK_API virtual EvaluationSessionPtr Session() const = 0;
+
+        CNTK_API virtual ~EvaluationContext() {}
+    };
+
+    ///
+    /// EvaluationSession prepares a model for concurrent inference once and hands out execution contexts, one per thread.
+    /// The Parameters of the model are turned into read-only Constants on the device of the session, which are shared by
+    /// all contexts, so that creating a context neither copies weights nor revalidates the graph of the model, and the
+    /// memory of a context is that of the activations only. Parameters and Constants that already reside on the device are
+    /// not copied; they must not be updated while the contexts of the session are evaluating.
+    ///
+    class EvaluationSession : public std::enable_shared_from_this<EvaluationSession>
+    {
+    public:
+        ///
+        /// Creates a new execution context. Can be called from any number of threads.
+        ///
+        CNTK_API virtual EvaluationContextPtr CreateContext() = 0;
+
+        ///
+        /// Model evaluated by the contexts of 'this' session; its arguments and outputs are used to evaluate any of the contexts.
+        ///
+        CNTK_API virtual FunctionPtr Model() const = 0;
+
+        ///
+        /// Device on which the contexts of 'this' session evaluate the model.
+        ///
+        CNTK_API virtual DeviceDescriptor Device() const = 0;
+
+        CNTK_API virtual ~EvaluationSession() {}
+    };
+
+    ///
+    /// Construct an EvaluationSession for evaluating the specified model on 'device'.
+    ///
+    CNTK_API EvaluationSessionPtr CreateEvaluationSession(const FunctionPtr& model, const DeviceDescriptor& device = DeviceDescriptor::UseDefaultDevice());
+
+    ///
+    /// A hypothesis found by a BeamSearchDecoder for one input sequence.
+    ///
+    struct BeamSearchHypothesis
+    {
+        // Decoded tokens, without the end of sequence symbol.
+        std::vector<size_t> tokens;
+        // Sum of the log probabilities of the decoded tokens, including the end of sequence symbol.
+        double logProbability;
+        // Log probability normalized by the length penalty, by which the hypotheses are ranked.
+        double score;
+    };
+
+    ///
+    /// BeamSearchDecoder decodes a batch of input sequences with a step function of a sequence-to-sequence model.
+    /// The step function computes the log probabilities of the next token from the previous token and the recurrent state.
+    /// All hypotheses of a batch are kept on the device: in each step the best 'beamWidth' extensions of the hypotheses of
+    /// each input sequence are selected with a TopK operation and the recurrent states are reordered with a Gather operation,
+    /// without copying any data to the host until the decoding has finished.
+    ///
+    class BeamSearchDecoder : public std::enable_shared_from_this<BeamSearchDecoder>
+    {
+    public:
+        ///
+        /// Decodes the input sequences described by 'arguments', which must contain a dense Value with one sample per input
+        /// sequence for each argument of the step function other than the token input, for at most 'maxLength' tokens.
+        /// The Values of the recurrent states are their initial values; all other Values, e.g. the encoding of the input
+        /// sequences, are passed unchanged to every step. Returns the 'beamWidth' hypotheses of each input sequence, best first.
+        ///
+        CNTK_API virtual std::vector<std::vector<BeamSearchHypothesis>> Decode(const std::unordered_map<Variable, ValuePtr>& arguments, size_t maxLength) = 0;
+
+        ///
+        /// Step function of the model decoded by 'this' BeamSearchDecoder.
+        ///
+        CNTK_API virtual FunctionPtr StepFunction() const = 0;
+
+        ///
+        /// Number of hypotheses kept for each input sequence.
+        ///
+        CNTK_API virtual size_t BeamWidth() const = 0;
+
+        CNTK_API virtual ~BeamSearchDecoder() {}
+    };
+
+    ///
+    /// Construct a BeamSearchDecoder for the specified step function, evaluated on 'device'.
+    /// 'tokenInput' is the argument of the step function, of shape [1] and with only a batch axis, that takes the index of the
+    /// previous token, which is 'startSymbol' in the first step. 'logProbabilities' is the output of the step function with the
+    /// log probabilities of the next token. Each of 'recurrentStates' pairs an argument of the step function with the output
+    /// that becomes its value in the next step. Hypotheses end with 'endSymbol'; they are ranked by their log probability
+    /// divided by ((5 + length) / 6) ^ 'lengthPenalty', so that a 'lengthPenalty' of 0 ranks by the log probability alone.
+    ///
+    CNTK_API BeamSearchDecoderPtr CreateBeamSearchDecoder(const FunctionPtr& stepFunction,
+                                                          const Variable& tokenInput,
+                                                          const Variable& logProbabilities,
+                                                          const std::vector<std::pair<Variable, Variable>>& recurrentStates,
+                                                          size_t beamWidth,
+                                                          size_t startSymbol,
+                                                          size_t endSymbol,
+                                                          double lengthPenalty = 0.0,
+                                                          const DeviceDescriptor& device = DeviceDescriptor::UseDefaultDevice());
+
     enum class DataUnit : unsigned int
     {
         ///Indiciate that the frequency of action is counted by sweep.
@@ -5654,6 +5912,18 @@ namespace CNTK
         ///
         CNTK_API void SaveCheckpoint(const std::wstring& filePath, Dictionary externalState = Dictionary());
 
+        ///
+        /// Checkpoint the model and other Trainer state at the specified file location without waiting for the files to be written.
+        /// The state is copied to host memory before the call returns; the files are written and flushed to the disk on a background thread.
+        /// Errors of writing the files are reported by the next call to SaveCheckpoint(), SaveCheckpointAsync() or WaitForCheckpoint().
+        ///
+        CNTK_API void SaveCheckpointAsync(const std::wstring& filePath, Dictionary externalState = Dictionary());
+
+        ///
+        /// Waits until the checkpoint that is being written in the background (if any) is complete.
+        ///
+        CNTK_API void WaitForCheckpoint();
+
         ///
         /// Restore the model and trainer state from a previously saved model and checkpoint from the specified file location
         ///
@@ -5709,6 +5979,8 @@ namespace CNTK
         ///
         CNTK_API virtual void PrintNodeTiming();
 
+        CNTK_API virtual ~Trainer();
+
     private:
         template <typename T1, typename ...CtorArgTypes>
         friend std::shared_ptr<T1> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
@@ -5729,8 +6001,12 @@ namespace CNTK
         bool TrainLocalMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, bool sweepEnd, const DeviceDescriptor& computeDevice);
         bool TrainDistributedMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, bool sweepEnd, const DeviceDescriptor& computeDevice);
 
+        void SaveCheckpoint(const std::wstring& modelFilePath, const Dictionary& externalState, bool asynchronous);
+
+        void WaitForCheckpointOnAllWorkers();
+
         void Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState,
-            const Dictionary& externalState, const Dictionary& distributedState = {});
+            const Dictionary& externalState, const Dictionary& distributedState, bool asynchronous);
 
         void UpdateTrainingProgress(size_t numSamples, const ValuePtr& loss, const ValuePtr& evalCriterion, const DeviceDescriptor& computeDevice);
         void AddProgressWriters(const std::vector<ProgressWriterPtr>& progressWriters);
@@ -5754,6 +6030,9 @@ namespace CNTK
         AccumulatorPtr m_aggregatedTrainingEvalCriterionValue;
 
         size_t m_prevDistributedTotalNumSamples;
+
+        // Checkpoint that is being written in the background.
+        std::future<void> m_pendingCheckpoint;
     };
 
     ///
@@ -6070,6 +6349,11 @@ namespace CNTK
     ///
     CNTK_API  Deserializer Base64ImageDeserializer(const std::wstring& fileName, const std::wstring& labelStreamName, size_t numLabels, const std::wstring& imageStreamName, const std::vector<ImageTransform>& transforms = {});
 
+    ///
+    /// Create a PackedImageDeserializer with the specified options
+    ///
+    CNTK_API  Deserializer PackedImageDeserializer(const std::wstring& fileName, const std::wstring& labelStreamName, size_t numLabels, const std::wstring& imageStreamName, const std::vector<ImageTransform>& transforms = {});
+
     ///
     /// Create a CTFDeserializer with the specified options
     ///
@@ -6266,6 +6550,15 @@ namespace CNTK
     ///
     CNTK_API DistributedCommunicatorPtr MPICommunicator(size_t packThresholdSizeInBytes = Internal::GetMPIPackThreshold(), bool useFP16AllReduce = false);
 
+    ///
+    /// Communicator for worker processes running on the same machine; data is exchanged through a named shared memory
+    /// segment instead of MPI, so MPI does not need to be installed. All workers have to be created with the same name
+    /// and number of workers, each one with its own rank. The buffer size limits how much data is exchanged at once.
+    /// The name should identify the job (e.g. contain the id assigned by the job scheduler); a segment left behind
+    /// under that name by a run that crashed is removed. Currently only supported on Linux.
+    ///
+    CNTK_API DistributedCommunicatorPtr SharedMemoryCommunicator(const std::wstring& name, size_t numberOfWorkers, size_t workerRank, size_t bufferSizeInBytes = 16 * 1024 * 1024);
+
     ///
     /// Distributed communicator that allows quantized aggregations.
     ///
@@ -6311,19 +6604,22 @@ namespace CNTK
         /// checkpointFrequencyInSamples: frequency in samples when to perform checkpointing.
         /// restoreFromCheckpointIfExists: if flag is set, the training session will try to restore before training.
         /// preserveAllCheckpoints: if flag is set, all checkpoints will be preserved.
+        /// asynchronous: if flag is set, the checkpoints are written in the background while the training continues (see Trainer::SaveCheckpointAsync()).
         ///
         CNTK_API CheckpointConfig(
             const std::wstring& checkPointFileName,
             size_t checkpointFrequency = std::numeric_limits<size_t>::max(),
             DataUnit checkpointFrequencyUnit = DataUnit::Sample,
             bool restoreFromCheckpointIfExists = true,
-            bool preserveAllCheckpoints = false);
+            bool preserveAllCheckpoints = false,
+            bool asynchronous = false);
 
     private:
         friend class TrainingSession;
         const std::wstring m_fileName;
         const bool m_restore;
         const bool m_preserveAll;
+        const bool m_asynchronous;
         const size_t m_frequency;
         const DataUnit m_frequencyUnit;
     };
@@ -144,6 +144,40 @@ CNTK_API CNTK_StatusCode CNTK_CloneModel(
     /*[in]*/ bool flattened,
     /*[out]*/ CNTK_ModelHandle* cloned);
 
+//
+// Creates a model that evaluates the specified model for concurrent CNTK_EvaluateSequence calls in batches:
+// calls that arrive close in time are coalesced into one evaluation of the model, and each call receives the
+// outputs of its own sequence. A batch is evaluated as soon as it contains maxBatchSize sequences, or when its
+// first call has waited for maxLatencyInMicroseconds. The resulting model can be used from many threads at the
+// same time, and must be released with CNTK_ReleaseModel.
+//
+// Parameters:
+//    model [in]: model to evaluate
+//    maxBatchSize [in]: maximum number of sequences in a batch
+//    maxLatencyInMicroseconds [in]: maximum time a call waits for other calls
+//    batching [out]: the resulting batching model
+//
+CNTK_API CNTK_StatusCode CNTK_CreateBatchingModel(
+    /*[in]*/ CNTK_ModelHandle model,
+    /*[in]*/ uint32_t maxBatchSize,
+    /*[in]*/ uint32_t maxLatencyInMicroseconds,
+    /*[out]*/ CNTK_ModelHandle* batching);
+
+//
+// Creates an execution context for evaluating the specified model from one thread, as a cheaper alternative to
+// CNTK_CloneModel for concurrent evaluation. The weights are prepared once on the first call for a model and shared
+// by all its contexts, so each context only allocates the activations of the model. Calling the function for a
+// context creates another context of the same model. The context is used with CNTK_EvaluateSequence and must be
+// released with CNTK_ReleaseModel. Must not be called concurrently for the same model.
+//
+// Parameters:
+//    model [in]: model to evaluate
+//    context [out]: the resulting execution context
+//
+CNTK_API CNTK_StatusCode CNTK_CreateEvaluationContext(
+    /*[in]*/ CNTK_ModelHandle model,
+    /*[out]*/ CNTK_ModelHandle* context);
+
 //
 // Releases all resources associated with the model.
 //
@@ -208,7 +242,12 @@ typedef struct CNTK_Value
 } CNTK_Value;
 
 //
-// Represents a value.
+// Evaluates a sequence with the model.
+// The data of the inputs is evaluated in place, it is only borrowed for the duration of the call.
+// If *outputValues is not null, it points to an array of numOutputs values provided by the caller, whose shapes
+// must match the outputs; the results are written into their buffers without any allocation.
+// Otherwise the output values are allocated and have to be released with CNTK_CleanValue and CNTK_ReleaseArray.
+// No reference to a buffer of the caller is kept after the call, debug builds verify this.
 //
 CNTK_API CNTK_StatusCode CNTK_EvaluateSequence(CNTK_ModelHandle model,
     /*[in]*/const CNTK_Variable* inputs,
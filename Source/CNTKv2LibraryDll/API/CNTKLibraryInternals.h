@@ -214,6 +214,18 @@ namespace CNTK
     class Evaluator;
     typedef std::shared_ptr<Evaluator> EvaluatorPtr;
 
+    class BatchingEvaluator;
+    typedef std::shared_ptr<BatchingEvaluator> BatchingEvaluatorPtr;
+
+    class EvaluationSession;
+    typedef std::shared_ptr<EvaluationSession> EvaluationSessionPtr;
+
+    class EvaluationContext;
+    typedef std::shared_ptr<EvaluationContext> EvaluationContextPtr;
+
+    class BeamSearchDecoder;
+    typedef std::shared_ptr<BeamSearchDecoder> BeamSearchDecoderPtr;
+
     class Trainer;
     typedef std::shared_ptr<Trainer> TrainerPtr;
 
@@ -303,6 +315,26 @@ namespace CNTK
         CNTK_API void UseSparseGradientAggregationInDataParallelSGD(bool enable);
         CNTK_API bool ShouldUseSparseGradientAggregationInDataParallelSGD();
 
+        // Size of the buckets in which the data parallel learner aggregates dense gradients while backpropagation
+        // is still running; 0 (default) aggregates all gradients at once after backpropagation.
+        CNTK_API void SetGradientAggregationBucketSizeInBytes(size_t bucketSizeInBytes);
+        CNTK_API size_t GetGradientAggregationBucketSizeInBytes();
+
+        // Algorithm used by the MPI communicator to aggregate dense values in CPU memory. 'MPI' (default) leaves
+        // the algorithm to the installed MPI library; 'Automatic' picks recursive halving for small messages and
+        // the ring (or the hierarchical algorithm on multiple hosts) for large ones.
+        enum class AllReduceAlgorithm
+        {
+            MPI,
+            Ring,
+            RecursiveHalving,
+            Hierarchical,
+            Automatic
+        };
+
+        CNTK_API void SetAllReduceAlgorithm(AllReduceAlgorithm algorithm);
+        CNTK_API AllReduceAlgorithm GetAllReduceAlgorithm();
+
         CNTK_API unsigned long GetRandomSeed();
         CNTK_API void SetFixedRandomSeed(unsigned long value);
         CNTK_API bool IsRandomSeedFixed();
@@ -315,6 +347,30 @@ namespace CNTK
         CNTK_API void EnableGradientAccumulationOptimization();
         CNTK_API void DisableGradientAccumulationOptimization();
 
+        // When enabled, networks compiled for training keep the values and, separately, the gradients of their dense
+        // Parameters in one contiguous buffer per data type. Gradients in such buffers are aggregated without packing.
+        CNTK_API void EnableContiguousParameterStorage();
+        CNTK_API void DisableContiguousParameterStorage();
+        CNTK_API bool IsContiguousParameterStorageEnabled();
+
+        // Replaces consecutive values that are consecutive slices of the same contiguous parameter storage by a single value
+        // spanning them, as the communicators do before aggregating values. The slices of a storage are laid out in the
+        // order of the Uids of their Parameters, which is the order in which the distributed learners aggregate gradients.
+        CNTK_API std::vector<NDArrayViewPtr> CoalesceContiguousValues(const std::vector<NDArrayViewPtr>& values);
+
+        // When enabled, networks compiled for evaluation only allocate no gradients and release the matrices a node keeps
+        // for backpropagation (e.g. the reserve space of OptimizedRNNStack) as soon as all consumers of its value are done.
+        // A later Forward that retains backward state recompiles the network for training.
+        CNTK_API void EnableInferenceOnlyMemoryMode();
+        CNTK_API void DisableInferenceOnlyMemoryMode();
+        CNTK_API bool IsInferenceOnlyMemoryModeEnabled();
+
+        // Pooled activation memory of the network the Function is compiled into, in bytes: the buffers of its matrix pool, plus the
+        // values and gradients of the nodes that are not drawn from the pool (learnable parameters excluded). Temporaries a node
+        // allocates outside of the pool (e.g. the delayed value of PastValue or the accumulators of precompute nodes) are not included.
+        // After a Forward call this is the peak of that memory for a minibatch of that size; 0 if the Function has not been compiled yet.
+        CNTK_API size_t GetActivationMemoryInBytes(const FunctionPtr& function);
+
         static const uint64_t DefaultProfilerBufferSize = 32 * 1024 * 1024;
         CNTK_API void StartProfiler(const std::wstring& profilerDir = L"profiler", bool profilerSyncGpu = false, size_t profilerBufferSize = DefaultProfilerBufferSize);
         CNTK_API void EnableProfiler();
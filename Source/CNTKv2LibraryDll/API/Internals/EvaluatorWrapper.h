@@ -102,6 +102,8 @@ namespace CNTK
         virtual void GetModelOutputsInfo(CNTK_Variable** outputs, uint32_t* numOutputs) = 0;
 
         virtual std::unique_ptr<EvaluatorWrapper> Clone(CNTK_ParameterCloningMethod method, bool flatten) = 0;
+        virtual std::unique_ptr<EvaluatorWrapper> CreateBatching(uint32_t maxBatchSize, uint32_t maxLatencyInMicroseconds) = 0;
+        virtual std::unique_ptr<EvaluatorWrapper> CreateContext() = 0;
         virtual void EvaluateSequence(
             const CNTK_Variable* inputs,
             const CNTK_Value* inputValues,
@@ -158,6 +160,8 @@ namespace CNTK
         void GetModelOutputsInfo(CNTK_Variable** outputs, uint32_t* numOutputs) override;
 
         std::unique_ptr<EvaluatorWrapper> Clone(CNTK_ParameterCloningMethod method, bool flatten) override;
+        std::unique_ptr<EvaluatorWrapper> CreateBatching(uint32_t maxBatchSize, uint32_t maxLatencyInMicroseconds) override;
+        std::unique_ptr<EvaluatorWrapper> CreateContext() override;
 
         void EvaluateSequence(
             const CNTK_Variable* inputs,
@@ -168,12 +172,57 @@ namespace CNTK
             uint32_t numOutputs,
             CNTK_Value** outputValues) override;
 
-    private:
+    protected:
+        // Device on which the values of the inputs are created.
+        virtual DeviceDescriptor InputDevice() const { return m_device; }
+
+        virtual void Evaluate(const std::unordered_map<Variable, ValuePtr>& inputs, std::unordered_map<Variable, ValuePtr>& outputs);
+
         FunctionPtr m_func;
         DeviceDescriptor m_device;
+
+        // Session shared by the contexts created from this model, see CNTK_CreateEvaluationContext.
+        EvaluationSessionPtr m_session;
+
+    private:
         std::unordered_map<std::string, Variable> m_arguments;
         std::unordered_map<std::string, Variable> m_outputs;
     };
+
+    //
+    // A wrapper that evaluates concurrent requests in batches, see CNTK_CreateBatchingModel.
+    //
+    class CNTKBatchingEvaluatorWrapper : public CNTKEvaluatorWrapper
+    {
+    public:
+        CNTKBatchingEvaluatorWrapper(FunctionPtr model, DeviceDescriptor device, uint32_t maxBatchSize, uint32_t maxLatencyInMicroseconds);
+
+        std::unique_ptr<EvaluatorWrapper> Clone(CNTK_ParameterCloningMethod method, bool flatten) override;
+
+    protected:
+        // Requests are batched on the CPU.
+        DeviceDescriptor InputDevice() const override { return DeviceDescriptor::CPUDevice(); }
+
+        void Evaluate(const std::unordered_map<Variable, ValuePtr>& inputs, std::unordered_map<Variable, ValuePtr>& outputs) override;
+
+    private:
+        BatchingEvaluatorPtr m_evaluator;
+    };
+
+    //
+    // A wrapper that evaluates an execution context of an evaluation session, see CNTK_CreateEvaluationContext.
+    //
+    class CNTKEvaluationContextWrapper : public CNTKEvaluatorWrapper
+    {
+    public:
+        CNTKEvaluationContextWrapper(EvaluationSessionPtr session);
+
+    protected:
+        void Evaluate(const std::unordered_map<Variable, ValuePtr>& inputs, std::unordered_map<Variable, ValuePtr>& outputs) override;
+
+    private:
+        EvaluationContextPtr m_context;
+    };
 }
 
 //#pragma warning(pop)
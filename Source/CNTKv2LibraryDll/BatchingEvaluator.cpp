@@ -0,0 +1,443 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Utils.h"
+#include "Value.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace CNTK
+{
+    namespace
+    {
+        // Sequences of the value of a variable with a batch axis and optionally a sequence axis.
+        // The value has the shape sampleShape x numTimeSteps x numSequences (without numTimeSteps if there is no sequence axis).
+        struct SequenceLayout
+        {
+            NDShape sampleShape;
+            size_t numDynamicAxes;
+            size_t numTimeSteps;
+            size_t numSequences;
+            std::vector<size_t> lengths;
+            std::vector<bool> startFlags;
+        };
+
+        template <typename ElementType>
+        ValuePtr Unpack(const NDShape& sampleShape, const std::vector<Axis>& sampleDynamicAxes, PackedValue& value)
+        {
+            auto packedData = value.PackedData<ElementType>();
+            return Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout(sampleShape, sampleDynamicAxes, *packedData.first, packedData.second);
+        }
+
+        // Returns the value with the data and mask of a packed value unpacked into padded sequences. This is done explicitly
+        // instead of through Value::Data(), which fails for packed values when the automatic unpacking of them is disabled.
+        ValuePtr Unpacked(const ValuePtr& value)
+        {
+            auto packedValue = std::dynamic_pointer_cast<PackedValue>(value);
+            if (!packedValue || !packedValue->IsPacked())
+                return value;
+
+            const auto& sampleDynamicAxes = packedValue->DynamicAxes();
+            auto sampleShape = value->Shape().SubShape(0, value->Shape().Rank() - sampleDynamicAxes.size());
+            switch (value->GetDataType())
+            {
+            case DataType::Float:
+                return Unpack<float>(sampleShape, sampleDynamicAxes, *packedValue);
+            case DataType::Double:
+                return Unpack<double>(sampleShape, sampleDynamicAxes, *packedValue);
+            case DataType::Float16:
+                return Unpack<half>(sampleShape, sampleDynamicAxes, *packedValue);
+            default:
+                InvalidArgument("BatchingEvaluator: values of data type %s cannot be batched.", DataTypeName(value->GetDataType()));
+            }
+        }
+
+        SequenceLayout GetSequenceLayout(const Variable& variable, const ValuePtr& value)
+        {
+            const auto& shape = value->Shape();
+            auto numDynamicAxes = variable.DynamicAxes().size();
+            if (numDynamicAxes == 0 || numDynamicAxes > 2 || shape.Rank() < numDynamicAxes)
+                InvalidArgument("BatchingEvaluator: the value with shape '%S' of variable '%S' cannot be batched, the variable must have a batch axis.",
+                                shape.AsString().c_str(), variable.AsString().c_str());
+
+            SequenceLayout layout;
+            auto sampleRank = shape.Rank() - numDynamicAxes;
+            layout.sampleShape = shape.SubShape(0, sampleRank);
+            layout.numDynamicAxes = numDynamicAxes;
+            layout.numTimeSteps = (numDynamicAxes == 2) ? shape[sampleRank] : 1;
+            layout.numSequences = shape[shape.Rank() - 1];
+            layout.lengths.assign(layout.numSequences, layout.numTimeSteps);
+            layout.startFlags.assign(layout.numSequences, true);
+
+            auto mask = value->Mask();
+            if (!mask || numDynamicAxes == 1)
+                return layout;
+
+            if (mask->Device() != DeviceDescriptor::CPUDevice())
+                mask = mask->DeepClone(DeviceDescriptor::CPUDevice());
+
+            // Only trailing steps of a sequence can be masked.
+            const MaskKind* maskBuffer = mask->DataBuffer();
+            for (size_t i = 0; i < layout.numSequences; ++i)
+            {
+                const MaskKind* sequenceMask = maskBuffer + (i * layout.numTimeSteps);
+                size_t length = 0;
+                while ((length < layout.numTimeSteps) && (sequenceMask[length] != MaskKind::Invalid))
+                    length++;
+
+                layout.lengths[i] = length;
+                layout.startFlags[i] = (sequenceMask[0] == MaskKind::SequenceBegin);
+            }
+
+            return layout;
+        }
+
+        const char* RawDataBuffer(const NDArrayViewPtr& view)
+        {
+            switch (view->GetDataType())
+            {
+            case DataType::Float:
+                return reinterpret_cast<const char*>(view->DataBuffer<float>());
+            case DataType::Double:
+                return reinterpret_cast<const char*>(view->DataBuffer<double>());
+            case DataType::Float16:
+                return reinterpret_cast<const char*>(view->DataBuffer<float16>());
+            default:
+                InvalidArgument("BatchingEvaluator: values of data type %s cannot be batched.", DataTypeName(view->GetDataType()));
+            }
+        }
+
+        char* WritableRawDataBuffer(const NDArrayViewPtr& view)
+        {
+            switch (view->GetDataType())
+            {
+            case DataType::Float:
+                return reinterpret_cast<char*>(view->WritableDataBuffer<float>());
+            case DataType::Double:
+                return reinterpret_cast<char*>(view->WritableDataBuffer<double>());
+            case DataType::Float16:
+                return reinterpret_cast<char*>(view->WritableDataBuffer<float16>());
+            default:
+                InvalidArgument("BatchingEvaluator: values of data type %s cannot be batched.", DataTypeName(view->GetDataType()));
+            }
+        }
+
+        NDArrayViewPtr OnCPU(const NDArrayViewPtr& view)
+        {
+            if (view->Device() == DeviceDescriptor::CPUDevice())
+                return view;
+
+            return view->DeepClone(DeviceDescriptor::CPUDevice(), /*readOnly=*/ true);
+        }
+
+        // Sequences [begin, end) of a value whose data is located on the CPU.
+        struct SequenceRange
+        {
+            NDArrayViewPtr data;
+            const SequenceLayout* layout;
+            size_t begin;
+            size_t end;
+        };
+
+        // Copies the sequences into a new value on the CPU, padded to the length of the longest sequence.
+        // The mask keeps the length and the begin flag of each sequence.
+        ValuePtr PackSequences(const std::vector<SequenceRange>& ranges)
+        {
+            const auto& firstLayout = *ranges.front().layout;
+            auto dataType = ranges.front().data->GetDataType();
+            auto sampleSizeInBytes = firstLayout.sampleShape.TotalSize() * DataTypeSize(dataType);
+
+            size_t numTimeSteps = 0;
+            size_t numSequences = 0;
+            for (const auto& range : ranges)
+            {
+                for (size_t i = range.begin; i < range.end; ++i)
+                    numTimeSteps = std::max(numTimeSteps, range.layout->lengths[i]);
+                numSequences += range.end - range.begin;
+            }
+
+            auto shape = (firstLayout.numDynamicAxes == 2) ? firstLayout.sampleShape.AppendShape({ numTimeSteps, numSequences }) : firstLayout.sampleShape.AppendShape({ numSequences });
+            auto data = MakeSharedObject<NDArrayView>(dataType, shape, DeviceDescriptor::CPUDevice());
+            auto mask = MakeSharedObject<NDMask>(NDShape({ numTimeSteps, numSequences }), DeviceDescriptor::CPUDevice());
+            bool isMaskNeeded = false;
+
+            auto buffer = WritableRawDataBuffer(data);
+            memset(buffer, 0, numTimeSteps * numSequences * sampleSizeInBytes);
+
+            size_t sequence = 0;
+            for (const auto& range : ranges)
+            {
+                auto source = RawDataBuffer(range.data);
+                for (size_t i = range.begin; i < range.end; ++i, ++sequence)
+                {
+                    auto length = range.layout->lengths[i];
+                    memcpy(buffer + (sequence * numTimeSteps * sampleSizeInBytes), source + (i * range.layout->numTimeSteps * sampleSizeInBytes), length * sampleSizeInBytes);
+
+                    if (length < numTimeSteps)
+                    {
+                        mask->InvalidateSection({ length, sequence }, { numTimeSteps - length, 1 });
+                        isMaskNeeded = true;
+                    }
+
+                    if (range.layout->startFlags[i])
+                        mask->MarkSequenceBegin({ 0, sequence });
+                    else
+                        isMaskNeeded = true;
+                }
+            }
+
+            return MakeSharedObject<Value>(data, isMaskNeeded ? mask : nullptr);
+        }
+    }
+
+    class BatchingEvaluatorImpl final : public BatchingEvaluator
+    {
+    public:
+        BatchingEvaluatorImpl(const FunctionPtr& model, const DeviceDescriptor& device, size_t maxBatchSize, size_t maxLatencyInMicroseconds)
+            : m_model(model),
+              m_device(device),
+              m_maxBatchSize(maxBatchSize),
+              m_maxLatency(maxLatencyInMicroseconds),
+              m_queuedSequences(0),
+              m_stopped(false)
+        {
+            if (!m_model)
+                InvalidArgument("BatchingEvaluator: the model is not allowed to be null.");
+
+            if (m_maxBatchSize == 0)
+                InvalidArgument("BatchingEvaluator: the maximum batch size must be greater than 0.");
+
+            m_arguments = m_model->Arguments();
+            if (m_arguments.empty())
+                InvalidArgument("BatchingEvaluator: the model '%S' has no arguments.", m_model->AsString().c_str());
+
+            m_thread = std::thread([this] { Run(); });
+        }
+
+        ~BatchingEvaluatorImpl()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+            }
+            m_requestQueued.notify_all();
+            m_thread.join();
+        }
+
+        std::unordered_map<Variable, ValuePtr> Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, const std::vector<Variable>& outputs) override
+        {
+            Request request;
+            request.outputs = outputs.empty() ? m_model->Outputs() : outputs;
+            for (const auto& argument : m_arguments)
+            {
+                auto value = arguments.find(argument);
+                if (value == arguments.end() || !value->second)
+                    InvalidArgument("BatchingEvaluator: no value was provided for argument '%S'.", argument.AsString().c_str());
+
+                if (value->second->IsSparse())
+                    InvalidArgument("BatchingEvaluator: the value of argument '%S' is sparse, only dense values can be batched.", argument.AsString().c_str());
+
+                if (value->second->GetDataType() != argument.GetDataType())
+                    InvalidArgument("BatchingEvaluator: the value of argument '%S' has data type %s.", argument.AsString().c_str(), DataTypeName(value->second->GetDataType()));
+
+                auto argumentValue = Unpacked(value->second);
+                auto layout = GetSequenceLayout(argument, argumentValue);
+                if (request.arguments.empty())
+                    request.numSequences = layout.numSequences;
+                else if (layout.numSequences != request.numSequences)
+                    InvalidArgument("BatchingEvaluator: the value of argument '%S' has %d sequences, the value of argument '%S' %d.",
+                                    argument.AsString().c_str(), (int)layout.numSequences, m_arguments.front().AsString().c_str(), (int)request.numSequences);
+
+                // The batch is assembled on the CPU, and transferred to the device at once.
+                request.arguments.push_back({ OnCPU(argumentValue->Data()), std::move(layout) });
+            }
+
+            if (request.numSequences == 0)
+                InvalidArgument("BatchingEvaluator: the request contains no sequences.");
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            request.arrivalTime = std::chrono::steady_clock::now();
+            m_queue.push_back(&request);
+            m_queuedSequences += request.numSequences;
+            m_requestQueued.notify_one();
+
+            m_requestDone.wait(lock, [&request] { return request.done; });
+            if (request.error)
+                std::rethrow_exception(request.error);
+
+            return std::move(request.results);
+        }
+
+        FunctionPtr Model() const override
+        {
+            return m_model;
+        }
+
+        size_t MaxBatchSize() const override
+        {
+            return m_maxBatchSize;
+        }
+
+        size_t MaxLatencyInMicroseconds() const override
+        {
+            return (size_t)m_maxLatency.count();
+        }
+
+    private:
+        struct ArgumentValue
+        {
+            NDArrayViewPtr data;
+            SequenceLayout layout;
+        };
+
+        // Lives on the stack of the requesting thread until 'done' is set.
+        struct Request
+        {
+            std::vector<ArgumentValue> arguments; // in the order of the arguments of the model
+            std::vector<Variable> outputs;
+            size_t numSequences = 0;
+            std::chrono::steady_clock::time_point arrivalTime;
+
+            std::unordered_map<Variable, ValuePtr> results;
+            std::exception_ptr error;
+            bool done = false;
+        };
+
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_requestQueued.wait(lock, [this] { return m_stopped || !m_queue.empty(); });
+                if (m_queue.empty())
+                    return;
+
+                // Waits for more requests until the batch is full or its first request has waited long enough.
+                auto deadline = m_queue.front()->arrivalTime + m_maxLatency;
+                m_requestQueued.wait_until(lock, deadline, [this] { return m_stopped || m_queuedSequences >= m_maxBatchSize; });
+
+                auto batch = TakeBatch();
+                lock.unlock();
+                EvaluateBatch(batch);
+                lock.lock();
+
+                for (auto request : batch)
+                    request->done = true;
+                m_requestDone.notify_all();
+            }
+        }
+
+        // Takes the requests from the front of the queue that fit into one batch. A request with more
+        // sequences than the maximum batch size is evaluated on its own.
+        std::vector<Request*> TakeBatch()
+        {
+            std::vector<Request*> batch;
+            size_t numSequences = 0;
+            while (!m_queue.empty())
+            {
+                auto request = m_queue.front();
+                if (!batch.empty() && ((numSequences + request->numSequences > m_maxBatchSize) || !HaveSameSampleShapes(*batch.front(), *request)))
+                    break;
+
+                batch.push_back(request);
+                numSequences += request->numSequences;
+                m_queuedSequences -= request->numSequences;
+                m_queue.pop_front();
+            }
+
+            return batch;
+        }
+
+        static bool HaveSameSampleShapes(const Request& a, const Request& b)
+        {
+            for (size_t i = 0; i < a.arguments.size(); ++i)
+            {
+                if (a.arguments[i].layout.sampleShape != b.arguments[i].layout.sampleShape)
+                    return false;
+            }
+            return true;
+        }
+
+        void EvaluateBatch(const std::vector<Request*>& batch)
+        {
+            try
+            {
+                std::unordered_map<Variable, ValuePtr> arguments;
+                for (size_t i = 0; i < m_arguments.size(); ++i)
+                {
+                    std::vector<SequenceRange> ranges;
+                    for (auto request : batch)
+                        ranges.push_back({ request->arguments[i].data, &request->arguments[i].layout, 0, request->numSequences });
+
+                    auto value = PackSequences(ranges);
+                    if (m_device != DeviceDescriptor::CPUDevice())
+                        value = MakeSharedObject<Value>(value->Data()->DeepClone(m_device, /*readOnly=*/ true), value->Mask());
+                    arguments[m_arguments[i]] = value;
+                }
+
+                std::unordered_map<Variable, ValuePtr> outputs;
+                for (auto request : batch)
+                {
+                    for (const auto& output : request->outputs)
+                        outputs[output] = nullptr;
+                }
+
+                m_model->Evaluate(arguments, outputs, m_device);
+
+                // Scatters the sequences of the outputs back to the requests, in the order in which they were batched.
+                for (const auto& output : outputs)
+                {
+                    auto value = Unpacked(output.second);
+                    auto layout = GetSequenceLayout(output.first, value);
+                    auto data = OnCPU(value->Data());
+
+                    size_t begin = 0;
+                    for (auto request : batch)
+                    {
+                        auto end = begin + request->numSequences;
+                        if (end > layout.numSequences)
+                            RuntimeError("BatchingEvaluator: the value of output '%S' has %d sequences, fewer than the arguments of the batch.",
+                                         output.first.AsString().c_str(), (int)layout.numSequences);
+
+                        if (std::find(request->outputs.begin(), request->outputs.end(), output.first) != request->outputs.end())
+                            request->results[output.first] = PackSequences({ { data, &layout, begin, end } });
+                        begin = end;
+                    }
+                }
+            }
+            catch (...)
+            {
+                auto error = std::current_exception();
+                for (auto request : batch)
+                    request->error = error;
+            }
+        }
+
+        const FunctionPtr m_model;
+        const DeviceDescriptor m_device;
+        const size_t m_maxBatchSize;
+        const std::chrono::microseconds m_maxLatency;
+        std::vector<Variable> m_arguments;
+
+        std::mutex m_mutex;
+        std::condition_variable m_requestQueued;
+        std::condition_variable m_requestDone;
+        std::deque<Request*> m_queue;
+        size_t m_queuedSequences;
+        bool m_stopped;
+
+        // Evaluates the batches; the only thread that uses the model.
+        std::thread m_thread;
+    };
+
+    BatchingEvaluatorPtr CreateBatchingEvaluator(const FunctionPtr& model, const DeviceDescriptor& device, size_t maxBatchSize, size_t maxLatencyInMicroseconds)
+    {
+        return MakeSharedObject<BatchingEvaluatorImpl>(model, device, maxBatchSize, maxLatencyInMicroseconds);
+    }
+}
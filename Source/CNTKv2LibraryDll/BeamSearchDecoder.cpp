@@ -0,0 +1,405 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace CNTK
+{
+    namespace
+    {
+        template <typename ElementType>
+        NDArrayViewPtr CreateView(const std::vector<double>& values, const NDShape& shape, const DeviceDescriptor& device)
+        {
+            std::vector<ElementType> buffer(values.begin(), values.end());
+            auto view = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), shape, device);
+            view->CopyFrom(*MakeSharedObject<NDArrayView>(shape, buffer, /*readOnly =*/ true));
+            return view;
+        }
+
+        NDArrayViewPtr CreateView(const std::vector<double>& values, const NDShape& shape, DataType dataType, const DeviceDescriptor& device)
+        {
+            switch (dataType)
+            {
+            case DataType::Float:
+                return CreateView<float>(values, shape, device);
+            case DataType::Double:
+                return CreateView<double>(values, shape, device);
+            default:
+                InvalidArgument("BeamSearchDecoder: values of data type %s are not supported.", DataTypeName(dataType));
+            }
+        }
+
+        template <typename ElementType>
+        std::vector<double> CopyToHost(const NDArrayViewPtr& view)
+        {
+            auto cpuView = view->DeepClone(DeviceDescriptor::CPUDevice(), /*readOnly =*/ true);
+            const ElementType* buffer = cpuView->DataBuffer<ElementType>();
+            return std::vector<double>(buffer, buffer + cpuView->Shape().TotalSize());
+        }
+
+        std::vector<double> CopyToHost(const NDArrayViewPtr& view)
+        {
+            if (view->GetDataType() == DataType::Float)
+                return CopyToHost<float>(view);
+            else
+                return CopyToHost<double>(view);
+        }
+
+        // Copies each of the 'numSequences' samples of 'data' into 'beamWidth' consecutive samples on 'device'.
+        NDArrayViewPtr ExpandToBeams(const NDArrayViewPtr& data, size_t sampleSize, size_t numSequences, size_t beamWidth, const DeviceDescriptor& device)
+        {
+            auto samples = data->AsShape({ sampleSize, numSequences });
+            if (samples->Device() != device)
+                samples = samples->DeepClone(device, /*readOnly =*/ true);
+
+            auto expanded = MakeSharedObject<NDArrayView>(data->GetDataType(), NDShape({ sampleSize, numSequences * beamWidth }), device);
+            for (size_t i = 0; i < numSequences; ++i)
+            {
+                auto sample = samples->SliceView({ 0, i }, { sampleSize, 1 }, /*readOnly =*/ true);
+                for (size_t k = 0; k < beamWidth; ++k)
+                    expanded->SliceView({ 0, i * beamWidth + k }, { sampleSize, 1 })->CopyFrom(*sample);
+            }
+
+            return expanded;
+        }
+    }
+
+    class BeamSearchDecoderImpl final : public BeamSearchDecoder
+    {
+        // Number of steps after which the decoder checks whether all hypotheses have ended; this is the only
+        // data copied to the host while decoding.
+        static const size_t TerminationCheckInterval = 8;
+
+        // Graph that selects the hypotheses of the next step for a batch of a given number of input sequences.
+        // Its values have no dynamic axes: the hypotheses of input sequence b are the columns [b * K, (b + 1) * K)
+        // of the batch of the step function, which are viewed as the tensor K x B here.
+        struct Selection
+        {
+            FunctionPtr function;
+
+            Variable logProbabilities;
+            Variable scores;
+            Variable finished;
+            Variable lengths;
+            std::vector<Variable> states;
+
+            Variable nextScores;
+            Variable nextFinished;
+            Variable nextLengths;
+            Variable tokens;
+            Variable parents;
+            std::vector<Variable> nextStates;
+        };
+
+    public:
+        BeamSearchDecoderImpl(const FunctionPtr& stepFunction, const Variable& tokenInput, const Variable& logProbabilities, const std::vector<std::pair<Variable, Variable>>& recurrentStates,
+                              size_t beamWidth, size_t startSymbol, size_t endSymbol, double lengthPenalty, const DeviceDescriptor& device)
+            : m_stepFunction(stepFunction),
+              m_tokenInput(tokenInput),
+              m_logProbabilities(logProbabilities),
+              m_recurrentStates(recurrentStates),
+              m_beamWidth(beamWidth),
+              m_startSymbol(startSymbol),
+              m_endSymbol(endSymbol),
+              m_lengthPenalty(lengthPenalty),
+              m_device(device)
+        {
+            if (!m_stepFunction)
+                InvalidArgument("BeamSearchDecoder: the step function is not allowed to be null.");
+
+            if (m_beamWidth == 0)
+                InvalidArgument("BeamSearchDecoder: the beam width must be positive.");
+
+            auto arguments = m_stepFunction->Arguments();
+            auto outputs = m_stepFunction->Outputs();
+            auto isArgument = [&arguments](const Variable& variable) { return std::find(arguments.begin(), arguments.end(), variable) != arguments.end(); };
+            auto isOutput = [&outputs](const Variable& variable) { return std::find(outputs.begin(), outputs.end(), variable) != outputs.end(); };
+
+            if (!isOutput(m_logProbabilities) || (m_logProbabilities.Shape().Rank() != 1))
+                InvalidArgument("BeamSearchDecoder: the log probabilities '%S' must be an output of rank 1 of the step function '%S'.",
+                                m_logProbabilities.AsString().c_str(), m_stepFunction->AsString().c_str());
+
+            m_vocabularySize = m_logProbabilities.Shape()[0];
+            m_dataType = m_logProbabilities.GetDataType();
+            if ((m_dataType != DataType::Float) && (m_dataType != DataType::Double))
+                InvalidArgument("BeamSearchDecoder: log probabilities of data type %s are not supported.", DataTypeName(m_dataType));
+
+            if (m_endSymbol >= m_vocabularySize)
+                InvalidArgument("BeamSearchDecoder: the end symbol %d is not in the vocabulary of size %d.", (int)m_endSymbol, (int)m_vocabularySize);
+
+            if (!isArgument(m_tokenInput) || (m_tokenInput.Shape() != NDShape({ 1 })))
+                InvalidArgument("BeamSearchDecoder: the token input '%S' must be an argument of shape [1] of the step function '%S'.",
+                                m_tokenInput.AsString().c_str(), m_stepFunction->AsString().c_str());
+
+            // All hypotheses are evaluated as one batch of samples.
+            for (const auto& argument : arguments)
+            {
+                if ((argument.DynamicAxes() != std::vector<Axis>({ Axis::DefaultBatchAxis() })) || argument.IsSparse() || (argument.GetDataType() != m_dataType))
+                    InvalidArgument("BeamSearchDecoder: the argument '%S' of the step function must be dense, have the data type of the log probabilities and only a batch axis.",
+                                    argument.AsString().c_str());
+            }
+
+            for (const auto& state : m_recurrentStates)
+            {
+                if (!isArgument(state.first) || (state.first == m_tokenInput) || !isOutput(state.second) || (state.second == m_logProbabilities) || (state.first.Shape() != state.second.Shape()))
+                    InvalidArgument("BeamSearchDecoder: the recurrent state '%S' must pair an argument of the step function with an output of the same shape, '%S' does not.",
+                                    state.first.AsString().c_str(), state.second.AsString().c_str());
+            }
+        }
+
+        std::vector<std::vector<BeamSearchHypothesis>> Decode(const std::unordered_map<Variable, ValuePtr>& arguments, size_t maxLength) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (maxLength == 0)
+                InvalidArgument("BeamSearchDecoder: the maximum length must be positive.");
+
+            // Each input sequence starts with 'beamWidth' copies of its arguments.
+            size_t numSequences = 0;
+            std::unordered_map<Variable, NDArrayViewPtr> inputs;
+            for (const auto& argument : m_stepFunction->Arguments())
+            {
+                if (argument == m_tokenInput)
+                    continue;
+
+                auto value = arguments.find(argument);
+                if ((value == arguments.end()) || !value->second)
+                    InvalidArgument("BeamSearchDecoder: no value is specified for the argument '%S' of the step function.", argument.AsString().c_str());
+
+                auto data = value->second->Data();
+                const auto& sampleShape = argument.Shape();
+                if ((value->second->MaskedCount() > 0) || value->second->IsSparse() || (data->Shape().SubShape(0, sampleShape.Rank()) != sampleShape) || (data->GetDataType() != m_dataType))
+                    InvalidArgument("BeamSearchDecoder: the value of the argument '%S' must be dense and contain one sample per input sequence.", argument.AsString().c_str());
+
+                auto count = data->Shape().TotalSize() / sampleShape.TotalSize();
+                if ((numSequences != 0) && (count != numSequences))
+                    InvalidArgument("BeamSearchDecoder: the value of the argument '%S' has %d samples, %d input sequences are expected.", argument.AsString().c_str(), (int)count, (int)numSequences);
+
+                numSequences = count;
+                inputs[argument] = ExpandToBeams(data, sampleShape.TotalSize(), numSequences, m_beamWidth, m_device)->AsShape(sampleShape.AppendShape({ numSequences * m_beamWidth }));
+            }
+
+            if (numSequences == 0)
+                InvalidArgument("BeamSearchDecoder: the number of input sequences cannot be determined, no argument other than the token input has a value.");
+
+            const auto& selection = GetSelection(numSequences);
+            const size_t numBeams = numSequences * m_beamWidth;
+            const NDShape beamShape({ 1, m_beamWidth, numSequences });
+
+            // Only the first hypothesis of each input sequence is live at the start; the others would duplicate it.
+            std::vector<double> initialScores(numBeams, -std::numeric_limits<double>::infinity());
+            for (size_t i = 0; i < numSequences; ++i)
+                initialScores[i * m_beamWidth] = 0;
+
+            NDArrayViewPtr scores[2] = { CreateView(initialScores, beamShape, m_dataType, m_device), MakeSharedObject<NDArrayView>(m_dataType, beamShape, m_device) };
+            NDArrayViewPtr finished[2] = { CreateView(std::vector<double>(numBeams, 0), beamShape, m_dataType, m_device), MakeSharedObject<NDArrayView>(m_dataType, beamShape, m_device) };
+            NDArrayViewPtr lengths[2] = { CreateView(std::vector<double>(numBeams, 0), beamShape, m_dataType, m_device), MakeSharedObject<NDArrayView>(m_dataType, beamShape, m_device) };
+
+            // Token and parent hypothesis selected in each step, for tracing back the hypotheses at the end.
+            auto tokens = MakeSharedObject<NDArrayView>(m_dataType, NDShape({ m_beamWidth, numSequences, maxLength }), m_device);
+            auto parents = MakeSharedObject<NDArrayView>(m_dataType, NDShape({ m_beamWidth, numSequences, maxLength }), m_device);
+
+            auto logProbabilities = MakeSharedObject<NDArrayView>(m_dataType, NDShape({ m_vocabularySize, numBeams }), m_device);
+            std::vector<NDArrayViewPtr> stateOutputs;
+            for (const auto& state : m_recurrentStates)
+                stateOutputs.push_back(MakeSharedObject<NDArrayView>(m_dataType, state.second.Shape().AppendShape({ numBeams }), m_device));
+
+            std::unordered_map<Variable, ValuePtr> stepArguments;
+            for (const auto& input : inputs)
+                stepArguments[input.first] = MakeSharedObject<Value>(input.second);
+
+            std::unordered_map<Variable, ValuePtr> stepOutputs = { { m_logProbabilities, MakeSharedObject<Value>(logProbabilities) } };
+            for (size_t i = 0; i < m_recurrentStates.size(); ++i)
+                stepOutputs[m_recurrentStates[i].second] = MakeSharedObject<Value>(stateOutputs[i]);
+
+            auto previousTokens = CreateView(std::vector<double>(numBeams, (double)m_startSymbol), { 1, numBeams }, m_dataType, m_device);
+            size_t length = 0;
+            while (length < maxLength)
+            {
+                stepArguments[m_tokenInput] = MakeSharedObject<Value>(previousTokens);
+                m_stepFunction->Evaluate(stepArguments, stepOutputs, m_device);
+
+                auto current = length % 2;
+                auto next = 1 - current;
+                auto stepTokens = tokens->SliceView({ 0, 0, length }, { m_beamWidth, numSequences });
+                auto stepParents = parents->SliceView({ 0, 0, length }, { m_beamWidth, numSequences });
+
+                std::unordered_map<Variable, ValuePtr> selectionArguments = {
+                    { selection.logProbabilities, MakeSharedObject<Value>(logProbabilities->AsShape({ m_vocabularySize, m_beamWidth, numSequences })) },
+                    { selection.scores, MakeSharedObject<Value>(scores[current]) },
+                    { selection.finished, MakeSharedObject<Value>(finished[current]) },
+                    { selection.lengths, MakeSharedObject<Value>(lengths[current]) },
+                };
+
+                std::unordered_map<Variable, ValuePtr> selectionOutputs = {
+                    { selection.nextScores, MakeSharedObject<Value>(scores[next]) },
+                    { selection.nextFinished, MakeSharedObject<Value>(finished[next]) },
+                    { selection.nextLengths, MakeSharedObject<Value>(lengths[next]) },
+                    { selection.tokens, MakeSharedObject<Value>(stepTokens) },
+                    { selection.parents, MakeSharedObject<Value>(stepParents) },
+                };
+
+                // The reordered states are written into the arguments of the next step.
+                for (size_t i = 0; i < m_recurrentStates.size(); ++i)
+                {
+                    const auto& stateShape = m_recurrentStates[i].first.Shape();
+                    selectionArguments[selection.states[i]] = MakeSharedObject<Value>(stateOutputs[i]);
+                    selectionOutputs[selection.nextStates[i]] = MakeSharedObject<Value>(inputs.at(m_recurrentStates[i].first)->AsShape(stateShape.AppendShape({ m_beamWidth, numSequences })));
+                }
+
+                selection.function->Evaluate(selectionArguments, selectionOutputs, m_device);
+
+                previousTokens = stepTokens->AsShape({ 1, numBeams });
+                length++;
+
+                if ((length % TerminationCheckInterval) == 0)
+                {
+                    auto hostFinished = CopyToHost(finished[next]);
+                    if (std::all_of(hostFinished.begin(), hostFinished.end(), [](double value) { return value > 0.5; }))
+                        break;
+                }
+            }
+
+            auto hostScores = CopyToHost(scores[length % 2]);
+            auto hostLengths = CopyToHost(lengths[length % 2]);
+            auto hostTokens = CopyToHost(tokens);
+            auto hostParents = CopyToHost(parents);
+
+            std::vector<std::vector<BeamSearchHypothesis>> hypotheses(numSequences);
+            for (size_t i = 0; i < numSequences; ++i)
+            {
+                for (size_t k = 0; k < m_beamWidth; ++k)
+                {
+                    BeamSearchHypothesis hypothesis;
+                    size_t beam = k;
+                    for (size_t t = length; t-- > 0;)
+                    {
+                        auto index = (t * numSequences + i) * m_beamWidth + beam;
+                        hypothesis.tokens.push_back((size_t)(hostTokens[index] + 0.5));
+                        beam = (size_t)(hostParents[index] + 0.5);
+                    }
+
+                    std::reverse(hypothesis.tokens.begin(), hypothesis.tokens.end());
+                    hypothesis.tokens.erase(std::find(hypothesis.tokens.begin(), hypothesis.tokens.end(), m_endSymbol), hypothesis.tokens.end());
+
+                    auto index = i * m_beamWidth + k;
+                    hypothesis.logProbability = hostScores[index];
+                    hypothesis.score = hostScores[index] / std::pow((5.0 + hostLengths[index]) / 6.0, m_lengthPenalty);
+                    hypotheses[i].push_back(std::move(hypothesis));
+                }
+
+                std::stable_sort(hypotheses[i].begin(), hypotheses[i].end(), [](const BeamSearchHypothesis& left, const BeamSearchHypothesis& right) { return left.score > right.score; });
+            }
+
+            return hypotheses;
+        }
+
+        FunctionPtr StepFunction() const override
+        {
+            return m_stepFunction;
+        }
+
+        size_t BeamWidth() const override
+        {
+            return m_beamWidth;
+        }
+
+    private:
+        const Selection& GetSelection(size_t numSequences)
+        {
+            auto existingSelection = m_selections.find(numSequences);
+            if (existingSelection != m_selections.end())
+                return existingSelection->second;
+
+            const size_t K = m_beamWidth;
+            const size_t V = m_vocabularySize;
+            const size_t B = numSequences;
+            const std::vector<Axis> noDynamicAxes;
+
+            Selection selection;
+            selection.logProbabilities = InputVariable({ V, K, B }, m_dataType, L"logProbabilities", noDynamicAxes);
+            selection.scores = InputVariable({ 1, K, B }, m_dataType, L"scores", noDynamicAxes);
+            selection.finished = InputVariable({ 1, K, B }, m_dataType, L"finished", noDynamicAxes);
+            selection.lengths = InputVariable({ 1, K, B }, m_dataType, L"lengths", noDynamicAxes);
+
+            std::vector<double> endSymbolOnly(V, -std::numeric_limits<double>::infinity());
+            endSymbolOnly[m_endSymbol] = 0;
+            std::vector<double> beamOffsets(B);
+            for (size_t i = 0; i < B; ++i)
+                beamOffsets[i] = (double)(i * K);
+
+            auto endSymbolLogProbabilities = Constant(CreateView(endSymbolOnly, { V, 1, 1 }, m_dataType, m_device));
+            auto firstBeams = Constant(CreateView(beamOffsets, { 1, B }, m_dataType, m_device));
+            auto vocabularySize = Constant::Scalar(m_dataType, (double)V, m_device);
+            auto endSymbol = Constant::Scalar(m_dataType, (double)m_endSymbol, m_device);
+            auto half = Constant::Scalar(m_dataType, 0.5, m_device);
+            auto one = Constant::Scalar(m_dataType, 1.0, m_device);
+
+            // Hypotheses that have ended can only be extended by the end symbol, at no cost.
+            auto candidates = Plus(selection.scores, ElementSelect(selection.finished, endSymbolLogProbabilities, selection.logProbabilities));
+            auto best = TopK(Reshape(candidates, { V * K, B }), K);
+            auto bestScores = best->Outputs()[0];
+            auto bestIndices = best->Outputs()[1];
+
+            // The index of a candidate within the hypotheses of its input sequence is parent * V + token.
+            auto parents = Floor(ElementDivide(Plus(bestIndices, half), vocabularySize));
+            auto tokens = Minus(bestIndices, ElementTimes(parents, vocabularySize));
+
+            // Index of the parent among the hypotheses of all input sequences, by which the states are gathered.
+            auto sources = Plus(parents, firstBeams);
+            auto parentFinished = GatherOp(sources, Reshape(selection.finished, { K * B }));
+            auto nextFinished = ElementSelect(parentFinished, parentFinished, Equal(tokens, endSymbol));
+            auto nextLengths = Plus(GatherOp(sources, Reshape(selection.lengths, { K * B })), Minus(one, parentFinished));
+
+            std::vector<Variable> outputs = { Reshape(bestScores, { 1, K, B }), Reshape(nextFinished, { 1, K, B }), Reshape(nextLengths, { 1, K, B }), tokens, parents };
+            for (const auto& state : m_recurrentStates)
+            {
+                auto stateInput = InputVariable(state.first.Shape().AppendShape({ K * B }), m_dataType, state.first.Name(), noDynamicAxes);
+                selection.states.push_back(stateInput);
+                outputs.push_back(GatherOp(sources, stateInput));
+            }
+
+            selection.function = Combine(outputs, L"BeamSearchSelection");
+            auto selectionOutputs = selection.function->Outputs();
+            selection.nextScores = selectionOutputs[0];
+            selection.nextFinished = selectionOutputs[1];
+            selection.nextLengths = selectionOutputs[2];
+            selection.tokens = selectionOutputs[3];
+            selection.parents = selectionOutputs[4];
+            selection.nextStates.assign(selectionOutputs.begin() + 5, selectionOutputs.end());
+
+            return m_selections.insert({ numSequences, std::move(selection) }).first->second;
+        }
+
+        const FunctionPtr m_stepFunction;
+        const Variable m_tokenInput;
+        const Variable m_logProbabilities;
+        const std::vector<std::pair<Variable, Variable>> m_recurrentStates;
+        const size_t m_beamWidth;
+        const size_t m_startSymbol;
+        const size_t m_endSymbol;
+        const double m_lengthPenalty;
+        const DeviceDescriptor m_device;
+
+        size_t m_vocabularySize;
+        DataType m_dataType;
+
+        // Selection graphs by the number of input sequences in a batch.
+        std::unordered_map<size_t, Selection> m_selections;
+        std::mutex m_mutex;
+    };
+
+    BeamSearchDecoderPtr CreateBeamSearchDecoder(const FunctionPtr& stepFunction, const Variable& tokenInput, const Variable& logProbabilities, const std::vector<std::pair<Variable, Variable>>& recurrentStates,
+                                                 size_t beamWidth, size_t startSymbol, size_t endSymbol, double lengthPenalty, const DeviceDescriptor& device)
+    {
+        return MakeSharedObject<BeamSearchDecoderImpl>(stepFunction, tokenInput, logProbabilities, recurrentStates, beamWidth, startSymbol, endSymbol, lengthPenalty, device);
+    }
+}
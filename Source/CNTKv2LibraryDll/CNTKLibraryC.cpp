@@ -115,6 +115,28 @@ CNTK_StatusCode CNTK_CloneModel(CNTK_ModelHandle model, CNTK_ParameterCloningMet
     return ExceptionCatcher::Call([&]() { *cloned = ((EvaluatorWrapper*)model)->Clone(method, flatten).release(); });
 }
 
+CNTK_StatusCode CNTK_CreateBatchingModel(CNTK_ModelHandle model, uint32_t maxBatchSize, uint32_t maxLatencyInMicroseconds, CNTK_ModelHandle* batching)
+{
+    if (model == CNTK_INVALID_MODEL_HANDLE)
+        return StatusCode(CNTK_INVALID_MODEL_HANDLE, "Invalid model handle");
+
+    if (!batching)
+        return StatusCode(CNTK_ERROR_NULL_POINTER, "'batching' parameter is not allowed to be null");
+
+    return ExceptionCatcher::Call([&]() { *batching = ((EvaluatorWrapper*)model)->CreateBatching(maxBatchSize, maxLatencyInMicroseconds).release(); });
+}
+
+CNTK_StatusCode CNTK_CreateEvaluationContext(CNTK_ModelHandle model, CNTK_ModelHandle* context)
+{
+    if (model == CNTK_INVALID_MODEL_HANDLE)
+        return StatusCode(CNTK_INVALID_MODEL_HANDLE, "Invalid model handle");
+
+    if (!context)
+        return StatusCode(CNTK_ERROR_NULL_POINTER, "'context' parameter is not allowed to be null");
+
+    return ExceptionCatcher::Call([&]() { *context = ((EvaluatorWrapper*)model)->CreateContext().release(); });
+}
+
 void CNTK_ReleaseModel(CNTK_ModelHandle model)
 {
     delete (EvaluatorWrapper*)model;
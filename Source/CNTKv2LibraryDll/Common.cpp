@@ -171,6 +171,38 @@ namespace CNTK
             Microsoft::MSR::CNTK::Globals::SetGradientAccumulationOptimization(/* enable = */ false);
         }
 
+        std::atomic<bool> s_useContiguousParameterStorage(false);
+        void EnableContiguousParameterStorage()
+        {
+            s_useContiguousParameterStorage.store(true);
+        }
+
+        void DisableContiguousParameterStorage()
+        {
+            s_useContiguousParameterStorage.store(false);
+        }
+
+        bool IsContiguousParameterStorageEnabled()
+        {
+            return s_useContiguousParameterStorage.load();
+        }
+
+        std::atomic<bool> s_useInferenceOnlyMemoryMode(false);
+        void EnableInferenceOnlyMemoryMode()
+        {
+            s_useInferenceOnlyMemoryMode.store(true);
+        }
+
+        void DisableInferenceOnlyMemoryMode()
+        {
+            s_useInferenceOnlyMemoryMode.store(false);
+        }
+
+        bool IsInferenceOnlyMemoryModeEnabled()
+        {
+            return s_useInferenceOnlyMemoryMode.load();
+        }
+
         void StartProfiler(const wstring& profilerDir, bool profilerSyncGpu, size_t profilerBufferSize)
         {
 #ifndef CNTK_UWP
@@ -625,6 +657,30 @@ namespace CNTK
             return s_useSparseGradientAggregationInDataParallelSGD;
         }
 
+        std::atomic<size_t> s_gradientAggregationBucketSizeInBytes(0);
+
+        void SetGradientAggregationBucketSizeInBytes(size_t bucketSizeInBytes)
+        {
+            s_gradientAggregationBucketSizeInBytes = bucketSizeInBytes;
+        }
+
+        size_t GetGradientAggregationBucketSizeInBytes()
+        {
+            return s_gradientAggregationBucketSizeInBytes;
+        }
+
+        std::atomic<AllReduceAlgorithm> s_allReduceAlgorithm(AllReduceAlgorithm::MPI);
+
+        void SetAllReduceAlgorithm(AllReduceAlgorithm algorithm)
+        {
+            s_allReduceAlgorithm = algorithm;
+        }
+
+        AllReduceAlgorithm GetAllReduceAlgorithm()
+        {
+            return s_allReduceAlgorithm;
+        }
+
         static std::atomic<bool> s_threadsAreSet(false);
         bool MaxNumCPUThreadsSet()
         {
@@ -1776,6 +1776,9 @@ namespace CNTK
 
             std::tie(m_computationNetwork, m_variableToNodeMap) = CreateComputationNetwork<ElementType>(this->shared_from_this(), device, outputs, m_fullyDefinedArgumentsMap, m_inputsExcludedFromGradientComputation, /*useMangledNamesForComputationNodes =*/ false);
 
+            // A network compiled without backprop roots is purged and recreated once they are specified, so it can drop all backprop state.
+            m_computationNetwork->SetInferenceOnly(m_currentBackpropRoots.empty() && Internal::IsInferenceOnlyMemoryModeEnabled());
+
             // Record the timestamps of Parameters and Constants
             assert(m_lastRecordedTimeStamps.empty());
             auto functionParameters = Parameters();
@@ -1815,6 +1818,12 @@ namespace CNTK
 
             m_computationNetwork->AllocateAllMatrices(forwardRootNodes, forwardOutputNodes, backpropRootNode);
             m_networkMatricesAllocated = allocateNetworkMatrices;
+
+            if (backpropRootNode && Internal::IsContiguousParameterStorageEnabled())
+            {
+                MoveParametersToContiguousStorage<float>();
+                MoveParametersToContiguousStorage<double>();
+            }
         }
         else
         {
@@ -1832,6 +1841,99 @@ namespace CNTK
         return m_computationNetwork;
     }
 
+    template <typename ElementType>
+    void CompositeFunction::MoveParametersToContiguousStorage()
+    {
+        auto deviceId = m_computationNetwork->GetDeviceId();
+
+        std::vector<std::pair<Parameter, ComputationNodeBasePtr>> parametersToMove;
+        std::vector<ComputationNodeBasePtr> gradientNodesToMove;
+        size_t valuesSize = 0;
+        size_t gradientsSize = 0;
+
+        // The distributed learners aggregate the gradients in the order of the Uids of their Parameters (see
+        // DistributedLearnerBase::ConvertToOrdered); the storage has the same order, so that the gradients are coalesced.
+        auto parameters = Parameters();
+        std::sort(parameters.begin(), parameters.end(), [](const Parameter& a, const Parameter& b) { return a.Uid() < b.Uid(); });
+        for (auto& parameter : parameters)
+        {
+            auto iter = m_variableToNodeMap.find(parameter);
+            if ((parameter.GetDataType() != AsDataType<ElementType>()) || parameter.IsSparse() || (parameter.Shape().TotalSize() == 0) || (iter == m_variableToNodeMap.end()))
+                continue;
+
+            // A value that already is a view lives in the contiguous storage of another network.
+            auto& valueMatrix = parameter.Value()->GetWritableTensorView<ElementType>()->GetSOB();
+            if ((valueMatrix.GetMatrixType() == MatrixType::DENSE) && !valueMatrix.IsView() && (valueMatrix.GetDeviceId() == deviceId))
+            {
+                parametersToMove.push_back({ parameter, iter->second });
+                valuesSize += valueMatrix.GetNumElements();
+            }
+
+            // A gradient that is reused by the parent node has to stay in the matrix it shares with the parent.
+            auto node = iter->second->As<ComputationNode<ElementType>>();
+            if (node->NeedsGradient() && node->GradientPtr() && (node->Gradient().GetMatrixType() == MatrixType::DENSE) && !node->ParentGradientReused())
+            {
+                gradientNodesToMove.push_back(iter->second);
+                gradientsSize += node->GetSampleLayout().GetNumElements();
+            }
+        }
+
+        if (parametersToMove.size() > 1)
+        {
+            // The slices share the storage object of the buffer, which keeps it alive.
+            Matrix<ElementType> valuesStorage(1, valuesSize, deviceId);
+            size_t offset = 0;
+            for (auto& parameterAndNode : parametersToMove)
+            {
+                auto& valueMatrix = parameterAndNode.first.Value()->GetWritableTensorView<ElementType>()->GetSOB();
+                auto slice = valuesStorage.ColumnSlice(offset, valueMatrix.GetNumElements());
+                slice.Reshape(valueMatrix.GetNumRows(), valueMatrix.GetNumCols());
+                slice.AssignValuesOf(valueMatrix);
+                offset += valueMatrix.GetNumElements();
+
+                // All views of the Parameter's value share this matrix object.
+                valueMatrix = std::move(slice);
+                RelinkParameterNodeValue<ElementType>(parameterAndNode.first, parameterAndNode.second);
+
+                // Other networks containing the Parameter relink their nodes when they see the new timestamp.
+                parameterAndNode.first.RecordValueUpdate();
+            }
+        }
+
+        if (gradientNodesToMove.size() > 1)
+        {
+            Matrix<ElementType> gradientsStorage(1, gradientsSize, deviceId);
+            gradientsStorage.SetValue(0);
+            size_t offset = 0;
+            size_t index = 0;
+            for (auto& gradientNode : gradientNodesToMove)
+            {
+                // Same dimensions as UpdateDataSize() uses for nodes without MBLayout.
+                const auto& sampleLayout = gradientNode->GetSampleLayout();
+                auto numElements = sampleLayout.GetNumElements();
+                auto numRows = (sampleLayout.GetRank() > 0) ? sampleLayout[0] : 1;
+                auto slice = gradientsStorage.ColumnSlice(offset, numElements);
+                slice.Reshape(numRows, numElements / numRows);
+                auto& gradient = gradientNode->As<ComputationNode<ElementType>>()->GradientPtrRef();
+                gradient = std::make_shared<Matrix<ElementType>>(std::move(slice));
+                offset += numElements;
+
+                // Lets the communicators aggregate consecutive gradients of the storage as one buffer.
+                RegisterContiguousStorageSlice(gradient->Data(), numElements * sizeof(ElementType), gradient, { gradientsStorage.Data(), index++ });
+            }
+        }
+    }
+
+    template <typename ElementType>
+    /*static*/ void CompositeFunction::RelinkParameterNodeValue(const Variable& parameter, const ComputationNodeBasePtr& computationNode)
+    {
+        auto value = Parameter(parameter).Value();
+        auto tensorView = value->GetWritableTensorView<ElementType>();
+        auto& nodeValue = computationNode->As<ComputationNode<ElementType>>()->Value();
+        if (nodeValue.Data() != tensorView->GetSOB().Data() + tensorView->GetShape().GetOffset())
+            nodeValue = value->GetWritableMatrix<ElementType>()->AsReference();
+    }
+
     template <typename ElementType>
     /*static*/ void CompositeFunction::PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, ComputationNodeBasePtr& computationNode, std::unordered_map<MBLayoutPtr, Variable>& layoutsPopulated)
     {
@@ -2208,7 +2310,16 @@ namespace CNTK
             if (newTimeStamp > prevTimeStamp)
             {
                 timeStampRecord.second = newTimeStamp;
-                m_variableToNodeMap.at(variable)->BumpEvalTimeStamp();
+                auto& computationNode = m_variableToNodeMap.at(variable);
+                if (variable.IsParameter())
+                {
+                    if (variable.GetDataType() == DataType::Float)
+                        RelinkParameterNodeValue<float>(variable, computationNode);
+                    else if (variable.GetDataType() == DataType::Double)
+                        RelinkParameterNodeValue<double>(variable, computationNode);
+                }
+
+                computationNode->BumpEvalTimeStamp();
             }
         }
 
@@ -2264,6 +2375,14 @@ namespace CNTK
     /*virtual*/ void CompositeFunction::Backward(const BackPropStatePtr& state,
                                                  const std::unordered_map<Variable, ValuePtr>& rootGradientValues,
                                                  std::unordered_map<Variable, ValuePtr>& backPropagatedGradientValuesForInputs)
+    {
+        Backward(state, rootGradientValues, backPropagatedGradientValuesForInputs, nullptr);
+    }
+
+    void CompositeFunction::Backward(const BackPropStatePtr& state,
+                                     const std::unordered_map<Variable, ValuePtr>& rootGradientValues,
+                                     std::unordered_map<Variable, ValuePtr>& backPropagatedGradientValuesForInputs,
+                                     const std::function<void(const Variable&, const ValuePtr&)>& gradientReady)
     {
         auto backpropState = dynamic_cast<const CNTKBackPropState*>(state.get());
         if (backpropState == nullptr)
@@ -2296,7 +2415,31 @@ namespace CNTK
         ScopedNetworkOperationMode modeGuard(m_computationNetwork, NetworkOperationMode::training);
 
         auto rootComputationNodePtr = m_variableToNodeMap.at(rootGradientValues.begin()->first);
-        m_computationNetwork->GetNestedNetwork(rootComputationNodePtr)->Backprop(FrameRange(nullptr), true, true);
+        if (!gradientReady)
+            m_computationNetwork->GetNestedNetwork(rootComputationNodePtr)->Backprop(FrameRange(nullptr), true, true);
+        else
+        {
+            // Gradients of inputs with caller provided storage are only copied out after backpropagation is done
+            std::unordered_map<ComputationNodeBasePtr, Variable> nodeToInput;
+            for (const auto& gradientVarValuePair : backPropagatedGradientValuesForInputs)
+            {
+                auto nodeIter = m_variableToNodeMap.find(gradientVarValuePair.first);
+                if ((gradientVarValuePair.second == nullptr) && (nodeIter != m_variableToNodeMap.end()))
+                    nodeToInput[nodeIter->second] = gradientVarValuePair.first;
+            }
+
+            m_computationNetwork->BackpropNestedNetwork(rootComputationNodePtr, [&nodeToInput, &gradientReady](const ComputationNodeBasePtr& node)
+            {
+                auto inputIter = nodeToInput.find(node);
+                if (inputIter == nodeToInput.end())
+                    return;
+
+                ValuePtr gradient;
+                ComputationNodeBasePtr computationNode = node;
+                GetNodeOutputOrGradient(inputIter->second, gradient, computationNode, /*getGradient =*/ true);
+                gradientReady(inputIter->second, gradient);
+            });
+        }
 
         GetNetworkGradients(backPropagatedGradientValuesForInputs);
 
@@ -2356,4 +2499,19 @@ namespace CNTK
             node->SetEvalTimeStampOutdatedWrtAll();
         }
     }
+
+    namespace Internal
+    {
+        size_t GetActivationMemoryInBytes(const FunctionPtr& function)
+        {
+            CompositeFunction* compositeFunction = dynamic_cast<CompositeFunction*>(function.get());
+            if (compositeFunction == nullptr)
+                InvalidArgument("GetActivationMemoryInBytes: Primitive (i.e. non-composite) Function '%S' is never compiled into a network.", function->AsString().c_str());
+
+            if (compositeFunction->m_computationNetwork == nullptr)
+                return 0;
+
+            return compositeFunction->m_computationNetwork->GetActivationMemoryInBytes();
+        }
+    }
 }
@@ -52,6 +52,7 @@ namespace CNTK
         friend inline std::shared_ptr<T> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
 
         friend void Internal::SaveAsLegacyModel(const FunctionPtr& rootFunction, const std::wstring& modelFile);
+        friend size_t Internal::GetActivationMemoryInBytes(const FunctionPtr& function);
 
         friend void ComputeInputPerDimMeansAndInvStdDevs(const MinibatchSourcePtr& minibatchSource,
                                                          std::unordered_map<StreamInformation, std::pair<NDArrayViewPtr, NDArrayViewPtr>>& computedMeanAndInvStdDevs,
@@ -108,6 +109,14 @@ namespace CNTK
                               const std::unordered_map<Variable, ValuePtr>& rootGradientValues,
                               std::unordered_map<Variable, ValuePtr>& backPropagatedGradientValuesForInputs) override;
 
+        // Same as above, but additionally calls 'gradientReady' for each of the requested inputs without caller provided storage
+        // as soon as backpropagation has finished computing its gradient, i.e. in the reverse topological order of the inputs,
+        // while the rest of the graph is still being backpropagated.
+        void Backward(const BackPropStatePtr& state,
+                      const std::unordered_map<Variable, ValuePtr>& rootGradientValues,
+                      std::unordered_map<Variable, ValuePtr>& backPropagatedGradientValuesForInputs,
+                      const std::function<void(const Variable&, const ValuePtr&)>& gradientReady);
+
         Dictionary SerializeBlockComposite() const;
 
         virtual Dictionary Serialize() const override;
@@ -292,6 +301,14 @@ namespace CNTK
                                                                           const std::unordered_set<Variable>& inputsToExcludeGradientsFor,
                                                                           bool allocateNetworkMatrices);
 
+        // Moves the values and, separately, the gradients of the dense Parameters of the given type into one contiguous buffer each.
+        template <typename ElementType>
+        void MoveParametersToContiguousStorage();
+
+        // Links the value of a Parameter's node to the storage of the Parameter again, if it has been moved by another network.
+        template <typename ElementType>
+        static void RelinkParameterNodeValue(const Variable& parameter, const Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode);
+
         template <typename ElementType>
         static Microsoft::MSR::CNTK::ComputationNodeBasePtr CreateComputationNode(const Variable& variable,
                                                                                   Function* function,
@@ -4,10 +4,12 @@
 //
 
 #include "stdafx.h"
+#include <chrono>
 #include "DataParallelDistributedLearner.h"
 #include "DistributedCommunicator.h"
 #include "Learner.h"
 #include "PerformanceProfiler.h"
+#include "Matrix.h"
 
 #ifdef CNTK_PARALLEL_TRAINING_SUPPORT
 #include "QuantizedDistributedCommunicator.h"
@@ -115,10 +117,114 @@ namespace CNTK
     }
 
     DataParallelDistributedLearner::DataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate)
-        : DistributedLearnerBase(communicator, learner, distributedAfterSamples, !Internal::ShouldUseSparseGradientAggregationInDataParallelSGD())
+        : DistributedLearnerBase(communicator, learner, distributedAfterSamples, !Internal::ShouldUseSparseGradientAggregationInDataParallelSGD()),
+          m_bucketSizeInBytes(Internal::GetGradientAggregationBucketSizeInBytes()),
+          m_recordedBucketSizeInBytes(0),
+          m_recordingLayout(false),
+          m_bucketsEnabled(false),
+          m_overlapping(false),
+          m_nextBucket(0),
+          m_bucketAggregationTime(0),
+          m_lastOverlapEfficiency(0)
     {
         if (useAsyncBufferedParameterUpdate)
             LogicError("Asynchronous parameter update is not yet supported for the DataParallelDistributedLearner.");
+
+        const auto& parameters = m_learner->Parameters();
+        m_ownParameters.insert(parameters.begin(), parameters.end());
+    }
+
+    DataParallelDistributedLearner::~DataParallelDistributedLearner()
+    {
+        // The communication thread refers to the learner, it has to finish first.
+        if (m_pendingAggregation.valid())
+            m_pendingAggregation.wait();
+    }
+
+    bool DataParallelDistributedLearner::BeginBackprop()
+    {
+        if (m_pendingAggregation.valid())
+            LogicError("DataParallelDistributedLearner: Gradient aggregation of the previous minibatch has not finished.");
+
+        m_readyGradients.clear();
+        m_nextBucket = 0;
+        m_bucketAggregationTime = 0;
+        m_recordingLayout = false;
+        m_overlapping = false;
+
+        if (m_bucketSizeInBytes == 0 || m_communicator->Workers().size() == 1)
+            return false;
+
+        m_recordingLayout = m_bucketLayout.empty();
+        m_overlapping = m_bucketsEnabled && IsAggregating();
+        return m_recordingLayout || m_overlapping;
+    }
+
+    void DataParallelDistributedLearner::OnGradientReady(const Parameter& parameter, const NDArrayViewPtr& gradient)
+    {
+        if (m_ownParameters.find(parameter) == m_ownParameters.end() || gradient->GetStorageFormat() != StorageFormat::Dense)
+            return;
+
+        if (m_recordingLayout)
+        {
+            if (m_bucketLayout.empty() || m_recordedBucketSizeInBytes >= m_bucketSizeInBytes)
+            {
+                m_bucketLayout.push_back({});
+                m_recordedBucketSizeInBytes = 0;
+            }
+
+            m_bucketLayout.back().push_back(parameter);
+            m_recordedBucketSizeInBytes += gradient->Shape().TotalSize() * DataTypeSize(gradient->GetDataType());
+        }
+
+        if (!m_overlapping)
+            return;
+
+        m_readyGradients[parameter] = gradient;
+        while (m_nextBucket < m_bucketLayout.size())
+        {
+            const auto& bucket = m_bucketLayout[m_nextBucket];
+            bool ready = std::all_of(bucket.begin(), bucket.end(), [this](const Parameter& p) { return m_readyGradients.find(p) != m_readyGradients.end(); });
+            if (!ready)
+                break;
+
+            AggregateNextBucket(m_readyGradients);
+        }
+    }
+
+    void DataParallelDistributedLearner::AggregateNextBucket(const std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues)
+    {
+        std::vector<NDArrayViewPtr> values;
+        for (const auto& parameter : m_bucketLayout[m_nextBucket++])
+            values.push_back(gradientValues.at(parameter));
+
+        // Aggregations are serialized on the communication threads, each bucket waits for the previous one.
+        auto previous = std::make_shared<std::future<void>>(std::move(m_pendingAggregation));
+        m_pendingAggregation = std::async(std::launch::async, [this, values, previous]
+        {
+            if (previous->valid())
+                previous->get();
+
+            // We are starting on a new thread. Make sure the new thread is
+            // setup to use the right device
+            auto device = values.front()->Device();
+            if (device.Type() == DeviceKind::GPU)
+                Microsoft::MSR::CNTK::Matrix<float>::SetDevice(device.Id());
+
+            auto start = std::chrono::steady_clock::now();
+            m_communicator->AggregateInPlace(values, m_communicator->Workers());
+            m_bucketAggregationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+
+    double DataParallelDistributedLearner::WaitForBuckets()
+    {
+        if (!m_pendingAggregation.valid())
+            return 0;
+
+        auto start = std::chrono::steady_clock::now();
+        m_pendingAggregation.get();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
 
     bool DataParallelDistributedLearner::Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info)
@@ -126,7 +232,7 @@ namespace CNTK
         // sparse gradient may be converted to dense for aggregation
         std::unordered_map<Parameter, NDArrayViewPtr> convertedGradientValues = gradientValues;
 
-        if (m_sampleCount >= m_distributeAfterSamples && m_communicator->Workers().size() > 1)
+        if (IsAggregating())
         {
 #ifndef  CNTK_UWP
             auto profGradientAgg = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainGradient);
@@ -135,6 +241,30 @@ namespace CNTK
             if (info.IsEmpty())
                 PrepaireZeroGradients(gradientValues);
 
+            // Workers without data did not backpropagate, they aggregate the buckets of zero gradients here,
+            // the same happens to buckets whose gradients were not reported during backpropagation.
+            std::unordered_set<Parameter> aggregatedParameters;
+            if (m_bucketsEnabled)
+            {
+                if (!m_overlapping)
+                {
+                    m_nextBucket = 0;
+                    m_bucketAggregationTime = 0;
+                }
+
+                while (m_nextBucket < m_bucketLayout.size())
+                    AggregateNextBucket(gradientValues);
+
+                auto exposedTime = WaitForBuckets();
+                m_lastOverlapEfficiency = (m_overlapping && m_bucketAggregationTime > 0) ? std::max(0.0, 1 - exposedTime / m_bucketAggregationTime) : 0;
+                if (m_overlapping && GetTraceLevel() >= TraceLevel::Info)
+                    fprintf(stderr, "DataParallelDistributedLearner: %d gradient buckets aggregated in %.2fms, %.2fms not overlapped with backpropagation, overlap efficiency %.1f%%.\n",
+                            (int)m_bucketLayout.size(), m_bucketAggregationTime * 1000, exposedTime * 1000, m_lastOverlapEfficiency * 100);
+
+                for (const auto& bucket : m_bucketLayout)
+                    aggregatedParameters.insert(bucket.begin(), bucket.end());
+            }
+
             // sorts gradient buffers according to parameter uid, and perform sparse to dense conversion
             // if !UseSparseGradientAggregationInDataParallelSGD()
             ConvertToOrdered(gradientValues, m_gradientBuffer, &convertedGradientValues);
@@ -143,6 +273,9 @@ namespace CNTK
             std::vector<NDArrayViewPtr> sparseValuesToAggregate;
             for (const auto& i : m_gradientBuffer)
             {
+                if (aggregatedParameters.find(i.first) != aggregatedParameters.end())
+                    continue;
+
                 auto storageFormat = i.second->GetStorageFormat();
                 if (storageFormat == StorageFormat::Dense)
                 {
@@ -164,12 +297,24 @@ namespace CNTK
             valuesToAggregate.push_back(info.evalCriterionValue);
             valuesToAggregate.push_back(info.trainingLossValue);
 
+            // Until buckets are used, each worker also reports whether it has recorded the bucket layout,
+            // buckets are enabled when all of them have.
+            NDArrayViewPtr layoutRecorded;
+            if (m_bucketSizeInBytes > 0 && !m_bucketsEnabled)
+            {
+                layoutRecorded = MakeSharedObject<NDArrayView>(m_bucketLayout.empty() ? 0.0 : 1.0, NDShape{}, DeviceDescriptor::CPUDevice());
+                valuesToAggregate.push_back(layoutRecorded);
+            }
+
             auto value = MakeSharedObject<NDArrayView>(static_cast<double>(info.numberOfSamples), NDShape{}, DeviceDescriptor::CPUDevice());
             valuesToAggregate.push_back(value);
 
             m_communicator->AggregateInPlace(valuesToAggregate, m_communicator->Workers());
             info.numberOfSamples = static_cast<size_t>(*valuesToAggregate.back()->WritableDataBuffer<double>());
 
+            if (layoutRecorded)
+                m_bucketsEnabled = static_cast<size_t>(*layoutRecorded->WritableDataBuffer<double>()) == m_communicator->Workers().size();
+
             if (!sparseValuesToAggregate.empty())
             {
                 m_communicator->AllReduceSparseBlockColumn(sparseValuesToAggregate);
@@ -182,6 +327,8 @@ namespace CNTK
 
         m_sampleCount += info.numberOfSamples;
         m_gradientBuffer.clear();
+        m_readyGradients.clear();
+        m_overlapping = false;
 
         if (info.IsEmpty())
             return false;
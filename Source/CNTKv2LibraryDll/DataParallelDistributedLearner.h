@@ -5,6 +5,7 @@
 
 #pragma  once
 
+#include <future>
 #include "CNTKLibrary.h"
 #include "DistributedLearnerBase.h"
 
@@ -18,7 +19,56 @@ namespace CNTK
     public:
         DataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate);
 
+        ~DataParallelDistributedLearner();
+
         // Optional override that gets called per minibatch after finishing gradient computation but before updating model parameters
         bool Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& trainingSampleCount) override;
+
+        //
+        // Overlapping of the gradient aggregation with backpropagation, enabled by Internal::SetGradientAggregationBucketSizeInBytes.
+        // Dense gradients are grouped into buckets of the configured size in the order in which they become ready, and each
+        // full bucket is aggregated on a communication thread while backpropagation continues. Update waits for the
+        // outstanding buckets and aggregates the rest as usual.
+        //
+        bool BeginBackprop() override;
+
+        void OnGradientReady(const Parameter& parameter, const NDArrayViewPtr& gradient) override;
+
+        double LastOverlapEfficiency() const override
+        {
+            return m_lastOverlapEfficiency;
+        }
+
+    private:
+        bool IsAggregating() const
+        {
+            return m_sampleCount >= m_distributeAfterSamples && m_communicator->Workers().size() > 1;
+        }
+
+        // Starts the aggregation of the next bucket of the layout after all previously started ones.
+        void AggregateNextBucket(const std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues);
+
+        // Waits till all started buckets are aggregated, returns the time spent waiting in seconds.
+        double WaitForBuckets();
+
+        size_t m_bucketSizeInBytes;
+        std::unordered_set<Parameter> m_ownParameters;
+
+        // Parameters of each bucket, in the order in which their gradients become ready. The layout is recorded during
+        // the first backpropagation and is the same on all workers, so that all of them issue the same sequence of aggregations,
+        // including the workers that got an empty minibatch. Buckets are only used after all workers have recorded the layout.
+        std::vector<std::vector<Parameter>> m_bucketLayout;
+        size_t m_recordedBucketSizeInBytes;
+        bool m_recordingLayout;
+        bool m_bucketsEnabled;
+
+        // State of the current minibatch.
+        bool m_overlapping;
+        size_t m_nextBucket;
+        std::unordered_map<Parameter, NDArrayViewPtr> m_readyGradients;
+        std::future<void> m_pendingAggregation;
+        double m_bucketAggregationTime;
+
+        double m_lastOverlapEfficiency;
     };
-}
\ No newline at end of file
+}
@@ -12,6 +12,7 @@
 #include "CUDAPageLockedMemAllocator.h"
 #include "MatrixQuantizerImpl.h"
 #include "GPUDataTransferer.h"
+#include <algorithm>
 #include <numeric>
 #include "Utils.h"
 
@@ -90,15 +91,23 @@ namespace CNTK
         }
         m_packThresholdSizeInBytes = packThresholdSizeInBytes;
         m_useFP16AllReduce = useFP16AllReduce;
+        m_allReduce.reset(new MPIAllReduce(m_mpi));
     }
 
     void MPICommunicatorImpl::Initialize(const std::vector<NDArrayViewPtr>& values)
     {
         assert(CPUDEVICE < 0); // just in case somebody decides to change CPUDEVICE macro.
         DeviceDescriptor lastGpuDevice = DeviceDescriptor::CPUDevice();
-        m_gpuDataTransferers.resize(values.size());
-        m_intermediateCPUBuffers.resize(values.size());
-        if (m_useFP16AllReduce)
+
+        // The transferers and buffers are kept across calls and only grow, so that the aggregations of the buckets
+        // of a minibatch (see Internal::SetGradientAggregationBucketSizeInBytes) reuse the ones of the first call.
+        if (m_gpuDataTransferers.size() < values.size())
+        {
+            m_gpuDataTransferers.resize(values.size());
+            m_intermediateCPUBuffers.resize(values.size());
+        }
+
+        if (m_useFP16AllReduce && m_intermediateGPUBuffers.size() < values.size())
             m_intermediateGPUBuffers.resize(values.size());
 
         for (auto i = 0; i < values.size(); ++i)
@@ -113,8 +122,7 @@ namespace CNTK
             // TODO: device.Type should be called Kind.
             if (device.Type() == DeviceKind::CPU)
             {
-                m_intermediateCPUBuffers[i] = Buffer();
-                m_gpuDataTransferers[i] = nullptr;
+                // Values in CPU memory are aggregated in place.
             }
             else if (device.Type() == DeviceKind::GPU)
             {
@@ -124,7 +132,9 @@ namespace CNTK
                     LogicError("MPICommunicator: Not all values are on the same GPU device id");
 
                 auto requiredSize = GetBufferSize(view);
-                m_gpuDataTransferers[i] = std::make_shared<GPUDataTransferer>(device.Id(), true);
+                if (m_gpuDataTransferers[i] == nullptr)
+                    m_gpuDataTransferers[i] = std::make_shared<GPUDataTransferer>(device.Id(), true);
+
                 if (m_intermediateCPUBuffers[i].totalSize < requiredSize)
                     m_intermediateCPUBuffers[i] = AllocateIntermediateBuffer(device.Id(), requiredSize);
 
@@ -305,7 +315,59 @@ namespace CNTK
         const std::vector<NDArrayViewPtr>& values,
         const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
     {
-        AggregateImpl(values, values, sendToWorkers);
+        // Gradients in a contiguous parameter storage are aggregated as one value, without being packed.
+        auto coalescedValues = Internal::CoalesceContiguousValues(values);
+        AggregateImpl(coalescedValues, coalescedValues, sendToWorkers);
+    }
+
+    std::vector<NDArrayViewPtr> Internal::CoalesceContiguousValues(const std::vector<NDArrayViewPtr>& values)
+    {
+        if (!Internal::IsContiguousParameterStorageEnabled() || (values.size() < 2))
+            return values;
+
+        // All workers have to issue the same aggregations in the same order. The values therefore keep the order of the
+        // caller, and only consecutive values that are consecutive slices of one storage are grouped; the layout of
+        // a storage only depends on the shapes and the order of the parameters of the network.
+        std::vector<bool> inStorage(values.size(), false);
+        std::vector<ContiguousStorageSlice> slices(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const auto& value = values[i];
+            if (!value->IsSparse() && !value->IsReadOnly() && ((value->GetDataType() == DataType::Float) || (value->GetDataType() == DataType::Double)))
+                inStorage[i] = FindContiguousStorageSlice(GetDataBuffer(value), GetBufferSize(value), slices[i]);
+        }
+
+        std::vector<NDArrayViewPtr> coalescedValues;
+        size_t end;
+        for (size_t begin = 0; begin < values.size(); begin = end)
+        {
+            for (end = begin + 1; end < values.size(); ++end)
+            {
+                if (!inStorage[begin] || !inStorage[end] || (slices[end].storage != slices[begin].storage) || (slices[end].index != slices[end - 1].index + 1))
+                    break;
+            }
+
+            const auto& first = values[begin];
+            if (end - begin == 1)
+            {
+                coalescedValues.push_back(first);
+                continue;
+            }
+
+            auto firstData = static_cast<char*>(GetDataBuffer(first));
+            size_t numBytes = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (GetDataBuffer(values[i]) != firstData + numBytes)
+                    LogicError("CoalesceContiguousValues: Slices of a contiguous parameter storage are not adjacent in memory.");
+
+                numBytes += GetBufferSize(values[i]);
+            }
+
+            coalescedValues.push_back(MakeSharedObject<NDArrayView>(first->GetDataType(), NDShape{ numBytes / DataTypeSize(first->GetDataType()) }, firstData, numBytes, first->Device()));
+        }
+
+        return coalescedValues;
     }
 
     void MPICommunicatorImpl::AggregateImpl(
@@ -351,10 +413,10 @@ namespace CNTK
         }
 
         // Do the packing to reduce the number of MPI requests.
-        // Do not re-allocating the continous buffer if existing buffer size equals to required one.
-        m_aggregationBufferFloat = SetContinuousBuffer<float>(packedFloatGradientsIndex, packedFloatGradientsSizeInBytes, inputValues, outputValues,
+        // The continuous buffers are only re-allocated when they have to grow.
+        SetContinuousBuffer<float>(m_aggregationBufferFloat, packedFloatGradientsIndex, packedFloatGradientsSizeInBytes, inputValues, outputValues,
             valuesToAggregate, valuesAfterAggregate);
-        m_aggregationBufferDouble = SetContinuousBuffer<double>(packedDoubleGradientsIndex, packedDoubleGradientsSizeInBytes, inputValues, outputValues,
+        SetContinuousBuffer<double>(m_aggregationBufferDouble, packedDoubleGradientsIndex, packedDoubleGradientsSizeInBytes, inputValues, outputValues,
             valuesToAggregate, valuesAfterAggregate);
 
         PackToContinuousBuffer(m_aggregationBufferFloat.get(), packedFloatGradientsIndex, inputValues, outputValues, valuesToAggregate, valuesAfterAggregate);
@@ -385,7 +447,22 @@ namespace CNTK
         // For all values residing on GPU initiate async transfer to CPU buffers if needed
         CopyDataFromGPUToCPU(valuesToAggregate);
 
+        // Copies an aggregated value back to the GPU if it has been aggregated in a CPU buffer.
+        auto copyAggregatedValueToGPU = [&](size_t idx)
+        {
+            if (ShouldCopyDataToCPU(valuesToAggregate[idx]))
+            {
+                auto view = valuesAfterAggregate[idx];
+                auto size = GetBufferSize(view);
+                auto& transferer = m_gpuDataTransferers[idx];
+                auto& buffer = m_intermediateCPUBuffers[idx];
+                transferer->CopyCPUToGPUAsync(buffer.data.get(), size, GetDataBuffer(view));
+            }
+        };
+
+        // Values aggregated synchronously (NCCL, CNTK's own allreduce algorithms) do not have a request.
         std::vector<MPI_Request> allReduceRequests;
+        std::vector<size_t> allReduceRequestValues;
         for (auto i = 0; i < numValues; ++i)
         {
             auto inputValue = valuesToAggregate[i];
@@ -445,6 +522,11 @@ namespace CNTK
             }
             else
                 LogicError("MPICommunicator: Unknown DataType.");
+
+            if (allReduceRequests.size() > allReduceRequestValues.size())
+                allReduceRequestValues.push_back(i);
+            else
+                copyAggregatedValueToGPU(i);
         }
 
         if (m_nccl->IsSupported())
@@ -466,17 +548,8 @@ namespace CNTK
 
             numAllReduceRequestsCompleted++;
 
-            assert(idx < valuesToAggregate.size());
-            auto value = valuesToAggregate[idx];
-
-            if (ShouldCopyDataToCPU(value))
-            {
-                auto view = valuesAfterAggregate[idx];
-                auto size = GetBufferSize(view);
-                auto& transferer = m_gpuDataTransferers[idx];
-                auto& buffer = m_intermediateCPUBuffers[idx];
-                transferer->CopyCPUToGPUAsync(buffer.data.get(), size, GetDataBuffer(view));
-            }
+            assert(idx < allReduceRequestValues.size());
+            copyAggregatedValueToGPU(allReduceRequestValues[idx]);
         }
 
         // TODO: Should not wait, simply publishing event on the compute stream should be sufficient
@@ -681,14 +754,18 @@ namespace CNTK
     }
 
     template <typename ElemType>
-    std::unique_ptr<Matrix<ElemType>> MPICommunicatorImpl::SetContinuousBuffer(std::vector<size_t>& packedGradientsIndex, size_t packedGradientsSizeInBytes,
+    void MPICommunicatorImpl::SetContinuousBuffer(std::unique_ptr<Matrix<ElemType>>& aggregationBuffer, std::vector<size_t>& packedGradientsIndex, size_t packedGradientsSizeInBytes,
         const std::vector<NDArrayViewPtr>& inputValues, const std::vector<NDArrayViewPtr>& outputValues,
         std::vector<NDArrayViewPtr>& valuesToAggregate, std::vector<NDArrayViewPtr>& valuesAfterAggregate)
     {
         if (packedGradientsIndex.size() > 1)
         {
-            return std::unique_ptr<Matrix<ElemType>>{new (std::nothrow) Matrix<ElemType>(1, packedGradientsSizeInBytes / sizeof(ElemType),
-                AsCNTKImplDeviceId(inputValues[packedGradientsIndex[0]]->Device()))};
+            auto numElements = packedGradientsSizeInBytes / sizeof(ElemType);
+            auto deviceId = AsCNTKImplDeviceId(inputValues[packedGradientsIndex[0]]->Device());
+            if (aggregationBuffer && aggregationBuffer->GetDeviceId() == deviceId)
+                aggregationBuffer->Resize(1, numElements);
+            else
+                aggregationBuffer.reset(new (std::nothrow) Matrix<ElemType>(1, numElements, deviceId));
         }
         else if (packedGradientsIndex.size() == 1)
         {
@@ -696,7 +773,6 @@ namespace CNTK
             valuesAfterAggregate.push_back(outputValues[packedGradientsIndex.front()]);
             packedGradientsIndex.clear();
         }
-        return std::unique_ptr<Matrix<ElemType>>{ nullptr };
     }
 
     template <typename ElemType>
@@ -759,6 +835,17 @@ namespace CNTK
             return;
         }
 
+        // With GPUDirect RDMA the data may reside in GPU memory, it is left to MPI as well as other operations than the sum.
+        if (!m_mpi->UseGpuGdr() && op == MPI_SUM)
+        {
+            auto algorithm = m_allReduce->Select(numElements * sizeof(ElemType));
+            if (algorithm != Internal::AllReduceAlgorithm::MPI)
+            {
+                m_allReduce->AllReduce(inputData, outputData, numElements, algorithm);
+                return;
+            }
+        }
+
         if (m_mpi->UseGpuGdr() || forceSync)
         {
             if (inputData == outputData)
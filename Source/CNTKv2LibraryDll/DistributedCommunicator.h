@@ -9,6 +9,7 @@
 #include "Constants.h"
 #include "NcclComm.h"
 #include "MPIWrapper.h"
+#include "MPIAllReduce.h"
 #include <MatrixQuantizerImpl.h>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
@@ -98,6 +99,9 @@ namespace CNTK
         // NcclComm
         std::unique_ptr<Microsoft::MSR::CNTK::NcclComm> m_nccl;
 
+        // CNTK's own allreduce algorithms for values in CPU memory, see Internal::SetAllReduceAlgorithm.
+        std::unique_ptr<MPIAllReduce> m_allReduce;
+
         std::vector<Buffer> m_intermediateSBCIndexCPUBuffers;
         std::vector<Buffer> m_intermediateSBCValueCPUBuffers;
     protected:
@@ -134,7 +138,7 @@ namespace CNTK
         void CopyDataFromGPUToCPU(std::vector<NDArrayViewPtr>& inputValues);
 
         template <typename ElemType>
-        std::unique_ptr<Microsoft::MSR::CNTK::Matrix<ElemType>> SetContinuousBuffer(std::vector<size_t>& packedGradientsIndex, size_t packedGradientsSizeInBytes,
+        void SetContinuousBuffer(std::unique_ptr<Microsoft::MSR::CNTK::Matrix<ElemType>>& aggregationBuffer, std::vector<size_t>& packedGradientsIndex, size_t packedGradientsSizeInBytes,
             const std::vector<NDArrayViewPtr>& inputValues, const std::vector<NDArrayViewPtr>& outputValues,
             std::vector<NDArrayViewPtr>& valuesToAggregate, std::vector<NDArrayViewPtr>& valuesAfterAggregate);
 
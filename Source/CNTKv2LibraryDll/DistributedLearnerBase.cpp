@@ -71,6 +71,7 @@ namespace CNTK
                 convertedGradientValues->insert(pair);
         }
 
+        // The contiguous parameter storage lays the gradients out in the same order.
         std::sort(result.begin(), result.end(),
             [](const std::pair<Parameter, NDArrayViewPtr>& a, const std::pair<Parameter, NDArrayViewPtr>& b) { return a.first.Uid() < b.first.Uid(); });
     }
@@ -0,0 +1,134 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Utils.h"
+#include <mutex>
+
+namespace CNTK
+{
+    namespace
+    {
+        // Replacing the arguments by themselves makes a clone use the Variables of the clonee as its arguments.
+        std::unordered_map<Variable, Variable> KeepArguments(const FunctionPtr& function)
+        {
+            std::unordered_map<Variable, Variable> replacements;
+            for (const auto& argument : function->Arguments())
+                replacements.insert({ argument, argument });
+            return replacements;
+        }
+    }
+
+    class EvaluationContextImpl final : public EvaluationContext
+    {
+    public:
+        EvaluationContextImpl(const EvaluationSessionPtr& session, const FunctionPtr& model)
+            : m_session(session),
+              m_model(model)
+        {
+            auto sessionOutputs = session->Model()->Outputs();
+            auto contextOutputs = m_model->Outputs();
+            for (size_t i = 0; i < sessionOutputs.size(); ++i)
+                m_outputs.insert({ sessionOutputs[i], contextOutputs[i] });
+        }
+
+        void Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputs) override
+        {
+            // The arguments of the model of the context are those of the session, only the outputs need to be mapped.
+            std::unordered_map<Variable, ValuePtr> contextOutputs;
+            for (const auto& output : outputs)
+            {
+                auto contextOutput = m_outputs.find(output.first);
+                if (contextOutput == m_outputs.end())
+                    InvalidArgument("EvaluationContext: '%S' is not an output of the model '%S' of the session.",
+                                    output.first.AsString().c_str(), m_session->Model()->AsString().c_str());
+
+                contextOutputs.insert({ contextOutput->second, output.second });
+            }
+
+            m_model->Evaluate(arguments, contextOutputs, m_session->Device());
+
+            for (auto& output : outputs)
+                output.second = contextOutputs.at(m_outputs.at(output.first));
+        }
+
+        EvaluationSessionPtr Session() const override
+        {
+            return m_session;
+        }
+
+    private:
+        EvaluationSessionPtr m_session;
+
+        // Clone of the model of the session, compiled into the network that holds the activations of this context.
+        FunctionPtr m_model;
+        std::unordered_map<Variable, Variable> m_outputs;
+    };
+
+    class EvaluationSessionImpl final : public EvaluationSession
+    {
+    public:
+        EvaluationSessionImpl(const FunctionPtr& model, const DeviceDescriptor& device)
+            : m_device(device)
+        {
+            if (!model)
+                InvalidArgument("EvaluationSession: the model is not allowed to be null.");
+
+            // The weights are placed on the device once, as read-only Constants; the networks of the contexts refer to
+            // Constants on their device instead of copying them.
+            auto replacements = KeepArguments(model);
+            for (const auto& parameter : model->Parameters())
+            {
+                auto value = parameter.Value();
+                auto sessionValue = (value->Device() == m_device) ? value->Alias(/*readOnly =*/ true) : value->DeepClone(m_device, /*readOnly =*/ true);
+                replacements.insert({ parameter, Constant(sessionValue, parameter.Name()) });
+            }
+
+            for (const auto& constant : model->Constants())
+            {
+                auto value = constant.Value();
+                if (value->Device() != m_device)
+                    replacements.insert({ constant, Constant(value->DeepClone(m_device, /*readOnly =*/ true), constant.Name()) });
+            }
+
+            m_model = model->Clone(ParameterCloningMethod::Share, replacements);
+        }
+
+        EvaluationContextPtr CreateContext() override
+        {
+            // Sharing the Constants, the clone only creates the Functions of the graph.
+            FunctionPtr contextModel;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                contextModel = m_model->Clone(ParameterCloningMethod::Share, KeepArguments(m_model));
+            }
+
+            return MakeSharedObject<EvaluationContextImpl>(shared_from_this(), contextModel);
+        }
+
+        FunctionPtr Model() const override
+        {
+            return m_model;
+        }
+
+        DeviceDescriptor Device() const override
+        {
+            return m_device;
+        }
+
+    private:
+        const DeviceDescriptor m_device;
+
+        // The model with the weights of the session. It is only cloned, never evaluated.
+        FunctionPtr m_model;
+        std::mutex m_mutex;
+    };
+
+    EvaluationSessionPtr CreateEvaluationSession(const FunctionPtr& model, const DeviceDescriptor& device)
+    {
+        return MakeSharedObject<EvaluationSessionImpl>(model, device);
+    }
+}
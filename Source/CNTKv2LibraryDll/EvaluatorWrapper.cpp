@@ -13,6 +13,24 @@ namespace CNTK
     using namespace std;
     using namespace std::placeholders;
 
+    // The buffers of the caller are only borrowed for the duration of a call, no Value or NDArrayView may refer to them afterwards.
+    static void VerifyBorrowedBuffersReleased(const weak_ptr<bool>& inputBuffers, const vector<weak_ptr<Value>>& outputBuffers)
+    {
+#ifdef _DEBUG
+        if (!inputBuffers.expired())
+            LogicError("EvaluateSequence: the data of an input is still referenced after the call.");
+
+        for (const auto& outputBuffer : outputBuffers)
+        {
+            if (!outputBuffer.expired())
+                LogicError("EvaluateSequence: a preallocated output is still referenced after the call.");
+        }
+#else
+        UNUSED(inputBuffers);
+        UNUSED(outputBuffers);
+#endif
+    }
+
     // Main interface
     CNTKEvaluatorWrapper::CNTKEvaluatorWrapper(FunctionPtr model, DeviceDescriptor device)
         : m_func(model), m_device(device)
@@ -55,6 +73,11 @@ namespace CNTK
         uint32_t numOutputs,
         CNTK_Value** outputValues)
     {
+        // The inputs are evaluated in place, the views of their buffers keep 'inputBuffers' alive.
+        auto inputBuffers = make_shared<bool>(true);
+        weak_ptr<bool> borrowedInputBuffers = inputBuffers;
+        vector<weak_ptr<Value>> borrowedOutputBuffers;
+
         // Prepare inputs.
         unordered_map<Variable, ValuePtr> preparedInputs;
         for (uint32_t i = 0; i < numInputs; ++i)
@@ -65,11 +88,10 @@ namespace CNTK
 
             auto inputValue = inputValues[i];
             auto inputShape = ToNDShape(inputValue.shape);
-
-            // TODO: Avoid copying.
             preparedInputs[var->second] =
-                Value::CreateSequence(inputShape.SubShape(0, var->second.Shape().Rank()), std::vector<float>(inputValue.data, inputValue.data + inputShape.TotalSize()), inputResetFlags[i], m_device);
+                Value::CreateSequenceView(inputShape.SubShape(0, var->second.Shape().Rank()), inputValue.data, inputShape.TotalSize(), inputResetFlags[i], InputDevice(), inputBuffers);
         }
+        inputBuffers.reset();
 
         // Prepare outputs.
         unordered_map<Variable, ValuePtr> preparedOutputs;
@@ -82,23 +104,29 @@ namespace CNTK
             ValuePtr value = nullptr;
             if (*outputValues != nullptr) // Buffer has been preallocated.
             {
-                auto buffer = *outputValues[i];
+                auto buffer = (*outputValues)[i];
                 auto shape = ToNDShape(buffer.shape);
                 NDShape maskShape = shape.SubShape(var->second.Shape().Rank(), shape.Rank());
                 auto data = make_shared<NDArrayView>(DataType::Float, shape, buffer.data, shape.TotalSize() * sizeof(float), DeviceDescriptor::CPUDevice());
                 value = make_shared<Value>(data, make_shared<NDMask>(maskShape));
+                borrowedOutputBuffers.push_back(value);
             }
             preparedOutputs[var->second] = value;
         }
 
-        m_func->Evaluate(preparedInputs, preparedOutputs, m_device);
+        Evaluate(preparedInputs, preparedOutputs);
+        preparedInputs.clear();
 
         if (preparedOutputs.size() != numOutputs)
             RuntimeError("Number of evaluated outputs '%d' does not match passed value '%d'.",
                 (int)preparedOutputs.size(), (int)numOutputs);
 
         if (*outputValues != nullptr)
+        {
+            preparedOutputs.clear();
+            VerifyBorrowedBuffersReleased(borrowedInputBuffers, borrowedOutputBuffers);
             return;
+        }
 
         // Copy to outputs if none was provided.
         auto arrayValueCleaner = std::bind(CleanAndDestroyValues, _1, preparedOutputs.size());
@@ -135,6 +163,12 @@ namespace CNTK
         }
 
         *outputValues = result.release();
+        VerifyBorrowedBuffersReleased(borrowedInputBuffers, borrowedOutputBuffers);
+    }
+
+    void CNTKEvaluatorWrapper::Evaluate(const unordered_map<Variable, ValuePtr>& inputs, unordered_map<Variable, ValuePtr>& outputs)
+    {
+        m_func->Evaluate(inputs, outputs, m_device);
     }
 
     unique_ptr<EvaluatorWrapper> CNTKEvaluatorWrapper::Clone(CNTK_ParameterCloningMethod method, bool flatten)
@@ -146,4 +180,64 @@ namespace CNTK
             cloned = m_func->Clone(ToNative(method));
         return unique_ptr<EvaluatorWrapper>(new CNTKEvaluatorWrapper(cloned, m_device));
     }
+
+    unique_ptr<EvaluatorWrapper> CNTKEvaluatorWrapper::CreateBatching(uint32_t maxBatchSize, uint32_t maxLatencyInMicroseconds)
+    {
+        // The batching wrapper evaluates its own clone, so that this model can still be used at the same time.
+        return unique_ptr<EvaluatorWrapper>(new CNTKBatchingEvaluatorWrapper(m_func->Clone(ParameterCloningMethod::Share), m_device, maxBatchSize, maxLatencyInMicroseconds));
+    }
+
+    unique_ptr<EvaluatorWrapper> CNTKEvaluatorWrapper::CreateContext()
+    {
+        // The session is created once, all contexts created from this model or from its contexts share its weights.
+        if (!m_session)
+            m_session = CreateEvaluationSession(m_func, m_device);
+        return unique_ptr<EvaluatorWrapper>(new CNTKEvaluationContextWrapper(m_session));
+    }
+
+    // Batching interface
+    CNTKBatchingEvaluatorWrapper::CNTKBatchingEvaluatorWrapper(FunctionPtr model, DeviceDescriptor device, uint32_t maxBatchSize, uint32_t maxLatencyInMicroseconds)
+        : CNTKEvaluatorWrapper(model, device),
+          m_evaluator(CreateBatchingEvaluator(model, device, maxBatchSize, maxLatencyInMicroseconds))
+    {}
+
+    void CNTKBatchingEvaluatorWrapper::Evaluate(const unordered_map<Variable, ValuePtr>& inputs, unordered_map<Variable, ValuePtr>& outputs)
+    {
+        vector<Variable> outputVariables;
+        for (const auto& output : outputs)
+            outputVariables.push_back(output.first);
+
+        auto results = m_evaluator->Evaluate(inputs, outputVariables);
+        for (auto& output : outputs)
+        {
+            const auto& result = results.at(output.first);
+            if (output.second) // Buffer has been preallocated.
+                output.second->Data()->CopyFrom(*result->Data());
+            else
+                output.second = result;
+        }
+    }
+
+    unique_ptr<EvaluatorWrapper> CNTKBatchingEvaluatorWrapper::Clone(CNTK_ParameterCloningMethod method, bool flatten)
+    {
+        FunctionPtr cloned;
+        if (flatten)
+            cloned = m_func->CloneFlattened(ToNative(method));
+        else
+            cloned = m_func->Clone(ToNative(method));
+        return unique_ptr<EvaluatorWrapper>(new CNTKBatchingEvaluatorWrapper(cloned, m_device, (uint32_t)m_evaluator->MaxBatchSize(), (uint32_t)m_evaluator->MaxLatencyInMicroseconds()));
+    }
+
+    // Evaluation context interface
+    CNTKEvaluationContextWrapper::CNTKEvaluationContextWrapper(EvaluationSessionPtr session)
+        : CNTKEvaluatorWrapper(session->Model(), session->Device()),
+          m_context(session->CreateContext())
+    {
+        m_session = session;
+    }
+
+    void CNTKEvaluationContextWrapper::Evaluate(const unordered_map<Variable, ValuePtr>& inputs, unordered_map<Variable, ValuePtr>& outputs)
+    {
+        m_context->Evaluate(inputs, outputs);
+    }
 }
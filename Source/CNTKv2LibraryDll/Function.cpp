@@ -10,6 +10,7 @@
 #include "CompositeFunction.h"
 #include "BlockFunction.h"
 #include "Utils.h"
+#include "Serialization.h"
 #include "UserFunctionFactory.h"
 #include "TrainingNodes.h"
 #include "proto/onnx/ONNX.h"
@@ -488,9 +489,14 @@ namespace CNTK
         {
         case ModelFormat::CNTKv2:
         {
-            if (useExternalFilesToStoreParameters)
-                fprintf(stderr, "Warning: useExternalFilesToStoreParameters only applies to ONNX format."); 
             Dictionary model = Serialize();
+            if (useExternalFilesToStoreParameters)
+            {
+                // The values are stored in a page-aligned tensor file next to the model, which Load maps into memory.
+                SaveWithExternalTensors(model, filepath);
+                break;
+            }
+
             auto stream = GetFstream(filepath, false);
             *stream << model;
             stream->flush();
@@ -514,8 +520,8 @@ namespace CNTK
             auto stream = GetFstream(filepath, true);
             if (!Internal::IsLegacyModel(*stream))
             {
-                Dictionary model;
-                *stream >> model;
+                // Loaded by name, so that the values in the tensor file of the model, if any, are found.
+                Dictionary model = Dictionary::Load(filepath);
                 return Function::Deserialize(model, computeDevice);
             }
             else
@@ -570,8 +576,7 @@ namespace CNTK
         auto stream = GetFstream(filepath, true);
         if (!Internal::IsLegacyModel(*stream))
         {
-            Dictionary model;
-            *stream >> model;
+            Dictionary model = Dictionary::Load(filepath);
             RestoreFromCheckpoint(model);
             return;
         }
@@ -41,6 +41,9 @@ namespace CNTK
     ///
     CNTK_API const size_t Learner::IgnoredMinibatchSize = TrainingParameterSchedule<double>::IgnoredMinibatchSize;
 
+    CNTK_API const std::wstring Learner::FusedUpdateKey = L"FusedUpdate";
+    CNTK_API const std::wstring Learner::LazySparseUpdateKey = L"LazySparseUpdate";
+
   
     // This method completely replaces the current schedule with the new schedule. However, since
     // the new schedule starts at time 0 and the current time (in terms of the number of elapsed
@@ -126,6 +129,9 @@ namespace CNTK
             else
                 LogicError("Unsupported DataType %s", DataTypeName(dt));
         }
+
+        // Nothing is pending for smoothed gradients that are zero.
+        m_lazySparseUpdateStates.clear();
     }
 
     // Clipping gradients to prevent outliers,
@@ -174,7 +180,57 @@ namespace CNTK
             // multiply by actualMBSize so that it's invariant to minibatch size since learning rate is per sample
             const auto weight = m_additionalOptions.l2RegularizationWeight * (IsCompatibleMode() ? 1 : actualMBSize);
             const auto& parameterMatrix = parameterValue->GetWritableMatrix<ElementType>();
-            Matrix<ElementType>::ScaleAndAdd(ElementType(weight), *parameterMatrix, *gradientMatrix);
+            // The lazy update only touches the columns of the sparse gradient, so the other columns are not regularized.
+            if (IsLazySparseUpdate(parameterValue, gradientValue))
+                Matrix<ElementType>::ScaleAndAddToBlocks(ElementType(weight), *parameterMatrix, *gradientMatrix);
+            else
+                Matrix<ElementType>::ScaleAndAdd(ElementType(weight), *parameterMatrix, *gradientMatrix);
+        }
+    }
+
+    // The timestamps of a parameter are kept relative to the last flush, which happens at least once in this many updates.
+    /*static*/ const int LearnerBase::s_lazySparseUpdateSyncInterval = 1 << 20;
+
+    bool LearnerBase::IsLazySparseUpdate(const NDArrayViewPtr& parameterValue, const NDArrayViewPtr& gradientValue) const
+    {
+        if (!IsLazySparseUpdateEnabled() || !HasLazySparseUpdateRule())
+            return false;
+
+        // L1 regularization and noise injection change all columns of the parameter.
+        if (m_additionalOptions.l1RegularizationWeight > 0 || GetCurrentTrainingParameterValue(m_additionalOptions.gaussianNoiseInjectionStdDev) > 0)
+            return false;
+
+        return gradientValue->GetStorageFormat() == StorageFormat::SparseBlockCol &&
+               gradientValue->Device().Type() == DeviceKind::CPU &&
+               parameterValue->GetStorageFormat() == StorageFormat::Dense &&
+               (parameterValue->GetDataType() == DataType::Float || parameterValue->GetDataType() == DataType::Double);
+    }
+
+    LearnerBase::LazySparseUpdateState& LearnerBase::NextLazySparseUpdate(const Parameter& parameter, size_t numCols) const
+    {
+        auto& state = m_lazySparseUpdateStates[parameter];
+        if (state.timestamps.size() != numCols)
+        {
+            state.timestamps.assign(numCols, 0);
+            state.currentTime = 0;
+        }
+
+        if (state.currentTime >= s_lazySparseUpdateSyncInterval)
+        {
+            FlushLazySparseUpdateState(parameter, state);
+            state.currentTime = 0;
+        }
+
+        state.currentTime++;
+        return state;
+    }
+
+    void LearnerBase::FlushLazySparseUpdateStates()
+    {
+        for (auto& item : m_lazySparseUpdateStates)
+        {
+            FlushLazySparseUpdateState(item.first, item.second);
+            item.second.currentTime = 0;
         }
     }
 
@@ -303,52 +359,67 @@ namespace CNTK
         UpdateOnMinibatch(trainingSampleCount);
 
         bool needUpdateMasterParameter = !m_masterParameterUpdated;
-        for (const auto& parameter : Parameters())
+        FusedUpdateRule fusedUpdateRule;
+        if (IsFusedUpdateEnabled() && CanUseFusedUpdate(gradientValues) && GetFusedUpdateRule(trainingSampleCount, fusedUpdateRule))
         {
-            const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
-            const auto& gradientValue = gradientValues.at(parameter);
+            FusedUpdate<float>(fusedUpdateRule, gradientValues, trainingSampleCount);
+            FusedUpdate<double>(fusedUpdateRule, gradientValues, trainingSampleCount);
 
-            if (needUpdateMasterParameter && parameter.GetDataType() == DataType::Float16)
+            for (const auto& parameter : Parameters())
             {
-                // convert fp16 parameter to fp32
-                auto sg = smoothedGradientValue->GetWritableMatrix<float>();
-                auto pv16 = parameter.Value()->GetWritableMatrix<half>();
-                size_t factor = sg->GetNumCols() / pv16->GetNumCols();
-                auto pv = sg->ColumnSlice(pv16->GetNumCols() * (factor - 1), pv16->GetNumCols());
-                pv.CastAssignValuesOf(*pv16);
+                auto paramRef = parameter;
+                paramRef.RecordValueUpdate();
             }
+        }
+        else
+        {
+            for (const auto& parameter : Parameters())
+            {
+                const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
+                const auto& gradientValue = gradientValues.at(parameter);
+
+                if (needUpdateMasterParameter && parameter.GetDataType() == DataType::Float16)
+                {
+                    // convert fp16 parameter to fp32
+                    auto sg = smoothedGradientValue->GetWritableMatrix<float>();
+                    auto pv16 = parameter.Value()->GetWritableMatrix<half>();
+                    size_t factor = sg->GetNumCols() / pv16->GetNumCols();
+                    auto pv = sg->ColumnSlice(pv16->GetNumCols() * (factor - 1), pv16->GetNumCols());
+                    pv.CastAssignValuesOf(*pv16);
+                }
 
-            // TODO: make this a runtime parameter.
+                // TODO: make this a runtime parameter.
 #if DUMPOUTPUT
-            LOGPRINTF(stderr, "Update_%ls\n", parameter.Uid().c_str());
+                LOGPRINTF(stderr, "Update_%ls\n", parameter.Uid().c_str());
 #endif
 
 #ifdef _DEBUG
-            if (HasNan(smoothedGradientValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
-                LogicError("%ls has NaNs in smoothedGradient.", parameter.Uid().c_str());
+                if (HasNan(smoothedGradientValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
+                    LogicError("%ls has NaNs in smoothedGradient.", parameter.Uid().c_str());
 #endif
 
 #if DUMPOUTPUT
-            const auto learningRate = LearningRate(trainingSampleCount);
-            const auto momentum = MomentumValueForMB(trainingSampleCount);
-            LOGPRINTF(stderr, "learnRatePerSample=%0.8f, momentum=%0.8f, actualMBSize=%ld\n",
-                      learningRate, momentum, trainingSampleCount);
-            LOGPRINTF(stderr, "GradUpdateType()=%s, GradientUpdateNoiseStd()=%0.8f\n",
-                      LearnerType().c_str(), m_additionalOptions.gaussianNoiseInjectionStdDev);
-            Print(gradientValue, "Gradient Update");
-            Print(smoothedGradientValue, "Smoothed Gradient Input");
+                const auto learningRate = LearningRate(trainingSampleCount);
+                const auto momentum = MomentumValueForMB(trainingSampleCount);
+                LOGPRINTF(stderr, "learnRatePerSample=%0.8f, momentum=%0.8f, actualMBSize=%ld\n",
+                          learningRate, momentum, trainingSampleCount);
+                LOGPRINTF(stderr, "GradUpdateType()=%s, GradientUpdateNoiseStd()=%0.8f\n",
+                          LearnerType().c_str(), m_additionalOptions.gaussianNoiseInjectionStdDev);
+                Print(gradientValue, "Gradient Update");
+                Print(smoothedGradientValue, "Smoothed Gradient Input");
 #endif
-            DISPATCH_TO_TYPED_UPDATE_FUNCTION;
+                DISPATCH_TO_TYPED_UPDATE_FUNCTION;
 
 #if DUMPOUTPUT
-            Print(parameter.Value(), "Parameter Update");
+                Print(parameter.Value(), "Parameter Update");
 #endif
 
 #ifdef _DEBUG
-            const auto& parameterValue = parameter.Value();
-            if (HasNan(parameterValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
-                LogicError("%ls has NaNs in parameter values after parameter update.", parameter.Uid().c_str());
+                const auto& parameterValue = parameter.Value();
+                if (HasNan(parameterValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
+                    LogicError("%ls has NaNs in parameter values after parameter update.", parameter.Uid().c_str());
 #endif
+            }
         }
 
         if (needUpdateMasterParameter)
@@ -390,6 +461,203 @@ namespace CNTK
         paramRef.RecordValueUpdate();
     }
 
+    bool LearnerBase::CanUseFusedUpdate(const unordered_map<Parameter, NDArrayViewPtr>& gradientValues) const
+    {
+        // Noise injection draws random numbers per parameter and clipping by norm needs the norm of
+        // each gradient before the first element can be updated.
+        if (GetCurrentTrainingParameterValue(m_additionalOptions.gaussianNoiseInjectionStdDev) > 0)
+            return false;
+
+        if (!m_additionalOptions.gradientClippingWithTruncation && m_additionalOptions.gradientClippingThresholdPerSample != numeric_limits<double>::infinity())
+            return false;
+
+        for (const auto& parameter : Parameters())
+        {
+            const auto& parameterValue = parameter.Value();
+            const auto& gradientValue = gradientValues.at(parameter);
+            const auto dataType = parameter.GetDataType();
+            if ((dataType != DataType::Float && dataType != DataType::Double) || gradientValue->GetDataType() != dataType)
+                return false;
+
+            if (parameterValue->IsSparse() || gradientValue->IsSparse())
+                return false;
+
+            if (parameterValue->Device().Type() != DeviceKind::CPU || gradientValue->Device().Type() != DeviceKind::CPU)
+                return false;
+        }
+
+        return true;
+    }
+
+    // The per-element operations below are the ones of PreProcess(), of the update methods of the learners
+    // (Matrix::SGDUpdate(), MomentumSGDUpdate(), NesterovAcceleratedMomentumSGDUpdate() and AdamUpdate()
+    // on dense CPU matrices) and of PostProcess(), evaluated in the same order and precision.
+    template <typename ElementType>
+    void LearnerBase::FusedUpdate(const FusedUpdateRule& rule, unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount)
+    {
+        struct Tensor
+        {
+            ElementType* parameter;
+            ElementType* gradient;
+            ElementType* smoothedGradient;
+            size_t size;
+        };
+
+        vector<Tensor> tensors;
+        for (const auto& parameter : Parameters())
+        {
+            if (parameter.GetDataType() != AsDataType<ElementType>())
+                continue;
+
+            const auto& parameterMatrix = GetWritableMatrix<ElementType>(parameter.Value());
+            const auto& gradientMatrix = GetWritableMatrix<ElementType>(gradientValues.at(parameter));
+            ElementType* smoothedGradient = nullptr;
+            if (rule.kind != FusedUpdateRule::Kind::SGD)
+                smoothedGradient = GetWritableMatrix<ElementType>(m_smoothedGradientValues.at(parameter))->Data();
+
+            tensors.push_back({ parameterMatrix->Data(), gradientMatrix->Data(), smoothedGradient, parameterMatrix->GetNumElements() });
+        }
+
+        if (tensors.empty())
+            return;
+
+        // Split the buffers into segments of bounded size, so that the work of many small and a few large
+        // parameters is spread evenly over the threads.
+        struct Segment
+        {
+            size_t tensor;
+            size_t begin;
+            size_t end;
+        };
+
+        const size_t segmentSize = 16384;
+        vector<Segment> segments;
+        for (size_t t = 0; t < tensors.size(); t++)
+        {
+            for (size_t begin = 0; begin < tensors[t].size; begin += segmentSize)
+                segments.push_back({ t, begin, min(begin + segmentSize, tensors[t].size) });
+        }
+
+        // Preprocessing: mean gradient, clipping by truncation and L2 regularization.
+        const bool isCompatibleMode = IsCompatibleMode();
+        const ElementType meanGradientScale = (ElementType)1.0 / trainingSampleCount;
+        const bool clipGradient = m_additionalOptions.gradientClippingThresholdPerSample != numeric_limits<double>::infinity();
+        const double maxGradientPerMB = isCompatibleMode ? m_additionalOptions.gradientClippingThresholdPerSample : m_additionalOptions.gradientClippingThresholdPerSample * trainingSampleCount;
+        const ElementType clipThresholdPos = abs(ElementType(maxGradientPerMB));
+        const ElementType clipThresholdNeg = -clipThresholdPos;
+        const bool applyL2 = m_additionalOptions.l2RegularizationWeight > 0;
+        const ElementType l2Weight = ElementType(m_additionalOptions.l2RegularizationWeight * (isCompatibleMode ? 1 : trainingSampleCount));
+
+        // Postprocessing: L1 regularization with proximal gradient descent method.
+        const bool applyL1 = m_additionalOptions.l1RegularizationWeight > 0;
+        const ElementType l1Threshold = ElementType(LearningRate(trainingSampleCount) * m_additionalOptions.l1RegularizationWeight * (isCompatibleMode ? 1 : trainingSampleCount));
+
+        // Update rule.
+        const ElementType learningRate = ElementType(rule.learningRate);
+        const ElementType momentum = ElementType(rule.momentum);
+        const ElementType unitGainFactor = rule.unitGain ? ElementType(1.0) - momentum : ElementType(1.0);
+        const ElementType smoothingScale = unitGainFactor * learningRate;
+        const ElementType smoothingScaleOverMomentum = momentum != 0 ? smoothingScale / momentum : 0;
+        // Matrix::AdamUpdate
+        const ElementType adamLearningRate = (ElementType)rule.learningRate;
+        const ElementType varianceMomentum = (ElementType)rule.varianceMomentum;
+        const ElementType epsilon = (ElementType)rule.epsilon;
+        const ElementType biasCorrection = rule.adamax ? (ElementType)(1. / (1 - pow(rule.momentum, rule.smoothedCount))) :
+                                                         (ElementType)(sqrt(1 - pow(rule.varianceMomentum, rule.smoothedCount)) / (1 - pow(rule.momentum, rule.smoothedCount)));
+
+        // sg_t = momentum * sg_{t-1} + unitGainFactor * learningRate * g_{t-1}, as computed by Matrix::ScaleAndAdd()
+        auto smoothGradient = [&](ElementType& smoothedGradient, ElementType gradient)
+        {
+            if (momentum == 1)
+                smoothedGradient += smoothingScale * gradient;
+            else if (momentum == 0)
+                smoothedGradient = smoothingScale * gradient;
+            else
+            {
+                smoothedGradient += smoothingScaleOverMomentum * gradient;
+                smoothedGradient *= momentum;
+            }
+        };
+
+        const long numSegments = (long)segments.size();
+#pragma omp parallel for
+        for (long s = 0; s < numSegments; s++)
+        {
+            const auto& segment = segments[s];
+            const auto& tensor = tensors[segment.tensor];
+            ElementType* parameter = tensor.parameter;
+            ElementType* gradient = tensor.gradient;
+            for (size_t i = segment.begin; i < segment.end; i++)
+            {
+                ElementType g = gradient[i];
+                if (isCompatibleMode)
+                    g *= meanGradientScale;
+
+                if (clipGradient)
+                {
+                    if (g > clipThresholdPos)
+                        g = clipThresholdPos;
+                    else if (g < clipThresholdNeg)
+                        g = clipThresholdNeg;
+                }
+
+                if (applyL2)
+                    g += l2Weight * parameter[i];
+
+                gradient[i] = g;
+
+                switch (rule.kind)
+                {
+                case FusedUpdateRule::Kind::SGD:
+                    parameter[i] += -learningRate * g;
+                    break;
+                case FusedUpdateRule::Kind::MomentumSGD:
+                    smoothGradient(tensor.smoothedGradient[i], g);
+                    parameter[i] -= tensor.smoothedGradient[i];
+                    break;
+                case FusedUpdateRule::Kind::Nesterov:
+                    smoothGradient(tensor.smoothedGradient[i], g);
+                    parameter[i] += -momentum * tensor.smoothedGradient[i];
+                    parameter[i] += -smoothingScale * g;
+                    break;
+                case FusedUpdateRule::Kind::Adam:
+                {
+                    // The smoothed gradient holds the variances followed by the means.
+                    ElementType& smoothedVariance = tensor.smoothedGradient[i];
+                    ElementType& smoothedMean = tensor.smoothedGradient[tensor.size + i];
+                    ElementType ada;
+                    if (!rule.adamax)
+                    {
+                        ElementType adaSqr = varianceMomentum * smoothedVariance + (1.0f - varianceMomentum) * g * g;
+                        smoothedVariance = adaSqr;
+                        ada = sqrt(adaSqr);
+                    }
+                    else
+                        ada = smoothedVariance = max(varianceMomentum * smoothedVariance, abs(g));
+
+                    ElementType w = biasCorrection * (ElementType)(1.0 / (ada + epsilon));
+                    ElementType m = momentum * smoothedMean + unitGainFactor * g;
+                    smoothedMean = m;
+                    parameter[i] -= m * w * adamLearningRate;
+                    break;
+                }
+                default:
+                    break;
+                }
+
+                if (applyL1)
+                {
+                    if (parameter[i] > l1Threshold)
+                        parameter[i] -= l1Threshold;
+                    else if (parameter[i] < -l1Threshold)
+                        parameter[i] += l1Threshold;
+                    else
+                        parameter[i] = 0;
+                }
+            }
+        }
+    }
+
     string LearnerBase::LearnerType() const
     {
         return Typename(this);
@@ -399,6 +667,9 @@ namespace CNTK
 
     /*virtual*/ Dictionary LearnerBase::CreateCheckpoint() /*override*/
     {
+        // The checkpoint contains the smoothed gradients as the dense update would have left them.
+        FlushLazySparseUpdateStates();
+
         Dictionary checkpoint;
 
         checkpoint[versionKey] = CurrentVersion();
@@ -450,6 +721,9 @@ namespace CNTK
         m_sampleCount = checkpoint[sampleCountKey].Value<size_t>();
         m_minibatchCount = checkpoint[minibatchCountKey].Value<size_t>();
 
+        // The smoothed gradients in the checkpoint have no pending decay.
+        m_lazySparseUpdateStates.clear();
+
         if (checkpoint.Contains(noiseInjectionSeedKey)) 
         {
             m_noiseInjectionSeed = checkpoint[noiseInjectionSeedKey].Value<size_t>();
@@ -552,6 +826,14 @@ namespace CNTK
         parameterMatrix->SGDUpdate(*gradientMatrix, learningRate);
     }
 
+    /*virtual*/ bool LearnerSGD::GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const /*override*/
+    {
+        rule = FusedUpdateRule();
+        rule.kind = FusedUpdateRule::Kind::SGD;
+        rule.learningRate = LearningRate(trainingSampleCount);
+        return true;
+    }
+
     double LearnerMomentumSGD::MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const
     {
         //TODO: The unit gain term (1-beta) should stay as it is (currentMomentum) instead of using the following scaled term.
@@ -617,8 +899,28 @@ namespace CNTK
         const auto learningRate = ElementType(LearningRate(trainingSampleCount));
         const auto momentum = ElementType(MomentumValueForMB(trainingSampleCount));
         const auto unitGainFactor = UnitGainFactor<ElementType>(trainingSampleCount);
-        parameterMatrix->MomentumSGDUpdate(*gradientMatrix, *smoothedGradientMatrix,
-                                           learningRate, momentum, unitGainFactor);
+        if (IsLazySparseUpdate(parameter.Value(), gradientValue))
+        {
+            auto& state = NextLazySparseUpdate(parameter, gradientMatrix->GetNumCols());
+            state.momentum = momentum;
+            parameterMatrix->MomentumSGDUpdate(*gradientMatrix, *smoothedGradientMatrix,
+                                               learningRate, momentum, unitGainFactor, state.timestamps.data(), state.currentTime);
+        }
+        else
+            parameterMatrix->MomentumSGDUpdate(*gradientMatrix, *smoothedGradientMatrix,
+                                               learningRate, momentum, unitGainFactor);
+    }
+
+    /*virtual*/ void LearnerMomentumSGD::FlushLazySparseUpdateState(const Parameter& parameter, LazySparseUpdateState& state) const /*override*/
+    {
+        const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
+        const auto numCols = state.timestamps.size();
+        if (parameter.GetDataType() == DataType::Float)
+            GetWritableMatrix<float>(smoothedGradientValue)->MomentumSGDFlushState(numCols, (float)state.momentum, state.timestamps.data(), state.currentTime);
+        else if (parameter.GetDataType() == DataType::Double)
+            GetWritableMatrix<double>(smoothedGradientValue)->MomentumSGDFlushState(numCols, state.momentum, state.timestamps.data(), state.currentTime);
+        else
+            LogicError("Unexpected parameter data type");
     }
 
     void LearnerMomentumSGD::UpdateHalf(const Parameter& parameter, const NDArrayViewPtr& gradientValue,
@@ -640,6 +942,18 @@ namespace CNTK
             learningRate, momentum, unitGainFactor);
     }
 
+    /*virtual*/ bool LearnerMomentumSGD::GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const /*override*/
+    {
+        ReportTrainingParameterValue(m_momentumSchedule, L"Momentum");
+
+        rule = FusedUpdateRule();
+        rule.kind = FusedUpdateRule::Kind::MomentumSGD;
+        rule.learningRate = LearningRate(trainingSampleCount);
+        rule.momentum = MomentumValueForMB(trainingSampleCount);
+        rule.unitGain = UseUnitGainMomentum();
+        return true;
+    }
+
     /*virtual*/ void LearnerNesterov::Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, 
                                              const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) /*override*/
     {
@@ -692,6 +1006,16 @@ namespace CNTK
             learningRate, momentum, unitGainFactor);
     }
 
+    /*virtual*/ bool LearnerNesterov::GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const /*override*/
+    {
+        rule = FusedUpdateRule();
+        rule.kind = FusedUpdateRule::Kind::Nesterov;
+        rule.learningRate = LearningRate(trainingSampleCount);
+        rule.momentum = MomentumValueForMB(trainingSampleCount);
+        rule.unitGain = UseUnitGainMomentum();
+        return true;
+    }
+
     LearnerAdaGrad::LearnerAdaGrad(const std::vector<Parameter>& parameters,
                                    const LearningRateSchedule& learningRateSchedule,
                                    bool needAveMultiplier,
@@ -1006,8 +1330,44 @@ namespace CNTK
 
         const auto varMomentum = VarianceMomentumValueForMB(trainingSampleCount);
 
-        smoothedGradientMatrix->AdamUpdate(*gradientMatrix, *parameterMatrix, m_smoothedCount, learningRate,
-                                           momentum, varMomentum, (ElementType)m_epsilon, unitGainFactor, m_adamax);
+        if (IsLazySparseUpdate(parameter.Value(), gradientValue))
+        {
+            auto& state = NextLazySparseUpdate(parameter, gradientMatrix->GetNumCols());
+            state.momentum = momentum;
+            state.varianceMomentum = varMomentum;
+            smoothedGradientMatrix->AdamUpdate(*gradientMatrix, *parameterMatrix, m_smoothedCount, learningRate,
+                                               momentum, varMomentum, (ElementType)m_epsilon, unitGainFactor, m_adamax,
+                                               state.timestamps.data(), state.currentTime);
+        }
+        else
+            smoothedGradientMatrix->AdamUpdate(*gradientMatrix, *parameterMatrix, m_smoothedCount, learningRate,
+                                               momentum, varMomentum, (ElementType)m_epsilon, unitGainFactor, m_adamax);
+    }
+
+    /*virtual*/ void LearnerAdam::FlushLazySparseUpdateState(const Parameter& parameter, LazySparseUpdateState& state) const /*override*/
+    {
+        const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
+        const auto numCols = state.timestamps.size();
+        if (parameter.GetDataType() == DataType::Float)
+            GetWritableMatrix<float>(smoothedGradientValue)->AdamFlushState(numCols, (float)state.momentum, (float)state.varianceMomentum, state.timestamps.data(), state.currentTime);
+        else if (parameter.GetDataType() == DataType::Double)
+            GetWritableMatrix<double>(smoothedGradientValue)->AdamFlushState(numCols, state.momentum, state.varianceMomentum, state.timestamps.data(), state.currentTime);
+        else
+            LogicError("Unexpected parameter data type");
+    }
+
+    /*virtual*/ bool LearnerAdam::GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const /*override*/
+    {
+        rule = FusedUpdateRule();
+        rule.kind = FusedUpdateRule::Kind::Adam;
+        rule.learningRate = LearningRate(trainingSampleCount);
+        rule.momentum = MomentumValueForMB(trainingSampleCount);
+        rule.unitGain = UseUnitGainMomentum();
+        rule.varianceMomentum = VarianceMomentumValueForMB(trainingSampleCount);
+        rule.epsilon = m_epsilon;
+        rule.smoothedCount = m_smoothedCount;
+        rule.adamax = m_adamax;
+        return true;
     }
 
     LearnerRMSProp::LearnerRMSProp(const vector<Parameter>& parameters,
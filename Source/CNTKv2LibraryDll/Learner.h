@@ -43,6 +43,57 @@ namespace CNTK
         // Allows derived class may override this to perform per-minibatch update actions
         virtual void UpdateOnMinibatch(size_t /*trainingSampleCount*/) {}
 
+        // Update rule of a learner, as applied per element by the fused multi-tensor update.
+        struct FusedUpdateRule
+        {
+            enum class Kind
+            {
+                SGD,
+                MomentumSGD,
+                Nesterov,
+                Adam,
+            };
+
+            Kind kind;
+            double learningRate;
+            double momentum;
+            bool unitGain;
+            double varianceMomentum;
+            double epsilon;
+            double smoothedCount;
+            bool adamax;
+        };
+
+        // Allows derived classes to provide the rule for the fused multi-tensor update of the current minibatch.
+        // Returns false if the learner has no fused update rule, its parameters are then updated one by one.
+        virtual bool GetFusedUpdateRule(size_t /*trainingSampleCount*/, FusedUpdateRule& /*rule*/) const { return false; }
+
+        // State of the lazy update of a parameter with block sparse column gradients, see SetLazySparseUpdate().
+        struct LazySparseUpdateState
+        {
+            // Time of the last update of each column; the smoothed gradients of a column are decayed
+            // for the minibatches in between when the column is updated again.
+            std::vector<int> timestamps;
+            int currentTime;
+            // Decay rates of the last update, the pending decay of all columns is applied with them when the state is flushed.
+            double momentum;
+            double varianceMomentum;
+        };
+
+        // Allows derived classes to declare that they update block sparse column gradients lazily, see IsLazySparseUpdate().
+        virtual bool HasLazySparseUpdateRule() const { return false; }
+
+        // Returns true if the update of the given parameter only touches the columns of its sparse gradient.
+        bool IsLazySparseUpdate(const NDArrayViewPtr& parameterValue, const NDArrayViewPtr& gradientValue) const;
+
+        // Advances the time of the lazy update of the parameter and returns its state.
+        LazySparseUpdateState& NextLazySparseUpdate(const Parameter& parameter, size_t numCols) const;
+
+        // Applies the pending decay of all columns to the smoothed gradients of the parameter and resets its timestamps.
+        virtual void FlushLazySparseUpdateState(const Parameter& /*parameter*/, LazySparseUpdateState& /*state*/) const {}
+
+        void FlushLazySparseUpdateStates();
+
         std::string LearnerType() const;
 
         // Returns current learning rate.
@@ -85,6 +136,11 @@ namespace CNTK
 
         mutable size_t m_noiseInjectionSeed;
 
+        mutable std::unordered_map<Parameter, LazySparseUpdateState> m_lazySparseUpdateStates;
+
+        // Once in this many updates of a parameter, the state of its lazy update is flushed so that the timestamps do not overflow.
+        static const int s_lazySparseUpdateSyncInterval;
+
         // The following four static protected methods expose private methods of NDArrayView class
         // (which declares LearnerBase as friend class), so that they are available to subclasses.
         template <typename ElementType>
@@ -125,6 +181,14 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount);
 
+        // Returns true if all parameters can be updated by the fused multi-tensor update.
+        bool CanUseFusedUpdate(const std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues) const;
+
+        // Fused multi-tensor update: applies preprocessing, the update rule and postprocessing to all parameters
+        // of the given element type in one parallel sweep over their flattened buffers.
+        template <typename ElementType>
+        void FusedUpdate(const FusedUpdateRule& rule, std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount);
+
         // TODO: make these functions friends of NDViewArray and move to Utils?
         static bool HasNan(const NDArrayViewPtr& value, const char* name);
         static void Print(const NDArrayViewPtr& value, const char* msg);
@@ -155,6 +219,8 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const override;
     };
 
     // SGD optimization with momentum. 
@@ -188,6 +254,11 @@ namespace CNTK
 
         void UpdateHalf(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        virtual bool GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const override;
+
+        virtual bool HasLazySparseUpdateRule() const override { return true; }
+        virtual void FlushLazySparseUpdateState(const Parameter& parameter, LazySparseUpdateState& state) const override;
+
         // returns current per-minibatch momentum value from the provided schedule.
         double MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const;
 
@@ -233,6 +304,11 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
         void UpdateHalf(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const override;
+
+        // The look-ahead step has no lazy counterpart.
+        virtual bool HasLazySparseUpdateRule() const override { return false; }
     };
 
     class LearnerAdaGrad : public LearnerBase
@@ -309,6 +385,10 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        // Not derived from the momentum SGD rule.
+        virtual bool GetFusedUpdateRule(size_t /*trainingSampleCount*/, FusedUpdateRule& /*rule*/) const override { return false; }
+        virtual bool HasLazySparseUpdateRule() const override { return false; }
+
     private:
         static const double s_targetAdagradAvDenom;
         double m_targetAdagradAvDenom_x_sqrtAdagradSqrFrames;
@@ -350,6 +430,10 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        virtual bool GetFusedUpdateRule(size_t trainingSampleCount, FusedUpdateRule& rule) const override;
+
+        virtual void FlushLazySparseUpdateState(const Parameter& parameter, LazySparseUpdateState& state) const override;
+
     private:
 
         // returns current per-minibatch variance momentum value.
@@ -0,0 +1,375 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include "MPIAllReduce.h"
+
+using namespace Microsoft::MSR::CNTK;
+
+namespace CNTK
+{
+    // Tag of the point-to-point messages of the allreduce, messages between two workers are matched in the order they are sent.
+    static const int s_allReduceTag = 0x7A11;
+
+    // Maximum length of a host name exchanged between workers.
+    static const size_t s_maxHostNameLength = 256;
+
+    // Beginning of the chunk 'index' out of 'numberOfChunks' balanced chunks of 'count' elements.
+    static size_t ChunkBegin(size_t count, size_t numberOfChunks, size_t index)
+    {
+        return count * index / numberOfChunks;
+    }
+
+    template <typename ElementType>
+    static size_t SegmentSize()
+    {
+        return std::max<size_t>(1, MPIAllReduce::SegmentSizeInBytes / sizeof(ElementType));
+    }
+
+    template <typename ElementType>
+    static void Add(ElementType* target, const ElementType* source, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            target[i] += source[i];
+    }
+
+    MPIAllReduce::MPIAllReduce(const MPIWrapperPtr& mpi)
+        : m_mpi(mpi),
+          m_rank((int)mpi->CurrentNodeRank()),
+          m_numberOfWorkers((int)mpi->NumNodesInUse()),
+          m_hostsInitialized(false),
+          m_indexInHost(0),
+          m_indexInPeers(0)
+    {
+        for (int i = 0; i < m_numberOfWorkers; ++i)
+            m_allWorkers.push_back(i);
+    }
+
+    void MPIAllReduce::InitializeHosts()
+    {
+        if (m_hostsInitialized)
+            return;
+
+        m_hostsInitialized = true;
+
+        auto name = m_mpi->CurrentNodeName();
+        std::vector<char> ownName(s_maxHostNameLength, 0);
+        for (size_t i = 0; i < name.size() && i + 1 < s_maxHostNameLength; ++i)
+            ownName[i] = (char)name[i];
+
+        std::vector<char> allNames(s_maxHostNameLength * m_numberOfWorkers);
+        m_mpi->Allgather(ownName.data(), (int)s_maxHostNameLength, MPI_CHAR, allNames.data(), (int)s_maxHostNameLength, MPI_CHAR);
+
+        // Hosts in the order of their first worker.
+        std::vector<std::vector<int>> hosts;
+        std::map<std::string, size_t> hostIndices;
+        size_t ownHost = 0;
+        for (int rank = 0; rank < m_numberOfWorkers; ++rank)
+        {
+            std::string host(allNames.data() + rank * s_maxHostNameLength);
+            auto inserted = hostIndices.insert(std::make_pair(host, hosts.size()));
+            if (inserted.second)
+                hosts.push_back(std::vector<int>());
+
+            if (rank == m_rank)
+                ownHost = inserted.first->second;
+
+            hosts[inserted.first->second].push_back(rank);
+        }
+
+        for (const auto& host : hosts)
+        {
+            if (host.size() != hosts.front().size())
+                return;
+        }
+
+        m_hostWorkers = hosts[ownHost];
+        m_indexInHost = std::find(m_hostWorkers.begin(), m_hostWorkers.end(), m_rank) - m_hostWorkers.begin();
+        for (const auto& host : hosts)
+            m_peerWorkers.push_back(host[m_indexInHost]);
+        m_indexInPeers = ownHost;
+    }
+
+    Internal::AllReduceAlgorithm MPIAllReduce::Select(size_t sizeInBytes)
+    {
+        auto algorithm = Internal::GetAllReduceAlgorithm();
+        if (algorithm == Internal::AllReduceAlgorithm::Automatic)
+        {
+            if (sizeInBytes < RecursiveHalvingThresholdInBytes)
+                return Internal::AllReduceAlgorithm::RecursiveHalving;
+
+            InitializeHosts();
+            bool multipleWorkersOnMultipleHosts = m_hostWorkers.size() > 1 && m_peerWorkers.size() > 1;
+            return multipleWorkersOnMultipleHosts ? Internal::AllReduceAlgorithm::Hierarchical : Internal::AllReduceAlgorithm::Ring;
+        }
+
+        if (algorithm == Internal::AllReduceAlgorithm::Hierarchical)
+        {
+            InitializeHosts();
+            if (m_hostWorkers.empty())
+                return Internal::AllReduceAlgorithm::Ring;
+        }
+
+        return algorithm;
+    }
+
+    template <typename ElementType>
+    void MPIAllReduce::AllReduce(const ElementType* input, ElementType* output, size_t count, Internal::AllReduceAlgorithm algorithm)
+    {
+        if (input != output)
+            memcpy(output, input, count * sizeof(ElementType));
+
+        if (m_numberOfWorkers == 1 || count == 0)
+            return;
+
+        switch (algorithm)
+        {
+        case Internal::AllReduceAlgorithm::Ring:
+            ReduceScatter(m_allWorkers, m_rank, output, count);
+            AllGather(m_allWorkers, m_rank, output, count);
+            break;
+        case Internal::AllReduceAlgorithm::RecursiveHalving:
+            RecursiveHalving(output, count);
+            break;
+        case Internal::AllReduceAlgorithm::Hierarchical:
+        {
+            InitializeHosts();
+            if (m_hostWorkers.empty())
+                LogicError("MPIAllReduce: the hierarchical allreduce requires the same number of workers on each host.");
+
+            ReduceScatter(m_hostWorkers, m_indexInHost, output, count);
+
+            size_t chunk = (m_indexInHost + 1) % m_hostWorkers.size();
+            size_t begin = ChunkBegin(count, m_hostWorkers.size(), chunk);
+            size_t end = ChunkBegin(count, m_hostWorkers.size(), chunk + 1);
+            ReduceScatter(m_peerWorkers, m_indexInPeers, output + begin, end - begin);
+            AllGather(m_peerWorkers, m_indexInPeers, output + begin, end - begin);
+
+            AllGather(m_hostWorkers, m_indexInHost, output, count);
+            break;
+        }
+        default:
+            LogicError("MPIAllReduce: unsupported allreduce algorithm %d.", (int)algorithm);
+        }
+    }
+
+    template <typename ElementType>
+    void MPIAllReduce::ReduceScatter(const std::vector<int>& group, size_t index, ElementType* data, size_t count)
+    {
+        size_t n = group.size();
+        if (n == 1)
+            return;
+
+        int next = group[(index + 1) % n];
+        int previous = group[(index + n - 1) % n];
+        auto dataType = MPIWrapper::GetDataType(data);
+        size_t segment = SegmentSize<ElementType>();
+        ElementType* buffer = ReceiveBuffer<ElementType>(count / n + 1);
+
+        std::vector<MPI_Request> sends;
+        auto send = [&](size_t offset, size_t size)
+        {
+            sends.push_back(MPI_Request());
+            m_mpi->Isend(data + offset, (int)size, dataType, next, s_allReduceTag, &sends.back()) || MpiFail("MPIAllReduce: MPI_Isend");
+        };
+
+        // In step s the worker receives chunk (index - s - 1) and adds it to its own values. This is the chunk
+        // it sends in step s + 1, so each segment is forwarded right after it has been reduced.
+        for (size_t offset = ChunkBegin(count, n, index); offset < ChunkBegin(count, n, index + 1); offset += segment)
+            send(offset, std::min(segment, ChunkBegin(count, n, index + 1) - offset));
+
+        std::vector<MPI_Request> receives;
+        for (size_t step = 0; step + 1 < n; ++step)
+        {
+            size_t chunk = (index + 2 * n - step - 1) % n;
+            size_t begin = ChunkBegin(count, n, chunk);
+            size_t end = ChunkBegin(count, n, chunk + 1);
+
+            receives.clear();
+            receives.reserve((end - begin + segment - 1) / segment);
+            for (size_t offset = begin; offset < end; offset += segment)
+            {
+                receives.push_back(MPI_Request());
+                m_mpi->Irecv(buffer + (offset - begin), (int)std::min(segment, end - offset), dataType, previous, s_allReduceTag, &receives.back()) || MpiFail("MPIAllReduce: MPI_Irecv");
+            }
+
+            for (size_t k = 0, offset = begin; offset < end; ++k, offset += segment)
+            {
+                size_t size = std::min(segment, end - offset);
+                m_mpi->Wait(&receives[k]);
+                Add(data + offset, buffer + (offset - begin), size);
+                if (step + 2 < n)
+                    send(offset, size);
+            }
+        }
+
+        if (!sends.empty())
+            m_mpi->WaitAll(sends);
+    }
+
+    template <typename ElementType>
+    void MPIAllReduce::AllGather(const std::vector<int>& group, size_t index, ElementType* data, size_t count)
+    {
+        size_t n = group.size();
+        if (n == 1)
+            return;
+
+        int next = group[(index + 1) % n];
+        int previous = group[(index + n - 1) % n];
+        auto dataType = MPIWrapper::GetDataType(data);
+        size_t segment = SegmentSize<ElementType>();
+
+        std::vector<MPI_Request> sends;
+        auto send = [&](size_t offset, size_t size)
+        {
+            sends.push_back(MPI_Request());
+            m_mpi->Isend(data + offset, (int)size, dataType, next, s_allReduceTag, &sends.back()) || MpiFail("MPIAllReduce: MPI_Isend");
+        };
+
+        // The worker starts with the reduced chunk (index + 1) and receives chunk (index - s) in step s, which is forwarded
+        // segment by segment in step s + 1. The received data is written in place, it is never overwritten again.
+        size_t owned = (index + 1) % n;
+        for (size_t offset = ChunkBegin(count, n, owned); offset < ChunkBegin(count, n, owned + 1); offset += segment)
+            send(offset, std::min(segment, ChunkBegin(count, n, owned + 1) - offset));
+
+        std::vector<MPI_Request> receives;
+        for (size_t step = 0; step + 1 < n; ++step)
+        {
+            size_t chunk = (index + n - step) % n;
+            size_t begin = ChunkBegin(count, n, chunk);
+            size_t end = ChunkBegin(count, n, chunk + 1);
+
+            receives.clear();
+            receives.reserve((end - begin + segment - 1) / segment);
+            for (size_t offset = begin; offset < end; offset += segment)
+            {
+                receives.push_back(MPI_Request());
+                m_mpi->Irecv(data + offset, (int)std::min(segment, end - offset), dataType, previous, s_allReduceTag, &receives.back()) || MpiFail("MPIAllReduce: MPI_Irecv");
+            }
+
+            for (size_t k = 0, offset = begin; offset < end; ++k, offset += segment)
+            {
+                m_mpi->Wait(&receives[k]);
+                if (step + 2 < n)
+                    send(offset, std::min(segment, end - offset));
+            }
+        }
+
+        if (!sends.empty())
+            m_mpi->WaitAll(sends);
+    }
+
+    template <typename ElementType>
+    void MPIAllReduce::RecursiveHalving(ElementType* data, size_t count)
+    {
+        // For a number of workers that is not a power of two, the first 2 * remainder workers are folded in pairs:
+        // the even worker sends its values to the odd one, waits for the result and does not take part otherwise.
+        int powerOfTwo = 1;
+        while (powerOfTwo * 2 <= m_numberOfWorkers)
+            powerOfTwo *= 2;
+        int remainder = m_numberOfWorkers - powerOfTwo;
+
+        if (m_rank < 2 * remainder && m_rank % 2 == 0)
+        {
+            Exchange<ElementType>(m_rank + 1, data, count, nullptr, 0, false);
+            Exchange<ElementType>(m_rank + 1, nullptr, 0, data, count, false);
+            return;
+        }
+
+        if (m_rank < 2 * remainder)
+            Exchange<ElementType>(m_rank - 1, nullptr, 0, data, count, true);
+
+        int virtualRank = m_rank < 2 * remainder ? m_rank / 2 : m_rank - remainder;
+        auto realRank = [remainder](int rank) { return rank < remainder ? 2 * rank + 1 : rank + remainder; };
+
+        // Reduce-scatter: in each step the range is halved, the worker keeps one half and sends the other one to the partner.
+        std::vector<std::pair<size_t, size_t>> ranges;
+        size_t begin = 0, end = count;
+        for (int mask = powerOfTwo / 2; mask > 0; mask /= 2)
+        {
+            ranges.push_back(std::make_pair(begin, end));
+            size_t middle = begin + (end - begin) / 2;
+            int partner = realRank(virtualRank ^ mask);
+            if ((virtualRank & mask) == 0)
+            {
+                Exchange(partner, data + middle, end - middle, data + begin, middle - begin, true);
+                end = middle;
+            }
+            else
+            {
+                Exchange(partner, data + begin, middle - begin, data + middle, end - middle, true);
+                begin = middle;
+            }
+        }
+
+        // Allgather: the same steps in reverse order, the worker sends its reduced half and receives the partner's.
+        for (int mask = 1; mask < powerOfTwo; mask *= 2)
+        {
+            auto range = ranges.back();
+            ranges.pop_back();
+            int partner = realRank(virtualRank ^ mask);
+            if (begin == range.first)
+                Exchange(partner, data + begin, end - begin, data + end, range.second - end, false);
+            else
+                Exchange(partner, data + begin, end - begin, data + range.first, begin - range.first, false);
+
+            begin = range.first;
+            end = range.second;
+        }
+
+        if (m_rank < 2 * remainder)
+            Exchange<ElementType>(m_rank - 1, data, count, nullptr, 0, false);
+    }
+
+    template <typename ElementType>
+    void MPIAllReduce::Exchange(int peer, const ElementType* send, size_t sendCount, ElementType* receive, size_t receiveCount, bool reduce)
+    {
+        auto dataType = MPIWrapper::GetDataType((ElementType*)nullptr);
+        size_t segment = SegmentSize<ElementType>();
+        ElementType* buffer = reduce ? ReceiveBuffer<ElementType>(receiveCount) : receive;
+
+        std::vector<MPI_Request> receives;
+        receives.reserve((receiveCount + segment - 1) / segment);
+        for (size_t offset = 0; offset < receiveCount; offset += segment)
+        {
+            receives.push_back(MPI_Request());
+            m_mpi->Irecv(buffer + offset, (int)std::min(segment, receiveCount - offset), dataType, peer, s_allReduceTag, &receives.back()) || MpiFail("MPIAllReduce: MPI_Irecv");
+        }
+
+        std::vector<MPI_Request> sends;
+        sends.reserve((sendCount + segment - 1) / segment);
+        for (size_t offset = 0; offset < sendCount; offset += segment)
+        {
+            sends.push_back(MPI_Request());
+            m_mpi->Isend(send + offset, (int)std::min(segment, sendCount - offset), dataType, peer, s_allReduceTag, &sends.back()) || MpiFail("MPIAllReduce: MPI_Isend");
+        }
+
+        for (size_t k = 0, offset = 0; offset < receiveCount; ++k, offset += segment)
+        {
+            m_mpi->Wait(&receives[k]);
+            if (reduce)
+                Add(receive + offset, buffer + offset, std::min(segment, receiveCount - offset));
+        }
+
+        if (!sends.empty())
+            m_mpi->WaitAll(sends);
+    }
+
+    template <typename ElementType>
+    ElementType* MPIAllReduce::ReceiveBuffer(size_t count)
+    {
+        if (m_receiveBuffer.size() < count * sizeof(ElementType))
+            m_receiveBuffer.resize(count * sizeof(ElementType));
+
+        return reinterpret_cast<ElementType*>(m_receiveBuffer.data());
+    }
+
+    template void MPIAllReduce::AllReduce<float>(const float* input, float* output, size_t count, Internal::AllReduceAlgorithm algorithm);
+    template void MPIAllReduce::AllReduce<double>(const double* input, double* output, size_t count, Internal::AllReduceAlgorithm algorithm);
+    template void MPIAllReduce::AllReduce<int>(const int* input, int* output, size_t count, Internal::AllReduceAlgorithm algorithm);
+}
@@ -0,0 +1,86 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <vector>
+#include "CNTKLibrary.h"
+#include "MPIWrapper.h"
+
+namespace CNTK
+{
+    //
+    // Allreduce (sum) of buffers in CPU memory implemented on top of the point-to-point primitives of the MPI wrapper,
+    // so that the aggregation bandwidth does not depend on the collective algorithms of the installed MPI library.
+    //  - Ring: reduce-scatter followed by allgather around a ring of all workers; each worker sends 2 * (n - 1) / n
+    //    of the buffer, which is bandwidth-optimal. Chunks are split into segments that are forwarded to the next
+    //    worker as soon as they have been reduced, so that sending, receiving and reducing overlap.
+    //  - Recursive halving: reduce-scatter by recursive halving followed by allgather by recursive doubling, log(n)
+    //    steps instead of 2 * (n - 1), which is better for small messages where the latency dominates.
+    //  - Hierarchical: ring reduce-scatter among the workers of a host, ring allreduce of the reduced chunk among the
+    //    workers with the same local rank on all hosts, ring allgather among the workers of a host. Only 1 / (workers per host)
+    //    of the buffer crosses the host boundary. Requires the same number of workers on each host, otherwise the ring is used.
+    //
+    class MPIAllReduce
+    {
+    public:
+        explicit MPIAllReduce(const Microsoft::MSR::CNTK::MPIWrapperPtr& mpi);
+
+        // Returns the algorithm that should be used for a message of the given size according to the configured
+        // Internal::AllReduceAlgorithm, Internal::AllReduceAlgorithm::MPI if the MPI library should be used instead.
+        // The result is the same on all workers, all of them have to call this for the same messages.
+        Internal::AllReduceAlgorithm Select(size_t sizeInBytes);
+
+        // Sums the input buffers of all workers into the output buffers, input and output may be the same.
+        template <typename ElementType>
+        void AllReduce(const ElementType* input, ElementType* output, size_t count, Internal::AllReduceAlgorithm algorithm);
+
+        // Messages below this size are aggregated with recursive halving in the automatic mode.
+        static const size_t RecursiveHalvingThresholdInBytes = 256 * 1024;
+
+        // Size of the segments in which chunks are pipelined.
+        static const size_t SegmentSizeInBytes = 128 * 1024;
+
+    private:
+        template <typename ElementType>
+        void RecursiveHalving(ElementType* data, size_t count);
+
+        // Ring reduce-scatter among the given workers, the worker at the given index in the group ends up owning the
+        // fully reduced chunk (index + 1) % group.size().
+        template <typename ElementType>
+        void ReduceScatter(const std::vector<int>& group, size_t index, ElementType* data, size_t count);
+
+        // Ring allgather among the given workers, that own the chunks as left by ReduceScatter.
+        template <typename ElementType>
+        void AllGather(const std::vector<int>& group, size_t index, ElementType* data, size_t count);
+
+        // Sends and receives the given ranges to/from the peer in segments; if 'reduce' is set, the received data is
+        // added to 'receive' segment by segment, otherwise it is written to it.
+        template <typename ElementType>
+        void Exchange(int peer, const ElementType* send, size_t sendCount, ElementType* receive, size_t receiveCount, bool reduce);
+
+        template <typename ElementType>
+        ElementType* ReceiveBuffer(size_t count);
+
+        // Groups the workers by host, once; has to be called by all workers.
+        void InitializeHosts();
+
+        Microsoft::MSR::CNTK::MPIWrapperPtr m_mpi;
+        int m_rank;
+        int m_numberOfWorkers;
+
+        std::vector<int> m_allWorkers;
+
+        // Workers on the same host and workers with the same local rank on all hosts, empty if the workers
+        // are not evenly distributed among hosts.
+        bool m_hostsInitialized;
+        std::vector<int> m_hostWorkers;
+        size_t m_indexInHost;
+        std::vector<int> m_peerWorkers;
+        size_t m_indexInPeers;
+
+        std::vector<char> m_receiveBuffer;
+    };
+}
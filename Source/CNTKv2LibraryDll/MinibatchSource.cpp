@@ -214,6 +214,19 @@ namespace CNTK
 
                 epochConfig.m_epochIndex = 0;
 
+                // Used by readers that do not see the whole data set on each worker (i.e. sharded reading).
+                if (numberOfWorkers > 1)
+                {
+                    epochConfig.m_sumAcrossWorkers = [](size_t value)
+                    {
+                        auto mpi = Microsoft::MSR::CNTK::MPIWrapper::GetInstance();
+                        if (!mpi)
+                            LogicError("GetNextMinibatch: The reader requires communication between workers, but MPI is not initialized.");
+                        mpi->AllReduce(&value, 1);
+                        return value;
+                    };
+                }
+
                 m_matrices.clear();
 
                 std::unordered_set<InputStreamDescription> inputs;
@@ -425,6 +438,12 @@ namespace CNTK
         return BuildImageDeserializer(L"Base64ImageDeserializer", fileName, labelStreamName, numLabels, imageStreamName, transforms);
     }
 
+    Deserializer PackedImageDeserializer(const std::wstring& fileName, const std::wstring& labelStreamName, size_t numLabels,
+        const std::wstring& imageStreamName, const std::vector<ImageTransform>& transforms)
+    {
+        return BuildImageDeserializer(L"PackedImageDeserializer", fileName, labelStreamName, numLabels, imageStreamName, transforms);
+    }
+
     Deserializer CTFDeserializer(const std::wstring& fileName, const std::vector<StreamConfiguration>& streams)
     {
         Deserializer ctf;
@@ -612,6 +631,7 @@ namespace CNTK
                     { L"CNTKBinaryFormatDeserializer", L"CNTKBinaryReader" },
                     { L"ImageDeserializer",            L"ImageReader" },
                     { L"Base64ImageDeserializer",      L"ImageReader" },
+                    { L"PackedImageDeserializer",      L"ImageReader" },
                     { L"HTKFeatureDeserializer",       L"HTKDeserializers" },
                     { L"HTKMLFDeserializer",           L"HTKDeserializers" },
                     { L"HTKMLFBinaryDeserializer",     L"HTKDeserializers" },
@@ -619,7 +639,8 @@ namespace CNTK
                 };
 
                 auto deserializerTypeName = deserializerConfig[L"type"].Value<std::wstring>();
-                if (deserializerTypeName == L"ImageDeserializer" || deserializerTypeName == L"Base64ImageDeserializer")
+                if (deserializerTypeName == L"ImageDeserializer" || deserializerTypeName == L"Base64ImageDeserializer" ||
+                    deserializerTypeName == L"PackedImageDeserializer")
                 {
                     defaultMultithreaded = true;
                 }
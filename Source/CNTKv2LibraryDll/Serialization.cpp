@@ -6,11 +6,15 @@
 #include "stdafx.h"
 #include "CNTKLibrary.h"
 #include "Utils.h"
+#include "Serialization.h"
+#include "MemoryMappedFile.h"
+#include "fileutil.h"
 #include <istream>
 #include <ostream>
 #include <string>
 #include <vector>
 #include <limits>
+#include <atomic>
 
 #ifdef _MSC_VER
 #include <io.h>
@@ -30,6 +34,7 @@ namespace CNTK
 
     static const uint32 MAGIC_NUMBER = 0x636e746bU;
     static const uint32 BLOCK_SIZE = 8 << 10; // 8Kb;
+    static const uint64 TENSOR_ALIGNMENT = 4 << 10; // page size
 
     static void SetUTF8Locale()
     {
@@ -124,6 +129,8 @@ namespace CNTK
         friend class Dictionary;
         friend class DictionaryValue;
 
+        friend void SaveWithExternalTensors(const Dictionary& dictionary, const std::wstring& filename);
+
         Serializer(const Dictionary& dict);
         Serializer(const DictionaryValue& dict);
 
@@ -145,6 +152,7 @@ namespace CNTK
         std::ostream& Write(std::ostream& stream);
         void Write(const std::wstring& filename);
         void Write(io::ZeroCopyOutputStream& stream);
+        void WriteWithExternalTensors(const std::wstring& filename);
 
 
         bool Read(std::istream& stream, Dictionary& dict);
@@ -171,6 +179,7 @@ namespace CNTK
         Dictionary* CreateFromProto(const proto::Dictionary& src);
         std::vector<DictionaryValue>* CreateFromProto(const proto::Vector& src);
         NDArrayView* CreateFromProto(const proto::NDArrayView& src);
+        NDArrayView* CreateFromProto(const proto::NDArrayView::ExternalValues& src, DataType dataType, StorageFormat storageFormat, const NDShape& shape);
         Axis* CreateFromProto(const proto::Axis& src);
         NDShape* CreateFromProto(const proto::NDShape& src);
 
@@ -231,6 +240,25 @@ namespace CNTK
             return DictionaryValue::Type(type);
         }
 
+        static const void* GetDataBuffer(const NDArrayView& src)
+        {
+            switch (src.GetDataType())
+            {
+            case DataType::Float:
+                return src.DataBuffer<float>();
+            case DataType::Double:
+                return src.DataBuffer<double>();
+            case DataType::Float16:
+                return src.DataBuffer<float16>();
+            case DataType::Int8:
+                return src.DataBuffer<int8_t>();
+            case DataType::Int16:
+                return src.DataBuffer<int16_t>();
+            default:
+                LogicError("Unsupported DataType %s", DataTypeName(src.GetDataType()));
+            }
+        }
+
         template <typename SrcT, typename DstT = SrcT>
         static void CopyData(const NDArrayView& src, RepeatedField<DstT>* dst)
         {
@@ -349,6 +377,10 @@ namespace CNTK
         Message* m_proto;
         std::vector<std::pair<NDArrayView*, proto::NDArrayView*>> m_arrayViews;
         size_t m_byteSize {0};
+
+        // Tensor file of the dictionary that is read, mapped when the first external value is encountered.
+        std::wstring m_tensorsFilename;
+        std::shared_ptr<Microsoft::MSR::CNTK::MemoryMappedFile> m_tensors;
     };
 
 
@@ -536,6 +568,9 @@ namespace CNTK
         std::unique_ptr<NDShape> shape(CreateFromProto(src.shape()));
         auto dataType = FromProtoType(src.data_type());
         auto storageFormat = FromProtoType(src.storage_format());
+        if (src.values_case() == proto::NDArrayView::kExternalValues)
+            return CreateFromProto(src.external_values(), dataType, storageFormat, *shape);
+
         NDArrayView* dst = new NDArrayView(dataType, storageFormat, *shape, DeviceDescriptor::CPUDevice());
 
         if (dataType == DataType::Float)
@@ -576,6 +611,25 @@ namespace CNTK
         return dst;
     }
 
+    NDArrayView* Serializer::CreateFromProto(const proto::NDArrayView::ExternalValues& src, DataType dataType, StorageFormat storageFormat, const NDShape& shape)
+    {
+        if (m_tensorsFilename.empty())
+            RuntimeError("The values of an NDArrayView are stored in the tensor file of the model, such a model can only be loaded from a file.");
+
+        // The values are used in place. Pages of the copy-on-write mapping are shared between all processes
+        // that load the same model, until they are written to (e.g. when a parameter is trained).
+        if (!m_tensors)
+            m_tensors = Microsoft::MSR::CNTK::MemoryMappedFile::OpenOrDie(m_tensorsFilename, /*copyOnWrite=*/true);
+
+        auto size = shape.TotalSize() * DataTypeSize(dataType);
+        if (storageFormat != StorageFormat::Dense || src.size() != size || src.offset() > m_tensors->Size() || m_tensors->Size() - src.offset() < size)
+            RuntimeError("The tensor file '%ls' does not contain the values of an NDArrayView with shape '%S'.", m_tensorsFilename.c_str(), shape.AsString().c_str());
+
+        auto dst = new NDArrayView(dataType, shape, m_tensors->WritableData() + src.offset(), size, DeviceDescriptor::CPUDevice());
+        dst->m_externalStorage = m_tensors;
+        return dst;
+    }
+
     proto::Vector* Serializer::CreateProto(const std::vector<DictionaryValue>& src, Arena* arena)
     {
         proto::Vector* dst = (arena != nullptr) ? 
@@ -778,6 +832,74 @@ namespace CNTK
 #endif
     }
 
+    static void FlushToDisk(const std::wstring& filename)
+    {
+        FILE* f = fopenOrDie(filename, L"r+b");
+        fsyncOrDie(f);
+        fcloseOrDie(f);
+    }
+
+    // Renames the new file over the old one. On Linux the old file is unlinked, its mappings stay valid. On Windows a mapped
+    // file cannot be replaced, nor can its name be reused before the mappings are closed, so it is first renamed aside
+    // and then deleted, which happens once the last mapping is closed.
+    static void ReplaceFile(const std::wstring& from, const std::wstring& to)
+    {
+#ifdef _WIN32
+        static std::atomic<unsigned int> s_replacedFiles(0);
+        auto aside = to + L"." + std::to_wstring(GetCurrentProcessId()) + L"_" + std::to_wstring(s_replacedFiles++) + L".old";
+        if (MoveFileExW(to.c_str(), aside.c_str(), MOVEFILE_REPLACE_EXISTING))
+            DeleteFileW(aside.c_str());
+#endif
+        renameOrDie(from, to);
+    }
+
+    void Serializer::WriteWithExternalTensors(const std::wstring& filename)
+    {
+        static const char padding[TENSOR_ALIGNMENT] = {};
+
+        // Dense values are moved from the protobuf to the tensor file, each one starting at a page boundary,
+        // so that they can be used in place from a mapping of the file.
+        std::vector<std::pair<NDArrayView*, proto::NDArrayView*>> inlineArrayViews;
+
+        // Processes that loaded the model map the tensor file, so both files are written next to the old ones and renamed
+        // over them once they are on the disk; the mappings keep referring to the old contents.
+        auto tensorsFilename = GetExternalTensorsFilename(filename);
+        auto tempTensorsFilename = tensorsFilename + L".tmp";
+        auto tensors = fopenOrDie(tempTensorsFilename, L"wb");
+        uint64 offset = 0;
+        for (auto& pair : m_arrayViews)
+        {
+            const auto& src = *(pair.first);
+            if (src.IsSparse() || src.Shape().TotalSize() == 0)
+            {
+                inlineArrayViews.push_back(pair);
+                continue;
+            }
+
+            auto size = src.Shape().TotalSize() * DataTypeSize(src.GetDataType());
+            auto paddedSize = (size + TENSOR_ALIGNMENT - 1) / TENSOR_ALIGNMENT * TENSOR_ALIGNMENT;
+            fwriteOrDie(GetDataBuffer(src), 1, size, tensors);
+            fwriteOrDie(padding, 1, paddedSize - size, tensors);
+
+            auto external = pair.second->mutable_external_values();
+            external->set_offset(offset);
+            external->set_size(size);
+            offset += paddedSize;
+            m_byteSize -= size;
+        }
+        fflushOrDie(tensors);
+        fsyncOrDie(tensors);
+        fcloseOrDie(tensors);
+
+        m_arrayViews.swap(inlineArrayViews);
+        auto tempFilename = filename + L".tmp";
+        Write(tempFilename);
+        FlushToDisk(tempFilename);
+
+        ReplaceFile(tempTensorsFilename, tensorsFilename);
+        ReplaceFile(tempFilename, filename);
+    }
+
     bool ParseMessage(io::ZeroCopyInputStream& input, Message& msg)
     {
         uint32 prefix = 0, limit = INT_MAX;;
@@ -833,6 +955,7 @@ namespace CNTK
 
     bool Serializer::Read(const std::wstring& filename, Dictionary& dict)
     {
+        m_tensorsFilename = GetExternalTensorsFilename(filename);
         m_proto = Arena::CreateMessage<proto::Dictionary>(&m_arena);
         return Read(filename, [this, &dict](io::ZeroCopyInputStream& input) {
             Copy(*dynamic_cast<proto::Dictionary*>(m_proto), dict);
@@ -842,6 +965,7 @@ namespace CNTK
 
     bool Serializer::Read(const std::wstring& filename, DictionaryValue& value)
     {
+        m_tensorsFilename = GetExternalTensorsFilename(filename);
         m_proto = Arena::CreateMessage<proto::DictionaryValue>(&m_arena);
         return Read(filename, [this, &value](io::ZeroCopyInputStream& input) {
             Copy(*dynamic_cast<proto::DictionaryValue*>(m_proto), value);
@@ -896,6 +1020,11 @@ namespace CNTK
         Serializer(*this).Write(filename);
     }
 
+    void SaveWithExternalTensors(const Dictionary& dictionary, const std::wstring& filename)
+    {
+        Serializer(dictionary).WriteWithExternalTensors(filename);
+    }
+
     std::istream& operator>>(std::istream& stream, Dictionary& dictionary)
     {
         if (!Serializer(dictionary).Read(stream, dictionary)) 
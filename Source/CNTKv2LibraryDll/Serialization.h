@@ -53,6 +53,15 @@ namespace CNTK
     const std::wstring udfFactoryMethodNameKey = L"deserialize_method";
     const std::wstring nativeUDFKey = L"native";
 
+    // Saves the dictionary like Dictionary::Save, except that the values of dense NDArrayViews are stored page-aligned
+    // in a separate tensor file, from which Dictionary::Load maps them into memory instead of copying them.
+    void SaveWithExternalTensors(const Dictionary& dictionary, const std::wstring& filename);
+
+    inline std::wstring GetExternalTensorsFilename(const std::wstring& filename)
+    {
+        return filename + L".tensors";
+    }
+
     template <typename T> 
     inline std::string GetVersionsString(size_t currentVersion, size_t dictVersion)
     {
@@ -0,0 +1,246 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include "ShardedDataParallelDistributedLearner.h"
+#include "PerformanceProfiler.h"
+
+namespace CNTK
+{
+    DistributedLearnerPtr CreateShardedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, const std::vector<Parameter>& parameters, const std::function<LearnerPtr(const std::vector<Parameter>&)>& createLearner)
+    {
+        return MakeSharedObject<ShardedDataParallelDistributedLearner>(communicator, parameters, createLearner);
+    }
+
+    std::vector<size_t> ShardedDataParallelDistributedLearner::PartitionParameters(const std::vector<Parameter>& parameters, size_t numberOfWorkers)
+    {
+        std::vector<size_t> order(parameters.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+            [&parameters](size_t a, size_t b) { return parameters[a].Shape().TotalSize() > parameters[b].Shape().TotalSize(); });
+
+        // Only depends on the order of the parameters, so that all workers compute the same partition.
+        std::vector<size_t> owners(parameters.size());
+        std::vector<size_t> shardSizes(numberOfWorkers, 0);
+        for (auto i : order)
+        {
+            auto owner = std::min_element(shardSizes.begin(), shardSizes.end()) - shardSizes.begin();
+            owners[i] = owner;
+            shardSizes[owner] += parameters[i].Shape().TotalSize();
+        }
+
+        return owners;
+    }
+
+    LearnerPtr ShardedDataParallelDistributedLearner::CreateShardLearner(const DistributedCommunicatorPtr& communicator, const std::vector<Parameter>& parameters, const std::function<LearnerPtr(const std::vector<Parameter>&)>& createLearner)
+    {
+        if (!communicator)
+            InvalidArgument("Communicator of a DistributedLearner cannot be null.");
+
+        if (!createLearner)
+            InvalidArgument("ShardedDataParallelDistributedLearner: the function that creates the learner of a shard cannot be null.");
+
+        auto numberOfWorkers = communicator->Workers().size();
+        if (parameters.size() < numberOfWorkers)
+            InvalidArgument("ShardedDataParallelDistributedLearner: %d parameters cannot be partitioned across %d workers, each worker needs at least one parameter.", (int)parameters.size(), (int)numberOfWorkers);
+
+        for (const auto& parameter : parameters)
+        {
+            if (parameter.GetDataType() != DataType::Float && parameter.GetDataType() != DataType::Double)
+                InvalidArgument("ShardedDataParallelDistributedLearner: parameter '%S' has data type '%s', only float and double parameters are supported.",
+                                parameter.AsString().c_str(), DataTypeName(parameter.GetDataType()));
+        }
+
+        auto owners = PartitionParameters(parameters, numberOfWorkers);
+        auto rank = communicator->CurrentWorker().m_globalRank;
+
+        std::vector<Parameter> shard;
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            if (owners[i] == rank)
+                shard.push_back(parameters[i]);
+        }
+
+        auto learner = createLearner(shard);
+        if (!learner)
+            InvalidArgument("ShardedDataParallelDistributedLearner: the learner created for the shard of worker %d is null.", (int)rank);
+
+        const auto& learnerParameters = learner->Parameters();
+        std::unordered_set<Parameter> shardParameters(shard.begin(), shard.end());
+        if (learnerParameters.size() != shard.size() ||
+            std::any_of(learnerParameters.begin(), learnerParameters.end(), [&shardParameters](const Parameter& p) { return shardParameters.find(p) == shardParameters.end(); }))
+            InvalidArgument("ShardedDataParallelDistributedLearner: the learner created for the shard of worker %d must update exactly the %d parameters of the shard.", (int)rank, (int)shard.size());
+
+        return learner;
+    }
+
+    ShardedDataParallelDistributedLearner::ShardedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, const std::vector<Parameter>& parameters, const std::function<LearnerPtr(const std::vector<Parameter>&)>& createLearner)
+        : DistributedLearnerBase(communicator, CreateShardLearner(communicator, parameters, createLearner), /*distributeAfterSamples*/ 0),
+          m_shardParameters(m_learner->Parameters().begin(), m_learner->Parameters().end()),
+          m_shards(2, std::vector<std::vector<Parameter>>(communicator->Workers().size())),
+          m_packed(2),
+          m_gathered(2)
+    {
+        // The distributed learner is responsible for all parameters, the local learner only for those of its shard.
+        Learner::m_parameters = parameters;
+
+        auto owners = PartitionParameters(parameters, communicator->Workers().size());
+        for (size_t i = 0; i < parameters.size(); ++i)
+            m_shards[parameters[i].GetDataType() == DataType::Float ? 0 : 1][owners[i]].push_back(parameters[i]);
+    }
+
+    template <typename ElementType>
+    void ShardedDataParallelDistributedLearner::AllGatherParameters(size_t bufferIndex)
+    {
+        const auto& shards = m_shards[bufferIndex];
+
+        // Shards are padded to the size of the largest one, the allgather requires the same size on all workers.
+        size_t packedSize = 0;
+        for (const auto& shard : shards)
+        {
+            size_t shardSize = 0;
+            for (const auto& parameter : shard)
+                shardSize += parameter.Shape().TotalSize();
+            packedSize = std::max(packedSize, shardSize);
+        }
+
+        if (packedSize == 0)
+            return;
+
+        auto& packed = m_packed[bufferIndex];
+        if (!packed)
+            packed = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), NDShape{ packedSize }, DeviceDescriptor::CPUDevice());
+
+        auto rank = m_communicator->CurrentWorker().m_globalRank;
+        auto packedData = packed->WritableDataBuffer<ElementType>();
+        for (const auto& parameter : shards[rank])
+        {
+            auto size = parameter.Shape().TotalSize();
+            MakeSharedObject<NDArrayView>(parameter.Shape(), packedData, size, DeviceDescriptor::CPUDevice())->CopyFrom(*parameter.Value());
+            packedData += size;
+        }
+
+        std::vector<NDArrayViewPtr> gathered{ m_gathered[bufferIndex] };
+        m_communicator->Concatenate(std::vector<NDArrayViewPtr>{ packed }, gathered, m_communicator->Workers());
+        m_gathered[bufferIndex] = gathered.front();
+
+        for (size_t worker = 0; worker < shards.size(); ++worker)
+        {
+            if (worker == rank)
+                continue;
+
+            auto gatheredData = m_gathered[bufferIndex]->WritableDataBuffer<ElementType>() + worker * packedSize;
+            for (const auto& parameter : shards[worker])
+            {
+                auto size = parameter.Shape().TotalSize();
+                parameter.Value()->CopyFrom(*MakeSharedObject<NDArrayView>(parameter.Shape(), gatheredData, size, DeviceDescriptor::CPUDevice(), /*readOnly*/ true));
+                gatheredData += size;
+
+                auto paramRef = parameter;
+                paramRef.RecordValueUpdate();
+            }
+        }
+    }
+
+    bool ShardedDataParallelDistributedLearner::Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info)
+    {
+        std::unordered_map<Parameter, NDArrayViewPtr> shardGradientValues;
+        {
+#ifndef CNTK_UWP
+            auto profGradientAgg = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainGradient);
+#endif
+
+            if (info.IsEmpty())
+                PrepaireZeroGradients(gradientValues);
+
+            // Gradients are aggregated in the order of the parameters, which is the same on all workers.
+            std::vector<NDArrayViewPtr> valuesToAggregate;
+            for (const auto& parameter : Parameters())
+            {
+                auto gradient = gradientValues.find(parameter);
+                if (gradient == gradientValues.end())
+                    InvalidArgument("ShardedDataParallelDistributedLearner: no gradient was provided for parameter '%S'.", parameter.AsString().c_str());
+
+                auto value = gradient->second;
+                if (value->GetStorageFormat() != StorageFormat::Dense)
+                {
+                    auto dense = MakeSharedObject<NDArrayView>(0, value->GetDataType(), value->Shape(), value->Device());
+                    dense->CopyFrom(*value);
+                    value = dense;
+                }
+                valuesToAggregate.push_back(value);
+
+                if (m_shardParameters.find(parameter) != m_shardParameters.end())
+                    shardGradientValues[parameter] = value;
+            }
+
+            valuesToAggregate.push_back(info.evalCriterionValue);
+            valuesToAggregate.push_back(info.trainingLossValue);
+
+            auto value = MakeSharedObject<NDArrayView>(static_cast<double>(info.numberOfSamples), NDShape{}, DeviceDescriptor::CPUDevice());
+            valuesToAggregate.push_back(value);
+
+            m_communicator->AggregateInPlace(valuesToAggregate, m_communicator->Workers());
+            info.numberOfSamples = static_cast<size_t>(*valuesToAggregate.back()->DataBuffer<double>());
+        }
+
+#ifndef CNTK_UWP
+        auto profWeights = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainWeights);
+#endif
+
+        m_sampleCount += info.numberOfSamples;
+        if (info.IsEmpty())
+            return false;
+
+        // All workers take the same decision, so either all or none of them take part in the allgather.
+        auto updated = m_learner->Update(shardGradientValues, info.numberOfSamples, info.atEndOfSweep);
+        if (updated)
+        {
+            AllGatherParameters<float>(0);
+            AllGatherParameters<double>(1);
+        }
+
+        return updated;
+    }
+
+    Dictionary ShardedDataParallelDistributedLearner::CreateCheckpoint()
+    {
+        // The state of the learners of all shards is collected on the main worker, which writes the checkpoint.
+        Dictionary shardCheckpoint;
+        shardCheckpoint[L"learner"] = m_learner->CreateCheckpoint();
+
+        std::vector<DictionaryPtr> gathered;
+        m_communicator->Gather(shardCheckpoint, gathered, m_communicator->Workers());
+
+        Dictionary result;
+        if (m_communicator->CurrentWorker().IsMain())
+        {
+            std::vector<DictionaryValue> shardLearners;
+            for (const auto& checkpoint : gathered)
+                shardLearners.push_back((*checkpoint)[L"learner"]);
+            result[L"shardLearners"] = shardLearners;
+        }
+
+        result[L"totalNumberOfSamplesSeen"] = m_sampleCount;
+        return result;
+    }
+
+    void ShardedDataParallelDistributedLearner::RestoreFromCheckpoint(const Dictionary& checkpoint)
+    {
+        if (!checkpoint.Contains(L"shardLearners"))
+            InvalidArgument("ShardedDataParallelDistributedLearner: the checkpoint does not contain the state of the shards, it must be the one created on the main worker.");
+
+        const auto& shardLearners = checkpoint[L"shardLearners"].Value<std::vector<DictionaryValue>>();
+        if (shardLearners.size() != m_communicator->Workers().size())
+            InvalidArgument("ShardedDataParallelDistributedLearner: the checkpoint has been created with %d workers and cannot be restored with %d workers.",
+                            (int)shardLearners.size(), (int)m_communicator->Workers().size());
+
+        m_learner->RestoreFromCheckpoint(shardLearners[m_communicator->CurrentWorker().m_globalRank].Value<Dictionary>());
+        m_sampleCount = checkpoint[L"totalNumberOfSamplesSeen"].Value<size_t>();
+    }
+}
@@ -0,0 +1,57 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <functional>
+#include <unordered_set>
+#include <vector>
+#include "CNTKLibrary.h"
+#include "DistributedLearnerBase.h"
+
+namespace CNTK
+{
+    ///
+    /// Data parallel distributed learner that partitions the optimizer state across the workers.
+    /// The parameters are split into one shard per worker; each worker keeps a local learner, and with it the
+    /// smoothed gradients, only for the parameters of its shard. After the gradients have been aggregated every
+    /// worker updates its shard, and the updated values are exchanged with an allgather so that all workers
+    /// continue with the complete model. The checkpoint contains the state of the learners of all shards.
+    ///
+    class ShardedDataParallelDistributedLearner : public DistributedLearnerBase
+    {
+    public:
+        ShardedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, const std::vector<Parameter>& parameters, const std::function<LearnerPtr(const std::vector<Parameter>&)>& createLearner);
+
+        // Optional override that gets called per minibatch after finishing gradient computation but before updating model parameters
+        bool Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info) override;
+
+        // Optionally overridable method to get checkpoint state associated with this Distributed train method
+        Dictionary CreateCheckpoint() override;
+
+        // Optionally overridable method to restore state pertaining this distributed training method from a previous checkpoint
+        void RestoreFromCheckpoint(const Dictionary& checkpoint) override;
+
+    private:
+        // Assigns each parameter to a worker: the largest parameters first, each to the worker with the fewest elements so far.
+        static std::vector<size_t> PartitionParameters(const std::vector<Parameter>& parameters, size_t numberOfWorkers);
+
+        static LearnerPtr CreateShardLearner(const DistributedCommunicatorPtr& communicator, const std::vector<Parameter>& parameters, const std::function<LearnerPtr(const std::vector<Parameter>&)>& createLearner);
+
+        // Exchanges the updated values of the parameters of the given type between the workers.
+        template <typename ElementType>
+        void AllGatherParameters(size_t bufferIndex);
+
+        // Parameters updated by the learner of this worker.
+        std::unordered_set<Parameter> m_shardParameters;
+
+        // Parameters of the shard of each worker, for float and double parameters.
+        std::vector<std::vector<std::vector<Parameter>>> m_shards;
+
+        // Packed values of the shard of this worker and of all workers, for float and double parameters.
+        std::vector<NDArrayViewPtr> m_packed;
+        std::vector<NDArrayViewPtr> m_gathered;
+    };
+}
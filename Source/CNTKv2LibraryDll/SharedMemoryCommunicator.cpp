@@ -0,0 +1,683 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+
+#ifndef _WIN32
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "SharedMemoryCommunicator.h"
+
+namespace CNTK
+{
+    static const uint64_t s_sharedMemoryMagic = 0x4d4853534b544e43; // "CNTKSSHM"
+
+    // Chunks are aligned to cache lines, so that workers do not write into the same line.
+    static const size_t s_cacheLineSizeInBytes = 64;
+
+    // How long workers wait for each other to attach to the segment, and in a collective operation. Workers that are gone
+    // are detected earlier; the timeouts only catch workers that are alive but never arrive.
+    static const int s_attachTimeoutInSeconds = 120;
+    static const int s_collectiveTimeoutInSeconds = 1800;
+
+    struct SharedMemoryCommunicatorImpl::Header
+    {
+        uint64_t m_magic;
+        uint64_t m_numberOfWorkers;
+        uint64_t m_slotSizeInBytes;
+        uint64_t m_creatorProcessId;
+
+        // Set by the worker 0 after it has initialized the header.
+        std::atomic<uint32_t> m_initialized;
+        std::atomic<uint32_t> m_attached;
+
+        // Number of workers that have destroyed their communicator.
+        std::atomic<uint32_t> m_detached;
+
+        // Barrier state: the last worker to arrive resets the count and advances the generation.
+        alignas(s_cacheLineSizeInBytes) std::atomic<uint32_t> m_barrierCount;
+        alignas(s_cacheLineSizeInBytes) std::atomic<uint32_t> m_barrierGeneration;
+    };
+
+    static size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static bool IsProcessAlive(uint64_t processId)
+    {
+        return kill((pid_t)processId, 0) == 0 || errno == EPERM;
+    }
+
+    // Whether the name still refers to the segment that is open as fd; the worker 0 of a new run replaces a stale segment.
+    static bool IsNamedSegment(const std::string& name, int fd)
+    {
+        int namedFd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (namedFd < 0)
+            return false;
+
+        struct stat named, opened;
+        bool same = fstat(namedFd, &named) == 0 && fstat(fd, &opened) == 0 && named.st_dev == opened.st_dev && named.st_ino == opened.st_ino;
+        close(namedFd);
+        return same;
+    }
+
+    DistributedCommunicatorPtr SharedMemoryCommunicator(const std::wstring& name, size_t numberOfWorkers, size_t workerRank, size_t bufferSizeInBytes)
+    {
+        return std::make_shared<SharedMemoryCommunicatorImpl>(name, numberOfWorkers, workerRank, bufferSizeInBytes);
+    }
+
+    SharedMemoryCommunicatorImpl::SharedMemoryCommunicatorImpl(const std::wstring& name, size_t numberOfWorkers, size_t workerRank, size_t bufferSizeInBytes)
+        : m_communicatorName(name),
+          m_numberOfWorkers(numberOfWorkers),
+          m_rank(workerRank),
+          m_segment(nullptr),
+          m_segmentSizeInBytes(0),
+          m_header(nullptr),
+          m_exchangeSizes(nullptr),
+          m_processIds(nullptr),
+          m_slots(nullptr)
+    {
+        if (name.empty() || name.find(L'/') != std::wstring::npos)
+            InvalidArgument("SharedMemoryCommunicator: Name '%S' must be non empty and must not contain '/'.", name.c_str());
+
+        if (numberOfWorkers == 0 || workerRank >= numberOfWorkers)
+            InvalidArgument("SharedMemoryCommunicator: Worker rank '%d' must be less than the number of workers '%d'.", (int)workerRank, (int)numberOfWorkers);
+
+        // Each slot has to hold at least a cache line per worker to be split into chunks.
+        m_slotSizeInBytes = AlignUp(std::max(bufferSizeInBytes / numberOfWorkers, numberOfWorkers * s_cacheLineSizeInBytes), s_cacheLineSizeInBytes);
+
+        size_t headerSize = AlignUp(sizeof(Header), s_cacheLineSizeInBytes);
+        size_t exchangeSizesSize = AlignUp(numberOfWorkers * sizeof(uint64_t), s_cacheLineSizeInBytes);
+        size_t processIdsSize = AlignUp(numberOfWorkers * sizeof(std::atomic<uint64_t>), s_cacheLineSizeInBytes);
+        m_segmentSizeInBytes = headerSize + exchangeSizesSize + processIdsSize + numberOfWorkers * m_slotSizeInBytes;
+
+        // Segments are named per user and job, the name given by the caller identifies the job.
+        m_name = "/cntk_" + std::to_string(getuid()) + "_" + std::string(name.begin(), name.end());
+
+        // The worker 0 creates the segment, dropping a stale one left behind by a crashed run, the others open it.
+        int fd = -1;
+        if (m_rank == 0)
+        {
+            if (shm_unlink(m_name.c_str()) == 0 && GetTraceLevel() >= TraceLevel::Info)
+                fprintf(stderr, "SharedMemoryCommunicator: Removed stale shared memory segment '%s' of a previous run.\n", m_name.c_str());
+
+            fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+            if (fd < 0)
+                RuntimeError("SharedMemoryCommunicator: Cannot create shared memory segment '%s': %s.", m_name.c_str(), strerror(errno));
+
+            if (ftruncate(fd, m_segmentSizeInBytes) != 0)
+            {
+                close(fd);
+                shm_unlink(m_name.c_str());
+                RuntimeError("SharedMemoryCommunicator: Cannot resize shared memory segment '%s' to '%d' bytes: %s.", m_name.c_str(), (int)m_segmentSizeInBytes, strerror(errno));
+            }
+        }
+        else
+            fd = AttachToSegment();
+
+        if (!m_segment)
+        {
+            m_segment = mmap(nullptr, m_segmentSizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (m_segment == MAP_FAILED)
+            {
+                m_segment = nullptr;
+                close(fd);
+                shm_unlink(m_name.c_str());
+                RuntimeError("SharedMemoryCommunicator: Cannot map shared memory segment '%s': %s.", m_name.c_str(), strerror(errno));
+            }
+        }
+        close(fd);
+
+        m_header = reinterpret_cast<Header*>(m_segment);
+        m_exchangeSizes = reinterpret_cast<uint64_t*>(reinterpret_cast<char*>(m_segment) + headerSize);
+        m_processIds = reinterpret_cast<std::atomic<uint64_t>*>(reinterpret_cast<char*>(m_segment) + headerSize + exchangeSizesSize);
+        m_slots = reinterpret_cast<char*>(m_segment) + headerSize + exchangeSizesSize + processIdsSize;
+
+        // The new segment is zero filled, only the header is touched here; slot pages are first touched by their owners.
+        if (m_rank == 0)
+        {
+            m_header->m_magic = s_sharedMemoryMagic;
+            m_header->m_numberOfWorkers = m_numberOfWorkers;
+            m_header->m_slotSizeInBytes = m_slotSizeInBytes;
+            m_header->m_creatorProcessId = (uint64_t)getpid();
+            m_header->m_initialized.store(1, std::memory_order_release);
+        }
+        else if (m_header->m_magic != s_sharedMemoryMagic || m_header->m_numberOfWorkers != m_numberOfWorkers || m_header->m_slotSizeInBytes != m_slotSizeInBytes)
+        {
+            RuntimeError("SharedMemoryCommunicator: Shared memory segment '%s' was created with a different configuration, all workers must use the same number of workers and buffer size.",
+                         m_name.c_str());
+        }
+
+        // Once everybody is attached the name is not needed anymore, the mapping stays valid.
+        m_processIds[m_rank].store((uint64_t)getpid(), std::memory_order_relaxed);
+        m_header->m_attached.fetch_add(1, std::memory_order_acq_rel);
+        WaitUntil([this]() { return m_header->m_attached.load(std::memory_order_acquire) >= m_numberOfWorkers; }, s_attachTimeoutInSeconds, "the attach");
+
+        Barrier();
+        if (m_rank == 0)
+            shm_unlink(m_name.c_str());
+
+        char hostName[256] = {};
+        gethostname(hostName, sizeof(hostName) - 1);
+        std::string host(hostName);
+        for (size_t i = 0; i < m_numberOfWorkers; ++i)
+            m_workers.insert(DistributedWorkerDescriptor{ i, std::wstring(host.begin(), host.end()) });
+        m_currentWorker = DistributedWorkerDescriptor{ m_rank, std::wstring(host.begin(), host.end()) };
+    }
+
+    int SharedMemoryCommunicatorImpl::AttachToSegment()
+    {
+        // A segment is stale if the process of the worker 0 that created it is gone, or if the worker 0 of this run has
+        // replaced it with a new segment of the same name before initializing the new one. Stale segments are skipped,
+        // only the worker 0 unlinks them, since the name may already refer to the segment of this run.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(s_attachTimeoutInSeconds);
+        for (;;)
+        {
+            int fd = shm_open(m_name.c_str(), O_RDWR, 0);
+            struct stat info;
+            if (fd >= 0 && fstat(fd, &info) == 0 && (size_t)info.st_size == m_segmentSizeInBytes)
+            {
+                void* segment = mmap(nullptr, m_segmentSizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (segment != MAP_FAILED)
+                {
+                    auto header = reinterpret_cast<Header*>(segment);
+                    while (header->m_initialized.load(std::memory_order_acquire) == 0 && IsNamedSegment(m_name, fd) &&
+                           std::chrono::steady_clock::now() <= deadline)
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+
+                    if (header->m_initialized.load(std::memory_order_acquire) != 0 && IsProcessAlive(header->m_creatorProcessId))
+                    {
+                        m_segment = segment;
+                        return fd;
+                    }
+
+                    munmap(segment, m_segmentSizeInBytes);
+                }
+            }
+
+            if (fd >= 0)
+                close(fd);
+
+            if (std::chrono::steady_clock::now() > deadline)
+                RuntimeError("SharedMemoryCommunicator: Timed out waiting for the worker 0 to create shared memory segment '%s' of '%d' bytes.",
+                             m_name.c_str(), (int)m_segmentSizeInBytes);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    SharedMemoryCommunicatorImpl::~SharedMemoryCommunicatorImpl()
+    {
+        if (m_segment)
+        {
+            // Lets the other workers fail rather than wait for this one in a collective operation.
+            if (m_header)
+                m_header->m_detached.fetch_add(1, std::memory_order_acq_rel);
+            munmap(m_segment, m_segmentSizeInBytes);
+        }
+    }
+
+    template <typename Predicate>
+    void SharedMemoryCommunicatorImpl::WaitUntil(const Predicate& done, int timeoutInSeconds, const char* operation)
+    {
+        // Workers are expected to arrive at about the same time, spin for a while before giving up the core.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeoutInSeconds);
+        for (size_t spins = 1; !done(); ++spins)
+        {
+            if (spins <= 1024)
+                continue;
+
+            std::this_thread::yield();
+            if (spins % 1024 != 0)
+                continue;
+
+            // A worker detaches or exits only after it has made its last change to the segment, so 'done' is checked
+            // again after a missing worker has been seen.
+            std::string error;
+            if (m_header->m_detached.load(std::memory_order_acquire) != 0)
+                error = "a worker has destroyed its communicator";
+
+            for (size_t i = 0; i < m_numberOfWorkers && error.empty(); ++i)
+            {
+                auto processId = m_processIds[i].load(std::memory_order_relaxed);
+                if (processId != 0 && !IsProcessAlive(processId))
+                    error = "the process of worker " + std::to_string(i) + " has exited";
+            }
+
+            if (error.empty() && std::chrono::steady_clock::now() > deadline)
+                error = "timed out after " + std::to_string(timeoutInSeconds) + " seconds";
+
+            if (!error.empty() && !done())
+                RuntimeError("SharedMemoryCommunicator: Worker '%d' cannot complete %s on shared memory segment '%s': %s.",
+                             (int)m_rank, operation, m_name.c_str(), error.c_str());
+        }
+    }
+
+    void SharedMemoryCommunicatorImpl::Barrier()
+    {
+        auto generation = m_header->m_barrierGeneration.load(std::memory_order_acquire);
+        if (m_header->m_barrierCount.fetch_add(1, std::memory_order_acq_rel) + 1 == m_numberOfWorkers)
+        {
+            m_header->m_barrierCount.store(0, std::memory_order_relaxed);
+            m_header->m_barrierGeneration.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+
+        WaitUntil([this, generation]() { return m_header->m_barrierGeneration.load(std::memory_order_acquire) != generation; }, s_collectiveTimeoutInSeconds, "a barrier");
+    }
+
+    void SharedMemoryCommunicatorImpl::CheckWorkers(const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        // Currently all operations should be executed on all workers, we do not support subgroups.
+        if (sendToWorkers != m_workers)
+            NOT_IMPLEMENTED;
+    }
+
+    // Has to be called by all workers of the subgroup, like the constructor of a communicator.
+    DistributedCommunicatorPtr SharedMemoryCommunicatorImpl::SubGroup(const std::unordered_set<DistributedWorkerDescriptor>& subGroupWorkers) const
+    {
+        std::vector<size_t> ranks;
+        for (const auto& worker : subGroupWorkers)
+        {
+            if (m_workers.find(worker) == m_workers.end())
+                InvalidArgument("SharedMemoryCommunicator: Worker '%d' of the subgroup is not a worker of this communicator.", (int)worker.m_globalRank);
+            ranks.push_back(worker.m_globalRank);
+        }
+
+        std::sort(ranks.begin(), ranks.end());
+        auto rank = std::find(ranks.begin(), ranks.end(), m_rank);
+        if (rank == ranks.end())
+            InvalidArgument("SharedMemoryCommunicator: The current worker '%d' is not a worker of the subgroup.", (int)m_rank);
+
+        // The subgroup gets the slot size of this communicator and a segment named after its workers.
+        std::wstring name = m_communicatorName + L"_group";
+        for (auto r : ranks)
+            name += L"_" + std::to_wstring(r);
+
+        return std::make_shared<SharedMemoryCommunicatorImpl>(name, ranks.size(), rank - ranks.begin(), m_slotSizeInBytes * ranks.size());
+    }
+
+    // Values are concatenated along their last axis, i.e. the batch axis; currently only values of the same shape are supported.
+    // The data is exchanged through CPU copies; the outputs are located on the devices of the values.
+    void SharedMemoryCommunicatorImpl::Concatenate(const std::vector<ValuePtr>& values, std::vector<ValuePtr>& outputValues, const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        CheckWorkers(sendToWorkers);
+
+        outputValues.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const auto& value = values[i];
+            const auto& shape = value->Shape();
+            if (value->GetStorageFormat() != StorageFormat::Dense)
+                RuntimeError("SharedMemoryCommunicator: Concatenation of sparse values is currently not supported.");
+
+            if (shape.Rank() == 0)
+                InvalidArgument("SharedMemoryCommunicator: Cannot concatenate values without axes.");
+
+            NDShape outputShape = shape;
+            outputShape[shape.Rank() - 1] *= m_numberOfWorkers;
+
+            std::vector<NDArrayViewPtr> concatenated;
+            Concatenate(std::vector<NDArrayViewPtr>{ value->Data()->DeepClone(DeviceDescriptor::CPUDevice(), /*readOnly=*/ true) }, concatenated, sendToWorkers);
+            auto outputData = MakeSharedObject<NDArrayView>(value->GetDataType(), outputShape, value->Device());
+            outputData->CopyFrom(*concatenated.front()->AsShape(outputShape));
+
+            // The masks are sent with their rank in front; values without a mask send nothing, all their steps are valid.
+            std::string mask;
+            if (auto valueMask = value->Mask())
+            {
+                auto cpuMask = valueMask->DeepClone(DeviceDescriptor::CPUDevice());
+                mask.push_back((char)cpuMask->Shape().Rank());
+                mask.append(reinterpret_cast<const char*>(cpuMask->DataBuffer()), cpuMask->Shape().TotalSize());
+            }
+
+            std::vector<std::string> masks(m_numberOfWorkers);
+            Exchange(mask.data(), mask.size(), [&](size_t rank, size_t, const char* data, size_t size)
+            {
+                masks[rank].append(data, size);
+            });
+
+            auto maskedWorker = std::find_if(masks.begin(), masks.end(), [](const std::string& m) { return !m.empty(); });
+            if (maskedWorker == masks.end())
+            {
+                outputValues[i] = MakeSharedObject<Value>(outputData);
+                continue;
+            }
+
+            size_t maskRank = (size_t)(*maskedWorker)[0];
+            if (maskRank == 0 || maskRank > shape.Rank())
+                LogicError("SharedMemoryCommunicator: A mask of rank '%d' cannot be concatenated.", (int)maskRank);
+
+            NDShape maskShape = outputShape.SubShape(outputShape.Rank() - maskRank);
+            size_t stepsPerWorker = maskShape.TotalSize() / m_numberOfWorkers;
+            size_t lastAxisDimension = shape[shape.Rank() - 1];
+            auto outputMask = MakeSharedObject<NDMask>(maskShape, DeviceDescriptor::CPUDevice());
+            for (size_t rank = 0; rank < m_numberOfWorkers; ++rank)
+            {
+                const auto& workerMask = masks[rank];
+                if (workerMask.empty())
+                {
+                    // Without a mask the sequences start in the first step.
+                    if (maskRank > 1)
+                    {
+                        std::vector<size_t> offset(maskRank, 0);
+                        offset.back() = rank * lastAxisDimension;
+                        NDShape section = maskShape;
+                        section[0] = 1;
+                        section[maskRank - 1] = lastAxisDimension;
+                        outputMask->MarkSequenceBegin(offset, section);
+                    }
+                    continue;
+                }
+
+                if (workerMask.size() != stepsPerWorker + 1 || (size_t)workerMask[0] != maskRank)
+                    LogicError("SharedMemoryCommunicator: Currently only concatenation of values of the same shape is supported.");
+
+                for (size_t step = 0; step < stepsPerWorker; ++step)
+                {
+                    auto kind = (MaskKind)workerMask[step + 1];
+                    if (kind == MaskKind::Valid)
+                        continue;
+
+                    // Index of the step in the mask of the worker, the concatenated mask is shifted along the last axis.
+                    std::vector<size_t> offset(maskRank);
+                    size_t index = step;
+                    for (size_t axis = 0; axis < maskRank; ++axis)
+                    {
+                        size_t dimension = (axis + 1 == maskRank) ? lastAxisDimension : maskShape[axis];
+                        offset[axis] = index % dimension;
+                        index /= dimension;
+                    }
+                    offset.back() += rank * lastAxisDimension;
+
+                    if (kind == MaskKind::Invalid)
+                        outputMask->InvalidateSection(offset, NDShape(maskRank, 1));
+                    else
+                        outputMask->MarkSequenceBegin(offset);
+                }
+            }
+
+            outputValues[i] = MakeSharedObject<Value>(outputData, value->Device() == DeviceDescriptor::CPUDevice() ? outputMask : outputMask->DeepClone(value->Device()));
+        }
+    }
+
+    void SharedMemoryCommunicatorImpl::Exchange(const char* data, size_t size, const std::function<void(size_t rank, size_t offset, const char* data, size_t size)>& receive)
+    {
+        m_exchangeSizes[m_rank] = size;
+        Barrier();
+
+        size_t maxSize = 0;
+        std::vector<size_t> sizes(m_numberOfWorkers);
+        for (size_t i = 0; i < m_numberOfWorkers; ++i)
+        {
+            sizes[i] = m_exchangeSizes[i];
+            maxSize = std::max(maxSize, sizes[i]);
+        }
+
+        for (size_t offset = 0; offset < maxSize; offset += m_slotSizeInBytes)
+        {
+            if (offset < size)
+                memcpy(Slot(m_rank), data + offset, std::min(m_slotSizeInBytes, size - offset));
+            Barrier();
+
+            for (size_t i = 0; i < m_numberOfWorkers; ++i)
+            {
+                if (offset < sizes[i])
+                    receive(i, offset, Slot(i), std::min(m_slotSizeInBytes, sizes[i] - offset));
+            }
+            Barrier();
+        }
+
+        // Sizes can only be overwritten after everybody has read them.
+        if (maxSize == 0)
+            Barrier();
+    }
+
+    void SharedMemoryCommunicatorImpl::Concatenate(const std::vector<NDArrayViewPtr>& input, std::vector<NDArrayViewPtr>& output, const std::unordered_set<DistributedWorkerDescriptor>& workers)
+    {
+        CheckWorkers(workers);
+
+        auto nonCpu = std::find_if(input.begin(), input.end(), [](const NDArrayViewPtr& v) { return v->Device() != DeviceDescriptor::CPUDevice(); });
+        if (nonCpu != input.end())
+            LogicError("SharedMemoryCommunicator: Currently only NDArrayViews located on CPU are supported for concatenation.");
+
+        // Currently we only support concatenation of inputs of the same size.
+        output.resize(input.size());
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            if (output[i] == nullptr ||
+                output[i]->Shape().TotalSize() != m_numberOfWorkers * input[i]->Shape().TotalSize() ||
+                output[i]->GetDataType() != input[i]->GetDataType())
+            {
+                output[i] = std::make_shared<NDArrayView>(input[i]->GetDataType(), NDShape{ input[i]->Shape().TotalSize() * m_numberOfWorkers }, DeviceDescriptor::CPUDevice());
+            }
+
+            const char* source = nullptr;
+            char* destination = nullptr;
+            if (input[i]->GetDataType() == DataType::Float)
+            {
+                source = reinterpret_cast<const char*>(input[i]->DataBuffer<float>());
+                destination = reinterpret_cast<char*>(output[i]->WritableDataBuffer<float>());
+            }
+            else if (input[i]->GetDataType() == DataType::Double)
+            {
+                source = reinterpret_cast<const char*>(input[i]->DataBuffer<double>());
+                destination = reinterpret_cast<char*>(output[i]->WritableDataBuffer<double>());
+            }
+            else
+                LogicError("SharedMemoryCommunicator: input DataType is not supported.");
+
+            size_t sizeInBytes = input[i]->Shape().TotalSize() * DataTypeSize(input[i]->GetDataType());
+            Exchange(source, sizeInBytes, [&](size_t rank, size_t offset, const char* data, size_t size)
+            {
+                if (offset + size > sizeInBytes)
+                    LogicError("SharedMemoryCommunicator: Currently only concatenation of inputs of the same size is supported.");
+                memcpy(destination + rank * sizeInBytes + offset, data, size);
+            });
+        }
+    }
+
+    void SharedMemoryCommunicatorImpl::Gather(
+        const Dictionary& input,
+        std::vector<std::shared_ptr<Dictionary>>& output,
+        const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        CheckWorkers(sendToWorkers);
+
+        std::stringstream dict;
+        dict << input;
+        std::string encoded = dict.str();
+
+        // Only the main worker receives the dictionaries.
+        std::vector<std::string> gathered(m_numberOfWorkers);
+        Exchange(encoded.data(), encoded.size(), [&](size_t rank, size_t, const char* data, size_t size)
+        {
+            if (m_rank == 0)
+                gathered[rank].append(data, size);
+        });
+
+        if (m_rank != 0)
+            return;
+
+        output.resize(m_numberOfWorkers);
+        for (size_t i = 0; i < m_numberOfWorkers; ++i)
+        {
+            std::stringstream ss(gathered[i]);
+            output[i] = std::make_shared<Dictionary>();
+            ss >> *output[i];
+        }
+    }
+
+    // Sums 'count' elements of all sources into the destination. Simple loops over restrict pointers are vectorized by the compiler;
+    // the data is processed in blocks that stay in the L1 cache while all sources are added.
+    template <typename ElementType>
+    static void SumInto(ElementType* __restrict destination, const std::vector<const ElementType*>& sources, size_t count)
+    {
+        const size_t blockSize = 4096 / sizeof(ElementType);
+        for (size_t begin = 0; begin < count; begin += blockSize)
+        {
+            size_t end = std::min(count, begin + blockSize);
+            for (auto source : sources)
+            {
+                const ElementType* __restrict s = source;
+                for (size_t i = begin; i < end; ++i)
+                    destination[i] += s[i];
+            }
+        }
+    }
+
+    template <typename ElementType>
+    void SharedMemoryCommunicatorImpl::AggregateImpl(const std::vector<NDArrayViewPtr>& values)
+    {
+        size_t totalCount = 0;
+        for (const auto& value : values)
+            totalCount += value->Shape().TotalSize();
+
+        const size_t slotCount = m_slotSizeInBytes / sizeof(ElementType);
+        const size_t alignment = s_cacheLineSizeInBytes / sizeof(ElementType);
+
+        // Values are processed as one contiguous sequence in windows of the slot size.
+        for (size_t windowBegin = 0; windowBegin < totalCount; windowBegin += slotCount)
+        {
+            size_t windowCount = std::min(slotCount, totalCount - windowBegin);
+
+            // Packing the local part of the window into the own slot.
+            auto slot = reinterpret_cast<ElementType*>(Slot(m_rank));
+            size_t valueBegin = 0;
+            for (const auto& value : values)
+            {
+                size_t count = value->Shape().TotalSize();
+                size_t begin = std::max(valueBegin, windowBegin), end = std::min(valueBegin + count, windowBegin + windowCount);
+                if (begin < end)
+                    memcpy(slot + (begin - windowBegin), value->DataBuffer<ElementType>() + (begin - valueBegin), (end - begin) * sizeof(ElementType));
+                valueBegin += count;
+            }
+            Barrier();
+
+            // Reduce-scatter: the chunk of this worker is summed into its own slot.
+            auto chunkBegin = [&](size_t rank) { return std::min(windowCount, AlignUp(windowCount * rank / m_numberOfWorkers, alignment)); };
+            size_t begin = chunkBegin(m_rank), end = chunkBegin(m_rank + 1);
+            if (begin < end)
+            {
+                std::vector<const ElementType*> sources;
+                for (size_t i = 0; i < m_numberOfWorkers; ++i)
+                {
+                    if (i != m_rank)
+                        sources.push_back(reinterpret_cast<const ElementType*>(Slot(i)) + begin);
+                }
+                SumInto(slot + begin, sources, end - begin);
+            }
+            Barrier();
+
+            // Allgather: reduced chunks are copied from the slots of their owners.
+            valueBegin = 0;
+            for (const auto& value : values)
+            {
+                size_t count = value->Shape().TotalSize();
+                for (size_t owner = 0; owner < m_numberOfWorkers; ++owner)
+                {
+                    size_t ownerBegin = windowBegin + chunkBegin(owner), ownerEnd = windowBegin + chunkBegin(owner + 1);
+                    size_t copyBegin = std::max(valueBegin, ownerBegin), copyEnd = std::min(valueBegin + count, ownerEnd);
+                    if (copyBegin < copyEnd)
+                        memcpy(value->WritableDataBuffer<ElementType>() + (copyBegin - valueBegin),
+                               reinterpret_cast<const ElementType*>(Slot(owner)) + (copyBegin - windowBegin),
+                               (copyEnd - copyBegin) * sizeof(ElementType));
+                }
+                valueBegin += count;
+            }
+
+            // Slots can only be overwritten after everybody has read them.
+            Barrier();
+        }
+    }
+
+    void SharedMemoryCommunicatorImpl::AggregateInPlace(
+        const std::vector<NDArrayViewPtr>& values,
+        const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        CheckWorkers(sendToWorkers);
+
+        if (m_numberOfWorkers == 1) // No need to aggregate anything.
+            return;
+
+        // Values on other devices are aggregated through CPU copies.
+        std::vector<NDArrayViewPtr> floatValues, doubleValues;
+        std::vector<std::pair<NDArrayViewPtr, NDArrayViewPtr>> copies;
+        for (const auto& value : values)
+        {
+            if (value->GetStorageFormat() != StorageFormat::Dense)
+                RuntimeError("SharedMemoryCommunicator: Aggregation for sparse matrices is currently not supported.");
+
+            auto cpuValue = value;
+            if (value->Device() != DeviceDescriptor::CPUDevice())
+            {
+                cpuValue = MakeSharedObject<NDArrayView>(value->GetDataType(), value->Shape(), DeviceDescriptor::CPUDevice());
+                cpuValue->CopyFrom(*value);
+                copies.push_back({ value, cpuValue });
+            }
+
+            if (value->GetDataType() == DataType::Float)
+                floatValues.push_back(cpuValue);
+            else if (value->GetDataType() == DataType::Double)
+                doubleValues.push_back(cpuValue);
+            else
+                LogicError("SharedMemoryCommunicator: Unsupported DataType %s for aggregation.", DataTypeName(value->GetDataType()));
+        }
+
+        AggregateImpl<float>(floatValues);
+        AggregateImpl<double>(doubleValues);
+
+        for (const auto& copy : copies)
+            copy.first->CopyFrom(*copy.second);
+    }
+
+    void SharedMemoryCommunicatorImpl::Aggregate(
+        const std::vector<NDArrayViewPtr>& values,
+        std::vector<NDArrayViewPtr>& outputValues,
+        const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        if (outputValues.empty())
+        {
+            outputValues.resize(values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                outputValues[i] = MakeSharedObject<NDArrayView>(values[i]->GetDataType(), values[i]->Shape(), values[i]->Device());
+        }
+        else if (outputValues.size() != values.size())
+        {
+            NOT_IMPLEMENTED;
+        }
+
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (outputValues[i] != values[i])
+                outputValues[i]->CopyFrom(*values[i]);
+        }
+
+        AggregateInPlace(outputValues, sendToWorkers);
+    }
+}
+
+#else
+
+namespace CNTK
+{
+    DistributedCommunicatorPtr SharedMemoryCommunicator(const std::wstring&, size_t, size_t, size_t)
+    {
+        LogicError("SharedMemoryCommunicator is currently only supported on Linux.");
+    }
+}
+
+#endif
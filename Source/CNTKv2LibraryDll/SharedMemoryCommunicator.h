@@ -0,0 +1,110 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include "CNTKLibrary.h"
+
+namespace CNTK
+{
+    //
+    // Communicator for worker processes on a single machine that exchanges data through a POSIX shared memory segment.
+    // The segment contains a header used for synchronization and one slot per worker. Aggregation is done in windows
+    // of the slot size: each worker packs its values into its own slot; then (reduce-scatter) worker r sums the r-th chunk
+    // of all slots into the r-th chunk of its own slot; then (allgather) every worker copies the reduced chunks out of the
+    // slots of their owners. A worker only ever writes its own slot, so the pages of the slot are first touched and therefore
+    // allocated on the NUMA node of the worker that reduces them.
+    // A subgroup attaches to a segment of its own, its workers are renumbered in the order of their ranks in this communicator.
+    //
+    class SharedMemoryCommunicatorImpl final : public DistributedCommunicator
+    {
+    public:
+        SharedMemoryCommunicatorImpl(const std::wstring& name, size_t numberOfWorkers, size_t workerRank, size_t bufferSizeInBytes);
+
+        ~SharedMemoryCommunicatorImpl();
+
+        const std::unordered_set<DistributedWorkerDescriptor>& Workers() const override
+        {
+            return m_workers;
+        }
+
+        const DistributedWorkerDescriptor& CurrentWorker() const override
+        {
+            return m_currentWorker;
+        }
+
+        DistributedCommunicatorPtr SubGroup(const std::unordered_set<DistributedWorkerDescriptor>& subGroupWorkers) const override;
+
+        void Concatenate(
+            const std::vector<ValuePtr>& values,
+            std::vector<ValuePtr>& outputValues,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
+
+        void Concatenate(
+            const std::vector<NDArrayViewPtr>& input,
+            std::vector<NDArrayViewPtr>& output,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
+
+        void Gather(
+            const Dictionary& input,
+            std::vector<DictionaryPtr>& output,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
+
+        void AggregateInPlace(
+            const std::vector<NDArrayViewPtr>& values,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
+
+        void Aggregate(
+            const std::vector<NDArrayViewPtr>& values,
+            std::vector<NDArrayViewPtr>& outputValues,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
+
+        void Barrier() override;
+
+    private:
+        struct Header;
+
+        void CheckWorkers(const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers);
+
+        // Maps the segment of the worker 0 of this run, skipping stale segments left behind by a run that crashed.
+        int AttachToSegment();
+
+        // Waits until 'done' returns true. Fails instead of waiting forever when another worker is gone, i.e. it has
+        // destroyed its communicator (e.g. after an error) or its process has exited, or when the timeout has passed.
+        template <typename Predicate>
+        void WaitUntil(const Predicate& done, int timeoutInSeconds, const char* operation);
+
+        char* Slot(size_t rank) const
+        {
+            return m_slots + rank * m_slotSizeInBytes;
+        }
+
+        // Sums the CPU values of the given element type across all workers.
+        template <typename ElementType>
+        void AggregateImpl(const std::vector<NDArrayViewPtr>& values);
+
+        // Sends the given bytes to all workers, 'receive' is called for each (possibly partial) block of the bytes of each worker
+        // at the given offset.
+        void Exchange(const char* data, size_t size, const std::function<void(size_t rank, size_t offset, const char* data, size_t size)>& receive);
+
+        std::wstring m_communicatorName;
+        std::string m_name;
+        size_t m_numberOfWorkers;
+        size_t m_rank;
+        size_t m_slotSizeInBytes;
+
+        void* m_segment;
+        size_t m_segmentSizeInBytes;
+        Header* m_header;
+        uint64_t* m_exchangeSizes;
+        std::atomic<uint64_t>* m_processIds;
+        char* m_slots;
+
+        DistributedWorkerDescriptor m_currentWorker;
+        std::unordered_set<DistributedWorkerDescriptor> m_workers;
+    };
+}
@@ -0,0 +1,225 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include "SparsifiedDataParallelDistributedLearner.h"
+#include "PerformanceProfiler.h"
+
+namespace CNTK
+{
+    DistributedLearnerPtr CreateSparsifiedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, double compressionRatio)
+    {
+        return MakeSharedObject<SparsifiedDataParallelDistributedLearner>(communicator, learner, distributeAfterSamples, compressionRatio);
+    }
+
+    // Indices of the selected entries are stored bitwise in the elements of the packed buffer, so that
+    // indices and values are exchanged with a single allgather of the gradient's data type.
+    template <typename ElementType>
+    using PackedIndexType = typename std::conditional<sizeof(ElementType) == sizeof(uint32_t), uint32_t, uint64_t>::type;
+
+    SparsifiedDataParallelDistributedLearner::SparsifiedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, double compressionRatio)
+        : DistributedLearnerBase(communicator, learner, distributeAfterSamples),
+          m_compressionRatio(compressionRatio),
+          m_packed(2),
+          m_gathered(2)
+    {
+        if (compressionRatio < 1)
+            InvalidArgument("Compression ratio '%g' of the sparsified distributed learner must not be less than 1.", compressionRatio);
+    }
+
+    size_t SparsifiedDataParallelDistributedLearner::NumberOfSelectedEntries(const NDArrayViewPtr& gradient) const
+    {
+        auto dataType = gradient->GetDataType();
+        if (dataType != DataType::Float && dataType != DataType::Double)
+            return 0;
+
+        auto size = gradient->Shape().TotalSize();
+        if (dataType == DataType::Float && size > std::numeric_limits<uint32_t>::max())
+            return 0;
+
+        auto k = (size_t)std::ceil(size / m_compressionRatio);
+        return 2 * k < size ? k : 0;
+    }
+
+    NDArrayViewPtr SparsifiedDataParallelDistributedLearner::CPUGradient(const Parameter& parameter, const NDArrayViewPtr& gradient)
+    {
+        if (gradient->Device().Type() == DeviceKind::CPU)
+            return gradient;
+
+        auto& cpuGradient = m_cpuGradients[parameter];
+        if (!cpuGradient)
+            cpuGradient = MakeSharedObject<NDArrayView>(gradient->GetDataType(), gradient->Shape(), DeviceDescriptor::CPUDevice());
+
+        return cpuGradient;
+    }
+
+    template <typename ElementType>
+    void SparsifiedDataParallelDistributedLearner::Sparsify(const Parameter& parameter, const NDArrayViewPtr& gradient, size_t k, ElementType* packed)
+    {
+        auto cpuGradient = CPUGradient(parameter, gradient);
+        if (cpuGradient != gradient)
+            cpuGradient->CopyFrom(*gradient);
+
+        auto& residual = m_residuals[parameter];
+        if (!residual)
+            residual = MakeSharedObject<NDArrayView>(0, gradient->GetDataType(), gradient->Shape(), DeviceDescriptor::CPUDevice());
+
+        auto size = gradient->Shape().TotalSize();
+        auto values = residual->WritableDataBuffer<ElementType>();
+        auto gradientValues = cpuGradient->DataBuffer<ElementType>();
+        for (size_t i = 0; i < size; ++i)
+            values[i] += gradientValues[i];
+
+        // Selecting the k entries of the largest magnitude in linear time, sorted by index for the scattered additions.
+        m_order.resize(size);
+        std::iota(m_order.begin(), m_order.end(), 0);
+        std::nth_element(m_order.begin(), m_order.begin() + k, m_order.end(),
+            [values](size_t a, size_t b) { return std::abs(values[a]) > std::abs(values[b]); });
+        std::sort(m_order.begin(), m_order.begin() + k);
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            PackedIndexType<ElementType> index = m_order[i];
+            memcpy(packed + i, &index, sizeof(ElementType));
+            packed[k + i] = values[m_order[i]];
+            values[m_order[i]] = 0;
+        }
+    }
+
+    template <typename ElementType>
+    void SparsifiedDataParallelDistributedLearner::Densify(const Parameter& parameter, const NDArrayViewPtr& gradient, size_t k, const ElementType* gathered, size_t packedSize)
+    {
+        auto size = gradient->Shape().TotalSize();
+        auto cpuGradient = CPUGradient(parameter, gradient);
+        auto values = cpuGradient->WritableDataBuffer<ElementType>();
+        std::fill(values, values + size, (ElementType)0);
+
+        for (size_t worker = 0; worker < m_communicator->Workers().size(); ++worker)
+        {
+            auto workerData = gathered + worker * packedSize;
+            for (size_t i = 0; i < k; ++i)
+            {
+                PackedIndexType<ElementType> index;
+                memcpy(&index, workerData + i, sizeof(ElementType));
+                if (index >= size)
+                    RuntimeError("SparsifiedDataParallelDistributedLearner: received index %d is out of the bounds of a gradient of size %d.", (int)index, (int)size);
+
+                values[index] += workerData[k + i];
+            }
+        }
+
+        if (cpuGradient != gradient)
+            gradient->CopyFrom(*cpuGradient);
+    }
+
+    template <typename ElementType>
+    void SparsifiedDataParallelDistributedLearner::SparsifiedAggregate(const std::vector<std::pair<Parameter, NDArrayViewPtr>>& gradients, size_t bufferIndex)
+    {
+        if (gradients.empty())
+            return;
+
+        size_t packedSize = 0;
+        for (const auto& gradient : gradients)
+            packedSize += 2 * NumberOfSelectedEntries(gradient.second);
+
+        auto& packed = m_packed[bufferIndex];
+        if (!packed || packed->Shape().TotalSize() != packedSize)
+            packed = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), NDShape{ packedSize }, DeviceDescriptor::CPUDevice());
+
+        auto packedData = packed->WritableDataBuffer<ElementType>();
+        for (const auto& gradient : gradients)
+        {
+            auto k = NumberOfSelectedEntries(gradient.second);
+            Sparsify(gradient.first, gradient.second, k, packedData);
+            packedData += 2 * k;
+        }
+
+        // All workers select the same number of entries, so the packed data has the same size on all of them.
+        std::vector<NDArrayViewPtr> gathered{ m_gathered[bufferIndex] };
+        m_communicator->Concatenate(std::vector<NDArrayViewPtr>{ packed }, gathered, m_communicator->Workers());
+        m_gathered[bufferIndex] = gathered.front();
+
+        auto gatheredData = m_gathered[bufferIndex]->DataBuffer<ElementType>();
+        for (const auto& gradient : gradients)
+        {
+            auto k = NumberOfSelectedEntries(gradient.second);
+            Densify(gradient.first, gradient.second, k, gatheredData, packedSize);
+            gatheredData += 2 * k;
+        }
+    }
+
+    bool SparsifiedDataParallelDistributedLearner::Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info)
+    {
+        std::unordered_map<Parameter, NDArrayViewPtr> convertedGradientValues;
+        if (m_sampleCount >= m_distributeAfterSamples && m_communicator->Workers().size() > 1)
+        {
+#ifndef CNTK_UWP
+            auto profGradientAgg = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainGradient);
+#endif
+
+            if (info.IsEmpty())
+                PrepaireZeroGradients(gradientValues);
+
+            // Gradients are ordered by parameter uid, so that they are packed in the same order on all workers.
+            ConvertToOrdered(gradientValues, m_gradientBuffer, &convertedGradientValues);
+
+            std::vector<NDArrayViewPtr> valuesToAggregate;
+            std::vector<std::pair<Parameter, NDArrayViewPtr>> floatGradients;
+            std::vector<std::pair<Parameter, NDArrayViewPtr>> doubleGradients;
+            for (const auto& i : m_gradientBuffer)
+            {
+                if (NumberOfSelectedEntries(i.second) == 0)
+                    valuesToAggregate.push_back(i.second);
+                else if (i.second->GetDataType() == DataType::Float)
+                    floatGradients.push_back(i);
+                else
+                    doubleGradients.push_back(i);
+            }
+            m_gradientBuffer.clear();
+
+            valuesToAggregate.push_back(info.evalCriterionValue);
+            valuesToAggregate.push_back(info.trainingLossValue);
+
+            auto value = MakeSharedObject<NDArrayView>(static_cast<double>(info.numberOfSamples), NDShape{}, DeviceDescriptor::CPUDevice());
+            valuesToAggregate.push_back(value);
+
+            m_communicator->AggregateInPlace(valuesToAggregate, m_communicator->Workers());
+            info.numberOfSamples = static_cast<size_t>(*valuesToAggregate.back()->DataBuffer<double>());
+
+            SparsifiedAggregate<float>(floatGradients, 0);
+            SparsifiedAggregate<double>(doubleGradients, 1);
+        }
+
+#ifndef CNTK_UWP
+        auto profWeights = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainWeights);
+#endif
+
+        m_sampleCount += info.numberOfSamples;
+        if (info.IsEmpty())
+            return false;
+
+        return m_learner->Update(convertedGradientValues.empty() ? gradientValues : convertedGradientValues, info.numberOfSamples, info.atEndOfSweep);
+    }
+
+    Dictionary SparsifiedDataParallelDistributedLearner::CreateCheckpoint()
+    {
+        // Resetting the residuals, they are not checkpointed; this keeps the in-memory state consistent with the checkpoint.
+        for (auto& residual : m_residuals)
+        {
+            if (residual.second->GetDataType() == DataType::Double)
+                residual.second->SetValue(0.0);
+            else
+                residual.second->SetValue(0.0f);
+        }
+
+        return DistributedLearnerBase::CreateCheckpoint();
+    }
+}
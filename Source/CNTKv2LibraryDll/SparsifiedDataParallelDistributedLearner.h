@@ -0,0 +1,66 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <vector>
+#include "CNTKLibrary.h"
+#include "DistributedLearnerBase.h"
+
+namespace CNTK
+{
+    ///
+    /// Data parallel distributed learner that only exchanges the largest entries of each gradient.
+    /// For a gradient of n entries the k = ceil(n / compressionRatio) entries with the largest magnitude are selected
+    /// and exchanged as (index, value) pairs with an allgather; every worker then sums the pairs of all workers into
+    /// the dense gradient. The entries that have not been sent are kept in a local residual that is added to the next
+    /// gradient (error feedback), similarly to the residuals of the 1-bit quantization. Gradients for which the pairs
+    /// would not be smaller than the dense values are aggregated densely.
+    ///
+    class SparsifiedDataParallelDistributedLearner : public DistributedLearnerBase
+    {
+    public:
+        SparsifiedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, double compressionRatio);
+
+        // Optional override that gets called per minibatch after finishing gradient computation but before updating model parameters
+        bool Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info) override;
+
+        // Optionally overridable method to get checkpoint state associated with this Distributed train method
+        Dictionary CreateCheckpoint() override;
+
+    private:
+        // Number of entries of a gradient of the given size that are exchanged, 0 if the gradient is aggregated densely.
+        size_t NumberOfSelectedEntries(const NDArrayViewPtr& gradient) const;
+
+        // Adds the gradient to the residual of the parameter, moves the k largest entries of the residual to 'packed'
+        // as k indices followed by k values.
+        template <typename ElementType>
+        void Sparsify(const Parameter& parameter, const NDArrayViewPtr& gradient, size_t k, ElementType* packed);
+
+        // Sums the entries selected by all workers into the gradient, 'packedSize' is the size of the data of each worker.
+        template <typename ElementType>
+        void Densify(const Parameter& parameter, const NDArrayViewPtr& gradient, size_t k, const ElementType* gathered, size_t packedSize);
+
+        template <typename ElementType>
+        void SparsifiedAggregate(const std::vector<std::pair<Parameter, NDArrayViewPtr>>& gradients, size_t bufferIndex);
+
+        // Returns a CPU buffer for the values of the gradient, the gradient itself if it resides on the CPU.
+        NDArrayViewPtr CPUGradient(const Parameter& parameter, const NDArrayViewPtr& gradient);
+
+        double m_compressionRatio;
+
+        // Residuals of the sparsified gradients, kept in CPU memory.
+        std::unordered_map<Parameter, NDArrayViewPtr> m_residuals;
+
+        // CPU copies of gradients that reside on a GPU.
+        std::unordered_map<Parameter, NDArrayViewPtr> m_cpuGradients;
+
+        // Packed selected entries of this worker and of all workers, for float and double gradients.
+        std::vector<NDArrayViewPtr> m_packed;
+        std::vector<NDArrayViewPtr> m_gathered;
+
+        std::vector<size_t> m_order;
+    };
+}
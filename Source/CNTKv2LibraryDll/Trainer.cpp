@@ -27,6 +27,12 @@ namespace
 
 namespace CNTK
 {
+    // The workers of a distributed trainer synchronize through the communicator of its distributed learner.
+    static DistributedCommunicatorPtr GetCommunicator(const LearnersPtr& learners)
+    {
+        return dynamic_cast<DistributedLearner*>(learners->ParameterLearners()[0].get())->GetCommunicator();
+    }
+
     Trainer::Trainer(const FunctionPtr& model, const FunctionPtr& lossFunction,
                      const std::vector<LearnerPtr>& parameterLearners,
                      const std::vector<ProgressWriterPtr>& progressWriters)
@@ -141,7 +147,7 @@ namespace CNTK
         m_distributed = m_parameterLearners->IsDistributed();
 
         if (m_distributed)
-            Evaluator::SetCommunicator(dynamic_cast<DistributedLearner*>(m_parameterLearners->ParameterLearners()[0].get())->GetCommunicator());
+            Evaluator::SetCommunicator(GetCommunicator(m_parameterLearners));
 
         for (auto& learner : m_parameterLearners->ParameterLearners())
         {
@@ -394,8 +400,34 @@ namespace CNTK
         for (const auto& parameter : m_learnerParameters)
             parameterGradients[parameter] = nullptr;
 
+        // Distributed learners may aggregate gradients while the rest of the network is still being backpropagated.
+        std::vector<DistributedLearner*> overlappingLearners;
+        if (m_distributed)
+        {
+            // All learners of a distributed trainer are distributed learners, see Learners::CheckDistributedLearners.
+            for (const auto& learner : m_parameterLearners->ParameterLearners())
+            {
+                auto distributedLearner = static_cast<DistributedLearner*>(learner.get());
+                if (distributedLearner->BeginBackprop())
+                    overlappingLearners.push_back(distributedLearner);
+            }
+        }
+
+        auto compositeFunction = dynamic_cast<CompositeFunction*>(m_combinedTrainingFunction.get());
+
         // TODO: Why Backward signature does not take Parameter instead of Variable for gradients?
-        m_combinedTrainingFunction->Backward(backPropSate, { { m_aggregatedLossFunction, m_rootGradientValue } }, parameterGradients);
+        if (overlappingLearners.empty() || !compositeFunction)
+            m_combinedTrainingFunction->Backward(backPropSate, { { m_aggregatedLossFunction, m_rootGradientValue } }, parameterGradients);
+        else
+            compositeFunction->Backward(backPropSate, { { m_aggregatedLossFunction, m_rootGradientValue } }, parameterGradients,
+                [&overlappingLearners](const Variable& variable, const ValuePtr& gradient)
+                {
+                    if (!variable.IsParameter())
+                        return;
+
+                    for (const auto& learner : overlappingLearners)
+                        learner->OnGradientReady(Parameter(variable), gradient->Data());
+                });
         m_prevMinibatchNumSamples = GetSampleCount(m_trainingSampleCountVar, outputs[m_trainingSampleCountVar]);
     }
 
@@ -405,12 +437,111 @@ namespace CNTK
         return modelFilePath + checkpointExt;
     }
 
+    // Flushes a file that has been written through a stream to the disk.
+    static void FlushToDisk(const std::wstring& filePath)
+    {
+        FILE* f = fopenOrDie(filePath, L"r+b");
+        fsyncOrDie(f);
+        fcloseOrDie(f);
+    }
+
+    // Writes the model and the trainer state to temporary files and renames them once both are on the disk,
+    // so that a crash while writing does not leave a partial checkpoint behind.
+    static void WriteCheckpoint(const std::wstring& modelFilePath, const Dictionary& model, Dictionary& state)
+    {
+        std::wstring tempModelFile = modelFilePath + L".tmp";
+        {
+            auto stream = GetFstream(tempModelFile, false);
+            *stream << model;
+            stream->flush();
+        }
+        FlushToDisk(tempModelFile);
+
+        std::wstring trainerStateCheckpointFilePath = GetTrainerStateCheckpointFilePath(modelFilePath);
+        std::wstring tempCheckpointFile = trainerStateCheckpointFilePath + L".tmp";
+
+        state.Save(tempCheckpointFile);
+        FlushToDisk(tempCheckpointFile);
+
+        // The return value is ignored here.
+        _wunlink(modelFilePath.c_str());
+        _wunlink(trainerStateCheckpointFilePath.c_str());
+
+        renameOrDie(tempModelFile, modelFilePath);
+        renameOrDie(tempCheckpointFile, trainerStateCheckpointFilePath);
+    }
+
+    Trainer::~Trainer()
+    {
+        if (!m_pendingCheckpoint.valid())
+            return;
+
+        try
+        {
+            m_pendingCheckpoint.get();
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "Trainer: writing the checkpoint in the background failed: %s\n", e.what());
+        }
+    }
+
+    void Trainer::WaitForCheckpoint()
+    {
+        // get() rethrows the errors of writing the checkpoint and leaves the future empty.
+        if (m_pendingCheckpoint.valid())
+            m_pendingCheckpoint.get();
+    }
+
+    // Waits for the checkpoint written in the background, like WaitForCheckpoint(). In distributed training the workers
+    // synchronize before an error of writing it is rethrown, and all of them fail together, so that none of them waits for
+    // the main worker (the only one that writes checkpoints) in a later collective operation forever.
+    void Trainer::WaitForCheckpointOnAllWorkers()
+    {
+        std::exception_ptr checkpointError;
+        try
+        {
+            WaitForCheckpoint();
+        }
+        catch (...)
+        {
+            checkpointError = std::current_exception();
+        }
+
+        if (m_distributed)
+        {
+            double failedWorkers = checkpointError ? 1 : 0;
+            auto values = std::vector<NDArrayViewPtr>{ MakeSharedObject<NDArrayView>(NDShape{}, &failedWorkers, 1, DeviceDescriptor::CPUDevice()) };
+            auto communicator = GetCommunicator(m_parameterLearners);
+            communicator->AggregateInPlace(values, communicator->Workers());
+
+            if (failedWorkers > 0 && !checkpointError)
+                RuntimeError("Trainer: writing the previous checkpoint failed on another worker.");
+        }
+
+        if (checkpointError)
+            std::rethrow_exception(checkpointError);
+    }
+
     void Trainer::SaveCheckpoint(const std::wstring& modelFilePath, Dictionary externalState)
     {
+        SaveCheckpoint(modelFilePath, externalState, /*asynchronous*/ false);
+    }
+
+    void Trainer::SaveCheckpointAsync(const std::wstring& modelFilePath, Dictionary externalState)
+    {
+        SaveCheckpoint(modelFilePath, externalState, /*asynchronous*/ true);
+    }
+
+    void Trainer::SaveCheckpoint(const std::wstring& modelFilePath, const Dictionary& externalState, bool asynchronous)
+    {
+        // At most one checkpoint is kept in memory and they are written in order.
+        WaitForCheckpointOnAllWorkers();
+
         auto learnersState = m_parameterLearners->CreateCheckpoint();
 
         if (!m_distributed)
-            return Save(modelFilePath, learnersState, externalState);
+            return Save(modelFilePath, learnersState, externalState, {}, asynchronous);
 
         auto compositeFunction = dynamic_cast<CompositeFunction*>(m_combinedTrainingFunction.get());
 
@@ -419,7 +550,7 @@ namespace CNTK
         state[externalWorkerStateKey] = externalState;
 
         // Collect distributed external state.
-        DistributedCommunicatorPtr communicator = MPICommunicator();
+        DistributedCommunicatorPtr communicator = GetCommunicator(m_parameterLearners);
         communicator->Barrier();
 
         std::vector<DictionaryPtr> remoteState;
@@ -432,38 +563,39 @@ namespace CNTK
         }
 
         if (communicator->CurrentWorker().IsMain())
-            Save(modelFilePath, learnersState, externalState, aggregatedState);
+            Save(modelFilePath, learnersState, externalState, aggregatedState, asynchronous);
 
         // all workers need to sync up after saving model to avoid read-after-write hazard
         // i.e. one worker is in the middle of write while another tries to read
+        // (for an asynchronous checkpoint, RestoreFromCheckpoint() waits for the main worker to finish writing)
         communicator->Barrier();
     }
 
-    void Trainer::Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState, const Dictionary& distributedState)
+    void Trainer::Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState, const Dictionary& distributedState, bool asynchronous)
     {
-        std::wstring tempModelFile = modelFilePath + L".tmp";
-        Dictionary state;
-        state[versionPropertyName] = trainerCheckpointVersion;
-        state[learnersPropertyName] = learnerState;
-        state[externalStatePropertyName] = externalState;
-        state[distributedStatePropertyName] = distributedState;
-
-        m_combinedTrainingFunction->Save(tempModelFile);
-        std::wstring trainerStateCheckpointFilePath = GetTrainerStateCheckpointFilePath(modelFilePath);
-        std::wstring tempCheckpointFile = trainerStateCheckpointFilePath + L".tmp";
+        auto state = std::make_shared<Dictionary>();
+        (*state)[versionPropertyName] = trainerCheckpointVersion;
+        (*state)[learnersPropertyName] = learnerState;
+        (*state)[externalStatePropertyName] = externalState;
+        (*state)[distributedStatePropertyName] = distributedState;
 
-        state.Save(tempCheckpointFile);
+        // Serializing the model copies the parameter values to host memory, after that the training may change them.
+        auto model = std::make_shared<Dictionary>(m_combinedTrainingFunction->Serialize());
 
-        // The return value is ignored here.
-        _wunlink(modelFilePath.c_str());
-        _wunlink(trainerStateCheckpointFilePath.c_str());
+        if (!asynchronous)
+            return WriteCheckpoint(modelFilePath, *model, *state);
 
-        renameOrDie(tempModelFile, modelFilePath);
-        renameOrDie(tempCheckpointFile, trainerStateCheckpointFilePath);
+        m_pendingCheckpoint = std::async(std::launch::async, [modelFilePath, model, state]()
+        {
+            WriteCheckpoint(modelFilePath, *model, *state);
+        });
     }
 
     Dictionary Trainer::RestoreFromCheckpoint(const std::wstring& modelFilePath)
     {
+        // The main worker may have been writing the checkpoint in the background.
+        WaitForCheckpointOnAllWorkers();
+
         // Restore the model's parameters
         m_combinedTrainingFunction->Restore(modelFilePath);
 
@@ -486,7 +618,7 @@ namespace CNTK
 
         // this ensures that nobody will start writing to the model/checkpoint files, until
         // everybody is done reading them.
-        DistributedCommunicatorPtr communicator = MPICommunicator();
+        DistributedCommunicatorPtr communicator = GetCommunicator(m_parameterLearners);
         communicator->Barrier();
 
         auto mainWorkerId = std::to_wstring(0);
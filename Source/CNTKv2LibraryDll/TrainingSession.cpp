@@ -35,8 +35,10 @@ namespace CNTK
         size_t checkpointFrequency,
         DataUnit checkpointFrequencyUnit,
         bool restoreFromCheckpointIfExists,
-        bool preserveAllCheckpoints) :
+        bool preserveAllCheckpoints,
+        bool asynchronous) :
         m_preserveAll(preserveAllCheckpoints),
+        m_asynchronous(asynchronous),
         m_restore(restoreFromCheckpointIfExists),
         m_fileName(checkPointFileName),
         m_frequency(checkpointFrequency),
@@ -252,6 +254,10 @@ namespace CNTK
             }
         }
 
+        // The last checkpoint is complete when the training is over; if writing it failed, all workers fail.
+        if (m_checkpoint.m_asynchronous)
+            Trainer()->WaitForCheckpointOnAllWorkers();
+
         // In case of incremental - save final checkpoint.
         // This is required only when we keep all existing checkpoints, otherwise 
         // The checkpoint was already saved with the proper name.
@@ -415,7 +421,12 @@ namespace CNTK
         wstring checkpointFile = m_checkpoint.m_fileName;
         if (m_checkpoint.m_preserveAll)
             checkpointFile += std::to_wstring(currentIndex);
-        Trainer()->SaveCheckpoint(checkpointFile, externalState);
+
+        // With asynchronous checkpoints, the checkpoint has only been captured (not written) when OnCheckpointEnd is called.
+        if (m_checkpoint.m_asynchronous)
+            Trainer()->SaveCheckpointAsync(checkpointFile, externalState);
+        else
+            Trainer()->SaveCheckpoint(checkpointFile, externalState);
         OnCheckpointEnd(currentIndex);
     }
 
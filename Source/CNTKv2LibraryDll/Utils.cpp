@@ -14,6 +14,7 @@
 #include "Utils.h"
 #include "Serialization.h"
 #include <fcntl.h>
+#include <mutex>
 #include "PrimitiveFunction.h"
 #include "PrimitiveFunctionAttribute.h"
 #include "RecurrentNodes.h"
@@ -1348,4 +1349,44 @@ namespace CNTK
         wss << "]";
         return wss.str();
     }
+
+    namespace
+    {
+        struct RegisteredStorageSlice
+        {
+            size_t numBytes;
+            std::weak_ptr<void> owner;
+            ContiguousStorageSlice slice;
+        };
+
+        std::mutex s_contiguousStorageSlicesMutex;
+        std::unordered_map<const void*, RegisteredStorageSlice> s_contiguousStorageSlices;
+    }
+
+    void RegisterContiguousStorageSlice(const void* data, size_t numBytes, const std::shared_ptr<void>& owner, const ContiguousStorageSlice& slice)
+    {
+        std::lock_guard<std::mutex> lock(s_contiguousStorageSlicesMutex);
+
+        // Slices whose owner has been released are dropped, their memory may be reused.
+        for (auto iter = s_contiguousStorageSlices.begin(); iter != s_contiguousStorageSlices.end();)
+        {
+            if (iter->second.owner.expired())
+                iter = s_contiguousStorageSlices.erase(iter);
+            else
+                ++iter;
+        }
+
+        s_contiguousStorageSlices[data] = { numBytes, owner, slice };
+    }
+
+    bool FindContiguousStorageSlice(const void* data, size_t numBytes, ContiguousStorageSlice& slice)
+    {
+        std::lock_guard<std::mutex> lock(s_contiguousStorageSlicesMutex);
+        auto iter = s_contiguousStorageSlices.find(data);
+        if ((iter == s_contiguousStorageSlices.end()) || (iter->second.numBytes != numBytes) || iter->second.owner.expired())
+            return false;
+
+        slice = iter->second.slice;
+        return true;
+    }
 }
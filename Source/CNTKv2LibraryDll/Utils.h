@@ -744,6 +744,18 @@ namespace CNTK
 
     std::wstring DynamicAxesAsString(const std::vector<Axis>& da, bool rowMajor = false);
 
+    // Position of a gradient in a contiguous parameter storage (see Internal::EnableContiguousParameterStorage).
+    // Slices of the same storage with consecutive indices are adjacent in memory.
+    struct ContiguousStorageSlice
+    {
+        const void* storage;
+        size_t index;
+    };
+
+    // Records that the buffer 'data' of 'numBytes' bytes is a slice of a contiguous storage, for as long as 'owner' is alive.
+    void RegisterContiguousStorageSlice(const void* data, size_t numBytes, const std::shared_ptr<void>& owner, const ContiguousStorageSlice& slice);
+    bool FindContiguousStorageSlice(const void* data, size_t numBytes, ContiguousStorageSlice& slice);
+
     template <typename T> //T can be Variable or StreamInfo
     static bool IsAtSweepEnd(const std::unordered_map<T, MinibatchData>& arguments)
     {
@@ -336,6 +336,49 @@ namespace CNTK
         return Create(sampleShape, sequencesView, { sequenceStartFlag }, device, readOnly, /*createNewCopy =*/ true);
     }
 
+    //
+    // Returns the number of samples in a caller owned buffer that is used as the storage of a Value object.
+    //
+    template <typename ElementType>
+    static size_t NumberOfSamplesInBuffer(const NDShape& sampleShape, const ElementType* buffer, size_t numElements)
+    {
+        if (buffer == nullptr)
+            InvalidArgument("Value::Create: The data buffer must not be null.");
+
+        if ((reinterpret_cast<uintptr_t>(buffer) % alignof(ElementType)) != 0)
+            InvalidArgument("Value::Create: The data buffer must be aligned to %zu bytes.", alignof(ElementType));
+
+        auto shapeSize = sampleShape.TotalSize();
+        if ((shapeSize == 0) || (numElements == 0) || ((numElements % shapeSize) != 0))
+            InvalidArgument("The number of elements (%zu) in the data buffer must be a positive multiple of the size (%zu) of the sample shape '%S'.",
+                            numElements, shapeSize, sampleShape.AsString().c_str());
+
+        return numElements / shapeSize;
+    }
+
+    template <typename ElementType>
+    /*static*/ ValuePtr Value::CreateBatchView(const NDShape& sampleShape, const ElementType* batchData, size_t numElements, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/)
+    {
+        auto numOfSequences = NumberOfSamplesInBuffer(sampleShape, batchData, numElements);
+
+        // Each sample is a new sequence of length 1, which needs no mask, so the buffer already has the layout of the Value.
+        auto batchView = MakeSharedObject<NDArrayView>(sampleShape.AppendShape({ 1, numOfSequences }), batchData, numElements, DeviceDescriptor::CPUDevice());
+        batchView->m_externalStorage = bufferOwner;
+        if (device != batchView->Device())
+            batchView = batchView->DeepClone(device, /*readOnly =*/ true);
+
+        return MakeSharedObject<Value>(batchView);
+    }
+
+    template <typename ElementType>
+    /*static*/ ValuePtr Value::CreateSequenceView(const NDShape& sampleShape, const ElementType* sequenceData, size_t numElements, bool sequenceStartFlag, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/)
+    {
+        auto sequenceLength = NumberOfSamplesInBuffer(sampleShape, sequenceData, numElements);
+        auto sequenceView = MakeSharedObject<NDArrayView>(sampleShape.AppendShape({ sequenceLength }), sequenceData, numElements, DeviceDescriptor::CPUDevice());
+        sequenceView->m_externalStorage = bufferOwner;
+        return Create(sampleShape, { sequenceView }, { sequenceStartFlag }, device, /*readOnly =*/ true, /*createNewCopy =*/ false);
+    }
+
     template <typename ElementType>
     /*static*/ ValuePtr Value::CreateBatch(size_t dimension, const std::vector<size_t>& batchData, const DeviceDescriptor& device, bool readOnly/* = false*/)
     {
@@ -755,6 +798,12 @@ namespace CNTK
     template /*static*/ CNTK_API ValuePtr Value::CreateSequence<float>(const NDShape& sampleShape, const std::vector<float>& sequenceData, bool sequenceStartFlag, const DeviceDescriptor& device, bool readOnly /*= false */);
     template /*static*/ CNTK_API ValuePtr Value::CreateSequence<double>(const NDShape& sampleShape, const std::vector<double>& sequenceData, bool sequenceStartFlag, const DeviceDescriptor& device, bool readOnly /*= false */);
     template /*static*/ CNTK_API ValuePtr Value::CreateSequence<float16> (const NDShape& sampleShape, const std::vector<float16>& sequenceData, bool sequenceStartFlag, const DeviceDescriptor& device, bool readOnly /*= false */);
+    template /*static*/ CNTK_API ValuePtr Value::CreateBatchView<float>(const NDShape& sampleShape, const float* batchData, size_t numElements, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateBatchView<double>(const NDShape& sampleShape, const double* batchData, size_t numElements, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateBatchView<float16>(const NDShape& sampleShape, const float16* batchData, size_t numElements, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateSequenceView<float>(const NDShape& sampleShape, const float* sequenceData, size_t numElements, bool sequenceStartFlag, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateSequenceView<double>(const NDShape& sampleShape, const double* sequenceData, size_t numElements, bool sequenceStartFlag, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateSequenceView<float16>(const NDShape& sampleShape, const float16* sequenceData, size_t numElements, bool sequenceStartFlag, const DeviceDescriptor& device, const std::shared_ptr<void>& bufferOwner /*= nullptr*/);
     template /*static*/ CNTK_API ValuePtr Value::CreateBatch<float>(size_t dimension, const std::vector<size_t>& batchData, const DeviceDescriptor& device, bool readOnly/* = false*/);
     template /*static*/ CNTK_API ValuePtr Value::CreateBatch<double>(size_t dimension, const std::vector<size_t>& batchData, const DeviceDescriptor& device, bool readOnly/* = false*/);
     template /*static*/ CNTK_API ValuePtr Value::CreateBatch<float16> (size_t dimension, const std::vector<size_t>& batchData, const DeviceDescriptor& device, bool readOnly/* = false*/);
@@ -548,7 +548,9 @@ namespace CNTK
 
             // TODO: this copying here is redundant, value should be moved from the dictionary to the variable.
             // Also, the correct device should be used upfront when deserializing NDArrayView.
-            Variable var(shape, kind, dataType, value.DeepClone(device, value.IsReadOnly()), needsGradient, dynamicAxis, isSparse, name, uid);
+            // Values mapped from the tensor file of the model (see Function::Save) are used in place on the CPU.
+            auto varValue = (value.m_externalStorage && value.Device() == device) ? value.Alias(value.IsReadOnly()) : value.DeepClone(device, value.IsReadOnly());
+            Variable var(shape, kind, dataType, varValue, needsGradient, dynamicAxis, isSparse, name, uid);
             if (var.IsParameter())
                 return Parameter(var);
             else
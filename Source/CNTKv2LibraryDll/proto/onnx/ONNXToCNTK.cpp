@@ -9,7 +9,10 @@
 #include "Utils.h"
 #include "Operators.h"
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <thread>
 #include "RNNHelper.h"
 #include "ONNXToCNTK.h"
 
@@ -37,8 +40,15 @@ public:
         VariableToFunctionPtr &sequenceWrapperInputToFunctionPtr,
         const DeviceDescriptor &computeDevice);
 
+    //
+    // Convert the floating point initializers of an ONNX graph into CNTK Constants in parallel.
+    //
+    static void ConvertInitializers(onnxruntime::Graph *graph, ONNXToCNTKVariableMap &constructedNodeArgVariableMap,
+                                    const DeviceDescriptor &computeDevice);
+
     static std::string model_location_;
 private:
+    static NDArrayViewPtr AdoptInitializer(onnx::TensorProto &tensorProto, const std::string &name);
     static FunctionPtr CreateCNTKNode(const Node *node, const std::vector<Variable> &inputs, const Graph *graph,
         VariableToFunctionPtr &sequenceWrapperInputToFunctionPtr,
                                       const DeviceDescriptor &computeDevice);
@@ -373,7 +383,7 @@ void RetrieveRawDataAsDouble(const onnx::TensorProto &valueProto)
     if (!raw_data.empty())
     {
         auto buff = raw_data.c_str();
-        for (int i = 0; i < raw_data.size(); i += 4)
+        for (int i = 0; i < raw_data.size(); i += 8)
         {
             double v = UnpackDouble(buff + i, i);
             p_mutable_double_data->Add(v);
@@ -649,6 +659,140 @@ Constant ONNXToCNTKHelper::CreateConstant(const onnx::TensorProto &valueProto, c
     }
 }
 
+// Takes over the values of a repeated field of a TensorProto, leaving the field empty.
+template <typename T>
+std::shared_ptr<google::protobuf::RepeatedField<T>> ReleaseRepeatedField(google::protobuf::RepeatedField<T> *field)
+{
+    auto values = std::make_shared<google::protobuf::RepeatedField<T>>();
+    values->Swap(field);
+    return values;
+}
+
+NDArrayViewPtr ONNXToCNTKHelper::AdoptInitializer(onnx::TensorProto &tensorProto, const std::string &name)
+{
+    LoadRawDataAndUnpack(tensorProto, false);
+
+    // the ONNX layout of a tensor is the CNTK layout of the reversed shape, see CreateConstantWithTensorData.
+    NDShape reversedShape = ReverseShape(NDShape(std::vector<size_t>(tensorProto.dims().begin(), tensorProto.dims().end())));
+    auto tensorProtoDataType = tensorProto.data_type();
+    CNTK::DataType dataType = (tensorProtoDataType == TensorProto_DataType_FLOAT) ? CNTK::DataType::Float :
+                              (tensorProtoDataType == TensorProto_DataType_DOUBLE) ? CNTK::DataType::Double : CNTK::DataType::Float16;
+    size_t elementSize = DataTypeSize(dataType);
+    size_t totalSize = reversedShape.TotalSize();
+
+    // The view is created on the buffer that already holds the values whenever possible, the TensorProto
+    // no longer refers to it afterwards.
+    std::shared_ptr<void> storage;
+    void *data = nullptr;
+    size_t dataSize = 0;
+    if (!tensorProto.raw_data().empty())
+    {
+        std::shared_ptr<std::string> rawData(tensorProto.release_raw_data());
+        dataSize = rawData->size();
+        if (reinterpret_cast<uintptr_t>(rawData->data()) % elementSize == 0)
+        {
+            data = &(*rawData)[0];
+            storage = rawData;
+        }
+        else
+        {
+            auto alignedData = std::make_shared<std::vector<double>>((dataSize + sizeof(double) - 1) / sizeof(double));
+            memcpy(alignedData->data(), rawData->data(), dataSize);
+            data = alignedData->data();
+            storage = alignedData;
+        }
+    }
+    else if (tensorProtoDataType == TensorProto_DataType_FLOAT)
+    {
+        auto values = ReleaseRepeatedField(tensorProto.mutable_float_data());
+        dataSize = values->size() * elementSize;
+        data = values->mutable_data();
+        storage = values;
+    }
+    else if (tensorProtoDataType == TensorProto_DataType_DOUBLE)
+    {
+        auto values = ReleaseRepeatedField(tensorProto.mutable_double_data());
+        dataSize = values->size() * elementSize;
+        data = values->mutable_data();
+        storage = values;
+    }
+    else
+    {
+        // float16 values are stored one per int32 and have to be narrowed.
+        auto values = std::make_shared<std::vector<uint16_t>>(tensorProto.int32_data_size());
+        for (int i = 0; i < tensorProto.int32_data_size(); i++)
+            (*values)[i] = static_cast<uint16_t>(tensorProto.int32_data(i));
+        tensorProto.clear_int32_data();
+        dataSize = values->size() * elementSize;
+        data = values->data();
+        storage = values;
+    }
+
+    if (dataSize != totalSize * elementSize)
+        LogicError("The initializer '%s' has %d bytes of data, %d bytes are expected for its shape.", name.c_str(), (int)dataSize, (int)(totalSize * elementSize));
+
+    NDArrayViewPtr view(new NDArrayView(dataType, reversedShape, data, dataSize, DeviceDescriptor::CPUDevice()));
+    view->m_externalStorage = storage;
+    return view;
+}
+
+void ONNXToCNTKHelper::ConvertInitializers(onnxruntime::Graph *graph, ONNXToCNTKVariableMap &constructedNodeArgVariableMap,
+                                           const DeviceDescriptor &computeDevice)
+{
+    if (!CNTKIsLittleEndianOrder())
+        return;
+
+    // Initializers of recurrent ops are read from their TensorProto when the op is created, see CreateRNNConstant.
+    std::set<std::string> rnnInputs;
+    for (auto &node : graph->Nodes())
+    {
+        if (Operators::IsRNNOp(node.OpType()))
+        {
+            for (auto nodeArg : node.InputDefs())
+                rnnInputs.insert(nodeArg->Name());
+        }
+    }
+
+    std::vector<std::pair<std::string, onnx::TensorProto *>> tensors;
+    for (const auto &initializer : graph->GetAllInitializedTensors())
+    {
+        auto tensorProtoDataType = initializer.second->data_type();
+        if ((tensorProtoDataType != TensorProto_DataType_FLOAT && tensorProtoDataType != TensorProto_DataType_DOUBLE && tensorProtoDataType != TensorProto_DataType_FLOAT16) ||
+            GetTensorElementTotal(*initializer.second) == 0 || rnnInputs.find(initializer.first) != rnnInputs.end())
+            continue;
+
+        tensors.push_back({ initializer.first, const_cast<onnx::TensorProto *>(initializer.second) });
+    }
+
+    // The tensors are converted on the CPU in parallel, each of them by a single thread.
+    std::vector<NDArrayViewPtr> views(tensors.size());
+    std::atomic<size_t> nextTensor(0);
+    auto convert = [&tensors, &views, &nextTensor]() {
+        for (size_t i = nextTensor++; i < tensors.size(); i = nextTensor++)
+            views[i] = AdoptInitializer(*tensors[i].second, tensors[i].first);
+    };
+
+    size_t numberOfThreads = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1), tensors.size());
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < numberOfThreads; ++i)
+        futures.push_back(std::async(std::launch::async, convert));
+    convert();
+    for (auto &future : futures)
+        future.get();
+
+    // Copies to the device are made one at a time, the CPU buffer of each tensor is released right after its copy.
+    // The Constants are found as leaf inputs by CreateCNTKInputsStartingFromIndex, like other constructed leaves.
+    for (size_t i = 0; i < tensors.size(); ++i)
+    {
+        NDArrayViewPtr view = views[i];
+        views[i] = nullptr;
+        if (computeDevice.Type() != DeviceKind::CPU)
+            view = view->DeepClone(computeDevice, /*readOnly=*/false);
+        Constant constant(view, ToFixedWStringFromMultiByte(tensors[i].first));
+        constructedNodeArgVariableMap.insert(ONNXToCNTKVariableMap::value_type(tensors[i].first, constant));
+    }
+}
+
 template <typename T>
 void CopyFromProto(const onnx::TensorProto &src, T &dst, vector<int> &srcIndexRange, int dstIndex)
 {
@@ -720,6 +864,8 @@ const CNTK::Constant CNTK::ONNXToCNTKHelper::CreateConstantWithTensorData(CNTK::
 
     NDArrayViewPtr dstFinal(new NDArrayView(cntkDataType, reversedShape, &data[0],
                                             totalSize * sizeof(TDst), computeDevice.CPUDevice()));
+    // The view does not own the buffer it is created on, the buffer is released with the last view of it.
+    dstFinal->m_externalStorage = std::shared_ptr<TDst>(data, std::default_delete<TDst[]>());
 
     if (computeDevice.Type() == DeviceKind::CPU)
     {
@@ -3743,6 +3889,8 @@ FunctionPtr ONNXToCNTK::CreateGraph(onnxruntime::Graph *src, const DeviceDescrip
     ONNXToCNTKVariableMap constructedNodeArgVariableMap;
     VariableToFunctionPtr sequenceWrapperInputToFunctionPtr;
 
+    ONNXToCNTKHelper::ConvertInitializers(src, constructedNodeArgVariableMap, computeDevice);
+
     const GraphNodes &nodes = src->Nodes();
     for (GraphNodes::ConstNodeIterator it = nodes.cbegin(); it != nodes.cend(); ++it)
     {
@@ -62,6 +62,8 @@ ASGDHelper<ElemType>* NewASGDHelper(
     double adjustCoef = 0.2,                                                 // see in DecayCoefficient()
     size_t adjustPerMinibatches = 600,                                       //
     int traceLevel = 0,                                                      // log level
-    int syncPerfStats = 0);                                                  // shown perf data every syncPerfStats
+    int syncPerfStats = 0,                                                   // shown perf data every syncPerfStats
+    size_t maxStaleness = SIZE_MAX,                                          // pushes a worker may be ahead of the slowest one (in-tree parameter server only)
+    double serverMomentum = 0);                                              // momentum applied on the servers (in-tree parameter server only)
 
 }}}
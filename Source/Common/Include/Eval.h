@@ -296,6 +296,17 @@ class VariableSchema : public std::vector<VariableLayout>
         }
 };
 
+//
+// Opaque handle to the recurrent state of a stream, i.e. the values the recurrent nodes (PastValue, FutureValue) of a
+// model carry over from one ForwardPass() to the next. The state can be imported into any evaluator of the same model.
+//
+class IRecurrentState
+{
+public:
+    virtual ~IRecurrentState() {}
+};
+typedef std::shared_ptr<IRecurrentState> RecurrentStatePtr;
+
 //
 // Extended interface, allowing for sparse input.
 // Implementation constraints: 
@@ -355,6 +366,30 @@ public:
     // resetRNN - flags whether to reset memory cells of RNN. 
     //
     virtual void ForwardPass(const ValueRefs<ElemType>& inputs, ValueRefs<ElemType>& output, bool resetRNN) = 0;
+
+    //
+    // ExportRecurrentState - retrieve the state that the last ForwardPass() carries over to the next ForwardPass()
+    // with resetRNN == false. Only the frames the recurrent nodes can still reach are kept.
+    // Returns nullptr if nothing has been evaluated yet.
+    //
+    virtual RecurrentStatePtr ExportRecurrentState() const = 0;
+
+    //
+    // ImportRecurrentState - replace the recurrent state of the evaluator, so that the next ForwardPass() with
+    // resetRNN == false continues the stream the state was exported from. This allows one evaluator to serve many
+    // streams, one chunk at a time. Importing nullptr discards the state; the next ForwardPass() must then reset the RNN.
+    //
+    virtual void ImportRecurrentState(const RecurrentStatePtr& state) = 0;
+
+    //
+    // SwapRecurrentState - import the given state and return the one it replaces.
+    //
+    RecurrentStatePtr SwapRecurrentState(const RecurrentStatePtr& state)
+    {
+        auto previousState = ExportRecurrentState();
+        ImportRecurrentState(state);
+        return previousState;
+    }
 };
 
 template <typename ElemType>
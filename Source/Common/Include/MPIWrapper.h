@@ -101,6 +101,7 @@ public:
     virtual int Wait(MPI_Request* request, MPI_Status* status) = 0;
     virtual int Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status) = 0;
     virtual int Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]) = 0;
+    virtual int Test(MPI_Request* request, int* flag, MPI_Status* status) = 0;
     virtual int Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, /*MPI_Comm comm,*/ MPI_Request* request) = 0;
     virtual int Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Status* status) = 0;
     virtual int Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Request* request) = 0;
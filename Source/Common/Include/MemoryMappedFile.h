@@ -0,0 +1,161 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "Basics.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// MemoryMappedFile -- a read-only mapping of a complete file into the address space.
+// The pages are shared between all processes mapping the same file, and are only
+// brought in by the OS when touched. A copy-on-write mapping can also be written to:
+// written pages become private to the process, and the file itself is never modified. The mapping is released when the object is destroyed,
+// so users that hand out pointers into the mapping should hold on to a shared_ptr to it
+// (e.g. through an aliasing shared_ptr).
+// -----------------------------------------------------------------------
+
+class MemoryMappedFile
+{
+public:
+    // Returns nullptr if the file does not exist, is empty or cannot be mapped.
+    static std::shared_ptr<MemoryMappedFile> TryOpen(const std::wstring& filename, bool copyOnWrite = false)
+    {
+        std::shared_ptr<MemoryMappedFile> result(new MemoryMappedFile(filename, copyOnWrite));
+        if (!result->Map())
+            return nullptr;
+        return result;
+    }
+
+    static std::shared_ptr<MemoryMappedFile> OpenOrDie(const std::wstring& filename, bool copyOnWrite = false)
+    {
+        auto result = TryOpen(filename, copyOnWrite);
+        if (!result)
+            RuntimeError("Error memory-mapping file '%ls'.", filename.c_str());
+        return result;
+    }
+
+    ~MemoryMappedFile()
+    {
+        Unmap();
+    }
+
+    const uint8_t* Data() const { return m_data; }
+
+    uint8_t* WritableData() const
+    {
+        if (!m_copyOnWrite)
+            LogicError("The memory-mapped file '%ls' is read-only.", m_filename.c_str());
+        return const_cast<uint8_t*>(m_data);
+    }
+
+    size_t Size() const { return m_size; }
+
+    const std::wstring& Filename() const { return m_filename; }
+
+    // Tells the OS that the whole mapping will be read sequentially, so it can read ahead aggressively.
+    void AdviseSequential() const
+    {
+#ifndef _WIN32
+        madvise(const_cast<uint8_t*>(m_data), m_size, MADV_SEQUENTIAL);
+#endif
+    }
+
+private:
+    MemoryMappedFile(const std::wstring& filename, bool copyOnWrite)
+        : m_filename(filename), m_copyOnWrite(copyOnWrite), m_data(nullptr), m_size(0)
+#ifdef _WIN32
+        , m_file(INVALID_HANDLE_VALUE), m_mapping(NULL)
+#endif
+    {}
+
+#ifdef _WIN32
+    bool Map()
+    {
+        m_file = CreateFileW(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+            return false;
+        m_size = (size_t)size.QuadPart;
+
+        m_mapping = CreateFileMappingW(m_file, NULL, m_copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping == NULL)
+            return false;
+
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, m_copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+        return m_data != nullptr;
+    }
+
+    void Unmap()
+    {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping != NULL)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+    }
+
+    HANDLE m_file;
+    HANDLE m_mapping;
+#else
+    bool Map()
+    {
+        int fd = open(wtocharpath(m_filename).c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        m_size = (size_t)st.st_size;
+        void* data = mmap(nullptr, m_size, m_copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, m_copyOnWrite ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        close(fd); // the mapping keeps its own reference to the file.
+
+        if (data == MAP_FAILED)
+            return false;
+
+        m_data = static_cast<const uint8_t*>(data);
+        return true;
+    }
+
+    void Unmap()
+    {
+        if (m_data)
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+
+    std::wstring m_filename;
+    bool m_copyOnWrite;
+    const uint8_t* m_data;
+    size_t m_size;
+
+    DISABLE_COPY_AND_MOVE(MemoryMappedFile);
+};
+
+}}}
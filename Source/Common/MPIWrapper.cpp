@@ -83,6 +83,7 @@ public:
     virtual int Wait(MPI_Request* request, MPI_Status* status);
     virtual int Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status);
     virtual int Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]);
+    virtual int Test(MPI_Request* request, int* flag, MPI_Status* status);
     virtual int Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
     virtual int Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Status* status);
     virtual int Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
@@ -180,6 +181,7 @@ public:
     virtual int Wait(MPI_Request* request, MPI_Status* status);
     virtual int Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status);
     virtual int Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]);
+    virtual int Test(MPI_Request* request, int* flag, MPI_Status* status);
     virtual int Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
     virtual int Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Status* status);
     virtual int Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
@@ -626,6 +628,11 @@ int MPIWrapperMpi::Waitall(int count, MPI_Request array_of_requests[], MPI_Statu
     return MPI_Waitall(count, array_of_requests, array_of_statuses);
 }
 
+int MPIWrapperMpi::Test(MPI_Request* request, int* flag, MPI_Status* status)
+{
+    return MPI_Test(request, flag, status);
+}
+
 int MPIWrapperMpi::Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Request* request)
 {
     return MPI_Isend(buf, count, datatype, dest, tag, m_currentComm, request);
@@ -1009,6 +1016,11 @@ int MPIWrapperEmpty::Waitall(int count, MPI_Request array_of_requests[], MPI_Sta
     return MPI_UNDEFINED;
 }
 
+int MPIWrapperEmpty::Test(MPI_Request* request, int* flag, MPI_Status* status)
+{
+    return MPI_UNDEFINED;
+}
+
 int MPIWrapperEmpty::Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Request* request)
 {
     return MPI_UNDEFINED;
@@ -46,6 +46,9 @@ struct ComputationEnvironment
 
     bool isV2Library = false;
 
+    // an inference-only network is never backpropagated through, so nodes need not keep state for a backward pass
+    bool inferenceOnly = false;
+
     // traceLevel
     int traceLevel = 0;
 
@@ -56,6 +59,8 @@ struct ComputationEnvironment
 
     bool IsV2Library() const { return isV2Library; }
 
+    bool IsInferenceOnly() const { return inferenceOnly; }
+
     // more properties should be added here as needed
 };
 typedef std::shared_ptr<ComputationEnvironment> ComputationEnvironmentPtr;
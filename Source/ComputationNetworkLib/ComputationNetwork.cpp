@@ -53,6 +53,24 @@ vector<MemRequestInfo<half>>& MatrixPool::GetMemRequestInfoVec<half>()
     return m_memRequestInfoHalfVec;
 }
 
+template <>
+vector<shared_ptr<Matrix<float>>>& MatrixPool::GetBufferVec<float>()
+{
+    return m_bufferFloatVec;
+}
+
+template <>
+vector<shared_ptr<Matrix<double>>>& MatrixPool::GetBufferVec<double>()
+{
+    return m_bufferDoubleVec;
+}
+
+template <>
+vector<shared_ptr<Matrix<half>>>& MatrixPool::GetBufferVec<half>()
+{
+    return m_bufferHalfVec;
+}
+
 // -----------------------------------------------------------------------
 // construction
 // -----------------------------------------------------------------------
@@ -150,6 +150,10 @@ public:
     // main entry point for backprop
     void Backprop(const ComputationNodeBasePtr rootNode);
 
+    // backprop through the nested network of rootNode, whose gradient must already be set;
+    // 'gradientCompleted' is called for every leaf that needs a gradient as soon as the gradient is final
+    void BackpropNestedNetwork(const ComputationNodeBasePtr& rootNode, const std::function<void(const ComputationNodeBasePtr&)>& gradientCompleted);
+
     template <class NODESET> // version that takes multiple nodes
     void TravserseInSortedGlobalEvalOrder(const NODESET& nodes, const std::function<void(const ComputationNodeBasePtr&)>& action)
     {
@@ -268,12 +272,18 @@ private:
 public:
     void AllocateAllMatrices(const std::vector<ComputationNodeBasePtr>& evalRootNodes, const std::vector<ComputationNodeBasePtr>& outValueRootNodes, ComputationNodeBasePtr trainRootNode);
 
+    // Pooled activation memory: the buffers of the matrix pool plus the values and gradients of the nodes that are not drawn from it,
+    // excluding the learnable parameters. Matrices a node creates for itself outside of the pool (e.g. by CreateMatrixIfNull()) are not included.
+    // Matrices only grow, so after a minibatch has been computed this is the peak pooled memory used for a minibatch of its size.
+    size_t GetActivationMemoryInBytes() const;
+
     // From the set of nodes extract all nodes which are used as accumulator nodes.
     std::set<ComputationNodeBasePtr> ExtractNodesWhichAccumulateResult(std::set<ComputationNodeBasePtr> nodes);
 
 private:
     void PrintMemorySharingStructure(const std::vector<ComputationNodeBasePtr>& nodes);
-    void ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap);
+    void ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap,
+                                             const std::unordered_map<ComputationNodeBasePtr, std::pair<MatrixPool::RequestMark, MatrixPool::RequestMark>>& forwardPropRequests);
 
 public:
     // -----------------------------------------------------------------------
@@ -970,6 +980,13 @@ public:
     }
     bool GetIsV2Library() const { return m_environment->isV2Library; }
 
+    // An inference-only network allocates no gradients and releases the temporaries of a node together with its value.
+    void SetInferenceOnly(bool enable)
+    {
+        m_environment->inferenceOnly = enable;
+    }
+    bool IsInferenceOnly() const { return m_environment->inferenceOnly; }
+
     void SetTraceLevel(int traceLevel)
     {
         m_environment->traceLevel = traceLevel;
@@ -1201,6 +1218,9 @@ protected:
         virtual void EndBackprop() override {}
 
         virtual void Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) override;
+        // same as above, additionally calls 'gradientCompleted' for each leaf that needs a gradient, right after
+        // the reverse traversal has reached it, i.e. after all nodes consuming it have contributed to its gradient
+        void Backprop(const FrameRange& fr, const std::function<void(const ComputationNodeBasePtr&)>& gradientCompleted);
         virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool);
         virtual void ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool);
         virtual void AllocateGradientMatricesForInputs(MatrixPool& matrixPool);
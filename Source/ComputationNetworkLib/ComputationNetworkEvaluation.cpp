@@ -89,6 +89,15 @@ void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // trai
     GetNestedNetwork(rootNode)->Backprop(FrameRange(nullptr), true, true);
 }
 
+void ComputationNetwork::BackpropNestedNetwork(const ComputationNodeBasePtr& rootNode, const std::function<void(const ComputationNodeBasePtr&)>& gradientCompleted)
+{
+    auto network = dynamic_pointer_cast<PARTraversalFlowControlNode>(GetNestedNetwork(rootNode));
+    if (!network)
+        LogicError("BackpropNestedNetwork: Nested network of %ls %ls operation is not a PAR traversal.", rootNode->NodeName().c_str(), rootNode->OperationName().c_str());
+
+    network->Backprop(FrameRange(nullptr), gradientCompleted);
+}
+
 void ComputationNetwork::FormNestedNetwork(const ComputationNodeBasePtr& rootNode)
 {
     if (m_nestedNetworks.find(rootNode) != m_nestedNetworks.end())
@@ -180,6 +189,11 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) /*override*/
 {
     childrenInThisLoop, childrenInOuterLoop; // TODO: think through what these mean when coming from PAR mode
+    Backprop(fr, nullptr);
+}
+
+void ComputationNetwork::PARTraversalFlowControlNode::Backprop(const FrameRange& fr, const std::function<void(const ComputationNodeBasePtr&)>& gradientCompleted)
+{
     // process nodes in pre-determined order
     for (auto pnode = m_nestedNodes.rbegin(); pnode != m_nestedNodes.rend(); pnode++) // iterate backwards over evaluation order
     {
@@ -194,6 +208,10 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
         // Extreme Tracing, part 2/4
         if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode() && node->NeedsGradient())
             DumpNode(node, /*dumpGradient=*/true);
+
+        // all consumers of a leaf come after it in evaluation order, so its gradient is final now
+        if (gradientCompleted && node->IsLeaf() && node->NeedsGradient())
+            gradientCompleted(node);
     }
 }
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) /*override*/
@@ -1088,6 +1106,8 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     MarkValueNonSharableNodes();
 
     bool performingBackPropagation = (trainRootNode != nullptr);
+    if (performingBackPropagation && IsInferenceOnly())
+        LogicError("AllocateAllMatrices: An inference-only network cannot be allocated for back propagation from '%ls'.", trainRootNode->NodeName().c_str());
 
     // Create a composite Eval order with the specified nodes as roots
     // For each node determine parents and whether the output of the
@@ -1158,25 +1178,33 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
 
     m_matrixPool.Reset();
 
-    TravserseInSortedGlobalEvalOrder(forwardPropRoots, [&outputValueNeededDuringBackProp, &parentsMap, this](const ComputationNodeBasePtr& node) {
+    // the requests each node makes for its forward computation, recorded in an inference-only network to release them together with the value of the node
+    std::unordered_map<ComputationNodeBasePtr, std::pair<MatrixPool::RequestMark, MatrixPool::RequestMark>> forwardPropRequests;
+
+    TravserseInSortedGlobalEvalOrder(forwardPropRoots, [&outputValueNeededDuringBackProp, &parentsMap, &forwardPropRequests, this](const ComputationNodeBasePtr& node) {
         if (node->Is<SEQTraversalFlowControlNode>())
         {
             auto seqTraversalFlowControlNode = node->As<SEQTraversalFlowControlNode>();
             for (auto& loopNode : seqTraversalFlowControlNode->m_nestedNodes)
                 loopNode->SetOutputNeededDuringBackprop(outputValueNeededDuringBackProp[loopNode]);
 
+            // the nodes of a loop are computed frame by frame, so their temporaries are kept as they are requested
             seqTraversalFlowControlNode->RequestMatricesBeforeForwardProp(m_matrixPool);
 
             for (auto& loopNode : seqTraversalFlowControlNode->m_nestedNodes)
-                ReleaseMatricesAfterEvalForChildren(loopNode, parentsMap);
+                ReleaseMatricesAfterEvalForChildren(loopNode, parentsMap, forwardPropRequests);
         }
         else
         {
             node->SetOutputNeededDuringBackprop(outputValueNeededDuringBackProp[node]);
+            auto begin = m_matrixPool.GetRequestMark();
             node->RequestMatricesBeforeForwardProp(m_matrixPool);
+            if (IsInferenceOnly())
+                forwardPropRequests[node] = std::make_pair(begin, m_matrixPool.GetRequestMark());
+
             // we only release matrices for the children since the root node's information will be used
             // and should not be shared with others
-            ReleaseMatricesAfterEvalForChildren(node, parentsMap);
+            ReleaseMatricesAfterEvalForChildren(node, parentsMap, forwardPropRequests);
         }
     });
 
@@ -1283,7 +1311,8 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         PrintMemorySharingStructure(GetAllNodes());
 }
 
-void ComputationNetwork::ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap)
+void ComputationNetwork::ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap,
+                                                             const std::unordered_map<ComputationNodeBasePtr, std::pair<MatrixPool::RequestMark, MatrixPool::RequestMark>>& forwardPropRequests)
 {
     for (int i = 0; i < n->GetNumInputs(); i++)
     {
@@ -1292,9 +1321,50 @@ void ComputationNetwork::ReleaseMatricesAfterEvalForChildren(ComputationNodeBase
         {
             parentsMap[pNode].erase(n);
             if (parentsMap[pNode].empty())
+            {
                 pNode->ReleaseMatricesAfterForwardProp(m_matrixPool);
+
+                // Without a backward pass, the matrices a node keeps for it (e.g. the saved statistics of BatchNormalization
+                // or the reserve space of OptimizedRNNStack) are not needed once all parents have consumed the value.
+                auto requests = forwardPropRequests.find(pNode);
+                if (requests != forwardPropRequests.end() && !pNode->IsOutputNeededDuringBackprop())
+                    m_matrixPool.RequestReleaseBetween(requests->second.first, requests->second.second);
+            }
         }
     }
 }
 
+size_t ComputationNetwork::GetActivationMemoryInBytes() const
+{
+    if (!AreMatricesAllocated())
+        return 0;
+
+    // the values and gradients that are not drawn from the pool, such as the values of the inputs and of the roots;
+    // GetMatrixInfo() does not list the private temporaries of a node
+    std::set<const MatrixBase*> matrices;
+    for (const auto& node : GetAllNodes())
+    {
+        if (node->OperationName() == OperationNameOf(LearnableParameter))
+            continue;
+
+        for (const auto& item : node->GetMatrixInfo())
+        {
+            if (item.first && !m_matrixPool.IsBuffer(item.first))
+                matrices.insert(item.first);
+        }
+    }
+
+    size_t size = m_matrixPool.GetBufferSizeInBytes();
+    for (const auto& matrix : matrices)
+    {
+        if (auto floatMatrix = dynamic_cast<const Matrix<float>*>(matrix))
+            size += floatMatrix->BufferSize();
+        else if (auto doubleMatrix = dynamic_cast<const Matrix<double>*>(matrix))
+            size += doubleMatrix->BufferSize();
+        else if (auto halfMatrix = dynamic_cast<const Matrix<half>*>(matrix))
+            size += halfMatrix->BufferSize();
+    }
+    return size;
+}
+
 }}}
@@ -162,6 +162,11 @@ struct /*interface*/ IStatefulNode
     typedef std::shared_ptr<INodeState> NodeStatePtr;
     virtual NodeStatePtr ExportState() = 0;
     virtual void ImportState(const NodeStatePtr& state) = 0;
+
+    // the complete state carried over to the next minibatch, e.g. to continue a stream after other streams have been computed
+    // Importing nullptr discards the state, the next minibatch then has to begin all its sequences.
+    virtual NodeStatePtr ExportCarriedOverState() const = 0;
+    virtual void ImportCarriedOverState(const NodeStatePtr& state) = 0;
 };
 typedef IStatefulNode::NodeStatePtr NodeStatePtr;
 
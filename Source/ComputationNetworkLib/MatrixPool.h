@@ -79,6 +79,14 @@ protected:
     template <class ElemType>
     vector<MemRequestInfo<ElemType>>& GetMemRequestInfoVec();
 
+    // the buffers created by OptimizedMemoryAllocation(), which the requested matrix pointers refer to
+    vector<shared_ptr<Matrix<float>>> m_bufferFloatVec;
+    vector<shared_ptr<Matrix<double>>> m_bufferDoubleVec;
+    vector<shared_ptr<Matrix<half>>> m_bufferHalfVec;
+
+    template <class ElemType>
+    vector<shared_ptr<Matrix<ElemType>>>& GetBufferVec();
+
     // MatrixPool allows a bunch of node to share one matrix
 
     struct AliasInfo
@@ -128,6 +136,41 @@ public:
         m_stepCounter++; 
     }
 
+    // number of memory requests made so far for each element type
+    // Two marks taken around the requests of a node identify the requests of that node.
+    struct RequestMark
+    {
+        size_t numFloatRequests;
+        size_t numDoubleRequests;
+        size_t numHalfRequests;
+    };
+
+    RequestMark GetRequestMark() const
+    {
+        return { m_memRequestInfoFloatVec.size(), m_memRequestInfoDoubleVec.size(), m_memRequestInfoHalfVec.size() };
+    }
+
+    // release all requests made between the two marks that have not been released yet
+    void RequestReleaseBetween(const RequestMark& begin, const RequestMark& end)
+    {
+        ReleaseBetween(m_memRequestInfoFloatVec, begin.numFloatRequests, end.numFloatRequests);
+        ReleaseBetween(m_memRequestInfoDoubleVec, begin.numDoubleRequests, end.numDoubleRequests);
+        ReleaseBetween(m_memRequestInfoHalfVec, begin.numHalfRequests, end.numHalfRequests);
+        m_stepCounter++;
+    }
+
+    // total size of the buffers created by OptimizedMemoryAllocation(), in bytes
+    // Since a matrix never shrinks, after a minibatch has been computed this is the peak memory used by the pool for it.
+    size_t GetBufferSizeInBytes() const
+    {
+        return BufferSizeInBytes(m_bufferFloatVec) + BufferSizeInBytes(m_bufferDoubleVec) + BufferSizeInBytes(m_bufferHalfVec);
+    }
+
+    bool IsBuffer(const MatrixBase* matrix) const
+    {
+        return IsBufferOf(m_bufferFloatVec, matrix) || IsBufferOf(m_bufferDoubleVec, matrix) || IsBufferOf(m_bufferHalfVec, matrix);
+    }
+
     // isWorkSpace is a flag indicating a memory is temporary and will be released very shortly. In the current implementation, all workspace
     // memories will have their own pool. This is a design proven to be useful for the workspace memory in convolution. 
     // matrixSize is an estimate of the required memory to be allocated. Note we don't allocate any memory at the time of request. Instead, a 
@@ -228,6 +271,36 @@ public:
     }
 
 private: 
+    template <class ElemType>
+    void ReleaseBetween(vector<MemRequestInfo<ElemType>>& memInfoVec, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (memInfoVec[i].releaseStep == INT_MAX)
+                memInfoVec[i].SetReleaseStep(m_stepCounter);
+        }
+    }
+
+    template <class ElemType>
+    static size_t BufferSizeInBytes(const vector<shared_ptr<Matrix<ElemType>>>& bufferVec)
+    {
+        size_t size = 0;
+        for (const auto& buffer : bufferVec)
+            size += buffer->BufferSize();
+        return size;
+    }
+
+    template <class ElemType>
+    static bool IsBufferOf(const vector<shared_ptr<Matrix<ElemType>>>& bufferVec, const MatrixBase* matrix)
+    {
+        for (const auto& buffer : bufferVec)
+        {
+            if (buffer.get() == matrix)
+                return true;
+        }
+        return false;
+    }
+
     bool CheckOverlap(pair<int, int>occ, vector<pair<int, int>>&occVec)
     {
         bool bRet = false;
@@ -374,6 +447,7 @@ private:
                     auto matrixPtr = make_shared<Matrix<ElemType>>(devId);
                     if (!matrixPtr) // this can't really happen, because we haven't started allocating memory yet
                         LogicError("MatrixPool: failed to get a valid matrix.");
+                    GetBufferVec<ElemType>().push_back(matrixPtr);
                     for (auto& memInfo : memInfoVec)
                     {
                         if (memInfo.deviceId == devId && memInfo.isWorkSpace == wsFlag && memInfo.memoryId == i)
@@ -103,6 +103,9 @@ void OptimizedRNNStackNode<ElemType>::ForwardProp(const FrameRange& fr)
     // The parameters are stored in a column matrix
     Matrix<ElemType>& paramW = InputRef(0).Value();
 
+    // Without a backward pass cuDNN needs no reserve space to be kept between forward and backward.
+    bool inferenceOnly = !Environment().IsTraining();
+
     MBLayoutPtr mb = GetMBLayout();
     if (m_rnnAttributes.IsSpatialRecurrence())
     {
@@ -131,7 +134,7 @@ void OptimizedRNNStackNode<ElemType>::ForwardProp(const FrameRange& fr)
 
         // create a vector with the correct number of timesteps(shapeXT[2]) containing the sequence count (shapeXT[1])
         numSequencesForFrame = vector<size_t>(shapeXT[2], shapeXT[1]);
-        m_transposedOutput->RNNForward(*m_transposedInput, paramW, shapeXT[0], shapeYT[0], numSequencesForFrame, m_rnnAttributes, *m_reserve, *m_workspace);
+        m_transposedOutput->RNNForward(*m_transposedInput, paramW, shapeXT[0], shapeYT[0], numSequencesForFrame, m_rnnAttributes, *m_reserve, *m_workspace, inferenceOnly);
 
         // No one uses shapeY, but it is necessary
         TensorShape shapeY;
@@ -148,7 +151,7 @@ void OptimizedRNNStackNode<ElemType>::ForwardProp(const FrameRange& fr)
         // ensure enough storage
         m_transposedOutput->Resize(this->Value().GetNumRows(), m_transposedInput->GetNumCols());
 
-        m_transposedOutput->RNNForward(*m_transposedInput, paramW, shapeXT[0], shapeYT[0], numSequencesForFrame, m_rnnAttributes, *m_reserve, *m_workspace);
+        m_transposedOutput->RNNForward(*m_transposedInput, paramW, shapeXT[0], shapeYT[0], numSequencesForFrame, m_rnnAttributes, *m_reserve, *m_workspace, inferenceOnly);
         this->UnpackSequencesFromCuDNN(*m_transposedOutput, this->Value());
     }
     m_BackwardDataCalledYet = false;
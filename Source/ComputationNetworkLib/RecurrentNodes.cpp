@@ -591,6 +591,63 @@ template<class ElemType, int direction>
         LogicError("Unrecognized direction in DelayedValueNodeBase");
 }
 
+template<class ElemType, int direction>
+/*virtual*/ NodeStatePtr DelayedValueNodeBase<ElemType, direction>::/*IStatefulNode::*/ ExportCarriedOverState() const /*override*/
+{
+    if (!m_delayedActivationMBLayout) // nothing computed yet
+        return nullptr;
+
+    // Only the last frames of m_delayedValue can be reached from the next minibatch: m_timeStep frames,
+    // plus the right splice of latency-controlled BLSTMs. The layout is shifted to keep the same time indices relative to its end.
+    size_t nT = m_delayedActivationMBLayout->GetNumTimeSteps();
+    size_t nU = m_delayedActivationMBLayout->GetNumParallelSequences();
+    size_t numTimeSteps = min(nT, (size_t)m_timeStep + m_delayedActivationMBLayout->RightSplice());
+    size_t shift = nT - numTimeSteps;
+
+    auto pMBLayout = make_shared<MBLayout>();
+    pMBLayout->Init(nU, numTimeSteps);
+    for (auto sequence : m_delayedActivationMBLayout->GetAllSequences())
+    {
+        if (sequence.tEnd <= shift) // ended before the kept frames
+            continue;
+
+        sequence.tBegin -= (ptrdiff_t)shift;
+        sequence.tEnd -= shift;
+        pMBLayout->AddSequence(sequence);
+    }
+
+    auto pState = make_shared<DelayedValueNodeState<ElemType>>(m_deviceId);
+    pState->CacheState(m_delayedValue->ColumnSlice(shift * nU, numTimeSteps * nU));
+    pState->CacheDelayedMBLayout(pMBLayout);
+    return pState;
+}
+
+template<class ElemType, int direction>
+/*virtual*/ void DelayedValueNodeBase<ElemType, direction>::/*IStatefulNode::*/ ImportCarriedOverState(const NodeStatePtr& pImportedState) /*override*/
+{
+    if (!pImportedState)
+    {
+        m_delayedValue->Resize(m_sampleLayout.GetNumElements(), 0);
+        m_delayedActivationMBLayout = nullptr;
+        return;
+    }
+
+    DelayedNodeStatePtr pState = dynamic_pointer_cast<DelayedValueNodeState<ElemType>>(pImportedState);
+    if (!pState || pState->IsEmpty())
+        LogicError("%ls %ls operation: Expecting the state exported by a node of the same type.", NodeName().c_str(), OperationName().c_str());
+
+    const Matrix<ElemType>& delayedActivation = pState->ExportCachedActivity();
+    if (delayedActivation.GetNumRows() != m_sampleLayout.GetNumElements())
+        InvalidArgument("%ls %ls operation: The imported state has dimension %d, but the node has dimension %d.",
+                        NodeName().c_str(), OperationName().c_str(), (int)delayedActivation.GetNumRows(), (int)m_sampleLayout.GetNumElements());
+
+    // the state may come from a network on a different device
+    m_delayedValue->AssignValuesOf(delayedActivation);
+    if (!m_delayedActivationMBLayout)
+        m_delayedActivationMBLayout = make_shared<MBLayout>();
+    pState->ExportDelayedMBLayout(m_delayedActivationMBLayout);
+}
+
 // instantiate the classes that derive from the above
 template class PastValueNode<float>;
 template class PastValueNode<double>;
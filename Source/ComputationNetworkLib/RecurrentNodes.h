@@ -73,6 +73,8 @@ public:
     virtual int /*IRecurrentNode::*/ GetRecurrenceSteppingDirection() const override { return -direction; }
     virtual NodeStatePtr /*IStatefulNode::*/ ExportState() override;
     virtual void /*IStatefulNode::*/ ImportState(const NodeStatePtr& pImportedState) override;
+    virtual NodeStatePtr /*IStatefulNode::*/ ExportCarriedOverState() const override;
+    virtual void /*IStatefulNode::*/ ImportCarriedOverState(const NodeStatePtr& pImportedState) override;
     int TimeStep() const { return m_timeStep; }
     ElemType InitialActivationValue() const { return m_initialStateValue; }
 
@@ -270,6 +270,13 @@ void CNTKEvalExtended<ElemType>::StartForwardEvaluation(const std::vector<wstrin
         shared_ptr<Matrix<ElemType>> outputMatrix = dynamic_pointer_cast<Matrix<ElemType>>(node->ValuePtr());
         if (outputMatrix->GetMatrixType() != MatrixType::DENSE)
             RuntimeError("Sparse outputs are not supported by this API.");
+
+        for (const auto& n : this->m_net->GetAllNodesForRoot(node))
+        {
+            auto statefulNode = dynamic_pointer_cast<IStatefulNode>(n);
+            if (statefulNode)
+                m_statefulNodes[n->NodeName()] = statefulNode;
+        }
     }
 
     m_started = true;
@@ -434,6 +441,58 @@ void CNTKEvalExtended<ElemType>::ForwardPass(const ValueRefs<ElemType>& inputs,
     ForwardPassT(inputs, outputs, resetRNN);
 }
 
+// The states carried over by the stateful nodes of the network, by node name.
+class NetworkRecurrentState : public IRecurrentState
+{
+public:
+    std::map<std::wstring, NodeStatePtr> m_nodeStates;
+};
+
+template<typename ElemType>
+RecurrentStatePtr CNTKEvalExtended<ElemType>::ExportRecurrentState() const
+{
+    if (!m_started)
+        RuntimeError("ExportRecurrentState() called before StartForwardEvaluation()");
+
+    auto state = make_shared<NetworkRecurrentState>();
+    for (const auto& statefulNode : m_statefulNodes)
+    {
+        auto nodeState = statefulNode.second->ExportCarriedOverState();
+        if (!nodeState)
+            return nullptr;
+
+        state->m_nodeStates[statefulNode.first] = nodeState;
+    }
+    return state;
+}
+
+template<typename ElemType>
+void CNTKEvalExtended<ElemType>::ImportRecurrentState(const RecurrentStatePtr& state)
+{
+    if (!m_started)
+        RuntimeError("ImportRecurrentState() called before StartForwardEvaluation()");
+
+    if (!state)
+    {
+        for (const auto& statefulNode : m_statefulNodes)
+            statefulNode.second->ImportCarriedOverState(nullptr);
+        return;
+    }
+
+    auto networkState = dynamic_pointer_cast<NetworkRecurrentState>(state);
+    if (!networkState)
+        RuntimeError("ImportRecurrentState: The state was not exported by ExportRecurrentState().");
+
+    for (const auto& statefulNode : m_statefulNodes)
+    {
+        auto nodeState = networkState->m_nodeStates.find(statefulNode.first);
+        if (nodeState == networkState->m_nodeStates.end())
+            RuntimeError("ImportRecurrentState: The state does not contain the recurrent node '%ls'; was it exported from a different model?", statefulNode.first.c_str());
+
+        statefulNode.second->ImportCarriedOverState(nodeState->second);
+    }
+}
+
 template <typename ElemType>
 void CNTKEvalExtended<ElemType>::Destroy()
 {
@@ -107,6 +107,10 @@ public:
 
     virtual void ForwardPass(const ValueRefs<ElemType>& inputs, ValueRefs<ElemType>& output, bool resetRNN) override;
 
+    virtual RecurrentStatePtr ExportRecurrentState() const override;
+
+    virtual void ImportRecurrentState(const RecurrentStatePtr& state) override;
+
     virtual void Destroy() override;
 
     virtual void CreateNetwork(const std::string& networkDescription) override
@@ -125,6 +129,7 @@ private:
     std::shared_ptr<ScopedNetworkOperationMode> m_scopedNetworkOperationMode;
     std::vector<ComputationNodeBasePtr> m_inputNodes;
     StreamMinibatchInputs m_inputMatrices;
+    std::map<std::wstring, shared_ptr<IStatefulNode>> m_statefulNodes;
     bool m_started;
 
     template<template<typename> class ValueContainer> 
@@ -114,6 +114,8 @@ public:
     void AdaDelta(CPUMatrix<GradType>& gradients, CPUMatrix<ElemType>& functionValues, ElemType learningRate, ElemType rho, ElemType epsilon);
 
     void AdaDeltaFlushTimestamps(size_t cols, ElemType rho, int* timestamps, int currentTimestamp);
+    void MomentumSGDFlushTimestamps(size_t cols, ElemType momentum, int* timestamps, int currentTimestamp);
+    void AdamFlushTimestamps(size_t cols, ElemType momentum, ElemType adaWeight, int* timestamps, int currentTimestamp);
 
     void Reshape(const size_t numRows, const size_t numCols);
 
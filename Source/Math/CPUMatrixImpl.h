@@ -1510,6 +1510,46 @@ void CPUMatrix<ElemType>::AdaDeltaFlushTimestamps(size_t cols, ElemType rho, int
     }
 }
 
+template <class ElemType>
+void CPUMatrix<ElemType>::MomentumSGDFlushTimestamps(size_t cols, ElemType momentum, int* timestamps, int currentTimestamp)
+{
+    // Sets all timestamps to 0 and decays the smoothed gradients of the lazy sparse momentum update
+    // (CPUSparseMatrix::MomentumSGD) by momentum ** (currentTimestamp - timestamp for that column).
+    auto rows = GetNumRows();
+    auto smoothedGradients = Data();
+#pragma omp parallel for
+    for (long col = 0; col < (long)cols; ++col)
+    {
+        ElemType decay = (ElemType)std::pow((double)momentum, currentTimestamp - timestamps[col]);
+        auto offset = rows * col;
+        timestamps[col] = 0;
+        for (size_t row = 0; row < rows; ++row)
+            smoothedGradients[offset + row] *= decay;
+    }
+}
+
+template <class ElemType>
+void CPUMatrix<ElemType>::AdamFlushTimestamps(size_t cols, ElemType momentum, ElemType adaWeight, int* timestamps, int currentTimestamp)
+{
+    // Same as MomentumSGDFlushTimestamps for the two moments of the lazy sparse Adam update (CPUSparseMatrix::Adam).
+    auto rows = GetNumRows();
+    auto smoothAda = Data();
+    auto smoothMom = Data() + cols * rows;
+#pragma omp parallel for
+    for (long col = 0; col < (long)cols; ++col)
+    {
+        ElemType adaDecay = (ElemType)std::pow((double)adaWeight, currentTimestamp - timestamps[col]);
+        ElemType momDecay = (ElemType)std::pow((double)momentum, currentTimestamp - timestamps[col]);
+        auto offset = rows * col;
+        timestamps[col] = 0;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            smoothAda[offset + row] *= adaDecay;
+            smoothMom[offset + row] *= momDecay;
+        }
+    }
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::Reshape(const size_t numRows, const size_t numCols)
 {
@@ -1286,6 +1286,30 @@ void CPUSparseMatrix<ElemType>::ScaleAndAdd(const ElemType alpha, const CPUSpars
     }
 }
 
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::ScaleAndAddToBlocks(const ElemType alpha, const CPUMatrix<ElemType>& lhs, CPUSparseMatrix<ElemType>& c)
+{
+    if (lhs.IsEmpty() || c.IsEmpty())
+        LogicError("ScaleAndAddToBlocks:  one of the input matrix is empty.");
+
+    if (lhs.GetNumRows() != c.GetNumRows() || lhs.GetNumCols() != c.GetNumCols())
+        InvalidArgument("CPUSparseMatrix::ScaleAndAddToBlocks: The dimensions of a and b must match.");
+
+    if (c.GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    auto rows = c.GetNumRows();
+    ElemType* values = c.Data();
+    const ElemType* lhsValues = lhs.Data();
+#pragma omp parallel for
+    for (long blockid = 0; blockid < (long)c.GetBlockSize(); ++blockid)
+    {
+        auto col = c.GetBlockIds()[blockid] - c.GetBlockIdShift();
+        for (size_t row = 0; row < rows; ++row)
+            values[blockid * rows + row] += alpha * lhsValues[col * rows + row];
+    }
+}
+
 template <class ElemType>
 /*static*/ bool CPUSparseMatrix<ElemType>::AreEqual(const CPUSparseMatrix<ElemType>& a, const CPUSparseMatrix<ElemType>& b, const ElemType threshold)
 {
@@ -1525,6 +1549,119 @@ void CPUSparseMatrix<ElemType>::AdaDelta(CPUMatrix<AccumType>& c, CPUMatrix<Accu
     }
 }
 
+// Lazy momentum SGD update with a block sparse column gradient: only the columns present in the gradient and their
+// smoothed gradients "c" are updated, with the update rule of the dense Matrix::MomentumSGDUpdate():
+// 1) c = momentum * c + unitGainFactor * learnRatePerSample * this
+// 2) functionValues = functionValues - c
+// The smoothed gradients of the other columns are not decayed; instead, when a column is updated, its smoothed gradients
+// are first decayed by momentum for each update it has skipped since timestamps[col], and timestamps[col] is set to
+// currentTimestamp. Parameter updates of the skipped steps are not applied. Without timestamps, the columns present in the
+// gradient are decayed by a single step and the other columns are left unchanged.
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::MomentumSGD(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType unitGainFactor, int* timestamps, int currentTimestamp)
+{
+    if (c.IsEmpty())
+    {
+        c.RequireSize(GetNumRows(), GetNumCols());
+        c.SetValue(0.0);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != GetNumCols())
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    ElemType* grad = Data();
+    ElemType* smoothedGradients = c.Data();
+    ElemType* val = functionValues.Data();
+    auto rows = GetNumRows();
+    ElemType scale = unitGainFactor * learnRatePerSample;
+
+#pragma omp parallel for
+    for (long blockid = 0; blockid < (long)GetBlockSize(); ++blockid)
+    {
+        auto col = GetBlockIds()[blockid] - GetBlockIdShift();
+        auto columnOffset = col * rows;
+        auto blockOffset = blockid * rows;
+        ElemType decay = momentum;
+        if (timestamps)
+        {
+            decay = (ElemType)std::pow((double)momentum, currentTimestamp - timestamps[col]);
+            timestamps[col] = currentTimestamp;
+        }
+        for (size_t row = 0; row < rows; ++row)
+        {
+            ElemType sg = decay * smoothedGradients[columnOffset + row] + scale * grad[blockOffset + row];
+            smoothedGradients[columnOffset + row] = sg;
+            val[columnOffset + row] -= sg;
+        }
+    }
+}
+
+// Lazy Adam update with a block sparse column gradient, with the update rule of CPUMatrix::Adam() for the columns present
+// in the gradient. The first and second moments of a column are decayed for the skipped updates as in MomentumSGD().
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::Adam(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType adaWeight, ElemType adaMul,
+                                     ElemType epsilon, ElemType unitGainFactor, bool adamax, int* timestamps, int currentTimestamp)
+{
+    size_t numColsNeeded = 2 * GetNumCols();
+
+    if (c.IsEmpty() || (c.GetNumCols() < numColsNeeded))
+    {
+        c.RequireSize(GetNumRows(), numColsNeeded);
+        c.SetValue(0.0);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != numColsNeeded)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    size_t n = GetNumElements();
+    ElemType* grad = Data();
+    ElemType* smoothAda = c.Data();
+    ElemType* smoothMom = c.Data() + n;
+    ElemType* val = functionValues.Data();
+    auto rows = GetNumRows();
+
+#pragma omp parallel for
+    for (long blockid = 0; blockid < (long)GetBlockSize(); ++blockid)
+    {
+        auto col = GetBlockIds()[blockid] - GetBlockIdShift();
+        auto columnOffset = col * rows;
+        auto blockOffset = blockid * rows;
+        ElemType adaDecay = adaWeight;
+        ElemType momDecay = momentum;
+        if (timestamps)
+        {
+            adaDecay = (ElemType)std::pow((double)adaWeight, currentTimestamp - timestamps[col]);
+            momDecay = (ElemType)std::pow((double)momentum, currentTimestamp - timestamps[col]);
+            timestamps[col] = currentTimestamp;
+        }
+        for (size_t row = 0; row < rows; ++row)
+        {
+            size_t denseIndex = columnOffset + row;
+            ElemType g = grad[blockOffset + row];
+            ElemType ada;
+            if (!adamax)
+            {
+                ElemType adaSqr = adaDecay * smoothAda[denseIndex] + (1.0f - adaWeight) * g * g;
+                smoothAda[denseIndex] = adaSqr;
+                ada = sqrt(adaSqr);
+            }
+            else
+                ada = smoothAda[denseIndex] = std::max(adaDecay * smoothAda[denseIndex], (ElemType)fabs((double)g));
+
+            ElemType w = adaMul * (ElemType)(1.0 / (ada + epsilon));
+            g = momDecay * smoothMom[denseIndex] + unitGainFactor * g;
+            smoothMom[denseIndex] = g;
+            val[denseIndex] -= g * w * learnRatePerSample;
+        }
+    }
+}
+
 template <class ElemType>
 CPUSparseMatrix<ElemType>& CPUSparseMatrix<ElemType>::InplaceTruncateTop(const ElemType threshold)
 {
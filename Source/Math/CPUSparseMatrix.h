@@ -141,6 +141,8 @@ public:
 
     static void Scale(const ElemType alpha, CPUSparseMatrix<ElemType>& rhs);
     static void ScaleAndAdd(const ElemType alpha, const CPUSparseMatrix<ElemType>& lhs, CPUMatrix<ElemType>& c);
+    // c += alpha * lhs, restricted to the columns stored in the block sparse column matrix c
+    static void ScaleAndAddToBlocks(const ElemType alpha, const CPUMatrix<ElemType>& lhs, CPUSparseMatrix<ElemType>& c);
 
     static bool AreEqual(const CPUSparseMatrix<ElemType>& a, const CPUSparseMatrix<ElemType>& b, const ElemType threshold = 1e-8);
 
@@ -239,6 +241,11 @@ public:
     template<typename AccumType>
     void AdaDelta(CPUMatrix<AccumType>& c, CPUMatrix<AccumType>& functionValues, AccumType learningRate, AccumType rho, AccumType epsilon, int* timestamps, int currentTimestamp);
 
+    // Lazy updates that only touch the columns present in a block sparse column gradient, see MomentumSGD().
+    void MomentumSGD(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType unitGainFactor, int* timestamps, int currentTimestamp);
+    void Adam(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType adaWeight, ElemType adaMul,
+              ElemType epsilon, ElemType unitGainFactor, bool adamax, int* timestamps, int currentTimestamp);
+
 public:
     CPUSparseMatrix<ElemType>& InplaceTruncateTop(const ElemType threshold);
     CPUSparseMatrix<ElemType>& InplaceTruncateBottom(const ElemType threshold);
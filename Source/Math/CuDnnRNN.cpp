@@ -67,7 +67,7 @@ void CuDnnRNNExecutor<ElemType>::ForwardCore(
     const GPUMatrix<ElemType>& inputX, GPUMatrix<ElemType>& outputY,
     const vector<size_t>& numSequencesForFrame,
     const RnnAttributes& rnnAttributes,
-    GPUMatrix<ElemType>& reserve, GPUMatrix<ElemType>& workspace
+    GPUMatrix<ElemType>& reserve, GPUMatrix<ElemType>& workspace, bool inferenceOnly
     )
 {
     // test that the RNN shape is correct
@@ -88,20 +88,37 @@ void CuDnnRNNExecutor<ElemType>::ForwardCore(
 
     // Need for every pass
     CUDNN_CALL(cudnnGetRNNWorkspaceSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &workSize));
-    // Only needed in training, can't be touched between passes.
-    CUDNN_CALL(cudnnGetRNNTrainingReserveSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &reserveSize));
-
     // convert from bytes to ElemType
     workSize = (workSize + sizeof(ElemType) - 1) / (sizeof(ElemType));
-    reserveSize = (reserveSize + sizeof(ElemType) - 1) / sizeof(ElemType);
-
-    reserve.Resize(reserveSize, 1);
     workspace.Resize(workSize, 1);
 
     wDesc = make_unique<CuDnnFilter<ElemType>>(*m_rnnT, xDesc[0]);
     if (wDesc->GetSize() != weightsW.GetNumElements())
         InvalidArgument("RNN needs %ld parameters, but %ld were allocated", wDesc->GetSize(), weightsW.GetNumElements());
 
+    // Without backward pass, the reserve is not needed at all.
+    if (inferenceOnly)
+    {
+        CUDNN_CALL(cudnnRNNForwardInference(
+            *m_cudnn, *m_rnnT,
+            (int)m_seqLength,
+            xDesc.data(), inputX.Data(),
+            0, 0,
+            0, 0,
+            *wDesc, weightsW.Data(),
+            yDesc.data(), outputY.Data(),
+            0, 0,
+            0, 0,
+            workspace.Data(), workspace.GetNumElements()*sizeof(ElemType)));
+        m_BackwardDataCalledYet = false;
+        return;
+    }
+
+    // Only needed in training, can't be touched between passes.
+    CUDNN_CALL(cudnnGetRNNTrainingReserveSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &reserveSize));
+    reserveSize = (reserveSize + sizeof(ElemType) - 1) / sizeof(ElemType);
+    reserve.Resize(reserveSize, 1);
+
     CUDNN_CALL(cudnnRNNForwardTraining(
         *m_cudnn, *m_rnnT,
         (int)m_seqLength,
@@ -1682,7 +1682,9 @@ void Matrix<ElemType>::MomentumSGDUpdate(Matrix<ElemType>& gradients,
                                          Matrix<ElemType>& smoothedGradients,
                                          ElemType learnRatePerSample,
                                          ElemType momentum,
-                                         ElemType unitGainFactor)
+                                         ElemType unitGainFactor,
+                                         int* timestamps,
+                                         int currentTimestamp)
 {
     DecideAndMoveToRightDevice(smoothedGradients, gradients, *this);
 
@@ -1708,13 +1710,25 @@ void Matrix<ElemType>::MomentumSGDUpdate(Matrix<ElemType>& gradients,
             // 1) sg_t = momentum * sg_{t-1} + (1.0 - momentum) * g_{t-1}
             // 2) g'_{t-1} = sg_t
             // 3) w_t = w_{t-1} - learnRatePerSample * g'_{t-1}
-            if (momentum != 0)
+            // The lazy update with timestamps follows the dense implementation for the columns present in the gradient.
+            if (timestamps)
             {
-                gradients.m_CPUSparseMatrix->NormalGrad(*smoothedGradients.m_CPUMatrix, momentum, unitGainFactor);
+                gradients.m_CPUSparseMatrix->MomentumSGD(*smoothedGradients.m_CPUMatrix, *m_CPUMatrix, learnRatePerSample, momentum, unitGainFactor, timestamps, currentTimestamp);
+                smoothedGradients.SetDataLocation(CPU);
+                SetDataLocation(CPU);
+            }
+            else
+            {
+                if (momentum != 0)
+                {
+                    gradients.m_CPUSparseMatrix->NormalGrad(*smoothedGradients.m_CPUMatrix, momentum, unitGainFactor);
+                }
+                ScaleAndAdd(-learnRatePerSample, gradients, *this);
             }
-            ScaleAndAdd(-learnRatePerSample, gradients, *this);
         },
         {
+            if (timestamps)
+                NOT_IMPLEMENTED;
             if (momentum != 0)
             {
                 gradients.m_GPUSparseMatrix->NormalGrad(*smoothedGradients.m_GPUMatrix, momentum, unitGainFactor);
@@ -1834,7 +1848,8 @@ void Matrix<ElemType>::FSAdagradUpdate(Matrix<ElemType>& gradients, Matrix<ElemT
 // varMomentum - /beta_2
 template <class ElemType>
 void Matrix<ElemType>::AdamUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, const double smoothedCount,
-    const double learnRatePerSample, const double meanMomentum, const double varMomentum, const double epsilon, ElemType unitGainFactor, bool adamax)
+    const double learnRatePerSample, const double meanMomentum, const double varMomentum, const double epsilon, ElemType unitGainFactor, bool adamax,
+    int* timestamps, int currentTimestamp)
 {
     // Bias correction
     let biasCorrection = adamax? (ElemType)(1. / (1- pow(meanMomentum, smoothedCount))) : (ElemType)(sqrt(1- pow(varMomentum, smoothedCount))/(1- pow(meanMomentum, smoothedCount)));
@@ -1852,8 +1867,19 @@ void Matrix<ElemType>::AdamUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>&
         biasCorrection, (ElemType)epsilon, unitGainFactor, adamax);
         SetDataLocation(GPU);
     },
-    { NOT_IMPLEMENTED; },
-    { gradients.m_GPUSparseMatrix->Adam(*m_GPUMatrix, *functionValues.m_GPUMatrix,
+    {
+        // Only the lazy update has a block sparse CPU kernel.
+        if (!timestamps)
+            NOT_IMPLEMENTED;
+        gradients.m_CPUSparseMatrix->Adam(*m_CPUMatrix, *functionValues.m_CPUMatrix,
+        (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum,
+        biasCorrection, (ElemType)epsilon, unitGainFactor, adamax, timestamps, currentTimestamp);
+        SetDataLocation(CPU);
+    },
+    {
+        if (timestamps)
+            NOT_IMPLEMENTED;
+        gradients.m_GPUSparseMatrix->Adam(*m_GPUMatrix, *functionValues.m_GPUMatrix,
         (ElemType)learnRatePerSample, (ElemType)meanMomentum,
         (ElemType)varMomentum, biasCorrection, (ElemType)epsilon, unitGainFactor, adamax);
         SetDataLocation(GPU); });
@@ -1909,6 +1935,26 @@ void Matrix<ElemType>::AdaDeltaFlushState(size_t cols, ElemType rho, int* timest
     { NOT_IMPLEMENTED; });
 }
 
+template <class ElemType>
+void Matrix<ElemType>::MomentumSGDFlushState(size_t cols, ElemType momentum, int* timestamps, int currentTimestamp)
+{
+    DISPATCH_MATRIX_ON_FLAG(this, this,
+    { m_CPUMatrix->MomentumSGDFlushTimestamps(cols, momentum, timestamps, currentTimestamp); SetDataLocation(CPU); },
+    { NOT_IMPLEMENTED; },
+    { NOT_IMPLEMENTED; },
+    { NOT_IMPLEMENTED; });
+}
+
+template <class ElemType>
+void Matrix<ElemType>::AdamFlushState(size_t cols, ElemType momentum, ElemType adaWeight, int* timestamps, int currentTimestamp)
+{
+    DISPATCH_MATRIX_ON_FLAG(this, this,
+    { m_CPUMatrix->AdamFlushTimestamps(cols, momentum, adaWeight, timestamps, currentTimestamp); SetDataLocation(CPU); },
+    { NOT_IMPLEMENTED; },
+    { NOT_IMPLEMENTED; },
+    { NOT_IMPLEMENTED; });
+}
+
 template <class ElemType>
 void Matrix<ElemType>::Reshape(const size_t numRows, const size_t numCols)
 {
@@ -5028,7 +5074,7 @@ void Matrix<ElemType>::BatchNormalizationBackward(const Matrix<ElemType>& in, Ma
 }
 
 template <class ElemType>
-void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<ElemType> &paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace)
+void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<ElemType> &paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace, bool inferenceOnly)
 {
     DecideAndMoveToRightDevice(*this, inputX, paramW);
     // move reserve/workspace to the consensus device
@@ -5038,7 +5084,7 @@ void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<E
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
                             NOT_IMPLEMENTED,
-                            m_GPUMatrix->RNNForward(*(inputX.m_GPUMatrix), *(paramW.m_GPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
+                            m_GPUMatrix->RNNForward(*(inputX.m_GPUMatrix), *(paramW.m_GPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix), inferenceOnly),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
 }
@@ -5404,6 +5450,25 @@ template <class ElemType>
     }
 }
 
+/// <summary>c += alpha * a, restricted to the columns stored in the block sparse column matrix c</summary>
+/// <param name="alpha">Scalar</param>
+/// <param name="a">Dense input matrix</param>
+/// <param name="c">Block sparse column matrix, whose stored columns are updated</param>
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::ScaleAndAddToBlocks(ElemType alpha, const Matrix<ElemType>& a, Matrix<ElemType>& c)
+{
+    DecideAndMoveToRightDevice(c, a);
+
+    if (a.GetMatrixType() != MatrixType::DENSE || c.GetMatrixType() != MatrixType::SPARSE)
+        LogicError("ScaleAndAddToBlocks: a must be dense and c must be sparse.");
+
+    DISPATCH_MATRIX_ON_FLAG(&c, &c,
+        { NOT_IMPLEMENTED; },
+        { NOT_IMPLEMENTED; },
+        { CPUSparseMatrix<ElemType>::ScaleAndAddToBlocks(alpha, *a.m_CPUMatrix, *c.m_CPUSparseMatrix); },
+        { NOT_IMPLEMENTED; });
+}
+
 /// <summary>Matrix-scalar multiply with col-major matrices: c = alpha * a + beta * c</summary>
 /// if a is a column vector, add to all columns of c
 /// if a is a row vector, add to all rows of c
@@ -8,6 +8,7 @@
 #include "Config.h"
 #include "TextConfigHelper.h"
 #include "ChunkCache.h"
+#include "DiskChunkCache.h"
 #include "BlockRandomizer.h"
 #include "NoRandomizer.h"
 #include "TextParser.h"
@@ -34,6 +35,9 @@ CNTKTextFormatReader::CNTKTextFormatReader(const ConfigParameters& config)
         else
             m_deserializer = make_shared<TextParser<double>>(corpus, configHelper, true);
 
+        if (configHelper.ShouldCacheChunksOnDisk())
+            m_deserializer = make_shared<DiskChunkCache>(m_deserializer, configHelper.GetFilePath(), configHelper.GetChunkCacheMaxSize());
+
         if (configHelper.ShouldKeepDataInMemory())
             m_deserializer = make_shared<ChunkCache>(m_deserializer);
 
@@ -10,6 +10,7 @@
 #include "DataReader.h"
 #include "ReaderShim.h"
 #include "CNTKTextFormatReader.h"
+#include "DiskChunkCache.h"
 #include "StringUtil.h"
 #include "V2Dependencies.h"
 
@@ -47,10 +48,14 @@ extern "C" DATAREADER_API bool CreateDeserializer(DataDeserializerPtr& deseriali
     // TODO: Remove type from the parser. Current implementation does not support streams of different types.
     if (type == L"CNTKTextFormatDeserializer")
     {
+        TextConfigHelper configHelper(deserializerConfig);
         if (precision == "float")
-            deserializer = make_shared<TextParser<float>>(corpus, TextConfigHelper(deserializerConfig), primary);
+            deserializer = make_shared<TextParser<float>>(corpus, configHelper, primary);
         else // double
-            deserializer = make_shared<TextParser<double>>(corpus, TextConfigHelper(deserializerConfig), primary);
+            deserializer = make_shared<TextParser<double>>(corpus, configHelper, primary);
+
+        if (configHelper.ShouldCacheChunksOnDisk())
+            deserializer = make_shared<DiskChunkCache>(deserializer, configHelper.GetFilePath(), configHelper.GetChunkCacheMaxSize());
     }
     else
         InvalidArgument("Unknown deserializer type '%ls'", type.c_str());
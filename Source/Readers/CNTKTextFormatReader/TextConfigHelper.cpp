@@ -126,8 +126,11 @@ TextConfigHelper::TextConfigHelper(const ConfigParameters& config)
     m_traceLevel = config(L"traceLevel", 1);
     m_chunkSizeBytes = config(L"chunkSizeInBytes", g_32MB); // 32 MB by default
     m_keepDataInMemory = config(L"keepDataInMemory", false);
+    m_cacheChunksOnDisk = config(L"cacheChunksOnDisk", false);
+    m_chunkCacheMaxSizeBytes = config(L"chunkCacheMaxSizeInBytes", (size_t)0);
     m_frameMode = config(L"frameMode", false);
     m_cacheIndex = config(L"cacheIndex", false);
+    m_numberOfIndexingThreads = config(L"numberOfIndexingThreads", (size_t)0);
 
     m_randomizationWindow = GetRandomizationWindowFromConfig(config);
     m_sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", false);
@@ -33,6 +33,8 @@ public:
 
     bool ShouldCacheIndex() const { return m_cacheIndex; }
 
+    size_t GetNumberOfIndexingThreads() const { return m_numberOfIndexingThreads; }
+
     unsigned int GetMaxAllowedErrors() const { return m_maxErrors; }
 
     unsigned int GetTraceLevel() const { return m_traceLevel; }
@@ -41,6 +43,10 @@ public:
 
     bool ShouldKeepDataInMemory() const { return m_keepDataInMemory; }
 
+    bool ShouldCacheChunksOnDisk() const { return m_cacheChunksOnDisk; }
+
+    size_t GetChunkCacheMaxSize() const { return m_chunkCacheMaxSizeBytes; }
+
     bool IsInFrameMode() const { return m_frameMode; }
 
     DataType GetDataType() const { return m_elementType; }
@@ -60,9 +66,12 @@ private:
     unsigned int m_traceLevel;
     size_t m_chunkSizeBytes; // chunks size in bytes
     bool m_keepDataInMemory; // if true the whole dataset is kept in memory
+    bool m_cacheChunksOnDisk; // if true, parsed chunks are persisted in a binary form next to the input file
+    size_t m_chunkCacheMaxSizeBytes; // disk budget for the persisted chunks (0 == unlimited)
     bool m_frameMode; // if true, the maximum expected sequence length in the dataset is one sample.
     bool m_cacheIndex; // When true, the index will be loaded from a cache file it if exists.
                        // If cache does not exist, the index, once created, will be written out to a file.
+    size_t m_numberOfIndexingThreads; // number of threads scanning the input to build the index (0 == auto).
 };
 
 }
@@ -71,6 +71,7 @@ TextParser(corpus, helper.GetFilePath(), helper.GetStreams(), primary)
     SetSkipSequenceIds(helper.ShouldSkipSequenceIds());
 
     SetCacheIndex(helper.ShouldCacheIndex());
+    SetNumberOfIndexingThreads(helper.GetNumberOfIndexingThreads());
 
     Initialize();
 }
@@ -93,7 +94,8 @@ TextParser<ElemType>::TextParser(CorpusDescriptorPtr corpus, const std::wstring&
     m_numRetries(5),
     m_corpus(corpus),
     m_useMaximumAsSequenceLength(true),
-    m_cacheIndex(false)
+    m_cacheIndex(false),
+    m_numberOfIndexingThreads(0)
 {
     assert(streams.size() > 0);
 
@@ -187,7 +189,8 @@ void TextParser<ElemType>::Initialize()
             .SetCorpus(m_corpus)
             .SetPrimary(m_primary)
             .SetChunkSize(m_chunkSizeBytes)
-            .SetCachingEnabled(m_cacheIndex);
+            .SetCachingEnabled(m_cacheIndex)
+            .SetNumberOfThreads(m_numberOfIndexingThreads);
 
         if (!m_useMaximumAsSequenceLength)
         {
@@ -1232,6 +1235,12 @@ void TextParser<ElemType>::SetCacheIndex(bool value)
     m_cacheIndex = value;
 }
 
+template <class ElemType>
+void TextParser<ElemType>::SetNumberOfIndexingThreads(size_t value)
+{
+    m_numberOfIndexingThreads = value;
+}
+
 template<class ElemType>
 inline bool TextParser<ElemType>::CanRead()
 {
@@ -133,6 +133,7 @@ private:
     unsigned int m_numAllowedErrors;
     bool m_skipSequenceIds;
     bool m_cacheIndex;
+    size_t m_numberOfIndexingThreads; // 0 == pick automatically.
     unsigned int m_numRetries; // specifies the number of times an unsuccessful
                                // file operation should be repeated (default value is 5).
 
@@ -203,6 +204,8 @@ private:
 
     void SetCacheIndex(bool value);
 
+    void SetNumberOfIndexingThreads(size_t value);
+
     friend class CNTKTextFormatReaderTestRunner<ElemType>;
 
     DISABLE_COPY_AND_MOVE(TextParser);
@@ -25,6 +25,8 @@
 #include "V2Dependencies.h"
 #include "LTNoRandomizer.h"
 #include "LTTumblingWindowRandomizer.h"
+#include "ShardedDeserializer.h"
+#include "BucketingSequenceEnumerator.h"
 
 namespace CNTK {
 
@@ -35,7 +37,9 @@ using namespace Microsoft::MSR::CNTK;
 // For more information please see its header file.
 // This method composes together packers + randomizer + a set of transformers and deserializers.
 CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
-    m_truncationLength(0)
+    m_truncationLength(0),
+    m_shardsWorkerRank(0),
+    m_shardsNumberOfWorkers(0)
 {
     wstring action = config(L"action", L"");
     bool isActionWrite = AreEqualIgnoreCase(action, L"write");
@@ -98,87 +102,120 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
     if (!composable && m_deserializers.size() > 1)
         InvalidArgument("Currently user defined deserializers do not support composability. Please specify a single deserializer.");
 
-    DataDeserializerPtr deserializer = m_deserializers.front();
-    if (m_deserializers.size() > 1)
-    {
-        // Bundling deserializers together.
-        // Option whether we need to check data between different deserializers.
-        bool cleanse = config(L"checkData", true);
-        deserializer = std::make_shared<Bundler>(config, m_corpus, deserializer, m_deserializers, cleanse);
-    }
+    m_composable = composable;
+
+    // Option whether we need to check data between different deserializers.
+    m_checkData = config(L"checkData", true);
 
-    int verbosity = config(L"verbosity", 0);
+    m_verbosity = config(L"verbosity", 0);
 
     // Pick up the randomizer, always picking up no randomization for the write mode.
-    bool randomize = isActionWrite ? false : config(L"randomize", true);
+    m_randomize = isActionWrite ? false : config(L"randomize", true);
 
     // Get maximum number of allowed errors per worker.
-    size_t maxErrors = config(L"maxErrors", 0);
+    m_maxErrors = config(L"maxErrors", 0);
 
     // By default do not use omp threads for deserialization of sequences.
     // It makes sense to put it to true for cases when deserialization is CPU intensive,
     // i.e. decompression of images.
-    bool multiThreadedDeserialization = config(L"multiThreadedDeserialization", ContainsDeserializer(config, L"ImageDeserializer"));
+    m_multiThreadedDeserialization = config(L"multiThreadedDeserialization", ContainsDeserializer(config, L"ImageDeserializer"));
+
+    m_randomizationSeed = GetRandomSeed(config);
 
     if (!composable) // Pick up simple interface.
     {
-        if (randomize)
-        {
-            bool sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", false);
-            m_sequenceEnumerator = std::make_shared<LTTumblingWindowRandomizer>(deserializer,
-                sampleBasedRandomizationWindow, config(L"randomizationWindow", requestDataSize),
-                GetRandomSeed(config),
-                multiThreadedDeserialization, maxErrors);
-        }
-        else
-            m_sequenceEnumerator = std::make_shared<LTNoRandomizer>(deserializer, multiThreadedDeserialization, maxErrors);
+        m_sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", false);
+        m_randomizationWindow = config(L"randomizationWindow", requestDataSize);
     }
     else
     {
-        if (randomize)
+        // By default randomizing the whole data set.
+        size_t randomizationWindow = requestDataSize;
+
+        // Currently in case of images, a single chunk is a single image. So no need to randomize, chunks will be randomized anyway.
+        if (m_randomize && ContainsDeserializer(config, L"ImageDeserializer") && m_deserializers.size() == 1)
         {
-            // By default randomizing the whole data set.
-            size_t randomizationWindow = requestDataSize;
+            randomizationWindow = 1;
+            m_packingMode = PackingMode::sample;
+        }
+
+        randomizationWindow = config(L"randomizationWindow", randomizationWindow);
+        bool sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", true);
 
-            // Currently in case of images, a single chunk is a single image. So no need to randomize, chunks will be randomized anyway.
-            if (ContainsDeserializer(config, L"ImageDeserializer") && m_deserializers.size() == 1)
+        if (m_randomize && ContainsDeserializer(config, L"CNTKTextFormatDeserializer") && !config.ExistsCurrent(L"randomizationWindow"))
+        {
+            if (!config.ExistsCurrent(L"sampleBasedRandomizationWindow") || // sampleBasedRandomizationWindow is not specified
+                !sampleBasedRandomizationWindow) // randomization window is in chunks
             {
-                randomizationWindow = 1;
-                m_packingMode = PackingMode::sample;
+                sampleBasedRandomizationWindow = false;
+                size_t chunkSizeBytes = config(L"chunkSizeInBytes", g_32MB); // 32 MB by default
+                randomizationWindow = g_4GB / chunkSizeBytes; // ~ 4 GB disk space worth of chunks
+                                                              // TODO: decrease randomization window if m_deserializers.size() > 1 ?
             }
-
-            randomizationWindow = config(L"randomizationWindow", randomizationWindow);
-            bool sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", true);
-
-            if (ContainsDeserializer(config, L"CNTKTextFormatDeserializer") && !config.ExistsCurrent(L"randomizationWindow"))
+            else
             {
-                if (!config.ExistsCurrent(L"sampleBasedRandomizationWindow") || // sampleBasedRandomizationWindow is not specified
-                    !sampleBasedRandomizationWindow) // randomization window is in chunks
-                {
-                    sampleBasedRandomizationWindow = false;
-                    size_t chunkSizeBytes = config(L"chunkSizeInBytes", g_32MB); // 32 MB by default
-                    randomizationWindow = g_4GB / chunkSizeBytes; // ~ 4 GB disk space worth of chunks
-                                                                  // TODO: decrease randomization window if m_deserializers.size() > 1 ?
-                }
-                else
-                {
-                    // config explicitly says to use a sample-based window, but does not specify its size.
-                    LogicError("'sampleBasedRandomizationWindow' (== 'true') requires that the 'randomizationWindow' is explicitly specified.");
-                }
+                // config explicitly says to use a sample-based window, but does not specify its size.
+                LogicError("'sampleBasedRandomizationWindow' (== 'true') requires that the 'randomizationWindow' is explicitly specified.");
             }
+        }
+
+        m_randomizationWindow = randomizationWindow;
+        m_sampleBasedRandomizationWindow = sampleBasedRandomizationWindow;
+    }
+
+    // Check whether to use local timeline, by default we use it for better performance.
+    m_localTimeline = config(L"localTimeline", true);
+
+    // Grouping sequences of similar length into the same minibatch to reduce padding, off by default.
+    m_bucketingPoolSizeInSamples = config(L"bucketingPoolSizeInSamples", 0);
+    m_numberOfBuckets = config(L"numberOfBuckets", 8);
+    if (m_bucketingPoolSizeInSamples != 0 && (m_packingMode != PackingMode::sequence || !m_localTimeline))
+        InvalidArgument("Bucketing of sequences is only supported in the sequence mode with the local timeline.");
 
+    CreateSequenceEnumeratorAndPacker();
+}
+
+void CompositeDataReader::CreateSequenceEnumeratorAndPacker()
+{
+    DataDeserializerPtr deserializer = m_deserializers.front();
+    if (m_deserializers.size() > 1)
+    {
+        // Bundling deserializers together.
+        deserializer = std::make_shared<Bundler>(m_verbosity, m_corpus, deserializer, m_deserializers, m_checkData);
+    }
+
+    if (!m_composable) // Pick up simple interface.
+    {
+        if (m_randomize)
+        {
+            m_sequenceEnumerator = std::make_shared<LTTumblingWindowRandomizer>(deserializer,
+                m_sampleBasedRandomizationWindow, m_randomizationWindow,
+                m_randomizationSeed,
+                m_multiThreadedDeserialization, m_maxErrors);
+        }
+        else
+            m_sequenceEnumerator = std::make_shared<LTNoRandomizer>(deserializer, m_multiThreadedDeserialization, m_maxErrors);
+    }
+    else
+    {
+        if (m_randomize)
+        {
             bool shouldPrefetch = true;
-            m_sequenceEnumerator = std::make_shared<BlockRandomizer>(verbosity, randomizationWindow, deserializer, shouldPrefetch,
-                multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config));
+            m_sequenceEnumerator = std::make_shared<BlockRandomizer>(m_verbosity, m_randomizationWindow, deserializer, shouldPrefetch,
+                m_multiThreadedDeserialization, m_maxErrors, m_sampleBasedRandomizationWindow, m_randomizationSeed);
         }
         else
-            m_sequenceEnumerator = std::make_shared<NoRandomizer>(deserializer, multiThreadedDeserialization, maxErrors);
+            m_sequenceEnumerator = std::make_shared<NoRandomizer>(deserializer, m_multiThreadedDeserialization, m_maxErrors);
     }
 
     // In case when there are transforms, applying them to the data.
     m_sequenceEnumerator = m_transforms.empty()
         ? m_sequenceEnumerator
-        : std::make_shared<TransformController>(m_transforms, m_sequenceEnumerator, multiThreadedDeserialization);
+        : std::make_shared<TransformController>(m_transforms, m_sequenceEnumerator, m_multiThreadedDeserialization);
+
+    if (m_bucketingPoolSizeInSamples != 0)
+        m_sequenceEnumerator = std::make_shared<BucketingSequenceEnumerator>(m_sequenceEnumerator,
+            m_bucketingPoolSizeInSamples, m_numberOfBuckets, m_randomizationSeed);
 
     // TODO: Output stream descriptions - this should come from the network so that we can check 
     // that input matches what the network expects (including tensor shape, etc.).
@@ -188,8 +225,6 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
     // same is the default.
     size_t numAlternatingBuffers = 2;
 
-    // Check whether to use local timeline, by default we use it for better performance.
-    bool localTimeline = config(L"localTimeline", true);
     switch (m_packingMode)
     {
     case PackingMode::sample:
@@ -197,7 +232,7 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
             m_sequenceEnumerator,
             outputStreams,
             numAlternatingBuffers,
-            localTimeline,
+            m_localTimeline,
             m_corpus);
         break;
     case PackingMode::sequence:
@@ -205,7 +240,7 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
             m_sequenceEnumerator,
             outputStreams,
             numAlternatingBuffers,
-            localTimeline,
+            m_localTimeline,
             m_corpus);
         break;
     case PackingMode::truncated:
@@ -246,6 +281,11 @@ bool CompositeDataReader::CreateDeserializers(const ConfigParameters& readerConf
     auto traceLevel = readerConfig.Find("traceLevel");
     bool composable = true;
 
+    // Shards are assigned to workers in the same way for all deserializers,
+    // so that the sequences of a shard can still be bundled together.
+    bool shuffleShards = readerConfig(L"shuffleShards", true);
+    size_t shardsSeed = GetRandomSeed(readerConfig);
+
     bool primary = true;  // Currently, the first deserializer becomes primary - it drives chunking.
     for (size_t i = 0; i < deserializerConfigs.size(); ++i)
     {
@@ -259,10 +299,32 @@ bool CompositeDataReader::CreateDeserializers(const ConfigParameters& readerConf
         }
 
         composable &= p(L"composable", true);
-        DataDeserializerPtr d = CreateDeserializer(p, primary);
+        DataDeserializerPtr d;
+        if (p.ExistsCurrent(L"shards"))
+        {
+            auto sharded = CreateShardedDeserializer(p, primary, shuffleShards, shardsSeed);
+            m_shardedDeserializers.push_back(sharded);
+            d = sharded;
+        }
+        else
+            d = CreateDeserializer(p, primary);
+
+        // Create transformers if necessary.
+        CreateTransforms(p);
+
         primary = false;
         m_deserializers.push_back(d);
     }
+
+    if (!m_shardedDeserializers.empty())
+    {
+        if (m_shardedDeserializers.size() != m_deserializers.size())
+            InvalidArgument("Either all deserializers or none of them have to be sharded.");
+
+        for (const auto& d : m_shardedDeserializers)
+            if (d->NumberOfShards() != m_shardedDeserializers.front()->NumberOfShards())
+                InvalidArgument("All sharded deserializers must have the same number of shards.");
+    }
     return composable;
 }
 
@@ -282,13 +344,38 @@ DataDeserializerPtr CompositeDataReader::CreateDeserializer(const ConfigParamete
         RuntimeError("Cannot create deserializer. Please check module and type in the configuration.");
     }
 
-    // Create transformers if necessary.
-    CreateTransforms(deserializerConfig);
-
     assert(d != nullptr);
     return d;
 }
 
+// Creates a deserializer over a list of file shards, i.e.
+// deserializers = [
+//     [
+//         type = "CNTKTextFormatDeserializer"
+//         module = "CNTKTextFormatReader"
+//         shards = "part0.ctf":"part1.ctf":"part2.ctf"
+//         ...
+// Each shard is read by its own instance of the deserializer with the 'file' parameter set to the shard.
+// Only the shards owned by the current worker are instantiated, see ShardedDeserializer for details.
+ShardedDeserializerPtr CompositeDataReader::CreateShardedDeserializer(const ConfigParameters& deserializerConfig, bool primary, bool shuffleShards, size_t seed)
+{
+    std::vector<std::wstring> shards = deserializerConfig(L"shards", ConfigParameters::Array(stringargvector(vector<wstring>{})));
+    if (shards.empty())
+        InvalidArgument("The list of shards cannot be empty.");
+
+    if (deserializerConfig.ExistsCurrent(L"file"))
+        InvalidArgument("Only one of 'file' and 'shards' can be specified for a deserializer.");
+
+    auto factory = [this, deserializerConfig, shards, primary](size_t shardIndex)
+    {
+        ConfigParameters shardConfig = deserializerConfig;
+        shardConfig.Insert("file", Microsoft::MSR::CNTK::ToLegacyString(Microsoft::MSR::CNTK::ToUTF8(shards[shardIndex])));
+        return CreateDeserializer(shardConfig, primary);
+    };
+
+    return std::make_shared<ShardedDeserializer>(shards.size(), factory, shuffleShards, seed);
+}
+
 // Create transformers based on the configuration, i.e.
 // deserializers = [
 //     [
@@ -363,7 +450,82 @@ void CompositeDataReader::StartEpoch(const EpochConfiguration& cfg, const std::m
         config.m_rightSplice = m_rightSplice;
     }
 
-    ReaderBase::StartEpoch(config, inputDescriptions);
+    if (m_shardedDeserializers.empty())
+    {
+        ReaderBase::StartEpoch(config, inputDescriptions);
+        return;
+    }
+
+    // Selecting shards of this worker, the randomizer and the packer
+    // have to be recreated if the local chunks have changed.
+    bool shardsChanged = false;
+    for (auto& d : m_shardedDeserializers)
+        shardsChanged |= d->SelectShards(config.m_workerRank, config.m_numberOfWorkers, config.m_epochIndex);
+
+    m_shardsWorkerRank = config.m_workerRank;
+    m_shardsNumberOfWorkers = config.m_numberOfWorkers;
+
+    if (shardsChanged)
+        CreateSequenceEnumeratorAndPacker();
+
+    // The packer still needs to know the number of workers to compute the local minibatch size.
+    ReaderBase::StartEpoch(GetLocalEpochConfiguration(config), config, inputDescriptions);
+}
+
+EpochConfiguration CompositeDataReader::GetLocalEpochConfiguration(const EpochConfiguration& config)
+{
+    // The data is already distributed between workers by shards,
+    // so the randomizer should not decimate it any further.
+    EpochConfiguration local = config;
+    local.m_numberOfWorkers = 1;
+    local.m_workerRank = 0;
+
+    size_t globalEpochSize = config.m_totalEpochSizeInSamples;
+    if (config.m_totalEpochSizeInSweeps != g_infinity || config.m_totalEpochSizeInSamples == requestDataSize)
+    {
+        // The size of the sweep over the whole data set is not known to any single worker,
+        // so it is summed up from the local sizes.
+        size_t sweepSize = m_shardedDeserializers.front()->NumberOfLocalSamples();
+        if (config.m_numberOfWorkers > 1)
+        {
+            if (!config.m_sumAcrossWorkers)
+                RuntimeError("Sharded reading with the epoch size in sweeps requires communication between workers, "
+                    "which is not available. Please specify the epoch size in samples.");
+
+            sweepSize = config.m_sumAcrossWorkers(sweepSize);
+        }
+
+        size_t numberOfSweeps = config.m_totalEpochSizeInSweeps != g_infinity ? config.m_totalEpochSizeInSweeps : 1;
+        globalEpochSize = sweepSize * numberOfSweeps;
+        local.m_totalEpochSizeInSweeps = g_infinity;
+    }
+
+    // Splitting the epoch evenly between workers, independently of the size of their shards,
+    // so that all workers read the same number of minibatches.
+    bool shouldAddOneSample = globalEpochSize % config.m_numberOfWorkers > config.m_workerRank;
+    local.m_totalEpochSizeInSamples = globalEpochSize / config.m_numberOfWorkers + (shouldAddOneSample ? 1 : 0);
+    if (local.m_totalEpochSizeInSamples == 0)
+        RuntimeError("The epoch size is too small to be split between '%d' workers.", (int)config.m_numberOfWorkers);
+
+    return local;
+}
+
+void CompositeDataReader::SetConfiguration(const ReaderConfiguration& config, const std::map<std::wstring, int>& inputDescriptions)
+{
+    if (m_shardedDeserializers.empty())
+    {
+        ReaderBase::SetConfiguration(config, inputDescriptions);
+        return;
+    }
+
+    if (config.m_workerRank != m_shardsWorkerRank || config.m_numberOfWorkers != m_shardsNumberOfWorkers)
+        RuntimeError("The number of workers or the worker rank cannot change in the middle of an epoch when shards are used.");
+
+    ReaderConfiguration local = config;
+    local.m_numberOfWorkers = 1;
+    local.m_workerRank = 0;
+    m_sequenceEnumerator->SetConfiguration(local);
+    m_packer->SetConfiguration(config, m_memoryProviders);
 }
 
 bool CompositeDataReader::ContainsDeserializer(const ConfigParameters& readerConfig, const wstring& type)
@@ -30,6 +30,9 @@ typedef std::shared_ptr<MemoryProvider> MemoryProviderPtr;
 class CorpusDescriptor;
 typedef std::shared_ptr<CorpusDescriptor> CorpusDescriptorPtr;
 
+class ShardedDeserializer;
+typedef std::shared_ptr<ShardedDeserializer> ShardedDeserializerPtr;
+
 struct EpochConfiguration;
 struct Minibatch;
 
@@ -60,11 +63,22 @@ public:
     // Starts a new epoch with the provided configuration
     void StartEpoch(const EpochConfiguration& config, const std::map<std::wstring, int>& inputDescriptions) override;
 
+    // Sets the configuration for the next minibatch.
+    void SetConfiguration(const ReaderConfiguration& config, const std::map<std::wstring, int>& inputDescriptions) override;
+
 private:
     bool CreateDeserializers(const Microsoft::MSR::CNTK::ConfigParameters& readerConfig);
     void CreateTransforms(const Microsoft::MSR::CNTK::ConfigParameters& deserializerConfig);
 
+    // Creates the randomizer, transformers and the packer on top of the deserializers.
+    void CreateSequenceEnumeratorAndPacker();
+
     DataDeserializerPtr CreateDeserializer(const Microsoft::MSR::CNTK::ConfigParameters& readerConfig, bool primary);
+    ShardedDeserializerPtr CreateShardedDeserializer(const Microsoft::MSR::CNTK::ConfigParameters& deserializerConfig, bool primary, bool shuffleShards, size_t seed);
+
+    // In the sharded mode the sequence enumerator only sees the local data of the worker,
+    // returns the part of the global epoch the worker has to read.
+    EpochConfiguration GetLocalEpochConfiguration(const EpochConfiguration& config);
     TransformerPtr CreateTransformer(const Microsoft::MSR::CNTK::ConfigParameters& config, const std::string& defaultModule, const std::wstring& transformerType);
 
     bool ContainsDeserializer(const Microsoft::MSR::CNTK::ConfigParameters& readerConfig, const wstring& type);
@@ -96,6 +110,29 @@ private:
 
     // rightSplice(nr) for LC-BLSTM
     size_t m_rightSplice;
+
+    // Options of the bundler, randomizer and packer, kept to recreate them when the owned shards change.
+    bool m_composable;
+    bool m_checkData;
+    int m_verbosity;
+    bool m_randomize;
+    size_t m_maxErrors;
+    bool m_multiThreadedDeserialization;
+    size_t m_randomizationWindow;
+    bool m_sampleBasedRandomizationWindow;
+    size_t m_randomizationSeed;
+    bool m_localTimeline;
+
+    // Size of the pool of sequences that are bucketed by length, 0 if bucketing is off.
+    size_t m_bucketingPoolSizeInSamples;
+    size_t m_numberOfBuckets;
+
+    // Deserializers that read only shards owned by the current worker, either all deserializers or none.
+    std::vector<ShardedDeserializerPtr> m_shardedDeserializers;
+
+    // Worker for which the shards are currently selected.
+    size_t m_shardsWorkerRank;
+    size_t m_shardsNumberOfWorkers;
 };
 
 }
@@ -441,4 +441,9 @@ bool ConfigHelper::GetCacheIndex() const
     return m_config(L"cacheIndex", false);
 }
 
+size_t ConfigHelper::GetNumberOfIndexingThreads() const
+{
+    return m_config(L"numberOfIndexingThreads", (size_t)0);
+}
+
 }
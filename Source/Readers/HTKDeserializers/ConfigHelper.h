@@ -76,6 +76,9 @@ public:
     // Gets "cacheIndex" config flag.
     bool GetCacheIndex() const;
 
+    // Gets "numberOfIndexingThreads" config value (0 == pick automatically).
+    size_t GetNumberOfIndexingThreads() const;
+
     // Gets number of utterances per minibatch for epochs as an array.
     Microsoft::MSR::CNTK::intargvector GetNumberOfUtterancesPerMinibatchForAllEppochs();
 
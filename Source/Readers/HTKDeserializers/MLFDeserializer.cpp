@@ -98,13 +98,14 @@ void MLFDeserializer::InitializeChunkInfos(CorpusDescriptorPtr corpus, const Con
     size_t totalNumSequences = 0;
     size_t totalNumFrames = 0;
     bool enableCaching = corpus->IsHashingEnabled() && config.GetCacheIndex();
+    size_t numberOfIndexingThreads = config.GetNumberOfIndexingThreads();
     for (const auto& path : mlfPaths)
     {
-        attempt(5, [this, path, enableCaching, corpus, stateListPath]() {
+        attempt(5, [this, path, enableCaching, numberOfIndexingThreads, corpus, stateListPath]() {
             if (m_textReader)
             {
                 MLFIndexBuilder builder(FileWrapper(path, L"rbS"), corpus);
-                builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching);
+                builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching).SetNumberOfThreads(numberOfIndexingThreads);
                 m_indices.emplace_back(builder.Build());
             }
             else
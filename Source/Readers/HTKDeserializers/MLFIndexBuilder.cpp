@@ -53,7 +53,8 @@ namespace CNTK {
     {
         m_input.CheckIsOpenOrDie();
 
-        index->Reserve(filesize(m_input.File()));
+        auto fileSize = filesize(m_input.File());
+        index->Reserve(fileSize);
 
         BufferedFileReader reader(m_bufferSize, m_input);
 
@@ -63,14 +64,45 @@ namespace CNTK {
         if (!m_corpus)
             RuntimeError("MLFIndexBuilder: corpus descriptor was not specified.");
 
+        auto ranges = SplitIntoRanges(reader.GetFileOffset(), fileSize);
+        auto scannedRanges = ScanInParallel<ScannedRange>(ranges, [this, &reader](size_t i, size_t begin, size_t end)
+        {
+            if (i == 0)
+                return ScanUtterances(reader, true, end);
+
+            auto rangeReader = OpenReaderAt(begin - 1);
+            rangeReader->TryMoveToNextLine();
+            return ScanUtterances(*rangeReader, false, end);
+        });
+
+        // Utterances that start before the point where one of the previous ranges stopped
+        // have already been indexed.
+        size_t scanEnd = 0;
+        for (auto& range : scannedRanges)
+        {
+            for (auto& utterance : range.utterances)
+            {
+                if (utterance.sequence.Offset() < scanEnd)
+                    continue;
+
+                size_t id = utterance.hasKey ? m_corpus->KeyToId(utterance.key) : 0;
+                if (utterance.isValid)
+                    index->AddSequence(utterance.sequence.SetKey(id));
+                else
+                    fprintf(stderr, "WARNING: Cannot parse the utterance '%s' at offset (%" PRIu64 ")\n", m_corpus->IdToKey(id).c_str(), utterance.sequence.Offset());
+            }
+            scanEnd = max(scanEnd, range.scanEnd);
+        }
+    }
 
-        size_t id = 0;
-        State currentState = State::Header;
+    MLFIndexBuilder::ScannedRange MLFIndexBuilder::ScanUtterances(BufferedFileReader& reader, bool isFirstRange, size_t end)
+    {
+        ScannedRange result;
+        State currentState = isFirstRange ? State::Header : State::UtteranceKey;
+        bool isSynchronized = isFirstRange;
         vector<boost::iterator_range<char*>> tokens;
-        bool isValid = true; // Flag indicating whether the current sequence is valid.
-        size_t sequenceStartOffset = 0; // Offset in file where current sequence starts.
+        ScannedUtterance utterance;
         string lastNonEmptyLine; // Needed to parse information about last frame
-        IndexedSequence sequence;
         string line;
         while (true)
         {
@@ -101,10 +133,24 @@ namespace CNTK {
                 if (line == "#!MLF!#")
                     continue;
 
+                // A range that does not start at the beginning of the file can only 
+                // synchronize on a quoted utterance key, the same line where the previous range stops.
+                bool isQuotedKey = (line.front() == '"');
+                if (!isSynchronized && !isQuotedKey)
+                    continue;
+                isSynchronized = true;
+
+                if (offset >= end && isQuotedKey)
+                {
+                    result.scanEnd = offset;
+                    return result;
+                }
+
                 lastNonEmptyLine.clear();
 
-                sequenceStartOffset = offset;
-                isValid = TryParseSequenceKey(line, id, m_corpus->KeyToId);
+                utterance.sequence.SetOffset(offset);
+                utterance.hasKey = TryParseSequenceKey(line, utterance.key);
+                utterance.isValid = utterance.hasKey;
                 currentState = State::UtteranceFrames;
             }
             break;
@@ -123,7 +169,7 @@ namespace CNTK {
 
                 uint32_t numberOfSamples = 0;
                 if (lastNonEmptyLine.empty())
-                    isValid = false;
+                    utterance.isValid = false;
                 else
                 {
                     tokens.clear();
@@ -135,16 +181,12 @@ namespace CNTK {
                     numberOfSamples = static_cast<uint32_t>(range.second);
                 }
 
-                if (isValid)
+                if (utterance.isValid)
                 {
-                    sequence.SetKey(id)
-                        .SetNumberOfSamples(numberOfSamples)
-                        .SetOffset(sequenceStartOffset)
-                        .SetSize(sequenceEndOffset - sequenceStartOffset);
-                    index->AddSequence(sequence);
+                    utterance.sequence.SetNumberOfSamples(numberOfSamples)
+                        .SetSize(sequenceEndOffset - utterance.sequence.Offset());
                 }
-                else
-                    fprintf(stderr, "WARNING: Cannot parse the utterance '%s' at offset (%" PRIu64 ")\n", m_corpus->IdToKey(id).c_str(), sequenceStartOffset);
+                result.utterances.push_back(utterance);
                 currentState = State::UtteranceKey; // Let's try the next one.
             }
             break;
@@ -152,16 +194,17 @@ namespace CNTK {
                 LogicError("Unexpected MLF state.");
             }  
         }
+
+        result.scanEnd = reader.GetFileOffset();
+        return result;
     }
 
 
     // Tries to parse sequence key
     // In MLF a sequence key should be in quotes. During parsing the extension should be removed.
-    bool MLFIndexBuilder::TryParseSequenceKey(const string& line, size_t& id, function<size_t(const string&)> keyToId)
+    bool MLFIndexBuilder::TryParseSequenceKey(const string& line, string& key)
     {
-        id = 0;
-
-        string key(line);
+        key = line;
 
         boost::trim_right(key);
 
@@ -174,8 +217,6 @@ namespace CNTK {
 
         // Remove extension if specified.
         key = key.substr(0, key.find_last_of("."));
-
-        id = keyToId(key);
         return true;
     }
 }
@@ -28,7 +28,27 @@ namespace CNTK {
             UtteranceFrames
         };
 
-        inline bool TryParseSequenceKey(const std::string& line, size_t& id, std::function<size_t(const std::string&)> keyToId);
+        // An utterance found by scanning a byte range of the input. The key is not yet mapped to
+        // a sequence id, this is done once the ranges are merged to keep the order of the mapping.
+        struct ScannedUtterance
+        {
+            IndexedSequence sequence;
+            std::string key;
+            bool hasKey;
+            bool isValid;
+        };
+
+        struct ScannedRange
+        {
+            std::vector<ScannedUtterance> utterances;
+            size_t scanEnd = 0; // offset at which the scan has stopped.
+        };
+
+        // Scans utterances that start inside the [begin, end) range. The first range starts
+        // with the MLF header, the others skip lines until the first utterance key.
+        ScannedRange ScanUtterances(BufferedFileReader& reader, bool isFirstRange, size_t end);
+
+        static bool TryParseSequenceKey(const std::string& line, std::string& key);
     };
 
 } // namespace
@@ -9,6 +9,7 @@
 #include <opencv2/opencv.hpp>
 #include "Base64ImageDeserializer.h"
 #include "ImageTransformers.h"
+#include "ByteReader.h"
 #include "ReaderUtil.h"
 #include "Index.h"
 #include "IndexBuilder.h"
@@ -113,7 +114,7 @@ namespace CNTK {
             }
             else
             {
-                image = cv::imdecode(decodedImage, m_deserializer.m_grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+                image = DecodeImage(reinterpret_cast<const unsigned char*>(decodedImage.data()), decodedImage.size(), m_deserializer.m_grayscale, m_deserializer.m_decodeMinSide);
             }
 
             m_deserializer.PopulateSequenceData(image, classId, copyId, { sequence.m_key, 0 }, result);
@@ -6,26 +6,38 @@
 #pragma once
 #include <opencv2/core/mat.hpp>
 #include "Config.h"
+#include "ConcStack.h"
 #ifdef USE_ZIP
 #include <zip.h>
 #include <unordered_map>
 #include <memory>
-#include "ConcStack.h"
 #endif
 
 namespace CNTK {
 
 using MultiMap = std::map<std::string, std::vector<size_t>>;
 
+// Decodes an encoded image from memory. If minSide is not zero and the image is a JPEG, the image
+// is decoded at the smallest resolution (1/2, 1/4 or 1/8 of the original) that keeps its shorter side
+// at least minSide pixels long, which is considerably cheaper than decoding the full image and
+// scaling it down afterwards.
+cv::Mat DecodeImage(const unsigned char* data, size_t size, bool grayscale, int minSide);
+
 class ByteReader
 {
 public:
-    ByteReader() = default;
+    ByteReader() : m_decodeMinSide(0) {}
     virtual ~ByteReader() = default;
 
     virtual void Register(const MultiMap& sequences) = 0;
     virtual cv::Mat Read(size_t seqId, const std::string& path, bool grayscale) = 0;
 
+    // Sets the minimal length of the shorter side of decoded images (see DecodeImage above).
+    void SetDecodeMinSide(int value) { m_decodeMinSide = value; }
+
+protected:
+    int m_decodeMinSide;
+
     DISABLE_COPY_AND_MOVE(ByteReader);
 };
 
@@ -39,6 +51,10 @@ public:
     cv::Mat Read(size_t seqId, const std::string& path, bool grayscale) override;
 
     std::string m_expandDirectory;
+
+private:
+    // Buffers for the encoded file contents, reused across images and threads.
+    Microsoft::MSR::CNTK::conc_stack<std::vector<unsigned char>> m_workspace;
 };
 
 #ifdef USE_ZIP
@@ -15,6 +15,7 @@
 #include "ImageTransformers.h"
 #include "CorpusDescriptor.h"
 #include "Base64ImageDeserializer.h"
+#include "PackedImageDeserializer.h"
 #include "V2Dependencies.h"
 
 namespace CNTK {
@@ -48,6 +49,8 @@ extern "C" DATAREADER_API bool CreateDeserializer(DataDeserializerPtr& deseriali
         deserializer = make_shared<ImageDataDeserializer>(corpus, deserializerConfig, primary);
     else if (type == L"Base64ImageDeserializer")
         deserializer = make_shared<Base64ImageDeserializerImpl>(corpus, deserializerConfig, primary);
+    else if (type == L"PackedImageDeserializer")
+        deserializer = make_shared<PackedImageDeserializer>(corpus, deserializerConfig, primary);
     else
         // Unknown type.
         return false;
@@ -14,6 +14,7 @@
 #include "TimerUtility.h"
 #include "ImageTransformers.h"
 #include "ImageUtil.h"
+#include "JpegHeader.h"
 
 namespace CNTK {
 
@@ -74,6 +75,9 @@ ImageDataDeserializer::ImageDataDeserializer(const ConfigParameters& config)
     m_streams = configHelper.GetStreams();
     assert(m_streams.size() == 2);
     m_grayscale = configHelper.UseGrayscale();
+    m_decodeMinSide = config(L"decodeMinSide", 0);
+    if (m_decodeMinSide < 0)
+        InvalidArgument("decodeMinSide must be >= 0, 0 disables reduced size decoding.");
     auto& label = m_streams[configHelper.GetLabelStreamId()];
     auto& feature = m_streams[configHelper.GetFeatureStreamId()];
 
@@ -146,6 +150,7 @@ void ImageDataDeserializer::CreateSequenceDescriptions(CorpusDescriptorPtr corpu
     // Creating the default reader with expanded directory to the map file.
     auto mapFileDirectory = ExtractDirectory(mapPath);
     m_defaultReader = make_unique<FileByteReader>(mapFileDirectory);
+    m_defaultReader->SetDecodeMinSide(m_decodeMinSide);
 
     size_t numberOfCopies = isMultiCrop ? ImageDeserializerBase::NumMultiViewCopies : 1;
     static_assert(ImageDeserializerBase::NumMultiViewCopies < std::numeric_limits<uint8_t>::max(), "Do not support more than 256 copies.");
@@ -262,6 +267,7 @@ void ImageDataDeserializer::RegisterByteReader(size_t seqId, const std::string&
     if (r == knownReaders.end())
     {
         reader = std::make_shared<ZipByteReader>(containerPath);
+        reader->SetDecodeMinSide(m_decodeMinSide);
         knownReaders[containerPath] = reader;
         readerSequences[containerPath] = MultiMap();
     }
@@ -295,7 +301,54 @@ cv::Mat FileByteReader::Read(size_t, const std::string& seqPath, bool grayscale)
     assert(!seqPath.empty());
     auto path = Expand3Dots(seqPath, m_expandDirectory);
 
-    return cv::imread(path, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    // Without reduced size decoding the image is read by OpenCV as before, e.g. with its EXIF orientation handling.
+    if (m_decodeMinSide <= 0)
+        return cv::imread(path, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+
+    std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(path.c_str(), "rb"), fclose);
+    if (!file || fseek(file.get(), 0, SEEK_END) != 0)
+        return cv::Mat();
+
+    long size = ftell(file.get());
+    if (size <= 0 || fseek(file.get(), 0, SEEK_SET) != 0)
+        return cv::Mat();
+
+    auto contents = m_workspace.pop_or_create([size]() { return std::vector<unsigned char>(size); });
+    if (contents.size() < (size_t)size)
+        contents.resize(size);
+
+    cv::Mat image;
+    if (fread(contents.data(), 1, size, file.get()) == (size_t)size)
+        image = DecodeImage(contents.data(), size, grayscale, m_decodeMinSide);
+
+    m_workspace.push(std::move(contents));
+    return image;
+}
+
+cv::Mat DecodeImage(const unsigned char* data, size_t size, bool grayscale, int minSide)
+{
+    int reduction = GetJpegDecodeReduction(data, size, minSide);
+
+    // Wrapping the encoded bytes without copying them.
+    cv::Mat encoded(1, (int)size, CV_8UC1, const_cast<unsigned char*>(data));
+
+#if CV_VERSION_MAJOR > 3 || (CV_VERSION_MAJOR == 3 && CV_VERSION_MINOR >= 2)
+    int flags = grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR;
+    switch (reduction)
+    {
+    case 2: flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2; break;
+    case 4: flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4; break;
+    case 8: flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8; break;
+    }
+    return cv::imdecode(encoded, flags);
+#else
+    // Reduced decoding is not available in this version of OpenCV, still scale the image down 
+    // right away, so that the following transforms work on the smaller image.
+    cv::Mat image = cv::imdecode(encoded, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    if (reduction > 1 && image.data)
+        cv::resize(image, image, cv::Size(), 1.0 / reduction, 1.0 / reduction, cv::INTER_AREA);
+    return image;
+#endif
 }
 
 bool ImageDataDeserializer::GetSequenceInfoByKey(const SequenceKey& key, SequenceInfo& result)
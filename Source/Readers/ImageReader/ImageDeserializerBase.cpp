@@ -20,7 +20,7 @@ using namespace Microsoft::MSR::CNTK;
     ImageDeserializerBase::ImageDeserializerBase() 
         : DataDeserializerBase(true),
           m_precision(DataType::Float),
-          m_grayscale(false), m_verbosity(0), m_multiViewCrop(false)
+          m_grayscale(false), m_decodeMinSide(0), m_verbosity(0), m_multiViewCrop(false)
     {}
 
     ImageDeserializerBase::ImageDeserializerBase(CorpusDescriptorPtr corpus, const ConfigParameters& config, bool primary)
@@ -71,6 +71,10 @@ using namespace Microsoft::MSR::CNTK;
 
         m_grayscale = config(L"grayscale", false);
 
+        m_decodeMinSide = config(L"decodeMinSide", 0);
+        if (m_decodeMinSide < 0)
+            InvalidArgument("decodeMinSide must be >= 0, 0 disables reduced size decoding.");
+
         // TODO: multiview should be done on the level of randomizer/transformers - it is responsiblity of the
         // TODO: randomizer to collect how many copies each transform needs and request same sequence several times.
         m_multiViewCrop = config(L"multiViewCrop", false);
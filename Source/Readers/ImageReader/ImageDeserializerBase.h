@@ -43,6 +43,10 @@ namespace CNTK {
         // Flag whether images shall be loaded in grayscale.
         bool m_grayscale;
 
+        // Minimal length of the shorter side of decoded images, allows decoding JPEGs 
+        // at reduced resolution (0 means images are always decoded at full resolution).
+        int m_decodeMinSide;
+
         // Verbosity.
         int m_verbosity;
 
@@ -459,9 +459,11 @@ void MeanTransformer::Apply(uint8_t, cv::Mat &mat, int /* indexInBatch */)
 
     if (m_meanImg.size() == mat.size())
     {
-        // If matrix has not been converted to the right type, do it now as maen requires floating point type.
-        ConvertToFloatingPointIfRequired(mat);
-        mat = mat - m_meanImg;
+        // Mean requires floating point type, the subtraction converts the input (if it has not 
+        // been converted yet) on the fly, without materializing an intermediate converted image.
+        cv::Mat result;
+        cv::subtract(mat, m_meanImg, result, cv::noArray(), ExpectedOpenCVPrecision());
+        mat = result;
     }
     else
     {
@@ -526,6 +528,67 @@ SequenceDataPtr TransposeTransformer::Transform(SequenceDataPtr sequence, int in
     return nullptr; // Make compiler happy
 }
 
+// An image that is transposed from HWC to CHW directly into the slot of the minibatch buffer.
+template <class TElementFrom, class TElementTo>
+struct TransposedImageSequence : DenseSequenceWriter
+{
+    TransposedImageSequence(const cv::Mat& image, size_t channelCount, const NDShape& sampleShape)
+        : DenseSequenceWriter(sampleShape, sampleShape.TotalSize() * sizeof(TElementTo)),
+        m_image(image), m_channelCount(channelCount)
+    {
+        m_numberOfSamples = 1;
+    }
+
+    void WriteSample(size_t sampleIndex, char* destination) override
+    {
+        assert(sampleIndex == 0);
+        UNUSED(sampleIndex);
+
+        auto dst = reinterpret_cast<TElementTo*>(destination);
+        size_t nRows = m_image.rows;
+        size_t nCols = m_image.cols;
+        size_t rowCount = nRows * nCols;
+
+        if (m_channelCount == 3) // Unrolling for BGR, the most common case.
+        {
+            TElementTo* b = dst;
+            TElementTo* g = dst + rowCount;
+            TElementTo* r = dst + 2 * rowCount;
+
+            for (size_t i = 0; i < nRows; ++i)
+            {
+                auto* x = m_image.ptr<TElementFrom>((int)i);
+                for (size_t j = 0; j < nCols; ++j)
+                {
+                    auto row = j * 3;
+                    *b++ = static_cast<TElementTo>(x[row]);
+                    *g++ = static_cast<TElementTo>(x[row + 1]);
+                    *r++ = static_cast<TElementTo>(x[row + 2]);
+                }
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < nRows; ++i)
+            {
+                auto* x = m_image.ptr<TElementFrom>((int)i);
+                for (size_t j = 0; j < nCols; ++j)
+                {
+                    size_t irow = i * nCols + j;
+                    for (size_t icol = 0; icol < m_channelCount; icol++)
+                    {
+                        dst[icol * rowCount + irow] = static_cast<TElementTo>(x[j * m_channelCount + icol]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    cv::Mat m_image;
+    size_t m_channelCount;
+};
+
 template <class TElementTo>
 template<class TElementFrom>
 SequenceDataPtr TransposeTransformer::TypedTranspose<TElementTo>::Apply(ImageSequenceData* inputSequence, int /* indexInBatch */)
@@ -541,54 +604,17 @@ SequenceDataPtr TransposeTransformer::TypedTranspose<TElementTo>::Apply(ImageSeq
 
     assert(inputSequence->m_numberOfSamples == 1);
 
-    size_t count = shape.TotalSize();
-
     ImageDimensions dimensions(TensorShape(shape.Dimensions()), ImageLayoutKind::HWC);
-    size_t rowCount = dimensions.m_height * dimensions.m_width;
-    size_t channelCount = dimensions.m_numChannels;
-
     auto dims = dimensions.AsTensorShape(CHW).GetDims();
     NDShape resultShape(std::vector<size_t>(dims.begin(), dims.end()));
-    auto result = std::make_shared<DenseSequenceWithBuffer<TElementTo>>(m_memBuffers, count, resultShape);
-    result->m_key = inputSequence->m_key;
-
-    auto dst = result->GetBuffer();
 
-    if (channelCount == 3) // Unrolling for BGR, the most common case.
-    {
-        size_t nRows = inputSequence->m_image.rows;
-        size_t nCols = inputSequence->m_image.cols;
-
-        TElementTo* b = dst;
-        TElementTo* g = dst + rowCount;
-        TElementTo* r = dst + 2 * rowCount;
+    const auto& image = inputSequence->m_image;
+    if ((size_t)image.rows * image.cols * image.channels() != resultShape.TotalSize())
+        RuntimeError("Image of size %dx%dx%d does not match the shape of the stream '%ls'.",
+            image.cols, image.rows, image.channels(), m_parent->m_inputStream.m_name.c_str());
 
-        for (size_t i = 0; i < nRows; ++i)
-        {
-            auto* x = inputSequence->m_image.ptr<TElementFrom>((int)i);
-            for (size_t j = 0; j < nCols; ++j)
-            {
-                auto row = j * 3;
-                *b++ = static_cast<TElementTo>(x[row]);
-                *g++ = static_cast<TElementTo>(x[row + 1]);
-                *r++ = static_cast<TElementTo>(x[row + 2]);
-            }
-        }
-    }
-    else
-    {
-        auto src = reinterpret_cast<const TElementFrom*>(inputSequence->GetDataBuffer());
-        for (size_t irow = 0; irow < rowCount; irow++)
-        {
-            for (size_t icol = 0; icol < channelCount; icol++)
-            {
-                dst[icol * rowCount + irow] = static_cast<TElementTo>(src[irow * channelCount + icol]);
-            }
-        }
-    }
-
-    
-    result->m_numberOfSamples = inputSequence->m_numberOfSamples;
+    auto result = std::make_shared<TransposedImageSequence<TElementFrom, TElementTo>>(image, dimensions.m_numChannels, resultShape);
+    result->m_key = inputSequence->m_key;
     return result;
 }
 
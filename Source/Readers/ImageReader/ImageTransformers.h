@@ -186,7 +186,9 @@ public:
     SequenceDataPtr Transform(SequenceDataPtr sequence, int indexInBatch=0) override;
 
 private:
-    // A helper class transposes images using a set of typed memory buffers.
+    // A helper class that transposes images to the requested element type.
+    // The transposition itself is deferred until the packer provides the destination
+    // in the minibatch buffer (see DenseSequenceWriter).
     template <class TElementTo>
     struct TypedTranspose
     {
@@ -196,13 +198,12 @@ private:
 
         template <class TElementFrom>
         SequenceDataPtr Apply(ImageSequenceData* inputSequence, int indexInBatch);
-        Microsoft::MSR::CNTK::conc_stack<std::vector<TElementTo>> m_memBuffers;
     };
 
-    // Auxiliary buffer to handle images of float type.
+    // Transposes images to float.
     TypedTranspose<float> m_floatTransform;
 
-    // Auxiliary buffer to handle images of double type.
+    // Transposes images to double.
     TypedTranspose<double> m_doubleTransform;
 };
 
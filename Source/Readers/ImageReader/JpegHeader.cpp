@@ -0,0 +1,65 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include <algorithm>
+#include "JpegHeader.h"
+
+namespace CNTK {
+
+bool TryGetJpegDimensions(const unsigned char* data, size_t size, int& width, int& height)
+{
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+        return false;
+
+    size_t pos = 2;
+    while (pos + 4 <= size)
+    {
+        if (data[pos] != 0xFF)
+            return false;
+
+        unsigned char marker = data[pos + 1];
+        if (marker == 0xFF) // fill byte
+        {
+            pos++;
+            continue;
+        }
+
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) // markers without a payload
+        {
+            pos += 2;
+            continue;
+        }
+
+        size_t length = (data[pos + 2] << 8) | data[pos + 3];
+
+        // Start of frame markers (except DHT, JPG and DAC that share the same range).
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+        {
+            if (pos + 9 > size)
+                return false;
+            height = (data[pos + 5] << 8) | data[pos + 6];
+            width = (data[pos + 7] << 8) | data[pos + 8];
+            return width > 0 && height > 0;
+        }
+
+        pos += 2 + length;
+    }
+    return false;
+}
+
+int GetJpegDecodeReduction(const unsigned char* data, size_t size, int minSide)
+{
+    int reduction = 1;
+    int width, height;
+    if (minSide > 0 && TryGetJpegDimensions(data, size, width, height))
+    {
+        while (reduction < 8 && std::min(width, height) / (reduction * 2) >= minSide)
+            reduction *= 2;
+    }
+    return reduction;
+}
+
+}
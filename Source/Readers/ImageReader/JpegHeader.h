@@ -0,0 +1,20 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace CNTK {
+
+// Reads the dimensions of a JPEG image from its frame header (baseline, progressive or any other
+// start of frame), without decoding the image. Returns false if the data is not a JPEG or ends before the frame header.
+bool TryGetJpegDimensions(const unsigned char* data, size_t size, int& width, int& height);
+
+// Returns the largest factor (1, 2, 4 or 8) by which a JPEG image can be scaled down while it is decoded,
+// so that its shorter side stays at least minSide pixels long. Returns 1 if minSide is 0 or the data is not a JPEG.
+int GetJpegDecodeReduction(const unsigned char* data, size_t size, int minSide);
+
+}
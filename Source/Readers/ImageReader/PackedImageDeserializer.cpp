@@ -0,0 +1,233 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <opencv2/opencv.hpp>
+#include "PackedImageDeserializer.h"
+#include "ByteReader.h"
+#include "ReaderUtil.h"
+#include "Index.h"
+#include "IndexBuilder.h"
+
+namespace CNTK {
+    using namespace Microsoft::MSR::CNTK;
+
+    // Builds the index from the image table stored at the end of the packed file,
+    // the file is not scanned.
+    class PackedImageDeserializer::PackedImageIndexBuilder : public IndexBuilder
+    {
+    public:
+        PackedImageIndexBuilder(const FileWrapper& input, std::vector<uint32_t>& classIds, size_t labelDimension)
+            : IndexBuilder(input), m_classIds(classIds), m_labelDimension(labelDimension)
+        {}
+
+        virtual std::wstring GetCacheFilename() override
+        {
+            // The packed file already contains the index.
+            LogicError("Index caching is not supported for packed image files.");
+        }
+
+    private:
+        virtual void Populate(std::shared_ptr<Index>& index) override
+        {
+            m_input.CheckIsOpenOrDie();
+
+            auto fileSize = m_input.Filesize();
+            FileHeader header;
+            if (!m_input.TryRead(header) || header.magic != PackedImageDeserializer::s_magic)
+                RuntimeError("File '%ls' is not a packed image file.", m_input.Filename().c_str());
+
+            if (header.version != PackedImageDeserializer::s_version)
+                RuntimeError("Unsupported version '%u' of the packed image file '%ls', expected version '%u'.",
+                    header.version, m_input.Filename().c_str(), PackedImageDeserializer::s_version);
+
+            if (header.numberOfImages == 0)
+                RuntimeError("Packed image file '%ls' is empty.", m_input.Filename().c_str());
+
+            if (header.tableOffset + header.numberOfImages * sizeof(TableEntry) > fileSize)
+                RuntimeError("Packed image file '%ls' is truncated.", m_input.Filename().c_str());
+
+            std::vector<TableEntry> table(header.numberOfImages);
+            m_input.SeekOrDie(header.tableOffset, SEEK_SET);
+            m_input.ReadOrDie(table.data(), sizeof(TableEntry), table.size());
+
+            index->Reserve(header.tableOffset);
+            m_classIds.reserve(table.size());
+
+            std::string key;
+            IndexedSequence sequence;
+            for (const auto& entry : table)
+            {
+                if (entry.offset + entry.size > header.tableOffset)
+                    RuntimeError("Invalid image offset '%" PRIu64 "' in the packed image file '%ls'.", entry.offset, m_input.Filename().c_str());
+
+                if (entry.classId >= m_labelDimension)
+                    RuntimeError("Image with index '%" PRIu64 "' has invalid class id '%u'. It is exceeding the label dimension of '%" PRIu64 "'.",
+                        m_classIds.size(), entry.classId, m_labelDimension);
+
+                key.resize(entry.keySize);
+                m_input.ReadOrDie(&key[0], 1, key.size());
+
+                sequence.SetKey(m_corpus->KeyToId(key))
+                    .SetNumberOfSamples(1)
+                    .SetOffset(entry.offset)
+                    .SetSize(entry.size);
+                index->AddSequence(sequence);
+                m_classIds.push_back(entry.classId);
+            }
+        }
+
+        std::vector<uint32_t>& m_classIds;
+        size_t m_labelDimension;
+    };
+
+    class PackedImageDeserializer::PackedChunk : public Chunk
+    {
+        const ChunkDescriptor& m_descriptor;
+        size_t m_firstImage;
+        PackedImageDeserializer& m_deserializer;
+
+        // Either points into the memory mapped file or into the buffer below.
+        const unsigned char* m_data;
+        std::vector<unsigned char> m_buffer;
+        std::shared_ptr<MemoryMappedFile> m_mappedFile;
+
+    public:
+        PackedChunk(const ChunkDescriptor& descriptor, size_t firstImage, PackedImageDeserializer& parent)
+            : m_descriptor(descriptor), m_firstImage(firstImage), m_deserializer(parent), m_data(nullptr)
+        {
+            if (descriptor.Sequences().empty() || !descriptor.SizeInBytes())
+                LogicError("Empty chunks are not supported.");
+
+            if (m_deserializer.m_mappedFile)
+            {
+                m_mappedFile = m_deserializer.m_mappedFile;
+                m_data = m_mappedFile->Data() + descriptor.StartOffset();
+            }
+            else
+            {
+                m_deserializer.ReadOrDie(descriptor.StartOffset(), descriptor.SizeInBytes(), m_buffer);
+                m_data = m_buffer.data();
+            }
+        }
+
+        void GetSequence(size_t sequenceIndex, std::vector<SequenceDataPtr>& result) override
+        {
+            const size_t innerSequenceIndex = m_deserializer.m_multiViewCrop ? sequenceIndex / ImageDeserializerBase::NumMultiViewCopies : sequenceIndex;
+            const size_t copyId = m_deserializer.m_multiViewCrop ? sequenceIndex % ImageDeserializerBase::NumMultiViewCopies : 0;
+
+            const auto& sequence = m_descriptor.Sequences()[innerSequenceIndex];
+            auto image = DecodeImage(m_data + sequence.OffsetInChunk(), sequence.SizeInBytes(), m_deserializer.m_grayscale, m_deserializer.m_decodeMinSide);
+
+            size_t classId = m_deserializer.m_classIds[m_firstImage + innerSequenceIndex];
+            m_deserializer.PopulateSequenceData(image, classId, copyId, { sequence.m_key, 0 }, result);
+        }
+    };
+
+    PackedImageDeserializer::PackedImageDeserializer(CorpusDescriptorPtr corpus, const ConfigParameters& config, bool primary) : ImageDeserializerBase(corpus, config, primary)
+    {
+        wstring fileName = config(L"file");
+        m_fileName = fileName;
+
+        size_t chunkSize = config(L"chunkSizeInBytes", g_32MB);
+        bool memoryMapped = config(L"memoryMapped", false);
+
+        attempt(5, [this, corpus, chunkSize]()
+        {
+            m_dataFile.reset(fopenOrDie(m_fileName, L"rbS"), [](FILE* f) { if (f) fclose(f); });
+
+            m_classIds.clear();
+            m_index = PackedImageIndexBuilder(FileWrapper(m_fileName, m_dataFile.get()), m_classIds, m_labelGenerator->LabelDimension())
+                .SetPrimary(m_primary)
+                .SetCorpus(corpus)
+                .SetChunkSize(chunkSize)
+                .Build();
+        });
+
+        m_firstImageInChunk.reserve(m_index->NumberOfChunks());
+        size_t firstImage = 0;
+        for (const auto& chunk : m_index->Chunks())
+        {
+            m_firstImageInChunk.push_back(firstImage);
+            firstImage += chunk.NumberOfSequences();
+        }
+
+        if (memoryMapped)
+            m_mappedFile = MemoryMappedFile::OpenOrDie(m_fileName);
+    }
+
+    void PackedImageDeserializer::ReadOrDie(size_t offset, size_t size, std::vector<unsigned char>& buffer)
+    {
+        buffer.resize(size);
+
+        std::lock_guard<std::mutex> lock(m_fileLock);
+        attempt(5, [this, offset, size, &buffer]()
+        {
+            // Let's see if the open descriptor has problems.
+            if (ferror(m_dataFile.get()) != 0)
+                m_dataFile.reset(fopenOrDie(m_fileName, L"rbS"), [](FILE* f) { if (f) fclose(f); });
+
+            int rc = _fseeki64(m_dataFile.get(), offset, SEEK_SET);
+            if (rc)
+                RuntimeError("Error seeking to position '%" PRIu64 "' in the input file '%ls', error code '%d'", (uint64_t)offset, m_fileName.c_str(), rc);
+
+            freadOrDie(buffer.data(), size, 1, m_dataFile.get());
+        });
+    }
+
+    std::vector<ChunkInfo> PackedImageDeserializer::ChunkInfos()
+    {
+        // In case of multi crop the deserializer provides the same sequence NumMultiViewCopies times.
+        size_t sequencesPerInitialSequence = m_multiViewCrop ? ImageDeserializerBase::NumMultiViewCopies : 1;
+        std::vector<ChunkInfo> result;
+        result.reserve(m_index->NumberOfChunks());
+        for (uint32_t i = 0; i < m_index->NumberOfChunks(); ++i)
+        {
+            const auto& chunk = m_index->Chunks()[i];
+            ChunkInfo c;
+            c.m_id = i;
+            c.m_numberOfSamples = c.m_numberOfSequences = chunk.NumberOfSequences() * sequencesPerInitialSequence;
+            result.push_back(c);
+        }
+        return result;
+    }
+
+    void PackedImageDeserializer::SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& result)
+    {
+        const auto& chunk = m_index->Chunks()[chunkId];
+        size_t sequenceCopies = m_multiViewCrop ? NumMultiViewCopies : 1;
+        result.reserve(sequenceCopies * chunk.NumberOfSequences());
+        size_t currentId = 0;
+        for (uint32_t indexInChunk = 0; indexInChunk < chunk.NumberOfSequences(); ++indexInChunk)
+        {
+            auto const& s = chunk[indexInChunk];
+            for (size_t i = 0; i < sequenceCopies; ++i)
+            {
+                result.push_back(
+                {
+                    currentId,
+                    s.m_numberOfSamples,
+                    chunkId,
+                    { s.m_key, 0 }
+                });
+
+                currentId++;
+            }
+        }
+    }
+
+    ChunkPtr PackedImageDeserializer::GetChunk(ChunkIdType chunkId)
+    {
+        const auto& chunkDescriptor = m_index->Chunks()[chunkId];
+        return make_shared<PackedChunk>(chunkDescriptor, m_firstImageInChunk[chunkId], *this);
+    }
+
+    bool PackedImageDeserializer::GetSequenceInfoByKey(const SequenceKey& key, SequenceInfo& r)
+    {
+        return DataDeserializerBase::GetSequenceInfoByKey(*m_index, key, r);
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <mutex>
+#include "ImageDeserializerBase.h"
+#include "Config.h"
+#include "CorpusDescriptor.h"
+#include "MemoryMappedFile.h"
+
+namespace CNTK {
+
+    class Index;
+
+    // Deserializer for images packed into a single file (see Scripts/map2packed.py):
+    //     Header: magic, version, number of images, offset of the image table
+    //     Encoded images (jpg, png, ...) stored back to back
+    //     Image table: one entry per image (offset, size, class id, key size), followed by all keys
+    // Consecutive images are grouped into chunks of the configured size, each chunk is brought into
+    // memory with a single sequential read (or is simply mapped, if the file is memory mapped),
+    // images are decoded on demand when the sequences are requested.
+    class PackedImageDeserializer : public ImageDeserializerBase
+    {
+    public:
+        PackedImageDeserializer(CorpusDescriptorPtr corpus, const Microsoft::MSR::CNTK::ConfigParameters& config, bool primary);
+
+        // Get a chunk by id.
+        ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+        // Get chunk descriptions.
+        std::vector<ChunkInfo> ChunkInfos() override;
+
+        // Gets sequence descriptions for the chunk.
+        void SequenceInfosForChunk(ChunkIdType, std::vector<SequenceInfo>&) override;
+
+        // Gets sequence description by key.
+        bool GetSequenceInfoByKey(const SequenceKey&, SequenceInfo&) override;
+
+        static const uint64_t s_magic = 0x636e746b5f70696d; // 'cntk_pim'
+        static const uint32_t s_version = 1;
+
+        struct FileHeader
+        {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t numberOfImages;
+            uint64_t tableOffset;
+        };
+
+        struct TableEntry
+        {
+            uint64_t offset;
+            uint32_t size;
+            uint32_t classId;
+            uint32_t keySize;
+            uint32_t reserved;
+        };
+
+    private:
+        class PackedChunk;
+        class PackedImageIndexBuilder;
+
+        // Reads a byte range of the file into the provided buffer.
+        void ReadOrDie(size_t offset, size_t size, std::vector<unsigned char>& buffer);
+
+        std::wstring m_fileName;
+        std::shared_ptr<Index> m_index;
+
+        // Class ids of all images, in the order they are stored in the file.
+        std::vector<uint32_t> m_classIds;
+
+        // Global index (into m_classIds) of the first image of each chunk.
+        std::vector<size_t> m_firstImageInChunk;
+
+        // Set if the file is memory mapped, otherwise chunks are read through m_dataFile.
+        std::shared_ptr<Microsoft::MSR::CNTK::MemoryMappedFile> m_mappedFile;
+        std::shared_ptr<FILE> m_dataFile;
+        std::mutex m_fileLock;
+    };
+
+}
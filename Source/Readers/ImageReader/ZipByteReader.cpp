@@ -135,7 +135,7 @@ cv::Mat ZipByteReader::Read(size_t seqId, const std::string& path, bool grayscal
     });
     m_zips.push(std::move(zipFile));
 
-    cv::Mat img = cv::imdecode(contents, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    cv::Mat img = DecodeImage(contents.data(), size, grayscale, m_decodeMinSide);
     assert(nullptr != img.data);
     m_workspace.push(std::move(contents));
     return img;
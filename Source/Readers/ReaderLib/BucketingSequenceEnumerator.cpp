@@ -0,0 +1,218 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "BucketingSequenceEnumerator.h"
+#include "RandomOrdering.h"
+
+namespace CNTK {
+
+const static std::wstring s_currentBucketProperty = L"bucketingCurrentBucket";
+const static std::wstring s_positionInBucketProperty = L"bucketingPositionInBucket";
+
+BucketingSequenceEnumerator::BucketingSequenceEnumerator(SequenceEnumeratorPtr sequenceProvider, size_t poolSizeInSamples, size_t numberOfBuckets, size_t seed)
+    : m_sequenceProvider(sequenceProvider),
+      m_poolSizeInSamples(poolSizeInSamples),
+      m_numberOfBuckets(numberOfBuckets),
+      m_seed(seed),
+      m_currentBucket(0),
+      m_positionInBucket(0),
+      m_poolEndOfSweep(false),
+      m_poolEndOfEpoch(false)
+{
+    if (m_poolSizeInSamples == 0)
+        InvalidArgument("Size of the bucketing pool cannot be 0.");
+
+    if (m_numberOfBuckets == 0)
+        InvalidArgument("Number of buckets cannot be 0.");
+}
+
+void BucketingSequenceEnumerator::StartEpoch(const EpochConfiguration& config)
+{
+    ClearPool();
+    m_sequenceProvider->StartEpoch(config);
+}
+
+void BucketingSequenceEnumerator::ClearPool()
+{
+    m_poolStartState.clear();
+    m_pool.clear();
+    m_lengths.clear();
+    m_bucketBegin.clear();
+    m_bucketOrder.clear();
+    m_currentBucket = 0;
+    m_positionInBucket = 0;
+    m_poolEndOfSweep = false;
+    m_poolEndOfEpoch = false;
+}
+
+std::map<std::wstring, size_t> BucketingSequenceEnumerator::GetState()
+{
+    auto state = IsPoolExhausted() ? m_sequenceProvider->GetState() : m_poolStartState;
+    state[s_currentBucketProperty] = IsPoolExhausted() ? 0 : m_currentBucket;
+    state[s_positionInBucketProperty] = IsPoolExhausted() ? 0 : m_positionInBucket;
+    return state;
+}
+
+void BucketingSequenceEnumerator::SetState(const std::map<std::wstring, size_t>& state)
+{
+    auto innerState = state;
+    size_t currentBucket = 0, positionInBucket = 0;
+
+    auto it = innerState.find(s_currentBucketProperty);
+    if (it != innerState.end())
+    {
+        currentBucket = it->second;
+        innerState.erase(it);
+    }
+
+    it = innerState.find(s_positionInBucketProperty);
+    if (it != innerState.end())
+    {
+        positionInBucket = it->second;
+        innerState.erase(it);
+    }
+
+    ClearPool();
+    m_sequenceProvider->SetState(innerState);
+    if (currentBucket == 0 && positionInBucket == 0)
+        return;
+
+    // Reading the same pool again and restoring the position in it.
+    FillPool();
+    if (currentBucket >= m_bucketOrder.size() ||
+        positionInBucket >= m_bucketBegin[m_bucketOrder[currentBucket] + 1] - m_bucketBegin[m_bucketOrder[currentBucket]])
+        RuntimeError("Invalid position '%d:%d' in the bucketing pool of '%d' buckets.", (int)currentBucket, (int)positionInBucket, (int)m_bucketOrder.size());
+
+    m_currentBucket = currentBucket;
+    m_positionInBucket = positionInBucket;
+}
+
+void BucketingSequenceEnumerator::FillPool()
+{
+    ClearPool();
+    m_poolStartState = m_sequenceProvider->GetState();
+
+    // The pool is read with a single request, because the data of the returned sequences
+    // is only guaranteed to be valid till the next request. The amount of requested samples
+    // does not depend on the minibatch size, so the same pool is read again on restore.
+    auto sequences = m_sequenceProvider->GetNextSequences(SIZE_MAX, m_poolSizeInSamples);
+    m_poolEndOfSweep = sequences.m_endOfSweep;
+    m_poolEndOfEpoch = sequences.m_endOfEpoch;
+
+    std::vector<size_t> lengths;
+    size_t numberOfSamples = 0;
+    if (!sequences.m_data.empty())
+    {
+        for (size_t i = 0; i < sequences.m_data.front().size(); ++i)
+        {
+            // Padding is defined by the longest stream of the sequence.
+            size_t length = 0;
+            for (const auto& stream : sequences.m_data)
+                length = std::max<size_t>(length, stream[i]->m_numberOfSamples);
+
+            lengths.push_back(length);
+            numberOfSamples += length;
+        }
+    }
+
+    if (lengths.empty())
+        return;
+
+    std::vector<size_t> order(lengths.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&lengths](size_t a, size_t b) { return lengths[a] < lengths[b]; });
+
+    m_pool.resize(sequences.m_data.size());
+    for (size_t streamIndex = 0; streamIndex < sequences.m_data.size(); ++streamIndex)
+    {
+        m_pool[streamIndex].reserve(order.size());
+        for (size_t i : order)
+            m_pool[streamIndex].push_back(sequences.m_data[streamIndex][i]);
+    }
+
+    m_lengths.reserve(order.size());
+    for (size_t i : order)
+        m_lengths.push_back(lengths[i]);
+
+    // Splitting the sorted pool into buckets of approximately the same number of samples.
+    size_t bucketSizeInSamples = std::max<size_t>(1, numberOfSamples / m_numberOfBuckets);
+    size_t samplesInBucket = 0;
+    m_bucketBegin.push_back(0);
+    for (size_t i = 0; i < m_lengths.size(); ++i)
+    {
+        if (samplesInBucket >= bucketSizeInSamples)
+        {
+            m_bucketBegin.push_back(i);
+            samplesInBucket = 0;
+        }
+        samplesInBucket += m_lengths[i];
+    }
+    m_bucketBegin.push_back(m_lengths.size());
+
+    // The order of buckets only depends on the state before the pool, so it is the same after restore.
+    size_t seed = m_seed;
+    for (const auto& value : m_poolStartState)
+        seed = seed * 31 + value.second;
+
+    m_bucketOrder.resize(m_bucketBegin.size() - 1);
+    std::iota(m_bucketOrder.begin(), m_bucketOrder.end(), 0);
+    std::mt19937_64 rng(seed);
+    Microsoft::MSR::CNTK::RandomShuffleMT(m_bucketOrder, rng);
+}
+
+Sequences BucketingSequenceEnumerator::GetNextSequences(size_t /*ignoring global sample count*/, size_t localSampleCount)
+{
+    if (localSampleCount == 0)
+        LogicError("Local sample count must not be zero.");
+
+    if (IsPoolExhausted())
+    {
+        FillPool();
+        if (IsPoolExhausted())
+        {
+            Sequences result;
+            result.m_endOfSweep = m_poolEndOfSweep;
+            result.m_endOfEpoch = m_poolEndOfEpoch;
+            return result;
+        }
+    }
+
+    size_t bucket = m_bucketOrder[m_currentBucket];
+    size_t begin = m_bucketBegin[bucket] + m_positionInBucket;
+    size_t end = m_bucketBegin[bucket + 1];
+
+    // Taking consecutive sequences of the bucket, at least one.
+    size_t last = begin;
+    size_t numberOfSamples = 0;
+    while (last < end && (last == begin || numberOfSamples + m_lengths[last] <= localSampleCount))
+        numberOfSamples += m_lengths[last++];
+
+    Sequences result;
+    result.m_data.resize(m_pool.size());
+    for (size_t streamIndex = 0; streamIndex < m_pool.size(); ++streamIndex)
+        result.m_data[streamIndex].assign(m_pool[streamIndex].begin() + begin, m_pool[streamIndex].begin() + last);
+
+    m_positionInBucket += last - begin;
+    if (last == end)
+    {
+        m_currentBucket++;
+        m_positionInBucket = 0;
+    }
+
+    if (IsPoolExhausted())
+    {
+        result.m_endOfSweep = m_poolEndOfSweep;
+        result.m_endOfEpoch = m_poolEndOfEpoch;
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <vector>
+#include "SequenceEnumerator.h"
+
+namespace CNTK {
+
+// A sequence enumerator that groups sequences of similar length together, so that the packer
+// wastes less space on padding when sequences of different length are packed into the same minibatch.
+// Randomized sequences are read from the underlying enumerator into a pool of a bounded size (in samples),
+// the pool is sorted by sequence length and split into several buckets of similar size. Buckets are then
+// returned in a random order, and each bucket is cut into minibatches of consecutive sequences up to the
+// requested sample count. The next pool is only read when all sequences of the current one have been returned.
+// Similarly to the local timeline randomizers, the pool itself is not checkpointed. Instead the checkpoint
+// contains the state of the underlying enumerator before the pool was filled and the position in the pool;
+// on restore the pool is read again. The content of the pool does not depend on the minibatch size, so the
+// restored position is exact even if the minibatch size changes.
+// The end of sweep/epoch is reported together with the last sequences of the pool.
+class BucketingSequenceEnumerator : public SequenceEnumerator
+{
+public:
+    BucketingSequenceEnumerator(SequenceEnumeratorPtr sequenceProvider, size_t poolSizeInSamples, size_t numberOfBuckets, size_t seed);
+
+    std::vector<StreamInformation> GetStreamDescriptions() const override
+    {
+        return m_sequenceProvider->GetStreamDescriptions();
+    }
+
+    void StartEpoch(const EpochConfiguration& config) override;
+
+    void SetConfiguration(const ReaderConfiguration& config) override
+    {
+        m_sequenceProvider->SetConfiguration(config);
+    }
+
+    void SetState(const std::map<std::wstring, size_t>& state) override;
+
+    std::map<std::wstring, size_t> GetState() override;
+
+    Sequences GetNextSequences(size_t globalSampleCount, size_t localSampleCount) override;
+
+private:
+    // Reads the next pool of sequences from the underlying enumerator and splits it into buckets.
+    void FillPool();
+
+    void ClearPool();
+
+    bool IsPoolExhausted() const
+    {
+        return m_currentBucket >= m_bucketOrder.size();
+    }
+
+    SequenceEnumeratorPtr m_sequenceProvider;
+    size_t m_poolSizeInSamples;
+    size_t m_numberOfBuckets;
+    size_t m_seed;
+
+    // State of the underlying enumerator before the current pool was read.
+    std::map<std::wstring, size_t> m_poolStartState;
+
+    // Sequences of the pool for each stream, sorted by length.
+    std::vector<std::vector<SequenceDataPtr>> m_pool;
+    std::vector<size_t> m_lengths;
+
+    // Bucket boundaries in the sorted pool, bucket i is [m_bucketBegin[i], m_bucketBegin[i + 1]).
+    std::vector<size_t> m_bucketBegin;
+
+    // Order in which buckets are returned.
+    std::vector<size_t> m_bucketOrder;
+
+    // Current position: index into m_bucketOrder and the position inside of the bucket.
+    size_t m_currentBucket;
+    size_t m_positionInBucket;
+
+    // Flags reported by the underlying enumerator when the pool was read.
+    bool m_poolEndOfSweep;
+    bool m_poolEndOfEpoch;
+
+    DISABLE_COPY_AND_MOVE(BucketingSequenceEnumerator);
+};
+
+}
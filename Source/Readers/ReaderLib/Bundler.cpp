@@ -18,13 +18,23 @@ Bundler::Bundler(
     DataDeserializerPtr primaryDeserializer,
     std::vector<DataDeserializerPtr> deserializers,
     bool cleanse)
+    : Bundler((int)readerConfig(L"verbosity", 0), corpus, primaryDeserializer, deserializers, cleanse)
+{
+}
+
+Bundler::Bundler(
+    int verbosity,
+    CorpusDescriptorPtr corpus,
+    DataDeserializerPtr primaryDeserializer,
+    std::vector<DataDeserializerPtr> deserializers,
+    bool cleanse)
     : DataDeserializerBase(true),
       m_corpus(corpus),
       m_deserializers(deserializers),
       m_primaryDeserializer(primaryDeserializer),
       m_mbDefiningDeserializer(std::numeric_limits<size_t>::max())
 {
-    m_verbosity = readerConfig(L"verbosity", 0);
+    m_verbosity = verbosity;
 
     // Combines streams of underlying deserializers.
     for (size_t j = 0; j < deserializers.size(); ++j)
@@ -19,6 +19,7 @@ class Bundler : public DataDeserializerBase
 {
 public:
     Bundler(const ConfigParameters& readerConfig, CorpusDescriptorPtr corpus, DataDeserializerPtr driver, std::vector<DataDeserializerPtr> deserializers, bool cleanse);
+    Bundler(int verbosity, CorpusDescriptorPtr corpus, DataDeserializerPtr driver, std::vector<DataDeserializerPtr> deserializers, bool cleanse);
 
     // Gets chunk descriptions.
     virtual std::vector<ChunkInfo> ChunkInfos() override;
@@ -0,0 +1,472 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include "DiskChunkCache.h"
+#include "SequenceData.h"
+#include "FileWrapper.h"
+#include "MemoryMappedFile.h"
+#include "EnvironmentUtil.h"
+
+namespace CNTK {
+
+using namespace std;
+using Microsoft::MSR::CNTK::MemoryMappedFile;
+
+// !!! Please update the s_version below if any of the structures below or the layout of the payload is modified.
+// A cache file consists of the header followed by the payload.
+// The payload starts with a table of <sequence index in chunk, sequence offset in payload> pairs sorted by the index,
+// followed by the sequence records. Each sequence record contains a StreamRecord for every stream, followed by
+// the sample shape dimensions, and then by nnz counts and indices (only for sparse streams) and values.
+// Every part is padded to 8 bytes, so that all data can be accessed in place from the mapped pages.
+struct CacheFileHeader
+{
+    uint64_t magic;
+    uint64_t version;
+    uint64_t sourceSize;
+    int64_t sourceModificationTime;
+    uint64_t streamsFingerprint;
+    uint64_t chunkId;
+    uint64_t numberOfSequences;
+    uint64_t payloadSize;
+    uint64_t checksum;
+};
+
+struct SequenceTableEntry
+{
+    uint64_t indexInChunk;
+    uint64_t offset;
+};
+
+struct StreamRecord
+{
+    uint64_t key;
+    uint32_t sample;
+    uint32_t numberOfSamples;
+    uint32_t isValid;
+    uint32_t elementType;
+    uint32_t rank;
+    uint32_t totalNnzCount;
+    uint64_t valuesSizeInBytes;
+};
+
+static const uint64_t s_magic = 0x636e746b5f63686b; // 'cntk_chk'
+static const uint64_t s_version = 1;
+static const size_t s_alignment = sizeof(uint64_t);
+
+static inline size_t Align(size_t size)
+{
+    return (size + s_alignment - 1) & ~(s_alignment - 1);
+}
+
+// FNV-1a over 64-bit words (and over the bytes of the tail).
+static uint64_t Checksum(const uint8_t* data, size_t size, uint64_t hash = 0xcbf29ce484222325)
+{
+    const uint64_t prime = 0x100000001b3;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+
+    for (; i < size; ++i)
+        hash = (hash ^ data[i]) * prime;
+
+    return hash;
+}
+
+static bool TryGetFileProperties(const wstring& path, uint64_t& size, int64_t& modificationTime)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_wstat64(path.c_str(), &st) != 0)
+        return false;
+#else
+    struct stat st;
+    if (stat(wtocharpath(path).c_str(), &st) != 0)
+        return false;
+#endif
+    size = static_cast<uint64_t>(st.st_size);
+    modificationTime = static_cast<int64_t>(st.st_mtime);
+    return true;
+}
+
+// Bumps the modification time of the file, which is used as the 'last used' time for the LRU eviction.
+static void Touch(const wstring& path)
+{
+#ifdef _WIN32
+    _wutime(path.c_str(), nullptr);
+#else
+    utime(wtocharpath(path).c_str(), nullptr);
+#endif
+}
+
+// Sequence data that points directly into the mapped cache file.
+// m_holdingBuffer keeps the mapping alive as long as the sequence is referenced.
+struct MappedDenseSequenceData : DenseSequenceData
+{
+    const void* GetDataBuffer() override { return m_data; }
+    const NDShape& GetSampleShape() override { return m_sampleShape; }
+
+    const void* m_data;
+    NDShape m_sampleShape;
+};
+
+struct MappedSparseSequenceData : SparseSequenceData
+{
+    const void* GetDataBuffer() override { return m_data; }
+    const NDShape& GetSampleShape() override { return m_sampleShape; }
+
+    const void* m_data;
+    NDShape m_sampleShape;
+};
+
+class DiskChunkCache::CachedChunk : public Chunk
+{
+public:
+    CachedChunk(const shared_ptr<MemoryMappedFile>& file, const vector<StreamInformation>& streams)
+        : m_file(file), m_streams(streams)
+    {
+        auto header = reinterpret_cast<const CacheFileHeader*>(m_file->Data());
+        m_payload = m_file->Data() + sizeof(CacheFileHeader);
+        m_table = reinterpret_cast<const SequenceTableEntry*>(m_payload);
+        m_numberOfSequences = header->numberOfSequences;
+    }
+
+    void GetSequence(size_t sequenceIndex, vector<SequenceDataPtr>& result) override
+    {
+        auto end = m_table + m_numberOfSequences;
+        auto entry = lower_bound(m_table, end, sequenceIndex,
+            [](const SequenceTableEntry& e, size_t index) { return e.indexInChunk < index; });
+        if (entry == end || entry->indexInChunk != sequenceIndex)
+            RuntimeError("Sequence with index %zu is not present in the cached chunk '%ls'.", sequenceIndex, m_file->Filename().c_str());
+
+        result.reserve(result.size() + m_streams.size());
+
+        const uint8_t* position = m_payload + entry->offset;
+        for (const auto& stream : m_streams)
+        {
+            auto record = reinterpret_cast<const StreamRecord*>(position);
+            position += sizeof(StreamRecord);
+
+            if (!record->isValid)
+            {
+                result.push_back(InvalidSequenceData::Instance());
+                continue;
+            }
+
+            auto dimensions = reinterpret_cast<const uint64_t*>(position);
+            NDShape sampleShape(vector<size_t>(dimensions, dimensions + record->rank));
+            position += record->rank * sizeof(uint64_t);
+
+            shared_ptr<SequenceDataBase> sequence;
+            if (stream.m_storageFormat == StorageFormat::Dense)
+            {
+                auto dense = make_shared<MappedDenseSequenceData>();
+                dense->m_sampleShape = sampleShape;
+                dense->m_data = position;
+                sequence = dense;
+            }
+            else
+            {
+                auto sparse = make_shared<MappedSparseSequenceData>();
+                sparse->m_sampleShape = sampleShape;
+
+                auto nnzCounts = reinterpret_cast<const SparseIndexType*>(position);
+                sparse->m_nnzCounts.assign(nnzCounts, nnzCounts + record->numberOfSamples);
+                position += Align(record->numberOfSamples * sizeof(SparseIndexType));
+
+                sparse->m_totalNnzCount = record->totalNnzCount;
+                sparse->m_indices = const_cast<SparseIndexType*>(reinterpret_cast<const SparseIndexType*>(position));
+                position += Align(record->totalNnzCount * sizeof(SparseIndexType));
+
+                sparse->m_data = position;
+                sequence = sparse;
+            }
+
+            position += Align(record->valuesSizeInBytes);
+
+            sequence->m_numberOfSamples = record->numberOfSamples;
+            sequence->m_elementType = static_cast<DataType>(record->elementType);
+            sequence->m_key = SequenceKey(record->key, record->sample);
+            sequence->m_holdingBuffer = shared_ptr<uint8_t>(m_file, const_cast<uint8_t*>(m_file->Data()));
+            result.push_back(sequence);
+        }
+    }
+
+private:
+    shared_ptr<MemoryMappedFile> m_file;
+    vector<StreamInformation> m_streams;
+    const uint8_t* m_payload;
+    const SequenceTableEntry* m_table;
+    size_t m_numberOfSequences;
+
+    DISABLE_COPY_AND_MOVE(CachedChunk);
+};
+
+DiskChunkCache::DiskChunkCache(DataDeserializerPtr deserializer, const wstring& sourceFilename, size_t diskBudgetInBytes)
+    : m_deserializer(deserializer),
+    m_streams(deserializer->StreamInfos()),
+    m_sourceFilename(sourceFilename),
+    m_cacheDirectory(GetCacheDirectory(sourceFilename)),
+    m_diskBudget(diskBudgetInBytes),
+    m_sourceSize(0),
+    m_sourceModificationTime(0)
+{
+    if (!TryGetFileProperties(m_sourceFilename, m_sourceSize, m_sourceModificationTime))
+        RuntimeError("DiskChunkCache: cannot access the source file '%ls'.", m_sourceFilename.c_str());
+
+    for (const auto& stream : m_streams)
+    {
+        if (stream.m_isBinary)
+            RuntimeError("DiskChunkCache: stream '%ls' is an opaque binary stream, these cannot be cached.", stream.m_name.c_str());
+    }
+
+    // Any change in the stream configuration (e.g. a different precision or dimension) invalidates the cache.
+    uint64_t fingerprint = Checksum(reinterpret_cast<const uint8_t*>(&s_version), sizeof(s_version));
+    for (const auto& stream : m_streams)
+    {
+        uint64_t properties[] = { static_cast<uint64_t>(stream.m_storageFormat), static_cast<uint64_t>(stream.m_elementType) };
+        fingerprint = Checksum(reinterpret_cast<const uint8_t*>(properties), sizeof(properties), fingerprint);
+        fingerprint = Checksum(reinterpret_cast<const uint8_t*>(stream.m_name.data()), stream.m_name.size() * sizeof(wchar_t), fingerprint);
+        const auto& dimensions = stream.m_sampleLayout.Dimensions();
+        fingerprint = Checksum(reinterpret_cast<const uint8_t*>(dimensions.data()), dimensions.size() * sizeof(size_t), fingerprint);
+    }
+    m_streamsFingerprint = fingerprint;
+
+    // Creates the cache directory (all directories on the path to a cache file).
+    msra::files::make_intermediate_dirs(GetCacheFilename(0));
+}
+
+/*static*/ wstring DiskChunkCache::GetCacheDirectory(const wstring& sourceFilename)
+{
+    return sourceFilename + L".chunks";
+}
+
+wstring DiskChunkCache::GetCacheFilename(ChunkIdType chunkId) const
+{
+    return m_cacheDirectory + L"/" + to_wstring(chunkId) + L".bin";
+}
+
+ChunkPtr DiskChunkCache::GetChunk(ChunkIdType chunkId)
+{
+    auto chunk = TryLoadFromCache(chunkId);
+    if (chunk)
+        return chunk;
+
+    chunk = m_deserializer->GetChunk(chunkId);
+    TryWriteToCache(chunkId, chunk);
+    return chunk;
+}
+
+ChunkPtr DiskChunkCache::TryLoadFromCache(ChunkIdType chunkId)
+{
+    auto filename = GetCacheFilename(chunkId);
+    auto file = MemoryMappedFile::TryOpen(filename);
+    if (!file || file->Size() < sizeof(CacheFileHeader))
+        return nullptr;
+
+    auto header = reinterpret_cast<const CacheFileHeader*>(file->Data());
+    if (header->magic != s_magic ||
+        header->version != s_version ||
+        header->sourceSize != m_sourceSize ||
+        header->sourceModificationTime != m_sourceModificationTime ||
+        header->streamsFingerprint != m_streamsFingerprint ||
+        header->chunkId != chunkId ||
+        header->payloadSize != file->Size() - sizeof(CacheFileHeader))
+        return nullptr;
+
+    {
+        lock_guard<mutex> lock(m_lock);
+        if (m_verifiedChunks.find(chunkId) == m_verifiedChunks.end())
+        {
+            // The payload is verified only once per process, afterwards the pages are trusted.
+            file->AdviseSequential();
+            if (header->checksum != Checksum(file->Data() + sizeof(CacheFileHeader), header->payloadSize))
+            {
+                fprintf(stderr, "WARNING: DiskChunkCache: checksum mismatch in '%ls', the chunk will be reloaded from the source.\n",
+                    filename.c_str());
+                return nullptr;
+            }
+            m_verifiedChunks.insert(chunkId);
+        }
+    }
+
+    Touch(filename);
+    return make_shared<CachedChunk>(file, m_streams);
+}
+
+void DiskChunkCache::TryWriteToCache(ChunkIdType chunkId, const ChunkPtr& chunk)
+{
+    vector<SequenceInfo> sequences;
+    m_deserializer->SequenceInfosForChunk(chunkId, sequences);
+    sort(sequences.begin(), sequences.end(),
+        [](const SequenceInfo& a, const SequenceInfo& b) { return a.m_indexInChunk < b.m_indexInChunk; });
+
+    vector<uint8_t> payload(sequences.size() * sizeof(SequenceTableEntry));
+    auto append = [&payload](const void* data, size_t size)
+    {
+        size_t offset = payload.size();
+        payload.resize(offset + Align(size), 0);
+        if (size > 0)
+            memcpy(payload.data() + offset, data, size);
+    };
+
+    vector<SequenceDataPtr> data;
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        SequenceTableEntry entry{ sequences[i].m_indexInChunk, payload.size() };
+        memcpy(payload.data() + i * sizeof(SequenceTableEntry), &entry, sizeof(entry));
+
+        data.clear();
+        chunk->GetSequence(sequences[i].m_indexInChunk, data);
+        if (data.size() != m_streams.size())
+            return;
+
+        for (size_t j = 0; j < m_streams.size(); ++j)
+        {
+            const auto& sequence = data[j];
+            StreamRecord record = {};
+            record.key = sequence->m_key.m_sequence;
+            record.sample = sequence->m_key.m_sample;
+            record.numberOfSamples = sequence->m_numberOfSamples;
+            record.isValid = sequence->m_isValid ? 1 : 0;
+
+            if (!sequence->m_isValid)
+            {
+                append(&record, sizeof(record));
+                continue;
+            }
+
+            auto elementType = sequence->m_elementType != DataType::Unknown ? sequence->m_elementType : m_streams[j].m_elementType;
+            const auto& dimensions = sequence->GetSampleShape().Dimensions();
+            vector<uint64_t> shape(dimensions.begin(), dimensions.end());
+
+            record.elementType = static_cast<uint32_t>(elementType);
+            record.rank = static_cast<uint32_t>(shape.size());
+
+            if (m_streams[j].m_storageFormat == StorageFormat::Dense)
+            {
+                record.valuesSizeInBytes = sequence->m_numberOfSamples * sequence->GetSampleShape().TotalSize() * DataTypeSize(elementType);
+                append(&record, sizeof(record));
+                append(shape.data(), shape.size() * sizeof(uint64_t));
+            }
+            else
+            {
+                auto sparse = static_cast<SparseSequenceData*>(sequence.get());
+                record.totalNnzCount = sparse->m_totalNnzCount;
+                record.valuesSizeInBytes = sparse->m_totalNnzCount * DataTypeSize(elementType);
+                append(&record, sizeof(record));
+                append(shape.data(), shape.size() * sizeof(uint64_t));
+                append(sparse->m_nnzCounts.data(), sparse->m_nnzCounts.size() * sizeof(SparseIndexType));
+                append(sparse->m_indices, sparse->m_totalNnzCount * sizeof(SparseIndexType));
+            }
+
+            append(sequence->GetDataBuffer(), record.valuesSizeInBytes);
+        }
+    }
+
+    CacheFileHeader header;
+    header.magic = s_magic;
+    header.version = s_version;
+    header.sourceSize = m_sourceSize;
+    header.sourceModificationTime = m_sourceModificationTime;
+    header.streamsFingerprint = m_streamsFingerprint;
+    header.chunkId = chunkId;
+    header.numberOfSequences = sequences.size();
+    header.payloadSize = payload.size();
+    header.checksum = Checksum(payload.data(), payload.size());
+
+    // Several workers can populate the same cache concurrently, so the temporary file is unique per worker,
+    // and only a complete file is atomically renamed into place.
+    auto filename = GetCacheFilename(chunkId);
+    auto temp = filename + L".tmp" + to_wstring(Microsoft::MSR::CNTK::EnvironmentUtil::GetLocalMPINodeRank());
+    bool success = true;
+    {
+        FileWrapper cache(temp, L"wb");
+        success = cache.IsOpen() &&
+            cache.TryWrite(header) &&
+            cache.TryWrite(payload.data(), 1, payload.size()) &&
+            cache.TryFlush();
+    }
+
+    if (success)
+    {
+        try
+        {
+            renameOrDie(temp, filename);
+        }
+        catch (...)
+        {
+            success = false;
+        }
+    }
+
+    if (!success)
+    {
+        _wunlink(temp.c_str());
+        return;
+    }
+
+    lock_guard<mutex> lock(m_lock);
+    m_verifiedChunks.insert(chunkId);
+    EnforceDiskBudget();
+}
+
+void DiskChunkCache::EnforceDiskBudget()
+{
+    if (m_diskBudget == 0)
+        return; // unlimited.
+
+    struct CacheFile
+    {
+        wstring path;
+        uint64_t size;
+        int64_t lastUsed;
+    };
+
+    vector<CacheFile> files;
+    uint64_t totalSize = 0;
+    for (const auto& name : msra::files::get_all_files_from_directory(m_cacheDirectory))
+    {
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, L".bin") != 0)
+            continue; // skip temporary files of other workers.
+
+        CacheFile file{ m_cacheDirectory + L"/" + name, 0, 0 };
+        if (!TryGetFileProperties(file.path, file.size, file.lastUsed))
+            continue;
+
+        totalSize += file.size;
+        files.push_back(file);
+    }
+
+    if (totalSize <= m_diskBudget)
+        return;
+
+    sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.lastUsed < b.lastUsed; });
+
+    // Chunks that are currently mapped stay valid after unlinking (the OS keeps the pages until unmapped).
+    for (const auto& file : files)
+    {
+        if (totalSize <= m_diskBudget)
+            break;
+
+        if (_wunlink(file.path.c_str()) == 0)
+            totalSize -= file.size;
+    }
+}
+
+}
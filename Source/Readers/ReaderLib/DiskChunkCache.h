@@ -0,0 +1,89 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include "DataDeserializer.h"
+
+namespace CNTK {
+
+// A persistent counterpart of the ChunkCache. The first time a chunk is requested, it is
+// decoded by the wrapped deserializer and written out in a binary form to a cache file
+// inside the '<source file>.chunks' directory. Later requests (in later epochs or in later jobs)
+// memory-map the cache file and expose sequences directly from the mapped pages, skipping
+// the parsing of the source altogether.
+// Each cache file records the size and the modification time of the source together with
+// a fingerprint of the stream layout and a checksum of the payload; cache files that do not
+// match are ignored and rewritten. The total size of the cache directory is bounded by a
+// disk budget, once it is exceeded, least recently used cache files are evicted.
+class DiskChunkCache : public DataDeserializer
+{
+public:
+    DiskChunkCache(DataDeserializerPtr deserializer, const std::wstring& sourceFilename, size_t diskBudgetInBytes);
+
+    virtual std::vector<StreamInformation> StreamInfos() override
+    {
+        return m_streams;
+    }
+
+    virtual std::vector<ChunkInfo> ChunkInfos() override
+    {
+        return m_deserializer->ChunkInfos();
+    }
+
+    virtual void SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& descriptions) override
+    {
+        return m_deserializer->SequenceInfosForChunk(chunkId, descriptions);
+    }
+
+    virtual bool GetSequenceInfo(const SequenceInfo& primary, SequenceInfo& description) override
+    {
+        return m_deserializer->GetSequenceInfo(primary, description);
+    }
+
+    // Gets chunk data given its id, either from the cache or from the underlying deserializer.
+    virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+    // Returns the directory where the chunks of the given source file are cached.
+    static std::wstring GetCacheDirectory(const std::wstring& sourceFilename);
+
+private:
+    class CachedChunk;
+
+    std::wstring GetCacheFilename(ChunkIdType chunkId) const;
+
+    // Returns nullptr if there's no cache file for the chunk or if the cache file is stale or corrupted.
+    ChunkPtr TryLoadFromCache(ChunkIdType chunkId);
+
+    // Serializes all sequences of the chunk into the cache directory. Failures are not fatal,
+    // the chunk simply will be parsed again next time.
+    void TryWriteToCache(ChunkIdType chunkId, const ChunkPtr& chunk);
+
+    // Evicts the least recently used cache files until the directory fits into the disk budget.
+    void EnforceDiskBudget();
+
+    DataDeserializerPtr m_deserializer;
+    std::vector<StreamInformation> m_streams;
+
+    std::wstring m_sourceFilename;
+    std::wstring m_cacheDirectory;
+    size_t m_diskBudget;
+
+    // Source file properties used to invalidate the cache.
+    uint64_t m_sourceSize;
+    int64_t m_sourceModificationTime;
+    uint64_t m_streamsFingerprint;
+
+    // Chunks which payload checksum has already been verified by this process.
+    std::set<ChunkIdType> m_verifiedChunks;
+
+    std::mutex m_lock;
+
+    DISABLE_COPY_AND_MOVE(DiskChunkCache);
+};
+
+}
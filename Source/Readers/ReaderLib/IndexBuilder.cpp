@@ -22,10 +22,43 @@ IndexBuilder::IndexBuilder(const FileWrapper& input)
     m_corpus(nullptr),
     m_isCacheEnabled(false),
     m_chunkSize(g_32MB),
+    m_numberOfThreads(0),
     m_bufferSize(g_2MB),
     m_primary(true)
 {}
 
+vector<pair<size_t, size_t>> IndexBuilder::SplitIntoRanges(size_t begin, size_t end) const
+{
+    size_t size = (end > begin) ? end - begin : 0;
+    size_t numberOfRanges = m_numberOfThreads;
+    if (numberOfRanges == 0)
+    {
+        numberOfRanges = max<size_t>(thread::hardware_concurrency(), 1);
+        numberOfRanges = min(numberOfRanges, max<size_t>(size / s_minRangeSize, 1));
+    }
+
+    numberOfRanges = max<size_t>(min(numberOfRanges, size), 1);
+
+    vector<pair<size_t, size_t>> ranges;
+    ranges.reserve(numberOfRanges);
+    size_t rangeSize = size / numberOfRanges;
+    for (size_t i = 0; i < numberOfRanges; ++i)
+    {
+        size_t rangeBegin = begin + i * rangeSize;
+        size_t rangeEnd = (i + 1 == numberOfRanges) ? end : rangeBegin + rangeSize;
+        ranges.push_back(make_pair(rangeBegin, rangeEnd));
+    }
+    return ranges;
+}
+
+unique_ptr<BufferedFileReader> IndexBuilder::OpenReaderAt(size_t offset) const
+{
+    FileWrapper file(m_input.Filename(), L"rbS");
+    file.CheckIsOpenOrDie();
+    file.SeekOrDie(offset, SEEK_SET);
+    return make_unique<BufferedFileReader>(m_bufferSize, file);
+}
+
 shared_ptr<Index> IndexBuilder::Build()
 {
     if (m_isCacheEnabled) 
@@ -258,62 +291,148 @@ static const char s_BOM[3] = { '\xEF', '\xBB', '\xBF' };
 
 void TextInputIndexBuilder::PopulateFromLines(shared_ptr<Index>& index)
 {
+    auto ranges = SplitIntoRanges(m_reader->GetFileOffset(), m_fileSize);
+    auto firstLine = m_reader->CurrentLineNumber();
+
+    auto scannedRanges = ScanInParallel<ScannedRange>(ranges, [this](size_t i, size_t begin, size_t end)
+    {
+        if (i == 0)
+            return ScanLines(*m_reader, end);
+
+        // Start with the first line that begins inside the range.
+        auto reader = OpenReaderAt(begin - 1);
+        reader->TryMoveToNextLine();
+        return ScanLines(*reader, end);
+    });
+
+    // Line numbers are relative to the start of each range, turn them into absolute ones.
+    auto lineNumber = firstLine;
+    for (auto& range : scannedRanges)
+    {
+        for (auto& sequence : range.sequences)
+            index->AddSequence(sequence.SetKey(sequence.Key() + lineNumber));
+        lineNumber += range.numberOfLines;
+    }
+}
+
+TextInputIndexBuilder::ScannedRange TextInputIndexBuilder::ScanLines(BufferedFileReader& reader, size_t end)
+{
+    ScannedRange result;
+    auto firstLine = reader.CurrentLineNumber();
+
     IndexedSequence sequence;
-    while (!m_reader->Empty())
+    while (!reader.Empty())
     {
-        size_t offset = m_reader->GetFileOffset();
+        size_t offset = reader.GetFileOffset();
+
+        if (offset >= end)
+            break; // the rest belongs to the next range.
 
-        if (!FindMainStream())
+        if (!FindMainStream(reader))
         { 
             // skip lines that do not contain main stream name.
-            m_reader->TryMoveToNextLine();
+            reader.TryMoveToNextLine();
             continue;
         }
 
-        sequence.SetNumberOfSamples(1).SetOffset(offset).SetKey(m_reader->CurrentLineNumber());
+        sequence.SetNumberOfSamples(1).SetOffset(offset).SetKey(reader.CurrentLineNumber() - firstLine);
 
-        if (m_reader->TryMoveToNextLine())
+        if (reader.TryMoveToNextLine())
         {
-            sequence.SetSize(m_reader->GetFileOffset() - offset);
-            index->AddSequence(sequence);
+            sequence.SetSize(reader.GetFileOffset() - offset);
+            result.sequences.push_back(sequence);
         } 
         else  if (offset < m_fileSize)
         {
             // There's a number of characters, not terminated by a newline,
             // add a sequence to the index, parser will have to deal with it.
             sequence.SetSize(m_fileSize - offset);
-            index->AddSequence(sequence);
+            result.sequences.push_back(sequence);
             break;
         }
     }
+
+    result.scanEnd = reader.GetFileOffset();
+    result.numberOfLines = reader.CurrentLineNumber() - firstLine;
+    return result;
 }
 
 void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
 {
+    auto ranges = SplitIntoRanges(m_reader->GetFileOffset(), m_fileSize);
+    if (m_corpus && !m_corpus->IsNumericSequenceKeys() && !m_corpus->IsHashingEnabled())
+    {
+        // Symbolic keys are mapped to ids in the order they are encountered, 
+        // which requires a single sequential pass.
+        ranges.resize(1);
+        ranges[0].second = m_fileSize;
+    }
+
+    auto scannedRanges = ScanInParallel<ScannedRange>(ranges, [this](size_t i, size_t begin, size_t end)
+    {
+        if (i == 0)
+            return ScanSequences(*m_reader, true, end);
+
+        auto reader = OpenReaderAt(begin - 1);
+        reader->TryMoveToNextLine();
+        return ScanSequences(*reader, false, end);
+    });
+
+    // A range scan starts at an arbitrary line and might pick up the tail of a sequence
+    // that was already indexed (in full) by one of the previous ranges, skip such sequences.
+    size_t scanEnd = 0;
+    for (auto& range : scannedRanges)
+    {
+        for (auto& sequence : range.sequences)
+        {
+            if (sequence.Offset() >= scanEnd)
+                index->AddSequence(sequence);
+        }
+        scanEnd = max(scanEnd, range.scanEnd);
+    }
+}
+
+TextInputIndexBuilder::ScannedRange TextInputIndexBuilder::ScanSequences(BufferedFileReader& reader, bool isFirstRange, size_t end)
+{
+    ScannedRange result;
     IndexedSequence sequence;
     uint32_t numberOfSamples = 0;
     bool foundMainStream = false;
-    size_t prevId = 0, nextId = 0, prevOffset = m_reader->GetFileOffset();
+    size_t prevId = 0, nextId = 0, prevOffset = reader.GetFileOffset();
 
-    // Go ahead and read the id of the very first sequence.
-    if (!TryGetSequenceId(prevId))
+    if (isFirstRange)
     {
-        RuntimeError("Expected a sequence id at the offset %zu, none was found.", prevOffset);
+        // Go ahead and read the id of the very first sequence.
+        if (!TryGetSequenceId(reader, prevId))
+            RuntimeError("Expected a sequence id at the offset %zu, none was found.", prevOffset);
     }
+    else
+    {
+        // Skip to the first line with a sequence id.
+        while (!TryGetSequenceId(reader, prevId))
+        {
+            if (!reader.TryMoveToNextLine())
+                return result;
+            prevOffset = reader.GetFileOffset();
+        }
 
-    while (!m_reader->Empty())
+        if (prevOffset >= end)
+            return result; // no sequence starts inside the range.
+    }
+
+    while (!reader.Empty())
     {
-        if (FindMainStream())
+        if (FindMainStream(reader))
         {
             numberOfSamples++;
             foundMainStream = true;
         }
 
-        m_reader->TryMoveToNextLine(); // ignore whatever is left on this line.
+        reader.TryMoveToNextLine(); // ignore whatever is left on this line.
 
-        auto offset = m_reader->GetFileOffset(); // a new line starts at this offset;
+        auto offset = reader.GetFileOffset(); // a new line starts at this offset;
         
-        if (TryGetSequenceId(nextId) && nextId != prevId)
+        if (TryGetSequenceId(reader, nextId) && nextId != prevId)
         {
             // found a new sequence, which starts at the [offset] bytes into the file
             // adding the previous one to the index.
@@ -327,8 +446,15 @@ void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
             numberOfSamples = 0;
             
             if (foundMainStream)
-                index->AddSequence(sequence);
+                result.sequences.push_back(sequence);
             foundMainStream = false;
+
+            if (offset >= end)
+            {
+                // the new sequence belongs to the next range.
+                result.scanEnd = offset;
+                return result;
+            }
         }
     }
 
@@ -340,13 +466,16 @@ void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
             .SetSize(m_fileSize - prevOffset);
         
         if (foundMainStream)
-            index->AddSequence(sequence);
+            result.sequences.push_back(sequence);
     }
+
+    result.scanEnd = m_fileSize;
+    return result;
 }
 
-inline bool TextInputIndexBuilder::FindMainStream()
+inline bool TextInputIndexBuilder::FindMainStream(BufferedFileReader& reader)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
     
     if (m_mainStream.empty())
@@ -357,7 +486,7 @@ inline bool TextInputIndexBuilder::FindMainStream()
     int i = 0;
     do  
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (i == length)
         {
             // we found a match, check to see if it's followed by either a space, 
@@ -375,30 +504,30 @@ inline bool TextInputIndexBuilder::FindMainStream()
 
         if (c == g_eol)
             break;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // we hit either the EOL or the EOF, see if we have a match
     return (i == length);
 }
 
-inline bool TextInputIndexBuilder::TryGetSequenceId(size_t& id)
+inline bool TextInputIndexBuilder::TryGetSequenceId(BufferedFileReader& reader, size_t& id)
 {
     if (m_corpus && !m_corpus->IsNumericSequenceKeys())
-        return TryGetSymbolicSequenceId(id, m_corpus->KeyToId);
+        return TryGetSymbolicSequenceId(reader, id, m_corpus->KeyToId);
 
-    return TryGetNumericSequenceId(id);
+    return TryGetNumericSequenceId(reader, id);
 }
 
-inline bool TextInputIndexBuilder::TryGetNumericSequenceId(size_t& id)
+inline bool TextInputIndexBuilder::TryGetNumericSequenceId(BufferedFileReader& reader, size_t& id)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
 
     bool found = false;
     id = 0;
     do
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (!isdigit(c))
             // Stop as soon as there's a non-digit character
             return found;
@@ -409,16 +538,16 @@ inline bool TextInputIndexBuilder::TryGetNumericSequenceId(size_t& id)
             RuntimeError("Overflow while reading a numeric sequence id (%zu-bit value).", sizeof(id));
         
         found = true;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // reached EOF without hitting the pipe character,
     // ignore it for now, parser will have to deal with it.
     return false;
 }
 
-inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function<size_t(const string&)> keyToId)
+inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(BufferedFileReader& reader, size_t& id, function<size_t(const string&)> keyToId)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
 
     bool found = false;
@@ -427,7 +556,7 @@ inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function
     key.reserve(256);
     do
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (isspace(c))
         {
             if (found)
@@ -437,7 +566,7 @@ inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function
 
         key += c;
         found = true;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // reached EOF without hitting the pipe character,
     // ignore it for now, parser will have to deal with it.
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <future>
 #include <boost/noncopyable.hpp>
 #include "Index.h"
 #include "CorpusDescriptor.h"
@@ -28,6 +29,10 @@ class IndexedSequence
     
 public:
     IndexedSequence& SetKey(size_t value) { key = value; return *this;  }
+
+    size_t Key() const { return key; }
+
+    size_t Offset() const { return offset; }
     
     IndexedSequence& SetNumberOfSamples(uint32_t value) { numberOfSamples = value; return *this; }
     
@@ -76,6 +81,10 @@ public:
 
     IndexBuilder& SetCachingEnabled(bool value) { m_isCacheEnabled = value; return *this; }
 
+    // Sets the number of threads used to scan the input file. Zero (default) picks the number
+    // of threads based on the hardware concurrency and the size of the input.
+    IndexBuilder& SetNumberOfThreads(size_t value) { m_numberOfThreads = value; return *this; }
+
     virtual std::wstring GetCacheFilename() = 0;
 
 protected:
@@ -85,17 +94,46 @@ protected:
 
     virtual void Populate(std::shared_ptr<Index>&) = 0;
 
+    // Splits the [begin, end) byte range of the input into a number of consecutive sub-ranges
+    // that can be scanned independently. Returns a single range if parallel scan is not worth it.
+    std::vector<std::pair<size_t, size_t>> SplitIntoRanges(size_t begin, size_t end) const;
+
+    // Opens a new reader over the input file, positioned at the given offset.
+    std::unique_ptr<BufferedFileReader> OpenReaderAt(size_t offset) const;
+
+    // Invokes scan(rangeIndex, begin, end) for all ranges, the first one on the calling thread
+    // and the rest asynchronously. Results are returned in the order of ranges, exceptions
+    // thrown by any of the scans are propagated to the caller.
+    template <class TResult, class TScan>
+    std::vector<TResult> ScanInParallel(const std::vector<std::pair<size_t, size_t>>& ranges, TScan scan) const
+    {
+        std::vector<std::future<TResult>> futures;
+        for (size_t i = 1; i < ranges.size(); ++i)
+            futures.push_back(std::async(std::launch::async, scan, i, ranges[i].first, ranges[i].second));
+
+        std::vector<TResult> results;
+        results.reserve(ranges.size());
+        results.push_back(scan(0, ranges[0].first, ranges[0].second));
+        for (auto& f : futures)
+            results.push_back(f.get());
+        return results;
+    }
+
     FileWrapper m_input;
     CorpusDescriptorPtr m_corpus;
     size_t m_bufferSize;
     bool m_primary;
     size_t m_chunkSize;
+    size_t m_numberOfThreads;
 
     bool m_isCacheEnabled;
 
     static const uint64_t s_version = 1;
 
 private:
+    // Minimum number of bytes per thread when the number of threads is picked automatically.
+    static const size_t s_minRangeSize = g_64MB;
+
     static std::shared_ptr<Index> TryLoadFromCache(const std::wstring& cacheFilename, size_t chunkSize);
     void WriteIndexCacheAsync(std::shared_ptr<Index>& index);
     std::shared_ptr<Index> m_index;
@@ -144,29 +182,44 @@ private:
 
     std::unique_ptr<BufferedFileReader> m_reader;
 
+    // Sequences found by scanning a byte range of the input.
+    struct ScannedRange
+    {
+        std::vector<IndexedSequence> sequences;
+        size_t scanEnd = 0;       // offset at which the scan has stopped.
+        size_t numberOfLines = 0; // number of lines consumed by the scan.
+    };
+
     // Returns true if main stream name if found on the current line.
-    bool FindMainStream();
+    bool FindMainStream(BufferedFileReader& reader);
 
     // Invokes either TryGetNumericSequenceId or TryGetSymbolicSequenceId depending
     // on the specified corpus settings.
-    bool TryGetSequenceId(size_t& id);
+    bool TryGetSequenceId(BufferedFileReader& reader, size_t& id);
 
     // Tries to get numeric sequence id.
     // Throws an exception if a non-numerical is read until the pipe character or 
     // EOF is reached without hitting the pipe character.
     // Returns false if no numerical characters are found preceding the pipe.
     // Otherwise, writes sequence id value to the provided reference, returns true.
-    bool TryGetNumericSequenceId(size_t& id);
+    bool TryGetNumericSequenceId(BufferedFileReader& reader, size_t& id);
 
     // Same as above but for symbolic ids.
     // It reads a symbolic key and converts it to numeric id using provided keyToId function.
-    bool TryGetSymbolicSequenceId(size_t& id, std::function<size_t(const std::string&)> keyToId);
+    bool TryGetSymbolicSequenceId(BufferedFileReader& reader, size_t& id, std::function<size_t(const std::string&)> keyToId);
 
     void PopulateImpl(std::shared_ptr<Index>& index);
 
+    // Scans sequences that start inside the [begin, end) range. The last sequence of the range 
+    // is followed to its end, even if it goes past the range end.
+    ScannedRange ScanSequences(BufferedFileReader& reader, bool isFirstRange, size_t end);
+
     // Parses input line by line, treating each line as an individual sequence.
     // Ignores sequence id information, using the line number instead as the id.
     void PopulateFromLines(std::shared_ptr<Index>& index);
+
+    // Scans lines that start inside the [begin, end) range, line numbers are relative to the range start.
+    ScannedRange ScanLines(BufferedFileReader& reader, size_t end);
 };
 
 }
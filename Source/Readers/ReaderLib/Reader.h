@@ -50,6 +50,11 @@ struct EpochConfiguration : public ReaderConfiguration
     size_t m_totalEpochSizeInSamples;       // Total size of the epoch in samples
     size_t m_totalEpochSizeInSweeps {g_infinity}; // Total size of the epoch in sweeps (default = no limit).
     size_t m_epochIndex;                    // Current epoch index [0 .. max number of epochs)
+
+    // Sums the given value across all workers. Used by readers that need an agreement between workers
+    // on the amount of data (i.e. in the sharded mode, where no worker sees the whole data set).
+    // Can be empty if the caller does not provide a way to communicate between workers.
+    std::function<size_t(size_t)> m_sumAcrossWorkers;
 };
 
 typedef size_t StreamId;
@@ -20,7 +20,12 @@ ReaderBase::~ReaderBase()
 
 void ReaderBase::StartEpoch(const EpochConfiguration& config, const std::map<std::wstring, int>& inputDescriptions)
 {
-    if (config.m_totalEpochSizeInSamples == 0)
+    StartEpoch(config, config, inputDescriptions);
+}
+
+void ReaderBase::StartEpoch(const EpochConfiguration& enumeratorConfig, const EpochConfiguration& packerConfig, const std::map<std::wstring, int>& inputDescriptions)
+{
+    if (enumeratorConfig.m_totalEpochSizeInSamples == 0)
     {
         RuntimeError("Epoch size cannot be 0.");
     }
@@ -53,8 +58,8 @@ void ReaderBase::StartEpoch(const EpochConfiguration& config, const std::map<std
         }
     }
 
-    m_sequenceEnumerator->StartEpoch(config);
-    m_packer->SetConfiguration(config, m_memoryProviders);
+    m_sequenceEnumerator->StartEpoch(enumeratorConfig);
+    m_packer->SetConfiguration(packerConfig, m_memoryProviders);
 }
 
 Minibatch ReaderBase::ReadMinibatch()
@@ -37,6 +37,9 @@ namespace CNTK {
         virtual ~ReaderBase() = 0;
 
     protected:
+        // Starts a new epoch with separate configurations for the sequence enumerator and the packer.
+        void StartEpoch(const EpochConfiguration& enumeratorConfig, const EpochConfiguration& packerConfig, const std::map<std::wstring, int>& requiredStreams);
+
         // Deserializer.
         DataDeserializerPtr m_deserializer;
 
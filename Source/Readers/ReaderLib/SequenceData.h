@@ -79,6 +79,50 @@ namespace CNTK {
         DISABLE_COPY_AND_MOVE(DenseSequenceWithBuffer);
     };
 
+    // A dense sequence that does not keep its samples in a buffer of its own.
+    // Instead, the packer gives it the slot of the minibatch buffer reserved for each sample,
+    // and the sequence produces (decodes, transforms) the sample directly into the slot.
+    // This saves an intermediate buffer and a full copy of the data per minibatch.
+    // Consumers that need the data in memory can still use GetDataBuffer, in which case
+    // all samples are written once into an internal buffer.
+    struct DenseSequenceWriter : DenseSequenceData
+    {
+        DenseSequenceWriter(const NDShape& sampleShape, size_t sampleSizeInBytes)
+            : m_sampleShape(sampleShape), m_sampleSizeInBytes(sampleSizeInBytes)
+        {}
+
+        // Writes the sample with the given index to the destination,
+        // which has room for exactly SampleSizeInBytes() bytes.
+        virtual void WriteSample(size_t sampleIndex, char* destination) = 0;
+
+        size_t SampleSizeInBytes() const
+        {
+            return m_sampleSizeInBytes;
+        }
+
+        const void* GetDataBuffer() override
+        {
+            if (m_materialized.empty())
+            {
+                m_materialized.resize(m_numberOfSamples * m_sampleSizeInBytes);
+                for (size_t i = 0; i < m_numberOfSamples; ++i)
+                    WriteSample(i, m_materialized.data() + i * m_sampleSizeInBytes);
+            }
+
+            return m_materialized.data();
+        }
+
+        const NDShape& GetSampleShape() override
+        {
+            return m_sampleShape;
+        }
+
+    private:
+        NDShape m_sampleShape;
+        size_t m_sampleSizeInBytes;
+        std::vector<char> m_materialized;
+    };
+
     class InvalidSequenceData : public SequenceDataBase
     {
     public:
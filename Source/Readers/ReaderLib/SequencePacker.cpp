@@ -7,10 +7,13 @@
 #define _SCL_SECURE_NO_WARNINGS
 
 #include <numeric>
+#include <algorithm>
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 #include "SequencePacker.h"
 #include "ReaderUtil.h"
+#include "SequenceData.h"
+#include "ExceptionCapture.h"
 
 namespace CNTK {
 
@@ -171,21 +174,32 @@ MBLayoutPtr SequencePacker::PackDenseStream(const StreamBatch& batch, size_t str
 
     const auto& sequenceInfos = pMBLayout->GetAllSequences();
 
-    // Iterate over sequences in the layout, copy samples from the
-    // source sequences into the buffer (at appropriate offsets).
-    for (int i = 0; i < sequenceInfos.size(); ++i)
+    // Sequences that can write their samples directly into the minibatch buffer
+    // do the actual work (i.e. transformation) while being packed, so in this case
+    // sequences are packed in parallel.
+    bool hasWriters = stream.m_storageFormat == StorageFormat::Dense &&
+        std::any_of(batch.begin(), batch.end(), [](const SequenceDataPtr& s) { return dynamic_cast<DenseSequenceWriter*>(s.get()) != nullptr; });
+
+    // Copies samples of a sequence in the layout from the
+    // source sequence into the buffer (at appropriate offsets).
+    auto packSequence = [&](int i)
     {
         const auto& sequenceInfo = sequenceInfos[i];
         // skip gaps
         if (sequenceInfo.seqId == GAP_SEQUENCE_ID)
         {
-            continue;
+            return;
         }
 
         const auto& sequence = batch[sequenceInfo.seqId];
         size_t numSamples = sequence->m_numberOfSamples;
         assert(numSamples == sequenceInfo.GetNumTimeSteps());
 
+        auto writer = hasWriters ? dynamic_cast<DenseSequenceWriter*>(sequence.get()) : nullptr;
+        if (writer && writer->SampleSizeInBytes() != sampleSize)
+            RuntimeError("Sample size '%" PRIu64 "' of a sequence does not match the sample size '%" PRIu64 "' of the stream '%ls'.",
+                writer->SampleSizeInBytes(), sampleSize, stream.m_name.c_str());
+
         char* bufferPtr = buffer.m_data.get();
         // Iterate over all samples in the sequence, keep track of the sample offset (which is especially
         // important for sparse input, where offset == number of preceding nnz elements).
@@ -197,7 +211,11 @@ MBLayoutPtr SequencePacker::PackDenseStream(const StreamBatch& batch, size_t str
             // verify that there's enough space left in the buffer to fit a full sample.
             assert(destinationOffset <= buffer.m_size - sampleSize);
             auto* destination = bufferPtr + destinationOffset;
-            if (stream.m_storageFormat == StorageFormat::Dense)
+            if (writer)
+            {
+                writer->WriteSample(sampleIndex, destination);
+            }
+            else if (stream.m_storageFormat == StorageFormat::Dense)
             {
                 // verify that the offset (an invariant for dense).
                 assert(sampleOffset == sampleIndex * sampleSize);
@@ -222,6 +240,20 @@ MBLayoutPtr SequencePacker::PackDenseStream(const StreamBatch& batch, size_t str
                 RuntimeError("Storage type %d is not supported.", (int)stream.m_storageFormat);
             }
         }
+    };
+
+    if (hasWriters)
+    {
+        ExceptionCapture capture;
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < sequenceInfos.size(); ++i)
+            capture.SafeRun(packSequence, i);
+        capture.RethrowIfHappened();
+    }
+    else
+    {
+        for (int i = 0; i < sequenceInfos.size(); ++i)
+            packSequence(i);
     }
 
     return pMBLayout;
@@ -0,0 +1,146 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "ShardedDeserializer.h"
+#include "RandomOrdering.h"
+
+namespace CNTK {
+
+ShardedDeserializer::ShardedDeserializer(size_t numberOfShards, ShardFactory factory, bool shuffleShards, size_t seed)
+    : m_numberOfShards(numberOfShards), m_factory(factory), m_shuffleShards(shuffleShards), m_seed(seed), m_numberOfLocalSamples(0)
+{
+    if (m_numberOfShards == 0)
+        InvalidArgument("The list of shards cannot be empty.");
+
+    // Each shard is owned by its own worker.
+    SelectShards(0, m_numberOfShards, 0);
+}
+
+std::vector<size_t> ShardedDeserializer::GetShardsOfWorker(size_t numberOfShards, size_t workerRank, size_t numberOfWorkers,
+    size_t epochIndex, bool shuffleShards, size_t seed)
+{
+    if (workerRank >= numberOfWorkers)
+        InvalidArgument("Worker rank '%d' must be less than the number of workers '%d'.", (int)workerRank, (int)numberOfWorkers);
+
+    if (numberOfShards < numberOfWorkers)
+        InvalidArgument("The number of shards '%d' cannot be less than the number of workers '%d', otherwise some workers would not get any data.",
+            (int)numberOfShards, (int)numberOfWorkers);
+
+    std::vector<size_t> order(numberOfShards);
+    std::iota(order.begin(), order.end(), 0);
+    if (shuffleShards)
+    {
+        std::mt19937_64 rng(seed + epochIndex);
+        Microsoft::MSR::CNTK::RandomShuffleMT(order, rng);
+    }
+
+    std::vector<size_t> result;
+    for (size_t position = workerRank; position < numberOfShards; position += numberOfWorkers)
+        result.push_back(order[position]);
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool ShardedDeserializer::SelectShards(size_t workerRank, size_t numberOfWorkers, size_t epochIndex)
+{
+    auto owned = GetShardsOfWorker(m_numberOfShards, workerRank, numberOfWorkers, epochIndex, m_shuffleShards, m_seed);
+    if (owned == m_ownedShards)
+        return false;
+
+    // Releasing shards that are not owned anymore, so that their indices are freed before new ones are built.
+    for (auto it = m_shards.begin(); it != m_shards.end();)
+    {
+        if (std::binary_search(owned.begin(), owned.end(), it->first))
+            ++it;
+        else
+            it = m_shards.erase(it);
+    }
+    m_shardLocations.clear();
+    m_chunks.clear();
+    m_chunkToShard.clear();
+    m_numberOfLocalSamples = 0;
+
+    for (size_t shardIndex : owned)
+    {
+        auto& shard = m_shards[shardIndex];
+        if (!shard)
+        {
+            shard = m_factory(shardIndex);
+            if (!shard)
+                RuntimeError("Cannot create the deserializer for shard '%d'.", (int)shardIndex);
+        }
+
+        auto streams = shard->StreamInfos();
+        if (m_streams.empty())
+            m_streams = streams;
+        else if (streams.size() != m_streams.size() ||
+            !std::equal(streams.begin(), streams.end(), m_streams.begin(),
+                [](const StreamInformation& a, const StreamInformation& b) { return a.m_name == b.m_name; }))
+            RuntimeError("Shard '%d' exposes streams that are different from other shards.", (int)shardIndex);
+
+        ShardLocation location{ shard, static_cast<ChunkIdType>(m_chunks.size()) };
+        auto chunks = shard->ChunkInfos();
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            if (chunks[i].m_id != i)
+                LogicError("Shard '%d' is expected to have consecutive chunk ids.", (int)shardIndex);
+
+            ChunkInfo chunk = chunks[i];
+            chunk.m_id = static_cast<ChunkIdType>(m_chunks.size());
+            m_chunks.push_back(chunk);
+            m_chunkToShard.push_back(m_shardLocations.size());
+            m_numberOfLocalSamples += chunk.m_numberOfSamples;
+        }
+
+        m_shardLocations.push_back(location);
+    }
+
+    m_ownedShards = owned;
+    return true;
+}
+
+const ShardedDeserializer::ShardLocation& ShardedDeserializer::Locate(ChunkIdType chunkId) const
+{
+    if (chunkId >= m_chunkToShard.size())
+        LogicError("Invalid chunk id '%d', the number of chunks is '%d'.", (int)chunkId, (int)m_chunkToShard.size());
+
+    return m_shardLocations[m_chunkToShard[chunkId]];
+}
+
+void ShardedDeserializer::SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& descriptions)
+{
+    const auto& location = Locate(chunkId);
+    size_t first = descriptions.size();
+    location.m_shard->SequenceInfosForChunk(chunkId - location.m_firstChunkId, descriptions);
+    for (size_t i = first; i < descriptions.size(); ++i)
+        descriptions[i].m_chunkId = chunkId;
+}
+
+bool ShardedDeserializer::GetSequenceInfo(const SequenceInfo& primary, SequenceInfo& description)
+{
+    for (const auto& location : m_shardLocations)
+    {
+        if (location.m_shard->GetSequenceInfo(primary, description))
+        {
+            description.m_chunkId += location.m_firstChunkId;
+            return true;
+        }
+    }
+    return false;
+}
+
+ChunkPtr ShardedDeserializer::GetChunk(ChunkIdType chunkId)
+{
+    const auto& location = Locate(chunkId);
+    return location.m_shard->GetChunk(chunkId - location.m_firstChunkId);
+}
+
+}
@@ -0,0 +1,103 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <map>
+#include <functional>
+#include "DataDeserializer.h"
+
+namespace CNTK {
+
+// A deserializer over a data set that is split into several file shards, each of them exposed by its own
+// deserializer. In distributed mode each worker only instantiates (and therefore indexes) the shards it owns,
+// so the startup I/O and the memory needed for the index do not grow with the number of workers.
+// Shards are assigned to workers deterministically: for every epoch the list of shards is shuffled
+// with a seed derived from the epoch index (or kept as is if shuffling is off) and the shard at position p
+// belongs to the worker p % numberOfWorkers.
+// Chunks of the owned shards are exposed as a single contiguous list of chunks in the ascending order of shards.
+class ShardedDeserializer : public DataDeserializer
+{
+public:
+    typedef std::function<DataDeserializerPtr(size_t shardIndex)> ShardFactory;
+
+    // Until the first call to SelectShards, only the shard that is owned by the worker 0 in the first epoch
+    // is instantiated, so that the streams and the data can be inspected before the epoch starts.
+    ShardedDeserializer(size_t numberOfShards, ShardFactory factory, bool shuffleShards, size_t seed);
+
+    // Selects the shards for the given worker and epoch, releasing the shards that are not owned anymore.
+    // Returns true if the set of owned shards has changed, in which case the chunk ids are not valid anymore.
+    bool SelectShards(size_t workerRank, size_t numberOfWorkers, size_t epochIndex);
+
+    // Returns sorted indices of shards owned by the worker in the given epoch.
+    static std::vector<size_t> GetShardsOfWorker(size_t numberOfShards, size_t workerRank, size_t numberOfWorkers,
+        size_t epochIndex, bool shuffleShards, size_t seed);
+
+    size_t NumberOfShards() const
+    {
+        return m_numberOfShards;
+    }
+
+    // Total number of samples in the owned shards.
+    size_t NumberOfLocalSamples() const
+    {
+        return m_numberOfLocalSamples;
+    }
+
+    const std::vector<size_t>& OwnedShards() const
+    {
+        return m_ownedShards;
+    }
+
+    virtual std::vector<StreamInformation> StreamInfos() override
+    {
+        return m_streams;
+    }
+
+    virtual std::vector<ChunkInfo> ChunkInfos() override
+    {
+        return m_chunks;
+    }
+
+    virtual void SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& descriptions) override;
+
+    virtual bool GetSequenceInfo(const SequenceInfo& primary, SequenceInfo& description) override;
+
+    virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+private:
+    // An owned shard together with the exposed id of its first chunk.
+    struct ShardLocation
+    {
+        DataDeserializerPtr m_shard;
+        ChunkIdType m_firstChunkId;
+    };
+
+    const ShardLocation& Locate(ChunkIdType chunkId) const;
+
+    size_t m_numberOfShards;
+    ShardFactory m_factory;
+    bool m_shuffleShards;
+    size_t m_seed;
+
+    std::vector<StreamInformation> m_streams;
+
+    // Currently instantiated shards by shard index.
+    std::map<size_t, DataDeserializerPtr> m_shards;
+    std::vector<size_t> m_ownedShards;
+
+    std::vector<ShardLocation> m_shardLocations;
+
+    std::vector<ChunkInfo> m_chunks;
+    // Index into m_shardLocations for each exposed chunk.
+    std::vector<size_t> m_chunkToShard;
+    size_t m_numberOfLocalSamples;
+
+    DISABLE_COPY_AND_MOVE(ShardedDeserializer);
+};
+
+typedef std::shared_ptr<ShardedDeserializer> ShardedDeserializerPtr;
+
+}
@@ -2,7 +2,8 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
 //
-// ASGDHelper.cpp : Implements ASGDHelper interface. The implementation is based on Multiverso.
+// ASGDHelper.cpp : Implements ASGDHelper interface. The implementation is based on Multiverso if it is enabled
+//                  (CNTK_ENABLE_ASGD=true), and on the in-tree ParameterServer otherwise.
 //
 
 #define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
@@ -10,6 +11,7 @@
 #include "ASGDHelper.h"
 #include "MPIWrapper.h"
 #include "ComputationNetwork.h"
+#include "ParameterServer.h"
 #include "TimerUtility.h"
 
 #include <functional>
@@ -27,17 +29,37 @@
 
 #pragma comment(lib, "Multiverso.lib")
 
-#endif
-
-
 #ifndef CPUONLY
 #include <cuda_runtime.h>
 #pragma comment (lib, "cudart.lib")     // for cudaMemcpyAsync()
 #endif
 
+#endif
+
 namespace Microsoft { namespace MSR { namespace CNTK {
 
-#ifndef CPUONLY
+// Factor of the learning rate when it is adjusted during the first synchronizations
+// this could be used to tackle the unstableness of ASGD
+static float DecayCoefficient(AdjustLearningRateAtBeginning adjustType, double adjustCoefficient, size_t adjustMBNumber, size_t parameterSyncCounter)
+{
+    float f = 1.f;
+    switch (adjustType)
+    {
+    case AdjustLearningRateAtBeginning::None:
+        break;
+    case AdjustLearningRateAtBeginning::Linearly:
+        f = min(f, max(0.f, (float)(adjustCoefficient + (1 - adjustCoefficient) / adjustMBNumber * parameterSyncCounter)));
+        break;
+    case AdjustLearningRateAtBeginning::Staircase:
+        f = min(f, max(0.f, (float)(adjustCoefficient * (parameterSyncCounter / adjustMBNumber + 1))));
+        break;
+    default:
+        break;
+    }
+    return f;
+}
+
+#if defined(ASGD_PARALLEL_SUPPORT) && !defined(CPUONLY)
 
 #include <cuda_runtime.h>
 
@@ -72,7 +94,7 @@ static void CudaCall(ERRTYPE retCode, const char* exprString, const char* libNam
 }
 
 #define CUDA_CALL(expr)     (CudaCall((expr), #expr, "CUDA",     cudaSuccess))
-#endif // CPUONLY
+#endif
 
 #ifdef ASGD_PARALLEL_SUPPORT
 
@@ -485,21 +507,7 @@ private:
 
     float DecayCoefficient()
     {
-        float f = 1.f;
-        switch (m_adjustLearningRateAtBeginningType)
-        {
-        case AdjustLearningRateAtBeginning::None:
-            break;
-        case AdjustLearningRateAtBeginning::Linearly:
-            f = min(f, max(0.f, (float)(m_adjustCoefficient + (1 - m_adjustCoefficient) / m_adjustMBNumber * m_parameterSyncCounter)));
-            break;
-        case AdjustLearningRateAtBeginning::Staircase:
-            f = min(f, max(0.f, (float)(m_adjustCoefficient * (m_parameterSyncCounter / m_adjustMBNumber + 1))));
-            break;
-        default:
-            break;
-        }
-        return f;
+        return Microsoft::MSR::CNTK::DecayCoefficient(m_adjustLearningRateAtBeginningType, m_adjustCoefficient, m_adjustMBNumber, m_parameterSyncCounter);
     }
 
     float ModelAggregationCoefficient(size_t samplesSinceLastSync)
@@ -595,34 +603,171 @@ private:
 
 #endif 
 
-// A None implementation of ASGDHelper interface which does nothing
+// ParameterServerASGDHelper is the implementation of ASGDHelper interface with the in-tree ParameterServer
 // This is used when CNTK_ENABLE_ASGD = false
+//
+// At each synchronization the worker pushes the change of its model since the previous synchronization and
+// continues from the latest model of the servers. With the asynchronous buffer, the exchange runs while the
+// worker trains on: the next synchronization rebases the local change onto the model returned by the exchange.
 template<class ElemType = float>
-class NoneASGDHelper : public ASGDHelper<ElemType>
+class ParameterServerASGDHelper : public ASGDHelper<ElemType>
 {
 public:
-    NoneASGDHelper(const std::list<ComputationNodeBasePtr> & learnableNodes,
-        int nodeNumRanks,
-        bool useAsyncBuffer = true,
-        bool isSimModelAveragingSGD = false,
-        AdjustLearningRateAtBeginning adjusttype = AdjustLearningRateAtBeginning::None,
-        double adjustcoef = 0.2,
-        size_t adjustnbmb = 600,
-        int traceLevel = 0,
-        int syncPerfStats = 0,
-        const MPIWrapperPtr& pMPI = nullptr) { }
-
-    ~NoneASGDHelper() { }
-
-    void InitModel(const std::list<ComputationNodeBasePtr> & learnableNode) override { }
-
-    bool PushAndPullModel(const std::list<ComputationNodeBasePtr> & learnableNodes, size_t sampleSinceLastSynced) override { 
+    typedef shared_ptr<ComputationNode<ElemType>> ComputationNodePtr;
+
+    ParameterServerASGDHelper(const std::list<ComputationNodeBasePtr> & learnableNodes, // Parameters that needs to be train
+        size_t nodeNumRanks,                                                            // Number of working nodes
+        bool useAsyncBuffer,                                                            // Using asynchonous buffer to hide communication cost
+        bool isSimulatedModelAveragingSGD,                                              // Using parameter server-based MA rather than ASGD
+        AdjustLearningRateAtBeginning adjusttype,                                       // Adjust learning per minibatches at very beginning of training process
+        double adjustCoef,                                                              // see in DecayCoefficient()
+        size_t adjustPerMinibatches,                                                    //
+        int traceLevel,                                                                 // log level
+        int syncPerfStats,                                                              // shown perf data every syncPerfStats
+        size_t maxStaleness,                                                            // pushes a worker may be ahead of the slowest one
+        double serverMomentum) :                                                        // momentum applied on the servers
+        m_totalClientNumber(nodeNumRanks),
+        m_useAsyncBuffer(useAsyncBuffer && !isSimulatedModelAveragingSGD),
+        m_ModelAveragingSGDSimulating(isSimulatedModelAveragingSGD),
+        m_adjustLearningRateAtBeginningType(adjusttype), m_adjustCoefficient(adjustCoef), m_adjustMBNumber(adjustPerMinibatches),
+        m_traceLevel(traceLevel), m_syncPerfStats(syncPerfStats),
+        m_parameterSyncCounter(0), m_secondsWaitingForServers(0), m_isExchangePending(false)
+    {
+        size_t totalModelSize = 0;
+        for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++)
+        {
+            ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+            m_tableOffsets.push_back(totalModelSize);
+            totalModelSize += node->Value().GetNumElements();
+        }
+
+        m_baseModel.resize(totalModelSize);
+        m_localModel.resize(totalModelSize);
+        m_pulledModel.resize(totalModelSize);
+        m_deltaArray.resize(totalModelSize);
+
+        // Simulated model averaging synchronizes all workers at every exchange.
+        m_server.reset(new ParameterServer<ElemType>(MPIWrapper::GetInstance(), totalModelSize,
+            m_ModelAveragingSGDSimulating ? 0 : maxStaleness, serverMomentum, traceLevel));
+    }
+
+    void InitModel(const std::list<ComputationNodeBasePtr> & learnableNodes) override
+    {
+        CopyFromNodes(learnableNodes, m_baseModel);
+        m_server->Initialize(m_baseModel.data());
+        CopyToNodes(m_baseModel, learnableNodes);
+        m_isExchangePending = false;
+        m_reportTimer.Start();
+    }
+
+    bool PushAndPullModel(const std::list<ComputationNodeBasePtr> & learnableNodes, size_t sampleSinceLastSynced) override
+    {
+        m_parameterSyncCounter++;
+
+        Timer waitTimer;
+        waitTimer.Start();
+        m_server->Wait();
+        waitTimer.Stop();
+        m_secondsWaitingForServers += waitTimer.ElapsedSeconds();
+
+        // Model averaging sends the average of the changes of all workers, ASGD the (decayed) change of each worker.
+        ElemType factor = m_ModelAveragingSGDSimulating ? (ElemType)1 / m_totalClientNumber : (ElemType)DecayCoefficient(m_adjustLearningRateAtBeginningType, m_adjustCoefficient, m_adjustMBNumber, m_parameterSyncCounter);
+
+        CopyFromNodes(learnableNodes, m_localModel);
+        for (size_t i = 0; i < m_localModel.size(); i++)
+        {
+            ElemType change = m_localModel[i] - m_baseModel[i];
+            m_deltaArray[i] = factor * change;
+            if (m_isExchangePending)
+                m_localModel[i] = m_pulledModel[i] + change;
+        }
+
+        if (m_useAsyncBuffer)
+        {
+            if (m_isExchangePending)
+                CopyToNodes(m_localModel, learnableNodes);
+
+            m_baseModel.swap(m_localModel);
+            m_server->PushAndPullAsync(m_deltaArray.data(), m_pulledModel.data());
+            m_isExchangePending = true;
+        }
+        else
+        {
+            m_server->PushAndPull(m_deltaArray.data(), m_baseModel.data());
+            CopyToNodes(m_baseModel, learnableNodes);
+        }
+
+        if (m_traceLevel > 2 && m_syncPerfStats > 0 && m_parameterSyncCounter % m_syncPerfStats == 0)
+            ReportPerfStats();
+
         return true;
     }
 
-    void WaitAll() override { }
+    void WaitAll() override
+    {
+        m_server->Wait();
+        m_server->Barrier();
+    }
+
+    void WaitAsyncBuffer() override
+    {
+        m_server->Wait();
+    }
+
+private:
+    void CopyFromNodes(const std::list<ComputationNodeBasePtr> & learnableNodes, std::vector<ElemType>& model)
+    {
+        int i = 0; // indicate the index of learnable nodes
+        for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++, i++)
+        {
+            ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+            Matrix<ElemType> &mat = node->Value();
+            mat.CopySection(mat.GetNumRows(), mat.GetNumCols(), model.data() + m_tableOffsets[i], mat.GetNumRows());
+        }
+    }
 
-    void WaitAsyncBuffer() override { }
+    void CopyToNodes(std::vector<ElemType>& model, const std::list<ComputationNodeBasePtr> & learnableNodes)
+    {
+        int i = 0; // indicate the index of learnable nodes
+        for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++, i++)
+        {
+            ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+            Matrix<ElemType> &mat = node->Value();
+            mat.SetValue(mat.GetNumRows(), mat.GetNumCols(), mat.GetDeviceId(), model.data() + m_tableOffsets[i]);
+        }
+    }
+
+    void ReportPerfStats()
+    {
+        m_reportTimer.Stop();
+        fprintf(stderr, "\t\t(parameter server stats) %d-th sync: %8.2f seconds since last report, %8.2f seconds waiting for the servers\n",
+            (int)m_parameterSyncCounter, m_reportTimer.ElapsedSeconds(), m_secondsWaitingForServers);
+        m_reportTimer.Restart();
+        m_secondsWaitingForServers = 0;
+    }
+
+    std::unique_ptr<ParameterServer<ElemType>> m_server;
+
+    size_t m_totalClientNumber;
+    bool m_useAsyncBuffer;
+    bool m_ModelAveragingSGDSimulating;
+
+    AdjustLearningRateAtBeginning m_adjustLearningRateAtBeginningType;
+    double m_adjustCoefficient;
+    size_t m_adjustMBNumber;
+
+    int m_traceLevel;
+    int m_syncPerfStats;
+    size_t m_parameterSyncCounter;
+    Timer m_reportTimer;
+    double m_secondsWaitingForServers;
+
+    vector<size_t> m_tableOffsets;
+    std::vector<ElemType> m_baseModel;   // model at the last synchronization, the local change is measured against it
+    std::vector<ElemType> m_localModel;
+    std::vector<ElemType> m_pulledModel; // reply of the pending exchange when using the asynchronous buffer
+    std::vector<ElemType> m_deltaArray;
+    bool m_isExchangePending;
 };
 
 template<class ElemType>
@@ -635,14 +780,16 @@ ASGDHelper<ElemType>* NewASGDHelper(
     double adjustCoef,
     size_t adjustPerMinibatches,
     int traceLevel,
-    int syncPerfStats) 
+    int syncPerfStats,
+    size_t maxStaleness,
+    double serverMomentum)
 {
 #ifdef ASGD_PARALLEL_SUPPORT
     return new MultiversoHelper<ElemType>(learnableNodes, nodeNumRanks, useAsyncBuffer, isSimulatedModelAveragingSGD, 
                                       adjusttype, adjustCoef, adjustPerMinibatches, traceLevel, syncPerfStats);
 #else
-    return new NoneASGDHelper<ElemType>(learnableNodes, nodeNumRanks, useAsyncBuffer, isSimulatedModelAveragingSGD, 
-                                      adjusttype, adjustCoef, adjustPerMinibatches, traceLevel, syncPerfStats); 
+    return new ParameterServerASGDHelper<ElemType>(learnableNodes, nodeNumRanks, useAsyncBuffer, isSimulatedModelAveragingSGD, 
+                                      adjusttype, adjustCoef, adjustPerMinibatches, traceLevel, syncPerfStats, maxStaleness, serverMomentum);
 #endif
 }
 
@@ -655,7 +802,9 @@ template<> ASGDHelper<half>* NewASGDHelper<half>(
     double adjustCoef,
     size_t adjustPerMinibatches,
     int traceLevel,
-    int syncPerfStats)
+    int syncPerfStats,
+    size_t maxStaleness,
+    double serverMomentum)
 {
     RuntimeError("NewASGDHelper - half not supported!");
 }
@@ -669,7 +818,9 @@ template ASGDHelper<float>* NewASGDHelper<float>(
     double adjustCoef,
     size_t adjustPerMinibatches,
     int traceLevel,
-    int syncPerfStats); 
+    int syncPerfStats,
+    size_t maxStaleness,
+    double serverMomentum);
 
 template ASGDHelper<double>* NewASGDHelper<double>(
     const std::list<ComputationNodeBasePtr> & learnableNodes,
@@ -680,6 +831,8 @@ template ASGDHelper<double>* NewASGDHelper<double>(
     double adjustCoef,
     size_t adjustPerMinibatches,
     int traceLevel,
-    int syncPerfStats); 
+    int syncPerfStats,
+    size_t maxStaleness,
+    double serverMomentum);
 
 }}} 
@@ -0,0 +1,420 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// ParameterServer.cpp : Implements the sharded parameter server used by asynchronous data-parallel SGD.
+//
+
+#define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
+
+#include "ParameterServer.h"
+#include "Basics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+template <class ElemType>
+ParameterServer<ElemType>::ParameterServer(const MPIWrapperPtr& mpi, size_t modelSize, size_t maxStaleness, double momentum, int traceLevel)
+    : m_mpi(mpi),
+      m_numWorkers(mpi ? mpi->NumNodesInUse() : 1),
+      m_rank(mpi ? mpi->CurrentNodeRank() : 0),
+      m_modelSize(modelSize),
+      m_maxStaleness(maxStaleness),
+      m_momentum(momentum),
+      m_traceLevel(traceLevel),
+      m_requestCommand(Command::None),
+      m_requestData(nullptr),
+      m_requestResult(nullptr),
+      m_requestState(RequestState::Idle),
+      m_activeCommand(Command::None),
+      m_outstandingReplies(0),
+      m_serverDone(false)
+{
+    if (momentum < 0 || momentum >= 1)
+        InvalidArgument("ParameterServer: momentum %g must be in [0, 1).", momentum);
+
+    // Requests carry the command in front of the shard.
+    if (ShardSize(0) >= INT_MAX)
+        RuntimeError("ParameterServer: a model of %d elements is too large for %d workers.", (int)modelSize, (int)m_numWorkers);
+
+    m_shard.assign(ShardSize(m_rank), 0);
+    if (momentum > 0)
+        m_velocity.assign(m_shard.size(), 0);
+
+    m_sendBuffers.resize(m_numWorkers);
+    m_sendRequests.resize(m_numWorkers);
+    m_sendActive.assign(m_numWorkers, false);
+    m_replyRequests.resize(m_numWorkers);
+    m_replyActive.assign(m_numWorkers, false);
+    m_barrierReplies.resize(m_numWorkers);
+
+    m_receiveBuffers.resize(m_numWorkers);
+    m_receiveRequests.resize(m_numWorkers);
+    m_receiveActive.assign(m_numWorkers, false);
+    m_replyBuffers.resize(m_numWorkers);
+    m_replySendRequests.resize(m_numWorkers);
+    m_replySendActive.assign(m_numWorkers, false);
+    m_pending.assign(m_numWorkers, Command::None);
+    m_clocks.assign(m_numWorkers, 0);
+
+    for (size_t i = 0; i < m_numWorkers; i++)
+    {
+        if (i == m_rank)
+            continue;
+
+        m_sendBuffers[i].resize(1 + ShardSize(i));
+        m_receiveBuffers[i].resize(1 + m_shard.size());
+        m_replyBuffers[i].resize(std::max<size_t>(1, m_shard.size()));
+    }
+
+    if (m_traceLevel > 0)
+    {
+        fprintf(stderr, "ParameterServer: worker %d serves elements [%d, %d) of %d", (int)m_rank, (int)ShardBegin(m_rank), (int)ShardBegin(m_rank + 1), (int)m_modelSize);
+        if (m_maxStaleness != UnboundedStaleness)
+            fprintf(stderr, ", max staleness = %d", (int)m_maxStaleness);
+        fprintf(stderr, ", momentum = %g\n", m_momentum);
+    }
+
+    m_thread = std::thread([this]() { Run(); });
+}
+
+template <class ElemType>
+ParameterServer<ElemType>::~ParameterServer()
+{
+    try
+    {
+        Wait();
+        Post(Command::Shutdown, nullptr, nullptr);
+        Wait();
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "~ParameterServer: %s\n", e.what());
+    }
+
+    m_thread.join();
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::Initialize(ElemType* model)
+{
+    Post(Command::Initialize, model, model);
+    Wait();
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::PushAndPullAsync(const ElemType* delta, ElemType* model)
+{
+    Post(Command::Push, delta, model);
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::Barrier()
+{
+    Post(Command::Barrier, nullptr, nullptr);
+    Wait();
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::Post(Command command, const ElemType* data, ElemType* result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_error)
+        std::rethrow_exception(m_error);
+
+    if (m_requestState != RequestState::Idle)
+        LogicError("ParameterServer: a new request was posted before waiting for the previous one.");
+
+    m_requestCommand = command;
+    m_requestData = data;
+    m_requestResult = result;
+    m_requestState = RequestState::Posted;
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_requestDone.wait(lock, [this]() { return m_error || m_requestState == RequestState::Idle || m_requestState == RequestState::Completed; });
+    if (m_error)
+        std::rethrow_exception(m_error);
+
+    m_requestState = RequestState::Idle;
+}
+
+// -----------------------------------------------------------------------
+// communication thread
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+void ParameterServer<ElemType>::Run()
+{
+    try
+    {
+        for (size_t worker = 0; worker < m_numWorkers; worker++)
+        {
+            if (worker != m_rank)
+                PostReceiveRequest(worker);
+        }
+
+        // The thread polls, since it must not block in MPI while the local worker posts new requests.
+        while (!m_serverDone || m_activeCommand != Command::None)
+        {
+            if (!Progress())
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+
+        for (size_t i = 0; i < m_numWorkers; i++)
+        {
+            if (m_sendActive[i])
+                m_mpi->Wait(&m_sendRequests[i], MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Wait");
+            if (m_replySendActive[i])
+                m_mpi->Wait(&m_replySendRequests[i], MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Wait");
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_error = std::current_exception();
+        m_requestDone.notify_all();
+    }
+}
+
+template <class ElemType>
+bool ParameterServer<ElemType>::Progress()
+{
+    bool progress = false;
+    bool hasNewRequest = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_requestState == RequestState::Posted)
+        {
+            m_requestState = RequestState::InProgress;
+            hasNewRequest = true;
+        }
+    }
+
+    if (hasNewRequest)
+    {
+        StartRequest();
+        progress = true;
+    }
+
+    int completed;
+    for (size_t i = 0; i < m_numWorkers; i++)
+    {
+        if (m_receiveActive[i])
+        {
+            m_mpi->Test(&m_receiveRequests[i], &completed, MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Test");
+            if (completed)
+            {
+                m_receiveActive[i] = false;
+                auto command = (Command)(int)m_receiveBuffers[i][0];
+                OnRequest(i, command, m_receiveBuffers[i].data() + 1);
+
+                // A worker only sends its next request after the reply to the previous one, and nothing after the shutdown.
+                if (command != Command::Shutdown)
+                    PostReceiveRequest(i);
+                progress = true;
+            }
+        }
+
+        if (m_replyActive[i])
+        {
+            m_mpi->Test(&m_replyRequests[i], &completed, MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Test");
+            if (completed)
+            {
+                m_replyActive[i] = false;
+                m_outstandingReplies--;
+                progress = true;
+            }
+        }
+
+        if (m_sendActive[i])
+        {
+            m_mpi->Test(&m_sendRequests[i], &completed, MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Test");
+            m_sendActive[i] = !completed;
+        }
+
+        if (m_replySendActive[i])
+        {
+            m_mpi->Test(&m_replySendRequests[i], &completed, MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Test");
+            m_replySendActive[i] = !completed;
+        }
+    }
+
+    if (m_activeCommand != Command::None && m_outstandingReplies == 0)
+    {
+        m_activeCommand = Command::None;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requestState = RequestState::Completed;
+        m_requestDone.notify_all();
+        progress = true;
+    }
+
+    return progress;
+}
+
+// Sends the request of the local worker to all servers.
+template <class ElemType>
+void ParameterServer<ElemType>::StartRequest()
+{
+    m_activeCommand = m_requestCommand;
+    m_outstandingReplies = m_numWorkers;
+
+    bool hasData = m_activeCommand == Command::Initialize || m_activeCommand == Command::Push;
+    auto dataType = MPIWrapper::GetDataType((ElemType*)nullptr);
+    for (size_t server = 0; server < m_numWorkers; server++)
+    {
+        size_t begin = ShardBegin(server);
+        size_t size = ShardSize(server);
+        if (server == m_rank)
+        {
+            OnRequest(m_rank, m_activeCommand, hasData ? m_requestData + begin : nullptr);
+            continue;
+        }
+
+        if (hasData)
+            m_mpi->Irecv(m_requestResult + begin, (int)size, dataType, (int)server, ReplyTag, &m_replyRequests[server]) || MpiFail("ParameterServer: MPI_Irecv");
+        else
+            m_mpi->Irecv(&m_barrierReplies[server], 1, dataType, (int)server, ReplyTag, &m_replyRequests[server]) || MpiFail("ParameterServer: MPI_Irecv");
+        m_replyActive[server] = true;
+
+        if (m_sendActive[server])
+        {
+            m_mpi->Wait(&m_sendRequests[server], MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Wait");
+            m_sendActive[server] = false;
+        }
+
+        auto& buffer = m_sendBuffers[server];
+        buffer[0] = (ElemType)(int)m_activeCommand;
+        if (hasData)
+            std::copy(m_requestData + begin, m_requestData + begin + size, buffer.begin() + 1);
+
+        m_mpi->Isend(buffer.data(), hasData ? (int)(1 + size) : 1, dataType, (int)server, RequestTag, &m_sendRequests[server]) || MpiFail("ParameterServer: MPI_Isend");
+        m_sendActive[server] = true;
+    }
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::OnRequest(size_t worker, Command command, const ElemType* data)
+{
+    if (m_pending[worker] != Command::None)
+        RuntimeError("ParameterServer: worker %d sent a request before receiving the reply to its previous one.", (int)worker);
+
+    size_t size = m_shard.size();
+    switch (command)
+    {
+    case Command::Initialize:
+        for (size_t i = 0; i < size; i++)
+            m_shard[i] += data[i] / (ElemType)m_numWorkers;
+        break;
+    case Command::Push:
+        if (m_velocity.empty())
+        {
+            for (size_t i = 0; i < size; i++)
+                m_shard[i] += data[i];
+        }
+        else
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                m_velocity[i] = (ElemType)m_momentum * m_velocity[i] + data[i];
+                m_shard[i] += m_velocity[i];
+            }
+        }
+        m_clocks[worker]++;
+        break;
+    case Command::Barrier:
+    case Command::Shutdown:
+        break;
+    default:
+        RuntimeError("ParameterServer: received an invalid request %d from worker %d.", (int)command, (int)worker);
+    }
+
+    m_pending[worker] = command;
+    SendReplies();
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::SendReplies()
+{
+    // Initialization, barrier and shutdown are replied to once all workers have sent them.
+    for (auto collective : { Command::Initialize, Command::Barrier, Command::Shutdown })
+    {
+        if (std::all_of(m_pending.begin(), m_pending.end(), [collective](Command pending) { return pending == collective; }))
+        {
+            for (size_t worker = 0; worker < m_numWorkers; worker++)
+                Reply(worker);
+
+            std::fill(m_clocks.begin(), m_clocks.end(), 0);
+            m_serverDone = collective == Command::Shutdown;
+            return;
+        }
+    }
+
+    // A push is replied to when all workers that are not waiting for a collective request have caught up to
+    // within 'maxStaleness' pushes of the pushing worker.
+    size_t minClock = SIZE_MAX;
+    for (size_t worker = 0; worker < m_numWorkers; worker++)
+    {
+        if (m_pending[worker] == Command::None || m_pending[worker] == Command::Push)
+            minClock = std::min(minClock, m_clocks[worker]);
+    }
+
+    for (size_t worker = 0; worker < m_numWorkers; worker++)
+    {
+        if (m_pending[worker] == Command::Push && (m_maxStaleness == UnboundedStaleness || m_clocks[worker] <= minClock + m_maxStaleness))
+            Reply(worker);
+    }
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::Reply(size_t worker)
+{
+    auto command = m_pending[worker];
+    m_pending[worker] = Command::None;
+
+    bool hasData = command == Command::Initialize || command == Command::Push;
+    if (worker == m_rank)
+    {
+        if (hasData)
+            std::copy(m_shard.begin(), m_shard.end(), m_requestResult + ShardBegin(m_rank));
+        m_outstandingReplies--;
+        return;
+    }
+
+    // The worker has received the previous reply before sending its request, so this does not block.
+    if (m_replySendActive[worker])
+    {
+        m_mpi->Wait(&m_replySendRequests[worker], MPI_STATUS_IGNORE) || MpiFail("ParameterServer: MPI_Wait");
+        m_replySendActive[worker] = false;
+    }
+
+    auto& buffer = m_replyBuffers[worker];
+    if (hasData)
+        std::copy(m_shard.begin(), m_shard.end(), buffer.begin());
+    else
+        buffer[0] = (ElemType)(int)command;
+
+    auto dataType = MPIWrapper::GetDataType((ElemType*)nullptr);
+    m_mpi->Isend(buffer.data(), hasData ? (int)m_shard.size() : 1, dataType, (int)worker, ReplyTag, &m_replySendRequests[worker]) || MpiFail("ParameterServer: MPI_Isend");
+    m_replySendActive[worker] = true;
+}
+
+template <class ElemType>
+void ParameterServer<ElemType>::PostReceiveRequest(size_t worker)
+{
+    auto& buffer = m_receiveBuffers[worker];
+    m_mpi->Irecv(buffer.data(), (int)buffer.size(), MPIWrapper::GetDataType((ElemType*)nullptr), (int)worker, RequestTag, &m_receiveRequests[worker]) || MpiFail("ParameterServer: MPI_Irecv");
+    m_receiveActive[worker] = true;
+}
+
+template class ParameterServer<float>;
+template class ParameterServer<double>;
+
+}}}
@@ -0,0 +1,155 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// ParameterServer.h : Sharded parameter server for asynchronous data-parallel SGD over MPI.
+//
+
+#pragma once
+
+#include "MPIWrapper.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// ParameterServer -- parameter server for asynchronous SGD without external dependencies.
+//
+// The model is a flat array that is split into one contiguous shard per worker. Every worker process hosts
+// the server of its shard in a communication thread, which also sends the requests of the local worker and
+// receives the replies. While a ParameterServer exists, its communication thread is the only thread of the
+// process that calls into MPI, so MPI_THREAD_SERIALIZED is sufficient. Requests of a worker to the shard it
+// hosts itself are handled without MPI.
+//
+// Workers push model deltas, which the servers add to their shards (optionally through a momentum that is
+// kept on the servers), and receive the latest model in reply. The servers bound the staleness: the reply to
+// a push is held back while another worker is more than 'maxStaleness' pushes behind the pushing one. Workers
+// that wait in Barrier() do not hold back others, and the push counts are reset at every barrier.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class ParameterServer
+{
+public:
+    static const size_t UnboundedStaleness = SIZE_MAX;
+
+    ParameterServer(const MPIWrapperPtr& mpi, size_t modelSize, size_t maxStaleness = UnboundedStaleness, double momentum = 0, int traceLevel = 0);
+
+    // Sends the shutdown request to all servers and waits until all workers have sent theirs.
+    ~ParameterServer();
+
+    // -----------------------------------------------------------------------
+    // Initialize() -- Sets the model on the servers to the average of 'model' over all workers and returns it in 'model'.
+    // Must be called by all workers before any other request.
+    // -----------------------------------------------------------------------
+    void Initialize(ElemType* model);
+
+    // -----------------------------------------------------------------------
+    // PushAndPullAsync() -- Adds 'delta' to the model on the servers and writes the updated model to 'model'.
+    // Returns immediately; both buffers must stay untouched until Wait() returns.
+    // -----------------------------------------------------------------------
+    void PushAndPullAsync(const ElemType* delta, ElemType* model);
+
+    void PushAndPull(const ElemType* delta, ElemType* model)
+    {
+        PushAndPullAsync(delta, model);
+        Wait();
+    }
+
+    // -----------------------------------------------------------------------
+    // Wait() -- Waits for the last request of this worker, rethrows errors of the communication thread.
+    // -----------------------------------------------------------------------
+    void Wait();
+
+    // -----------------------------------------------------------------------
+    // Barrier() -- Waits until all workers have arrived at the barrier.
+    // -----------------------------------------------------------------------
+    void Barrier();
+
+    size_t ShardBegin(size_t rank) const { return rank * m_modelSize / m_numWorkers; }
+    size_t ShardSize(size_t rank) const { return ShardBegin(rank + 1) - ShardBegin(rank); }
+
+private:
+    // The command is sent as the first element of each request.
+    enum class Command : int
+    {
+        None = 0,
+        Initialize = 1,
+        Push = 2,
+        Barrier = 3,
+        Shutdown = 4,
+    };
+
+    enum class RequestState
+    {
+        Idle,
+        Posted,
+        InProgress,
+        Completed,
+    };
+
+    static const int RequestTag = 0x5E71;
+    static const int ReplyTag = 0x5E72;
+
+    // Called by the worker: hands the request to the communication thread.
+    void Post(Command command, const ElemType* data, ElemType* result);
+
+    // Communication thread.
+    void Run();
+    bool Progress();
+    void StartRequest();
+    void OnRequest(size_t worker, Command command, const ElemType* data);
+    void SendReplies();
+    void Reply(size_t worker);
+    void PostReceiveRequest(size_t worker);
+
+    MPIWrapperPtr m_mpi;
+    size_t m_numWorkers;
+    size_t m_rank;
+    size_t m_modelSize;
+    size_t m_maxStaleness;
+    double m_momentum;
+    int m_traceLevel;
+
+    // Request of the local worker, guarded by m_mutex.
+    std::mutex m_mutex;
+    std::condition_variable m_requestDone;
+    Command m_requestCommand;
+    const ElemType* m_requestData;
+    ElemType* m_requestResult;
+    RequestState m_requestState;
+    std::exception_ptr m_error;
+
+    // Worker side of the communication thread: one outstanding request per server.
+    Command m_activeCommand;
+    size_t m_outstandingReplies;
+    std::vector<std::vector<ElemType>> m_sendBuffers;
+    std::vector<MPI_Request> m_sendRequests;
+    std::vector<bool> m_sendActive;
+    std::vector<MPI_Request> m_replyRequests;
+    std::vector<bool> m_replyActive;
+    std::vector<ElemType> m_barrierReplies;
+
+    // Server side of the communication thread.
+    std::vector<ElemType> m_shard;
+    std::vector<ElemType> m_velocity;
+    std::vector<std::vector<ElemType>> m_receiveBuffers;
+    std::vector<MPI_Request> m_receiveRequests;
+    std::vector<bool> m_receiveActive;
+    std::vector<std::vector<ElemType>> m_replyBuffers;
+    std::vector<MPI_Request> m_replySendRequests;
+    std::vector<bool> m_replySendActive;
+    std::vector<Command> m_pending; // request of each worker that has not been replied to
+    std::vector<size_t> m_clocks;   // number of pushes of each worker since the last barrier
+    bool m_serverDone;
+
+    std::thread m_thread;
+};
+
+}}}
@@ -327,6 +327,8 @@ protected:
     intargvector m_nSyncSamplesPerWorker;
     bool m_isAsyncBufferEnabled;
     bool m_isSimulateMA;
+    size_t m_maxStaleness;
+    double m_serverMomentum;
     AdjustLearningRateAtBeginning m_adjustLearningRateAtBeginning;
     double m_adjustCoefficient;
     size_t m_adjustPerMinibatches;
@@ -0,0 +1,113 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
+
+#include "CNTKLibrary.h"
+#include "Common.h"
+#include <chrono>
+
+using namespace CNTK;
+using namespace std;
+
+namespace
+{
+    const vector<pair<Internal::AllReduceAlgorithm, const char*>> g_algorithms =
+    {
+        { Internal::AllReduceAlgorithm::MPI, "mpi" },
+        { Internal::AllReduceAlgorithm::Ring, "ring" },
+        { Internal::AllReduceAlgorithm::RecursiveHalving, "recursive halving" },
+        { Internal::AllReduceAlgorithm::Hierarchical, "hierarchical" },
+        { Internal::AllReduceAlgorithm::Automatic, "automatic" },
+    };
+
+    // Fills the value with (rank + 1) * (i + 1), aggregates it and checks that each element is the sum over all workers.
+    void AggregateAndCheck(const DistributedCommunicatorPtr& communicator, const NDArrayViewPtr& value, const char* algorithmName)
+    {
+        auto numberOfWorkers = communicator->Workers().size();
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        auto count = value->Shape().TotalSize();
+
+        auto data = value->WritableDataBuffer<float>();
+        for (size_t i = 0; i < count; ++i)
+            data[i] = (float)((rank + 1) * (i % 1000 + 1));
+
+        communicator->AggregateInPlace({ value }, communicator->Workers());
+
+        float sumOfRanks = (float)(numberOfWorkers * (numberOfWorkers + 1) / 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (data[i] != sumOfRanks * (i % 1000 + 1))
+                ReportFailure("Allreduce with %s of %d elements is wrong at %d; Expected=%g, Actual=%g",
+                    algorithmName, (int)count, (int)i, sumOfRanks * (i % 1000 + 1), data[i]);
+        }
+    }
+}
+
+void TestAllReduceAlgorithms()
+{
+    printf("Aggregating with all allreduce algorithms.\n");
+
+    auto communicator = MPICommunicator();
+    for (const auto& algorithm : g_algorithms)
+    {
+        Internal::SetAllReduceAlgorithm(algorithm.first);
+
+        // Sizes that are smaller than the number of workers, not divisible by it and larger than a pipelined segment.
+        for (size_t count : { 1, 3, 1001, 100000 })
+            AggregateAndCheck(communicator, MakeSharedObject<NDArrayView>(DataType::Float, NDShape{ count }, DeviceDescriptor::CPUDevice()), algorithm.second);
+    }
+
+    Internal::SetAllReduceAlgorithm(Internal::AllReduceAlgorithm::MPI);
+}
+
+// Prints the achieved bus bandwidth of each algorithm for messages of increasing size: the algorithm bandwidth (size / time)
+// multiplied by 2 * (n - 1) / n, the amount of data a bandwidth-optimal allreduce moves through each link per byte of the message.
+void BenchmarkAllReduce()
+{
+    const size_t numberOfIterations = 10;
+
+    auto communicator = MPICommunicator();
+    auto numberOfWorkers = communicator->Workers().size();
+    bool isMainWorker = communicator->CurrentWorker().IsMain();
+    if (isMainWorker)
+        printf("Allreduce benchmark on %d workers, bus bandwidth in GB/s\n%12s %18s %18s %18s %18s %18s\n", (int)numberOfWorkers,
+            "bytes", g_algorithms[0].second, g_algorithms[1].second, g_algorithms[2].second, g_algorithms[3].second, g_algorithms[4].second);
+
+    for (size_t sizeInBytes = 4 * 1024; sizeInBytes <= 256 * 1024 * 1024; sizeInBytes *= 4)
+    {
+        auto value = MakeSharedObject<NDArrayView>(DataType::Float, NDShape{ sizeInBytes / sizeof(float) }, DeviceDescriptor::CPUDevice());
+        if (isMainWorker)
+            printf("%12d", (int)sizeInBytes);
+
+        for (const auto& algorithm : g_algorithms)
+        {
+            Internal::SetAllReduceAlgorithm(algorithm.first);
+
+            // The first aggregation checks the result and warms up the buffers.
+            AggregateAndCheck(communicator, value, algorithm.second);
+
+            communicator->Barrier();
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < numberOfIterations; ++i)
+                communicator->AggregateInPlace({ value }, communicator->Workers());
+            communicator->Barrier();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count() / numberOfIterations;
+
+            double algorithmBandwidth = sizeInBytes / seconds / 1e9;
+            double busBandwidth = algorithmBandwidth * 2 * (numberOfWorkers - 1) / numberOfWorkers;
+            if (isMainWorker)
+                printf(" %18.3f", busBandwidth);
+        }
+
+        if (isMainWorker)
+        {
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    Internal::SetAllReduceAlgorithm(Internal::AllReduceAlgorithm::MPI);
+}
@@ -0,0 +1,94 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
+
+#include "CNTKLibrary.h"
+#include "Common.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace CNTK;
+using namespace std;
+
+namespace
+{
+    // Closed loop load: each client sends its next request as soon as the previous one has been answered.
+    // Returns the latencies of all requests in microseconds and the total time in seconds.
+    pair<vector<double>, double> RunClients(const BatchingEvaluatorPtr& evaluator, const Variable& input, const vector<ValuePtr>& requests, size_t numberOfClients)
+    {
+        vector<vector<double>> latencies(numberOfClients);
+        vector<thread> clients;
+        auto start = chrono::steady_clock::now();
+        for (size_t c = 0; c < numberOfClients; ++c)
+        {
+            clients.emplace_back([&, c]() {
+                for (size_t i = c; i < requests.size(); i += numberOfClients)
+                {
+                    auto requestStart = chrono::steady_clock::now();
+                    evaluator->Evaluate({ { input, requests[i] } });
+                    latencies[c].push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - requestStart).count());
+                }
+            });
+        }
+
+        for (auto& client : clients)
+            client.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        vector<double> result;
+        for (const auto& clientLatencies : latencies)
+            result.insert(result.end(), clientLatencies.begin(), clientLatencies.end());
+        sort(result.begin(), result.end());
+        return { result, seconds };
+    }
+
+    double Percentile(const vector<double>& sortedValues, double percentile)
+    {
+        auto index = (size_t)(percentile / 100 * (sortedValues.size() - 1) + 0.5);
+        return sortedValues[index];
+    }
+}
+
+// Prints the throughput and the median and 99th percentile latency of single sequence requests sent by an increasing
+// number of clients, for several maximum batch sizes. A maximum batch size of 1 evaluates each request on its own.
+void BenchmarkBatchingEvaluator()
+{
+    const size_t inputDim = 256;
+    const size_t hiddenDim = 1024;
+    const size_t maxSequenceLength = 20;
+    const size_t numberOfRequests = 2000;
+    const size_t maxLatencyInMicroseconds = 2000;
+
+    auto device = ShouldRunOnGpu() ? DeviceDescriptor::GPUDevice(0) : DeviceDescriptor::CPUDevice();
+
+    auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto model = SimpleRecurrentLayer(input, { hiddenDim }, [](const Variable& x) { return PastValue(x); }, device);
+    model = FullyConnectedLinearLayer(model, hiddenDim, device);
+
+    vector<ValuePtr> requests;
+    for (size_t i = 0; i < numberOfRequests; ++i)
+        requests.push_back(GenerateSequences<float>(GenerateSequenceLengths(1, maxSequenceLength), { inputDim }, DeviceDescriptor::CPUDevice(), false));
+
+    printf("Batching evaluator benchmark on %S, max latency %d us\n%14s %10s %16s %12s %12s\n", device.AsString().c_str(), (int)maxLatencyInMicroseconds,
+        "maxBatchSize", "clients", "requests/s", "p50 (us)", "p99 (us)");
+
+    for (size_t maxBatchSize : { 1, 8, 32 })
+    {
+        auto evaluator = CreateBatchingEvaluator(model, device, maxBatchSize, maxLatencyInMicroseconds);
+
+        // Warms up the evaluation of the model.
+        RunClients(evaluator, input, vector<ValuePtr>(requests.begin(), requests.begin() + 2 * maxBatchSize), maxBatchSize);
+
+        for (size_t numberOfClients : { 1, 4, 16, 64 })
+        {
+            auto result = RunClients(evaluator, input, requests, numberOfClients);
+            printf("%14d %10d %16.1f %12.1f %12.1f\n", (int)maxBatchSize, (int)numberOfClients,
+                numberOfRequests / result.second, Percentile(result.first, 50), Percentile(result.first, 99));
+            fflush(stdout);
+        }
+    }
+}
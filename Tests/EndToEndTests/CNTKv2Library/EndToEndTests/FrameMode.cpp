@@ -111,6 +111,14 @@ void TestFrameMode()
     // Create a set of trainers.
     std::map<std::wstring, std::function<DistributedLearnerPtr(LearnerPtr)>> learners;
     learners[L"simple"] = [](LearnerPtr l) { return CreateDataParallelDistributedLearner(MPICommunicator(), l, 0); };
+    learners[L"bucketed"] = [](LearnerPtr l)
+    {
+        // Small buckets, so that gradients are aggregated in several buckets overlapped with backpropagation.
+        Internal::SetGradientAggregationBucketSizeInBytes(1024);
+        auto learner = CreateDataParallelDistributedLearner(MPICommunicator(), l, 0);
+        Internal::SetGradientAggregationBucketSizeInBytes(0);
+        return learner;
+    };
 
     learners[L"gpu"] = [](LearnerPtr l) { return CreateQuantizedDataParallelDistributedLearner(QuantizedMPICommunicator(true, true, 32), l, 0); };
     learners[L"blockmomentum"] = [](LearnerPtr l) { return CreateBlockMomentumDistributedLearner(MPICommunicator(), l, 0, 1024); };
@@ -227,6 +235,30 @@ void TestDistributedCheckpointing()
             FloatingPointCompare(loss, expectedLoss[i], "Post checkpoint restoration training loss does not match expectation");
            
         }
+
+        // A checkpoint below a regular file cannot be written; the main worker fails to write it in the background,
+        // and the next checkpoint has to fail on all workers rather than leave the others waiting for the main worker.
+        if (workerRank == 0)
+            std::ofstream("distributed_checkpoint_test.blocking").put('x');
+        sync->Barrier();
+
+        trainer->SaveCheckpointAsync(L"distributed_checkpoint_test.blocking/checkpoint");
+        bool failed = false;
+        try
+        {
+            trainer->SaveCheckpoint(L"distributed_checkpoint_test.after_failure");
+        }
+        catch (const std::exception&)
+        {
+            failed = true;
+        }
+
+        if (!failed)
+            ReportFailure("A checkpoint did not fail after writing the previous one has failed");
+
+        sync->Barrier();
+        if (workerRank == 0)
+            remove("distributed_checkpoint_test.blocking");
     }
 
     sync->Barrier();
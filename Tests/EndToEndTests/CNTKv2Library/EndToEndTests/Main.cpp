@@ -22,6 +22,9 @@ void TrainSequenceToSequenceTranslator();
 void TrainTruncatedLSTMAcousticModelClassifier();
 void TestFrameMode();
 void TestDistributedCheckpointing();
+void TestAllReduceAlgorithms();
+void BenchmarkAllReduce();
+void BenchmarkBatchingEvaluator();
 
 int main(int argc, char *argv[])
 {
@@ -61,6 +64,8 @@ int main(int argc, char *argv[])
 
             TestDistributedCheckpointing();
 
+            TestAllReduceAlgorithms();
+
             std::string testsPassedMsg = "\nCNTKv2Library-Distribution tests: Passed\n";
 
             printf("%s", testsPassedMsg.c_str());
@@ -77,6 +82,21 @@ int main(int argc, char *argv[])
         }
     }
 
+    // Has to be started with mpiexec, prints the bandwidth of the allreduce algorithms of the MPI communicator.
+    if (argc == 2 && !std::string(argv[1]).compare("AllReduceBenchmark"))
+    {
+        BenchmarkAllReduce();
+        DistributedCommunicator::Finalize();
+        return 0;
+    }
+
+    // Prints the throughput and latency of the batching evaluator under load from concurrent clients.
+    if (argc == 2 && !std::string(argv[1]).compare("BatchingEvaluatorBenchmark"))
+    {
+        BenchmarkBatchingEvaluator();
+        return 0;
+    }
+
     std::string testName(argv[1]);
 
     if (!testName.compare("CifarResNet"))
@@ -292,9 +292,10 @@ BOOST_AUTO_TEST_CASE(EvalSparseTimesTest)
     eval->Destroy();
 }
 
-BOOST_AUTO_TEST_CASE(EvalRNNTest)
+// A single LSTM layer with 4 inputs and outputs, and a cell dimension of 1
+std::string LSTMModelDefinition()
 {
-    std::string modelDefinition =
+    return
         "deviceId = -1 \n"
         "precision = \"float\" \n"
         "traceLevel = 1 \n"
@@ -350,6 +351,11 @@ BOOST_AUTO_TEST_CASE(EvalRNNTest)
             "FeatureNodes = (i1) \n"
             "outputNodes = (o1) \n"
          "] \n";
+}
+
+BOOST_AUTO_TEST_CASE(EvalRNNTest)
+{
+    std::string modelDefinition = LSTMModelDefinition();
 
     VariableSchema inputLayouts;
     VariableSchema outputLayouts;
@@ -415,5 +421,63 @@ BOOST_AUTO_TEST_CASE(EvalRNNTest)
     eval->Destroy();
 }
 
+BOOST_AUTO_TEST_CASE(EvalRNNStreamStateTest)
+{
+    std::string modelDefinition = LSTMModelDefinition();
+
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float> *eval;
+    size_t featDim = 4;
+    eval = SetupNetworkAndGetLayouts(modelDefinition, inputLayouts, outputLayouts);
+
+    // Chunks of 3 frames: two consecutive chunks of one stream, and a chunk of another stream.
+    const size_t numFrames = 3;
+    Values<float> firstChunk(1), secondChunk(1), otherChunk(1);
+    for (size_t i = 0; i < featDim * numFrames; i++)
+    {
+        firstChunk[0].m_buffer.push_back((float)i / 10);
+        secondChunk[0].m_buffer.push_back((float)(i % 5) / 4);
+        otherChunk[0].m_buffer.push_back((float)i / -7);
+    }
+
+    Values<float> outputBuffer = outputLayouts.CreateBuffers<float>({ numFrames });
+
+    BOOST_REQUIRE(eval->ExportRecurrentState() == nullptr); // nothing evaluated yet
+
+    // the stream evaluated without interruption
+    eval->ForwardPass(firstChunk, outputBuffer, true);
+    eval->ForwardPass(secondChunk, outputBuffer, false);
+    std::vector<float> expected = outputBuffer[0].m_buffer;
+
+    // the stream interrupted by another stream
+    eval->ForwardPass(firstChunk, outputBuffer, true);
+    auto streamState = eval->ExportRecurrentState();
+    BOOST_REQUIRE(streamState != nullptr);
+
+    eval->ForwardPass(otherChunk, outputBuffer, true);
+    auto otherStreamState = eval->SwapRecurrentState(streamState);
+
+    eval->ForwardPass(secondChunk, outputBuffer, false);
+    auto buf = outputBuffer[0].m_buffer;
+    BOOST_CHECK_EQUAL_COLLECTIONS(buf.begin(), buf.end(), expected.begin(), expected.end());
+
+    // the state of the other stream continues it as well
+    eval->ImportRecurrentState(otherStreamState);
+    eval->ForwardPass(secondChunk, outputBuffer, false);
+    std::vector<float> otherStreamResult = outputBuffer[0].m_buffer;
+
+    eval->ForwardPass(otherChunk, outputBuffer, true);
+    eval->ForwardPass(secondChunk, outputBuffer, false);
+    buf = outputBuffer[0].m_buffer;
+    BOOST_CHECK_EQUAL_COLLECTIONS(buf.begin(), buf.end(), otherStreamResult.begin(), otherStreamResult.end());
+
+    // without a state a stream cannot be continued
+    eval->ImportRecurrentState(nullptr);
+    BOOST_REQUIRE_THROW(eval->ForwardPass(secondChunk, outputBuffer, false), std::exception);
+
+    eval->Destroy();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }}}}
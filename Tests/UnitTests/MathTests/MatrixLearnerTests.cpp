@@ -60,17 +60,53 @@ public:
         timestamps = SingleMatrix::RandomGaussian(1, dim2, c_deviceIdZero, -1.0f, 1.0f, IncrementCounter());
     }
 
+    // Returns for each column of the gradient whether it has a non-zero element, that is, a block in matGsparseBSC.
+    std::vector<bool> TouchedColumns()
+    {
+        std::vector<bool> touched(matG.GetNumCols(), false);
+        for (size_t col = 0; col < matG.GetNumCols(); col++)
+            for (size_t row = 0; row < matG.GetNumRows(); row++)
+                touched[col] = touched[col] || matG.GetValue(row, col) != 0;
+        return touched;
+    }
+
+    // Checks that the model updated lazily matches the dense update in the touched columns and is unchanged elsewhere.
+    bool IsLazyModelCorrect(const SingleMatrix& matMinitial, const std::vector<bool>& touched)
+    {
+        return IsLazyModelCorrect(matMinitial, matM, touched);
+    }
+
+    // Checks that the model updated lazily matches the expected values in the touched columns and is unchanged elsewhere.
+    bool IsLazyModelCorrect(const SingleMatrix& matMinitial, const SingleMatrix& matMexpected, const std::vector<bool>& touched)
+    {
+        for (size_t col = 0; col < matMsparse.GetNumCols(); col++)
+        {
+            const auto& expected = touched[col] ? matMexpected : matMinitial;
+            for (size_t row = 0; row < matMsparse.GetNumRows(); row++)
+            {
+                if (fabsf(expected.GetValue(row, col) - matMsparse.GetValue(row, col)) > c_epsilonFloatE4)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void TransferToDevice(int deviceId)
+    {
+        matSG.TransferToDeviceIfNotThere(deviceId, true);
+        matSGsparse.TransferToDeviceIfNotThere(deviceId, true);
+        matM.TransferToDeviceIfNotThere(deviceId, true);
+        matMsparse.TransferToDeviceIfNotThere(deviceId, true);
+        matG.TransferToDeviceIfNotThere(deviceId, true);
+        matGsparseBSC.TransferToDeviceIfNotThere(deviceId, true);
+        timestamps.TransferToDeviceIfNotThere(deviceId, true);
+    }
+
     void RunOnDevices(std::function<void()> func)
     {
         for (int deviceId : {-1, 0})
         {
-            matSG.TransferToDeviceIfNotThere(deviceId, true);
-            matSGsparse.TransferToDeviceIfNotThere(deviceId, true);
-            matM.TransferToDeviceIfNotThere(deviceId, true);
-            matMsparse.TransferToDeviceIfNotThere(deviceId, true);
-            matG.TransferToDeviceIfNotThere(deviceId, true);
-            matGsparseBSC.TransferToDeviceIfNotThere(deviceId, true);
-            timestamps.TransferToDeviceIfNotThere(deviceId, true);
+            TransferToDevice(deviceId);
             func();
         }
     }
@@ -121,5 +157,124 @@ BOOST_FIXTURE_TEST_CASE(AdaDeltaSparse, MatrixLearnerFixture)
     });
 }
 
+// tests the lazy sparse momentum SGD update vs. dense
+BOOST_FIXTURE_TEST_CASE(MomentumSGDLazySparse, MatrixLearnerFixture)
+{
+    // the lazy update is only implemented on the CPU
+    TransferToDevice(CPUDEVICE);
+    auto touched = TouchedColumns();
+    SingleMatrix matMinitial(matM.DeepClone());
+
+    timestamps.SetValue(0.0f);
+    auto ts = reinterpret_cast<int*>(timestamps.Data());
+    matM.MomentumSGDUpdate(matG, matSG, 0.5f, 0.9f, 0.1f);
+    matMsparse.MomentumSGDUpdate(matGsparseBSC, matSGsparse, 0.5f, 0.9f, 0.1f, ts, 1);
+    BOOST_CHECK(IsLazyModelCorrect(matMinitial, touched));
+
+    // the untouched columns of the smoothed gradients catch up with the dense update when the state is flushed
+    matSGsparse.MomentumSGDFlushState(matGsparseBSC.GetNumCols(), 0.9f, ts, 1);
+    BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
+}
+
+// tests the lazy sparse Adam update vs. dense
+BOOST_FIXTURE_TEST_CASE(AdamLazySparse, MatrixLearnerFixture)
+{
+    // the lazy update is only implemented on the CPU
+    TransferToDevice(CPUDEVICE);
+    auto touched = TouchedColumns();
+    SingleMatrix matMinitial(matM.DeepClone());
+
+    // Adam keeps both moments in the smoothed gradients
+    matSG.Resize(dim1, 2 * dim2);
+    matSG.SetValue(0.1f);
+    matSGsparse.Resize(dim1, 2 * dim2);
+    matSGsparse.SetValue(0.1f);
+
+    timestamps.SetValue(0.0f);
+    auto ts = reinterpret_cast<int*>(timestamps.Data());
+    matSG.AdamUpdate(matG, matM, 2, 0.01, 0.9, 0.999, 1e-8, 0.1f);
+    matSGsparse.AdamUpdate(matGsparseBSC, matMsparse, 2, 0.01, 0.9, 0.999, 1e-8, 0.1f, /*adamax=*/false, ts, 1);
+    BOOST_CHECK(IsLazyModelCorrect(matMinitial, touched));
+
+    matSGsparse.AdamFlushState(matGsparseBSC.GetNumCols(), 0.9f, 0.999f, ts, 1);
+    BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
+}
+
+// tests the lazy sparse momentum SGD update vs. dense when the gradient skips several minibatches
+BOOST_FIXTURE_TEST_CASE(MomentumSGDLazySparseSkippedMinibatches, MatrixLearnerFixture)
+{
+    const int numSkippedMinibatches = 3;
+    TransferToDevice(CPUDEVICE);
+    auto touched = TouchedColumns();
+    SingleMatrix matMinitial(matMsparse.DeepClone());
+    SingleMatrix matGzero(dim1, dim2, CPUDEVICE);
+    matGzero.SetValue(0.0f);
+
+    timestamps.SetValue(0.0f);
+    auto ts = reinterpret_cast<int*>(timestamps.Data());
+    matM.MomentumSGDUpdate(matG, matSG, 0.5f, 0.9f, 0.1f);
+    matMsparse.MomentumSGDUpdate(matGsparseBSC, matSGsparse, 0.5f, 0.9f, 0.1f, ts, 1);
+    SingleMatrix matSGfirst(matSGsparse.DeepClone());
+
+    // the dense update sees a zero gradient in the minibatches that the lazy update skips
+    for (int i = 0; i < numSkippedMinibatches; i++)
+        matM.MomentumSGDUpdate(matGzero, matSG, 0.5f, 0.9f, 0.1f);
+
+    const int lastTimestamp = numSkippedMinibatches + 2;
+    matM.MomentumSGDUpdate(matG, matSG, 0.5f, 0.9f, 0.1f);
+    matMsparse.MomentumSGDUpdate(matGsparseBSC, matSGsparse, 0.5f, 0.9f, 0.1f, ts, lastTimestamp);
+    matSGsparse.MomentumSGDFlushState(matGsparseBSC.GetNumCols(), 0.9f, ts, lastTimestamp);
+    BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
+
+    // the lazy model only moves in the minibatches with a gradient
+    SingleMatrix matMexpected(matMinitial.DeepClone());
+    matMexpected -= matSGfirst;
+    matMexpected -= matSGsparse;
+    BOOST_CHECK(IsLazyModelCorrect(matMinitial, matMexpected, touched));
+}
+
+// tests the lazy sparse Adam update vs. dense when the gradient skips several minibatches
+BOOST_FIXTURE_TEST_CASE(AdamLazySparseSkippedMinibatches, MatrixLearnerFixture)
+{
+    const int numSkippedMinibatches = 3;
+    TransferToDevice(CPUDEVICE);
+    auto touched = TouchedColumns();
+    SingleMatrix matGzero(dim1, dim2, CPUDEVICE);
+    matGzero.SetValue(0.0f);
+
+    for (auto adamax : { false, true })
+    {
+        matMsparse = SingleMatrix(matM.DeepClone());
+        matSG.Resize(dim1, 2 * dim2);
+        matSG.SetValue(0.1f);
+        matSGsparse.Resize(dim1, 2 * dim2);
+        matSGsparse.SetValue(0.1f);
+        SingleMatrix matMinitial(matMsparse.DeepClone());
+
+        timestamps.SetValue(0.0f);
+        auto ts = reinterpret_cast<int*>(timestamps.Data());
+        matSG.AdamUpdate(matG, matM, 2, 0.01, 0.9, 0.999, 1e-8, 0.1f, adamax);
+        matSGsparse.AdamUpdate(matGsparseBSC, matMsparse, 2, 0.01, 0.9, 0.999, 1e-8, 0.1f, adamax, ts, 1);
+        SingleMatrix matMfirst(matM.DeepClone());
+
+        // the dense update sees a zero gradient in the minibatches that the lazy update skips
+        for (int i = 0; i < numSkippedMinibatches; i++)
+            matSG.AdamUpdate(matGzero, matM, 3 + i, 0.01, 0.9, 0.999, 1e-8, 0.1f, adamax);
+
+        const int lastTimestamp = numSkippedMinibatches + 2;
+        SingleMatrix matMbeforeLast(matM.DeepClone());
+        matSG.AdamUpdate(matG, matM, lastTimestamp + 1, 0.01, 0.9, 0.999, 1e-8, 0.1f, adamax);
+        matSGsparse.AdamUpdate(matGsparseBSC, matMsparse, lastTimestamp + 1, 0.01, 0.9, 0.999, 1e-8, 0.1f, adamax, ts, lastTimestamp);
+        matSGsparse.AdamFlushState(matGsparseBSC.GetNumCols(), 0.9f, 0.999f, ts, lastTimestamp);
+        BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
+
+        // the lazy model only moves in the minibatches with a gradient, by the same steps as the dense model
+        SingleMatrix matMexpected(matMfirst.DeepClone());
+        matMexpected += matM;
+        matMexpected -= matMbeforeLast;
+        BOOST_CHECK(IsLazyModelCorrect(matMinitial, matMexpected, touched));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }}}}
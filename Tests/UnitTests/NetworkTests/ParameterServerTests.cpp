@@ -0,0 +1,121 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "ParameterServer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Microsoft::MSR::CNTK;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+// The tests work with any number of workers: run on their own they use a single worker, run with
+// "mpiexec -n <workers> networktests --run_test=ParameterServerTests" every process is a worker.
+// The assertions do not depend on the rank, so that all processes report the same results.
+static MPIWrapperPtr GetMPIWrapper()
+{
+    return MPIWrapper::GetInstance();
+}
+
+// Initializes MPI before the first test of the suite and finalizes it after the last one, before the processes exit.
+// MPI that was initialized elsewhere in the process is left alone, so the other tests of the binary are not affected.
+struct MPIFixture
+{
+    MPIFixture() : m_initialized(!MPIWrapper::GetInstance())
+    {
+        if (m_initialized)
+            MPIWrapper::GetInstance(/*create=*/true);
+    }
+
+    ~MPIFixture()
+    {
+        if (m_initialized)
+        {
+            MPIWrapper::GetInstance()->Finalize();
+            MPIWrapper::DeleteInstance();
+        }
+    }
+
+    bool m_initialized;
+};
+
+static bool AllClose(const std::vector<float>& values, float expected)
+{
+    return std::all_of(values.begin(), values.end(), [expected](float value) { return std::fabs(value - expected) <= 1e-4f * std::max(1.0f, std::fabs(expected)); });
+}
+
+BOOST_AUTO_TEST_SUITE(ParameterServerTests, *boost::unit_test::fixture<MPIFixture>())
+
+BOOST_AUTO_TEST_CASE(PushesAreSummedWithBoundedStaleness)
+{
+    // Not divisible by the number of workers, so the shards have different sizes.
+    const size_t modelSize = 1001;
+    const size_t numPushes = 20;
+    const size_t maxStaleness = 2;
+
+    auto mpi = GetMPIWrapper();
+    size_t numWorkers = mpi->NumNodesInUse();
+    size_t rank = mpi->CurrentNodeRank();
+
+    ParameterServer<float> server(mpi, modelSize, maxStaleness);
+
+    // The initial model is the average of the models of all workers.
+    std::vector<float> model(modelSize, (float)(rank + 1));
+    server.Initialize(model.data());
+    float initial = (numWorkers + 1) / 2.0f;
+    BOOST_REQUIRE(AllClose(model, initial));
+
+    // When the k-th push of a worker returns, all other workers have pushed at least k - maxStaleness times.
+    std::vector<float> delta(modelSize, 1.0f);
+    bool isStalenessBounded = true;
+    for (size_t k = 1; k <= numPushes; k++)
+    {
+        server.PushAndPull(delta.data(), model.data());
+        float minimum = initial + k + (numWorkers - 1) * (k > maxStaleness ? k - maxStaleness : 0);
+        isStalenessBounded &= std::all_of(model.begin(), model.end(), [minimum](float value) { return value >= minimum; });
+    }
+    BOOST_REQUIRE(isStalenessBounded);
+
+    // After the barrier, the model contains the pushes of all workers.
+    server.Barrier();
+    std::fill(delta.begin(), delta.end(), 0.0f);
+    server.PushAndPullAsync(delta.data(), model.data());
+    server.Wait();
+    BOOST_REQUIRE(AllClose(model, initial + numWorkers * numPushes));
+}
+
+BOOST_AUTO_TEST_CASE(ServerAppliesMomentum)
+{
+    const size_t modelSize = 257;
+    const size_t numPushes = 3;
+    const double momentum = 0.5;
+
+    auto mpi = GetMPIWrapper();
+    size_t numWorkers = mpi->NumNodesInUse();
+
+    // Without staleness, each reply contains all pushes of the same round, so the result does not depend on timing.
+    ParameterServer<float> server(mpi, modelSize, /*maxStaleness=*/0, momentum);
+
+    std::vector<float> model(modelSize, 0.0f);
+    server.Initialize(model.data());
+
+    std::vector<float> delta(modelSize, 1.0f);
+    for (size_t k = 0; k < numPushes; k++)
+        server.PushAndPull(delta.data(), model.data());
+
+    float velocity = 0;
+    float expected = 0;
+    for (size_t i = 0; i < numWorkers * numPushes; i++)
+    {
+        velocity = (float)momentum * velocity + 1;
+        expected += velocity;
+    }
+    BOOST_REQUIRE(AllClose(model, expected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
@@ -4,8 +4,11 @@
 //
 #include "stdafx.h"
 #include "Common/ReaderTestHelper.h"
+#include "../../../Source/Readers/ImageReader/JpegHeader.h"
 
 using namespace Microsoft::MSR::CNTK;
+using ::CNTK::TryGetJpegDimensions;
+using ::CNTK::GetJpegDecodeReduction;
 
 namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
 
@@ -78,6 +81,8 @@ BOOST_AUTO_TEST_CASE(ImageSimpleCompositeAndBase64)
 
     // Image deserializer.
     test({});
+    // Image deserializer decoding the images through DecodeImage, the 4x8 images are not reduced.
+    test({ L"decodeMinSide=4" });
     // Base64 deserializer.
     test(
     {
@@ -117,6 +122,16 @@ BOOST_AUTO_TEST_CASE(InvalidImageSimpleCompositeAndBase64)
         L"maxErrors=4",
         L"useNumericSequenceKeys=true"
     });
+
+    // The invalid images are rejected the same way when their dimensions are looked up for reduced size decoding.
+    test(
+    {
+        L"MapFile=\"$RootDir$/InvalidBase64ImageReaderSimple_map.txt\"",
+        L"DeserializerType=\"Base64ImageDeserializer\"",
+        L"maxErrors=4",
+        L"useNumericSequenceKeys=true",
+        L"decodeMinSide=4"
+    });
 };
 
 BOOST_AUTO_TEST_CASE(Base64WithWriteIds)
@@ -550,10 +565,111 @@ BOOST_AUTO_TEST_CASE(ImageReaderNoMatchingIds)
     });
 }
 
+BOOST_AUTO_TEST_CASE(ImageReaderJpegDimensions)
+{
+    std::ifstream file(testDataPath() + "/Data/images/black.jpg", std::ios::binary);
+    std::vector<unsigned char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    BOOST_REQUIRE(!contents.empty());
+
+    int width = 0, height = 0;
+    BOOST_REQUIRE(TryGetJpegDimensions(contents.data(), contents.size(), width, height));
+    BOOST_CHECK_EQUAL(width, 4);
+    BOOST_CHECK_EQUAL(height, 8);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 namespace
 {
+    // Builds the markers of a JPEG image up to the start of scan: an application segment, a fill byte,
+    // a Huffman table (that shares the range of the start of frame markers) and the given start of frame.
+    std::vector<unsigned char> JpegHeader(unsigned char startOfFrame, int width, int height)
+    {
+        std::vector<unsigned char> header = { 0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x06, 'J', 'F', 'I', 'F', 0xFF, 0xFF, 0xC4, 0x00, 0x04, 0x00, 0x00 };
+        std::vector<unsigned char> frame =
+        {
+            0xFF, startOfFrame, 0x00, 0x0B, 0x08,
+            (unsigned char)(height >> 8), (unsigned char)height, (unsigned char)(width >> 8), (unsigned char)width,
+            0x01, 0x01, 0x11, 0x00
+        };
+        header.insert(header.end(), frame.begin(), frame.end());
+        std::vector<unsigned char> startOfScan = { 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00 };
+        header.insert(header.end(), startOfScan.begin(), startOfScan.end());
+        return header;
+    }
+
+    // Offset of the first byte after the dimensions in the frame header of JpegHeader.
+    const size_t JpegHeaderDimensionsEnd = 26;
+
+    BOOST_AUTO_TEST_SUITE(JpegHeaderTests)
+
+    BOOST_AUTO_TEST_CASE(JpegDimensionsOfBaselineAndProgressiveImages)
+    {
+        for (unsigned char startOfFrame : { 0xC0, 0xC1, 0xC2 })
+        {
+            auto header = JpegHeader(startOfFrame, 640, 480);
+            int width = 0, height = 0;
+            BOOST_REQUIRE(TryGetJpegDimensions(header.data(), header.size(), width, height));
+            BOOST_CHECK_EQUAL(width, 640);
+            BOOST_CHECK_EQUAL(height, 480);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(JpegDimensionsOfTruncatedOrNonJpegData)
+    {
+        int width, height;
+        auto header = JpegHeader(0xC2, 640, 480);
+        for (size_t size = 0; size < JpegHeaderDimensionsEnd; ++size)
+            BOOST_CHECK(!TryGetJpegDimensions(header.data(), size, width, height));
+        BOOST_CHECK(TryGetJpegDimensions(header.data(), JpegHeaderDimensionsEnd, width, height));
+
+        // Image without a frame header.
+        std::vector<unsigned char> noFrame = { 0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x06, 'J', 'F', 'I', 'F', 0xFF, 0xD9 };
+        BOOST_CHECK(!TryGetJpegDimensions(noFrame.data(), noFrame.size(), width, height));
+
+        // Frame header with a zero dimension.
+        auto empty = JpegHeader(0xC0, 0, 480);
+        BOOST_CHECK(!TryGetJpegDimensions(empty.data(), empty.size(), width, height));
+
+        // Segment that is not preceded by a marker.
+        auto corrupted = JpegHeader(0xC0, 640, 480);
+        corrupted[10] = 0x00;
+        BOOST_CHECK(!TryGetJpegDimensions(corrupted.data(), corrupted.size(), width, height));
+
+        std::vector<unsigned char> png = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 'I', 'H', 'D', 'R' };
+        BOOST_CHECK(!TryGetJpegDimensions(png.data(), png.size(), width, height));
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(png.data(), png.size(), 1), 1);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), JpegHeaderDimensionsEnd - 1, 1), 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(JpegDecodeReductionKeepsTheShorterSideAtLeastMinSide)
+    {
+        auto header = JpegHeader(0xC2, 640, 480);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 0), 1);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 481), 1);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 241), 1);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 240), 2);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 120), 4);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 60), 8);
+        BOOST_CHECK_EQUAL(GetJpegDecodeReduction(header.data(), header.size(), 1), 8);
+
+        // The largest reduction that keeps the shorter side at least minSide pixels long, for either orientation.
+        for (int minSide = 1; minSide <= 300; ++minSide)
+        {
+            for (auto dimensions : { std::make_pair(500, 375), std::make_pair(375, 500), std::make_pair(227, 227) })
+            {
+                auto image = JpegHeader(0xC0, dimensions.first, dimensions.second);
+                int shorterSide = std::min(dimensions.first, dimensions.second);
+                int reduction = GetJpegDecodeReduction(image.data(), image.size(), minSide);
+                BOOST_CHECK(reduction == 1 || reduction == 2 || reduction == 4 || reduction == 8);
+                BOOST_CHECK(reduction == 1 || shorterSide / reduction >= minSide);
+                BOOST_CHECK(reduction == 8 || shorterSide / (reduction * 2) < minSide);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+
     // Test with not set data directory.
     struct EmptyDataDirFixture : ReaderFixture
     {
@@ -18,6 +18,11 @@
 #include "CudaMemoryProvider.h"
 #include "HeapMemoryProvider.h"
 #include "BufferedFileReader.h"
+#include "DiskChunkCache.h"
+#include "ShardedDeserializer.h"
+#include "BucketingSequenceEnumerator.h"
+#include "SequenceData.h"
+#include <boost/filesystem.hpp>
 
 #pragma warning(push)
 // disable warning about possible mod 0 operation in uniform_int_distribution
@@ -946,6 +951,103 @@ BOOST_AUTO_TEST_CASE(NoRandomizerOneEpoch)
                                   actual.begin(), actual.end());
 }
 
+BOOST_AUTO_TEST_CASE(ShardedDeserializerSelectsShardsOfWorker)
+{
+    const size_t numberOfShards = 7;
+    const size_t numberOfWorkers = 3;
+    for (bool shuffle : { false, true })
+    {
+        vector<vector<size_t>> previousEpoch;
+        for (size_t epoch = 0; epoch < 3; ++epoch)
+        {
+            vector<vector<size_t>> assignment;
+            vector<size_t> all;
+            for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+            {
+                auto shards = ShardedDeserializer::GetShardsOfWorker(numberOfShards, rank, numberOfWorkers, epoch, shuffle, 5);
+                BOOST_CHECK(shards == ShardedDeserializer::GetShardsOfWorker(numberOfShards, rank, numberOfWorkers, epoch, shuffle, 5));
+                BOOST_CHECK(shards.size() == 2 || shards.size() == 3);
+                all.insert(all.end(), shards.begin(), shards.end());
+                assignment.push_back(shards);
+            }
+
+            // Each shard belongs to exactly one worker.
+            sort(all.begin(), all.end());
+            vector<size_t> expected(numberOfShards);
+            iota(expected.begin(), expected.end(), 0);
+            BOOST_CHECK_EQUAL_COLLECTIONS(all.begin(), all.end(), expected.begin(), expected.end());
+
+            if (!shuffle && epoch > 0)
+                BOOST_CHECK(assignment == previousEpoch);
+            previousEpoch = assignment;
+        }
+    }
+
+    BOOST_CHECK_THROW(ShardedDeserializer::GetShardsOfWorker(2, 0, 3, 0, true, 0), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(ShardedDeserializerReadsOnlyLocalShards)
+{
+    const size_t numberOfShards = 5;
+    const size_t chunksPerShard = 2;
+    const size_t sequencesPerChunk = 3;
+
+    set<size_t> created;
+    auto factory = [&](size_t shardIndex) -> DataDeserializerPtr
+    {
+        created.insert(shardIndex);
+        vector<float> data(chunksPerShard * sequencesPerChunk);
+        iota(data.begin(), data.end(), (float)(shardIndex * 100));
+        return make_shared<MockDeserializer>(chunksPerShard, sequencesPerChunk, data);
+    };
+
+    auto sharded = make_shared<ShardedDeserializer>(numberOfShards, factory, true, 0);
+    BOOST_CHECK_EQUAL(created.size(), 1);
+
+    created.clear();
+    sharded->SelectShards(1, 2, 0);
+    auto owned = sharded->OwnedShards();
+    BOOST_CHECK_EQUAL(owned.size(), 2);
+    for (auto shard : created)
+        BOOST_CHECK(find(owned.begin(), owned.end(), shard) != owned.end());
+
+    // Selecting the same shards again does not recreate them.
+    created.clear();
+    BOOST_CHECK(!sharded->SelectShards(1, 2, 0));
+    BOOST_CHECK(created.empty());
+
+    auto chunks = sharded->ChunkInfos();
+    BOOST_REQUIRE_EQUAL(chunks.size(), owned.size() * chunksPerShard);
+    for (size_t i = 0; i < chunks.size(); ++i)
+        BOOST_CHECK_EQUAL(chunks[i].m_id, i);
+    BOOST_CHECK_EQUAL(sharded->NumberOfLocalSamples(), owned.size() * chunksPerShard * sequencesPerChunk);
+
+    auto randomizer = make_shared<NoRandomizer>(sharded);
+    EpochConfiguration epochConfiguration;
+    epochConfiguration.m_numberOfWorkers = 1;
+    epochConfiguration.m_workerRank = 0;
+    epochConfiguration.m_minibatchSizeInSamples = 0;
+    epochConfiguration.m_totalEpochSizeInSamples = sharded->NumberOfLocalSamples();
+    epochConfiguration.m_epochIndex = 0;
+    randomizer->StartEpoch(epochConfiguration);
+
+    vector<float> actual;
+    for (size_t i = 0; i < sharded->NumberOfLocalSamples(); ++i)
+    {
+        Sequences sequences = randomizer->GetNextSequences(1, 1);
+        BOOST_REQUIRE_EQUAL(sequences.m_data.size(), 1);
+        auto& data = reinterpret_cast<DenseSequenceData&>(*sequences.m_data[0][0]);
+        actual.push_back(*((float*)data.GetDataBuffer()));
+    }
+
+    vector<float> expected;
+    for (auto shard : owned)
+        for (size_t i = 0; i < chunksPerShard * sequencesPerChunk; ++i)
+            expected.push_back((float)(shard * 100 + i));
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
 BOOST_AUTO_TEST_CASE(CheckGetCurrentCursorForRandomizers)
 {
     size_t chunkSizeInSamples = 10000;
@@ -1906,6 +2008,303 @@ BOOST_AUTO_TEST_CASE(TestTruncatedBpttPacker)
     BOOST_TEST(!mb.m_endOfSweep);
 }
 
+// A sequence that writes samples of the form (100 * id + 10 * sample + element) directly into the minibatch.
+struct MockSequenceWriter : DenseSequenceWriter
+{
+    MockSequenceWriter(size_t id, unsigned int numberOfSamples, const NDShape& sampleShape)
+        : DenseSequenceWriter(sampleShape, sampleShape.TotalSize() * sizeof(float)), m_id(id)
+    {
+        m_numberOfSamples = numberOfSamples;
+        m_elementType = DataType::Float;
+    }
+
+    void WriteSample(size_t sampleIndex, char* destination) override
+    {
+        auto values = reinterpret_cast<float*>(destination);
+        for (size_t i = 0; i < SampleSizeInBytes() / sizeof(float); ++i)
+            values[i] = (float)(100 * m_id + 10 * sampleIndex + i);
+    }
+
+    const void* GetDataBuffer() override
+    {
+        m_materialized = true;
+        return DenseSequenceWriter::GetDataBuffer();
+    }
+
+    size_t m_id;
+    bool m_materialized = false;
+};
+
+// Returns the given sequences as a single minibatch.
+class MockSequenceEnumerator : public SequenceEnumerator
+{
+public:
+    MockSequenceEnumerator(const StreamInformation& stream, const std::vector<SequenceDataPtr>& sequences)
+        : m_stream(stream), m_sequences(sequences)
+    {}
+
+    std::vector<StreamInformation> GetStreamDescriptions() const override { return { m_stream }; }
+    void StartEpoch(const EpochConfiguration&) override {}
+    void SetConfiguration(const ReaderConfiguration&) override {}
+    void SetState(const std::map<std::wstring, size_t>&) override {}
+    std::map<std::wstring, size_t> GetState() override { return {}; }
+
+    Sequences GetNextSequences(size_t, size_t) override
+    {
+        Sequences result;
+        result.m_data.push_back(m_sequences);
+        result.m_endOfEpoch = true;
+        return result;
+    }
+
+private:
+    StreamInformation m_stream;
+    std::vector<SequenceDataPtr> m_sequences;
+};
+
+BOOST_AUTO_TEST_CASE(SequencePackerWithDenseSequenceWriters)
+{
+    const size_t sampleDimension = 3;
+    NDShape sampleShape({ sampleDimension });
+
+    StreamInformation stream;
+    stream.m_name = L"input";
+    stream.m_id = 0;
+    stream.m_storageFormat = StorageFormat::Dense;
+    stream.m_elementType = DataType::Float;
+    stream.m_sampleLayout = sampleShape;
+
+    std::vector<unsigned int> lengths = { 2, 5, 1, 3, 4 };
+    std::vector<SequenceDataPtr> sequences;
+    for (size_t i = 0; i < lengths.size(); ++i)
+        sequences.push_back(make_shared<MockSequenceWriter>(i, lengths[i], sampleShape));
+
+    auto enumerator = make_shared<MockSequenceEnumerator>(stream, sequences);
+    auto packer = make_shared<SequencePacker>(enumerator, enumerator->GetStreamDescriptions(), 1);
+
+    ReaderConfiguration config;
+    config.m_numberOfWorkers = 1;
+    config.m_minibatchSizeInSamples = 100;
+    packer->SetConfiguration(config, std::vector<MemoryProviderPtr> { std::make_shared<HeapMemoryProvider>() });
+
+    auto minibatch = packer->ReadMinibatch();
+    BOOST_REQUIRE_EQUAL(minibatch.m_data.size(), 1);
+
+    const auto& layout = minibatch.m_data[0]->m_layout;
+    const auto* data = static_cast<const float*>(minibatch.m_data[0]->m_data);
+    size_t numberOfSequences = 0;
+    for (const auto& sequence : layout->GetAllSequences())
+    {
+        if (sequence.seqId == GAP_SEQUENCE_ID)
+            continue;
+
+        numberOfSequences++;
+        BOOST_REQUIRE_EQUAL(sequence.GetNumTimeSteps(), lengths[sequence.seqId]);
+        for (size_t t = 0; t < sequence.GetNumTimeSteps(); ++t)
+        {
+            auto sample = data + layout->GetColumnIndex(sequence, t) * sampleDimension;
+            for (size_t i = 0; i < sampleDimension; ++i)
+                BOOST_REQUIRE_EQUAL(sample[i], (float)(100 * sequence.seqId + 10 * t + i));
+        }
+    }
+    BOOST_REQUIRE_EQUAL(numberOfSequences, lengths.size());
+
+    // Samples have been written directly into the minibatch.
+    for (const auto& s : sequences)
+        BOOST_REQUIRE(!static_pointer_cast<MockSequenceWriter>(s)->m_materialized);
+
+    // Consumers that need the data in memory get all samples materialized.
+    auto materialized = static_cast<const float*>(sequences[1]->GetDataBuffer());
+    for (size_t t = 0; t < lengths[1]; ++t)
+        for (size_t i = 0; i < sampleDimension; ++i)
+            BOOST_REQUIRE_EQUAL(materialized[t * sampleDimension + i], (float)(100 + 10 * t + i));
+}
+
+BOOST_AUTO_TEST_CASE(BucketingSequenceEnumeratorReducesPadding)
+{
+    const size_t sweepNumberOfSamples = 2000;
+    const size_t minibatchSize = 60;
+
+    EpochConfiguration config;
+    config.m_numberOfWorkers = 1;
+    config.m_workerRank = 0;
+    config.m_minibatchSizeInSamples = minibatchSize;
+    config.m_totalEpochSizeInSamples = sweepNumberOfSamples;
+    config.m_epochIndex = 0;
+
+    auto createEnumerator = [&](bool bucketing) -> SequenceEnumeratorPtr
+    {
+        auto deserializer = make_shared<SequentialDeserializer>(0, 100, sweepNumberOfSamples, 30);
+        SequenceEnumeratorPtr result = make_shared<NoRandomizer>(deserializer);
+        if (bucketing)
+            result = make_shared<BucketingSequenceEnumerator>(result, 500, 4, 0);
+        result->StartEpoch(config);
+        return result;
+    };
+
+    // Reads minibatches till the end of the epoch, returning the first value of each sequence
+    // and the state before each minibatch.
+    auto readEpoch = [&](SequenceEnumeratorPtr enumerator, size_t mbSize, vector<vector<float>>& minibatches, vector<map<wstring, size_t>>& states, size_t& padding)
+    {
+        padding = 0;
+        for (;;)
+        {
+            states.push_back(enumerator->GetState());
+            auto sequences = enumerator->GetNextSequences(SIZE_MAX, mbSize);
+            if (!sequences.m_data.empty())
+            {
+                vector<float> values;
+                size_t maxLength = 0, numberOfSamples = 0;
+                for (const auto& s : sequences.m_data[0])
+                {
+                    values.push_back(*(const float*)s->GetDataBuffer());
+                    maxLength = max<size_t>(maxLength, s->m_numberOfSamples);
+                    numberOfSamples += s->m_numberOfSamples;
+                }
+                BOOST_CHECK(values.size() == 1 || numberOfSamples <= mbSize);
+                padding += maxLength * values.size() - numberOfSamples;
+                minibatches.push_back(values);
+            }
+
+            if (sequences.m_endOfEpoch)
+                break;
+        }
+    };
+
+    vector<vector<float>> expected, actual;
+    vector<map<wstring, size_t>> expectedStates, states;
+    size_t expectedPadding = 0, padding = 0;
+    readEpoch(createEnumerator(false), minibatchSize, expected, expectedStates, expectedPadding);
+    readEpoch(createEnumerator(true), minibatchSize, actual, states, padding);
+
+    // Each sequence is returned exactly once, with less padding.
+    vector<float> expectedValues, actualValues;
+    for (const auto& m : expected)
+        expectedValues.insert(expectedValues.end(), m.begin(), m.end());
+    for (const auto& m : actual)
+        actualValues.insert(actualValues.end(), m.begin(), m.end());
+    sort(actualValues.begin(), actualValues.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(expectedValues.begin(), expectedValues.end(), actualValues.begin(), actualValues.end());
+    BOOST_CHECK_LT(padding, expectedPadding / 2);
+
+    // Restoring from any checkpoint continues exactly at the same position.
+    for (size_t i = 0; i < actual.size(); i += 7)
+    {
+        auto restored = createEnumerator(true);
+        restored->SetState(states[i]);
+
+        vector<vector<float>> rest;
+        vector<map<wstring, size_t>> restStates;
+        readEpoch(restored, minibatchSize, rest, restStates, padding);
+        BOOST_REQUIRE_EQUAL(rest.size(), actual.size() - i);
+        for (size_t j = 0; j < rest.size(); ++j)
+            BOOST_CHECK_EQUAL_COLLECTIONS(rest[j].begin(), rest[j].end(), actual[i + j].begin(), actual[i + j].end());
+
+        // The set of remaining sequences does not depend on the minibatch size.
+        restored = createEnumerator(true);
+        restored->SetState(states[i]);
+        rest.clear();
+        readEpoch(restored, minibatchSize / 3, rest, restStates, padding);
+
+        vector<float> remaining, expectedRemaining;
+        for (const auto& m : rest)
+            remaining.insert(remaining.end(), m.begin(), m.end());
+        for (size_t j = i; j < actual.size(); ++j)
+            expectedRemaining.insert(expectedRemaining.end(), actual[j].begin(), actual[j].end());
+        sort(remaining.begin(), remaining.end());
+        sort(expectedRemaining.begin(), expectedRemaining.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(remaining.begin(), remaining.end(), expectedRemaining.begin(), expectedRemaining.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DiskChunkCacheRoundTrip)
+{
+    const size_t chunkSizeInSamples = 100;
+    const size_t sweepNumberOfSamples = 1000;
+    const uint32_t maxSequenceLength = 30;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength);
+
+    auto source = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    {
+        ofstream sourceFile(source.string());
+        sourceFile << "source";
+    }
+    auto cacheDirectory = DiskChunkCache::GetCacheDirectory(source.wstring());
+
+    auto readChunk = [&](DataDeserializerPtr d, ChunkIdType chunkId)
+    {
+        vector<float> values;
+        vector<SequenceInfo> sequences;
+        d->SequenceInfosForChunk(chunkId, sequences);
+        auto chunk = d->GetChunk(chunkId);
+        for (const auto& s : sequences)
+        {
+            vector<SequenceDataPtr> data;
+            chunk->GetSequence(s.m_indexInChunk, data);
+            BOOST_REQUIRE_EQUAL(data.size(), 1);
+            BOOST_REQUIRE_EQUAL(data[0]->m_numberOfSamples, s.m_numberOfSamples);
+            auto buffer = static_cast<const float*>(data[0]->GetDataBuffer());
+            values.insert(values.end(), buffer, buffer + data[0]->m_numberOfSamples);
+        }
+        return make_pair(chunk, values);
+    };
+
+    auto isCached = [](const ChunkPtr& chunk)
+    {
+        return dynamic_pointer_cast<SequentialDeserializer::SequentialChunk>(chunk) == nullptr;
+    };
+
+    {
+        auto cache = make_shared<DiskChunkCache>(deserializer, source.wstring(), 0);
+        auto expected = readChunk(deserializer, 1);
+        auto first = readChunk(cache, 1);
+        BOOST_CHECK(!isCached(first.first));
+        BOOST_CHECK(first.second == expected.second);
+
+        auto second = readChunk(cache, 1);
+        BOOST_CHECK(isCached(second.first));
+        BOOST_CHECK(second.second == expected.second);
+    }
+
+    {
+        // A new instance (e.g. a later job) picks up the cache left by the previous one.
+        auto cache = make_shared<DiskChunkCache>(deserializer, source.wstring(), 0);
+        BOOST_CHECK(isCached(readChunk(cache, 1).first));
+    }
+
+    {
+        // Changing the source invalidates the cache.
+        ofstream sourceFile(source.string(), ios::app);
+        sourceFile << "modified";
+    }
+
+    {
+        auto cache = make_shared<DiskChunkCache>(deserializer, source.wstring(), 0);
+        BOOST_CHECK(!isCached(readChunk(cache, 1).first));
+        BOOST_CHECK(isCached(readChunk(cache, 1).first));
+        readChunk(cache, 2);
+    }
+
+    {
+        // With a budget that fits only one chunk, the least recently used chunk gets evicted.
+        auto chunkFile = [&](ChunkIdType chunkId) { return boost::filesystem::path(cacheDirectory) / (to_string(chunkId) + ".bin"); };
+        auto budget = max(boost::filesystem::file_size(chunkFile(1)), boost::filesystem::file_size(chunkFile(2)));
+        boost::filesystem::remove_all(cacheDirectory);
+
+        auto cache = make_shared<DiskChunkCache>(deserializer, source.wstring(), budget);
+        readChunk(cache, 1);
+        BOOST_CHECK(boost::filesystem::exists(chunkFile(1)));
+        boost::filesystem::last_write_time(chunkFile(1), time(nullptr) - 100);
+
+        readChunk(cache, 2);
+        BOOST_CHECK(!boost::filesystem::exists(chunkFile(1)));
+        BOOST_CHECK(boost::filesystem::exists(chunkFile(2)));
+    }
+
+    boost::filesystem::remove_all(cacheDirectory);
+    boost::filesystem::remove(source);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } } } }
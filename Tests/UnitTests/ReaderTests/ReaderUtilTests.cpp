@@ -10,6 +10,7 @@
 #include "Index.h"
 #include "Platform.h"
 #include "IndexBuilder.h"
+#include "../../../Source/Readers/HTKDeserializers/MLFIndexBuilder.h"
 #include "ReaderUtil.h"
 #include "Common/ReaderTestHelper.h"
 #include <boost/algorithm/string/replace.hpp>
@@ -741,6 +742,122 @@ BOOST_AUTO_TEST_CASE(Index_non_primary)
 }
 
 
+// Same as CheckIdentical above, but compares each sequence of each chunk.
+static void CheckSameSequences(const shared_ptr<Index>& index1, const shared_ptr<Index>& index2)
+{
+    BOOST_REQUIRE(index1);
+    BOOST_REQUIRE(index2);
+    Check(index1, index2->NumberOfChunks(), index2->NumberOfSequences(), index2->NumberOfSamples(), index2->SizeInBytes());
+    for (int i = 0; i < index1->NumberOfChunks(); i++)
+    {
+        auto& chunk1 = (*index1)[i];
+        auto& chunk2 = (*index2)[i];
+        Check(chunk1, chunk2.NumberOfSequences(), chunk2.NumberOfSamples(), chunk2.StartOffset(), chunk2.SizeInBytes());
+        for (int j = 0; j < chunk1.NumberOfSequences(); j++)
+            Check(chunk1[j], chunk2[j].m_key, chunk2[j].NumberOfSamples(), chunk2[j].OffsetInChunk(), chunk2[j].SizeInBytes());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Index_built_in_parallel)
+{
+    // Sequences of varying length (some of which span several lines, do not contain
+    // the main stream or are separated by empty lines) so that the range boundaries 
+    // fall at all sorts of places.
+    string input;
+    for (size_t i = 0; i < 200; i++)
+    {
+        auto id = to_string(i);
+        for (size_t j = 0; j < i % 7; j++)
+            input += id + ((j % 3 == 0) ? "\t|a 1 2 3\n" : "\t|b 4\t|a 5 6 7\n");
+        input += (i % 5 == 0) ? "\n\n" : id + "\t|b 8\n";
+    }
+
+    for (size_t numberOfThreads : { 2, 3, 7, 16, 64 })
+    {
+        for (size_t chunkSize : { (size_t)100, g_32MB })
+        {
+            auto expected = GetIndexBuilder(input)->SetMainStream("a").SetChunkSize(chunkSize).SetNumberOfThreads(1).Build();
+            auto actual = GetIndexBuilder(input)->SetMainStream("a").SetChunkSize(chunkSize).SetNumberOfThreads(numberOfThreads).Build();
+            CheckSameSequences(actual, expected);
+
+            expected = GetIndexBuilder(input)->SetSkipSequenceIds(true).SetMainStream("a").SetChunkSize(chunkSize).SetNumberOfThreads(1).Build();
+            actual = GetIndexBuilder(input)->SetSkipSequenceIds(true).SetMainStream("a").SetChunkSize(chunkSize).SetNumberOfThreads(numberOfThreads).Build();
+            CheckSameSequences(actual, expected);
+
+            expected = GetIndexBuilder(input)->SetCorpus(std::make_shared<CorpusDescriptor>(false, true)).SetChunkSize(chunkSize).SetNumberOfThreads(1).Build();
+            actual = GetIndexBuilder(input)->SetCorpus(std::make_shared<CorpusDescriptor>(false, true)).SetChunkSize(chunkSize).SetNumberOfThreads(numberOfThreads).Build();
+            CheckSameSequences(actual, expected);
+        }
+
+        for (const string& str : { s_textData, string("\n\n  ") + s_textData, string("1\n1\n1\n1\n1 \n2\n\n\n\n3\n\n3\n3\n4 abc\n4 def\nghj\n4") })
+        {
+            auto expected = GetIndexBuilder(str)->SetNumberOfThreads(1).Build();
+            auto actual = GetIndexBuilder(str)->SetNumberOfThreads(numberOfThreads).Build();
+            CheckSameSequences(actual, expected);
+
+            expected = GetIndexBuilder(str)->SetSkipSequenceIds(true).SetNumberOfThreads(1).Build();
+            actual = GetIndexBuilder(str)->SetSkipSequenceIds(true).SetNumberOfThreads(numberOfThreads).Build();
+            CheckSameSequences(actual, expected);
+        }
+    }
+}
+
+static shared_ptr<Index> BuildMLFIndex(const string& input, size_t chunkSize, size_t bufferSize, size_t numberOfThreads)
+{
+    static size_t id = 0;
+    wstring filename = to_wstring(id++) + L".mlf.test.tmp";
+    CreateTestFile(input, filename);
+
+    shared_ptr<Index> index;
+    {
+        auto f = FileWrapper::OpenOrDie(filename, L"rb");
+        // Symbolic keys without hashing get their ids in the order in which the index sees them.
+        MLFIndexBuilder builder(f, make_shared<CorpusDescriptor>(false));
+        index = builder.SetChunkSize(chunkSize).SetBufferSize(bufferSize).SetNumberOfThreads(numberOfThreads).Build();
+    }
+    _wunlink(filename.c_str());
+    return index;
+}
+
+BOOST_AUTO_TEST_CASE(MLF_index_built_in_parallel)
+{
+    // Utterances of varying length, some of them with Windows line endings, an MLF header or empty lines
+    // in front, or without frames, so that the boundaries of the scanned ranges fall at all sorts of places
+    // (inside keys, frames and the terminating dots). Some utterances miss the terminating dot: the key of
+    // the next utterance is then read as a frame, and a range that starts on this key must not index it again.
+    string input = "#!MLF!#\n";
+    for (size_t i = 0; i < 200; i++)
+    {
+        const string eol = (i % 9 == 4) ? "\r\n" : "\n";
+        if (i % 17 == 16)
+            input += "#!MLF!#" + eol;
+        if (i % 11 == 3)
+            input += eol + eol;
+
+        input += ((i % 4 == 0) ? "\"*/utt" : "\"utt") + to_string(i) + ".lab\"" + eol;
+        if (i != 50)
+        {
+            for (size_t j = 0; j <= i % 6; j++)
+                input += to_string(j * 10) + " " + to_string(j * 10 + 10) + " s" + to_string(j) + " " + to_string(j) + eol;
+        }
+        if (i % 23 != 7)
+            input += "." + eol;
+    }
+
+    for (size_t chunkSize : { (size_t)300, g_32MB })
+    {
+        auto expected = BuildMLFIndex(input, chunkSize, 64 * 1024, 1);
+        BOOST_REQUIRE_EQUAL(expected->NumberOfSequences(), (size_t)190);
+
+        for (size_t numberOfThreads : { 2, 3, 7, 16, 64, 256 })
+        {
+            for (size_t bufferSize : { (size_t)7, (size_t)64 * 1024 })
+                CheckSameSequences(BuildMLFIndex(input, chunkSize, bufferSize, numberOfThreads), expected);
+        }
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE(Index_with_caching)
 {
     auto filename = L"test.tmp";
@@ -807,3 +807,12 @@ std::vector<T> CombineVectors(std::initializer_list<std::vector<T>> vs)
 }
 
 MinibatchSourceConfig GetHTKMinibatchSourceConfig(size_t featureDim, size_t numOutputClasses, size_t epochSize = MinibatchSource::InfinitelyRepeat, bool randomize = true);
+
+#ifndef _WIN32
+namespace CNTK { namespace Test {
+// Runs the given action for each worker of a shared memory communicator, each worker in its own thread.
+// Results are checked by the caller on the main thread. Defined in SharedMemoryCommunicatorTests.cpp, where the
+// name is made unique for the test process; also used by the tests of the distributed learners.
+void RunWorkers(const std::wstring& name, size_t numberOfWorkers, size_t bufferSizeInBytes, const std::function<void(DistributedCommunicatorPtr)>& action);
+}}
+#endif
@@ -0,0 +1,309 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Common.h"
+
+using namespace CNTK;
+using namespace std;
+
+namespace CNTK { namespace Test {
+
+#ifndef _WIN32
+
+BOOST_AUTO_TEST_SUITE(DistributedLearnerSuite)
+
+BOOST_AUTO_TEST_CASE(SparsifiedLearnerExchangesLargestEntriesWithErrorFeedback)
+{
+    const size_t numberOfWorkers = 2;
+
+    // Parameters of each worker: one large enough to be sparsified, one that is aggregated densely.
+    vector<Parameter> largeParameters, smallParameters;
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        largeParameters.push_back(Parameter(NDShape{ 8 }, DataType::Float, 0.0, DeviceDescriptor::CPUDevice(), L"large"));
+        smallParameters.push_back(Parameter(NDShape{ 2 }, DataType::Float, 0.0, DeviceDescriptor::CPUDevice(), L"small"));
+    }
+
+    RunWorkers(L"SparsifiedLearnerTest", numberOfWorkers, 64 * 1024, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        auto learner = SGDLearner({ largeParameters[rank], smallParameters[rank] }, TrainingParameterPerSampleSchedule(1.0));
+        auto distributedLearner = CreateSparsifiedDataParallelDistributedLearner(communicator, learner, 0, /*compressionRatio*/ 4);
+
+        for (size_t step = 0; step < 2; ++step)
+        {
+            // Worker 0 has gradient 1..8, worker 1 has gradient 11..18.
+            vector<float> largeGradient(8), smallGradient(2, (float)(rank + 1));
+            for (size_t i = 0; i < largeGradient.size(); ++i)
+                largeGradient[i] = (float)(rank * 10 + i + 1);
+
+            unordered_map<Parameter, NDArrayViewPtr> gradients;
+            gradients[largeParameters[rank]] = MakeSharedObject<NDArrayView>(NDShape{ 8 }, largeGradient)->DeepClone();
+            gradients[smallParameters[rank]] = MakeSharedObject<NDArrayView>(NDShape{ 2 }, smallGradient)->DeepClone();
+
+            MinibatchInfo info{ false, false, 1,
+                MakeSharedObject<NDArrayView>(0.0, NDShape{}, DeviceDescriptor::CPUDevice()),
+                MakeSharedObject<NDArrayView>(0.0, NDShape{}, DeviceDescriptor::CPUDevice()) };
+            distributedLearner->Update(gradients, info);
+        }
+    });
+
+    // The first step exchanges the entries 6 and 7 (7 + 17, 8 + 18); the second one the entries 5 and 4 of
+    // the residuals (2 * 6 + 2 * 16, 2 * 5 + 2 * 15). The small gradient is summed densely in both steps.
+    const vector<float> expectedLarge = { 0, 0, 0, 0, -40, -44, -24, -26 };
+    const vector<float> expectedSmall = { -6, -6 };
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        for (size_t i = 0; i < expectedLarge.size(); ++i)
+            BOOST_REQUIRE_EQUAL(largeParameters[rank].Value()->DataBuffer<float>()[i], expectedLarge[i]);
+
+        for (size_t i = 0; i < expectedSmall.size(); ++i)
+            BOOST_REQUIRE_EQUAL(smallParameters[rank].Value()->DataBuffer<float>()[i], expectedSmall[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ShardedLearnerMatchesLearnerOnAggregatedGradients)
+{
+    const size_t numberOfWorkers = 2;
+    const size_t numberOfSteps = 3;
+    const vector<size_t> sizes = { 8, 2, 5 };
+
+    auto createLearner = [](const vector<Parameter>& parameters)
+    {
+        return MomentumSGDLearner(parameters, LearningRateSchedule(0.1), MomentumSchedule(0.9));
+    };
+
+    // Worker r has the gradient (r + 1) * (step + i + 1) for the element i of each parameter.
+    auto gradientValue = [](size_t rank, size_t step, size_t i) { return (float)((rank + 1) * (step + i + 1)); };
+
+    auto createParameters = [&sizes]()
+    {
+        vector<Parameter> parameters;
+        for (auto size : sizes)
+            parameters.push_back(Parameter(NDShape{ size }, DataType::Float, 1.0, DeviceDescriptor::CPUDevice()));
+        return parameters;
+    };
+
+    // The reference learner is updated with the sum of the gradients of all workers.
+    auto referenceParameters = createParameters();
+    auto referenceLearner = createLearner(referenceParameters);
+    for (size_t step = 0; step < numberOfSteps; ++step)
+    {
+        unordered_map<Parameter, NDArrayViewPtr> gradients;
+        for (const auto& parameter : referenceParameters)
+        {
+            vector<float> gradient(parameter.Shape().TotalSize());
+            for (size_t i = 0; i < gradient.size(); ++i)
+                for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+                    gradient[i] += gradientValue(rank, step, i);
+            gradients[parameter] = MakeSharedObject<NDArrayView>(parameter.Shape(), gradient)->DeepClone();
+        }
+        referenceLearner->Update(gradients, numberOfWorkers, /*sweepEnd*/ false);
+    }
+
+    vector<vector<Parameter>> parameters;
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+        parameters.push_back(createParameters());
+
+    // Boost assertions are not thread safe, the workers record what is checked after they are joined.
+    vector<size_t> numberOfParameters(numberOfWorkers);
+    vector<vector<size_t>> numberOfSamples(numberOfWorkers);
+
+    Dictionary checkpoint;
+    RunWorkers(L"ShardedLearnerTest", numberOfWorkers, 64 * 1024, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        auto distributedLearner = CreateShardedDataParallelDistributedLearner(communicator, parameters[rank], createLearner);
+        numberOfParameters[rank] = distributedLearner->Parameters().size();
+
+        for (size_t step = 0; step < numberOfSteps; ++step)
+        {
+            // The last step is done by a new learner restored from the checkpoint written by the main worker.
+            if (step == numberOfSteps - 1)
+            {
+                auto state = distributedLearner->CreateCheckpoint();
+                if (rank == 0)
+                    checkpoint = state;
+                communicator->Barrier();
+
+                distributedLearner = CreateShardedDataParallelDistributedLearner(communicator, parameters[rank], createLearner);
+                distributedLearner->RestoreFromCheckpoint(checkpoint);
+            }
+
+            unordered_map<Parameter, NDArrayViewPtr> gradients;
+            for (const auto& parameter : parameters[rank])
+            {
+                vector<float> gradient(parameter.Shape().TotalSize());
+                for (size_t i = 0; i < gradient.size(); ++i)
+                    gradient[i] = gradientValue(rank, step, i);
+                gradients[parameter] = MakeSharedObject<NDArrayView>(parameter.Shape(), gradient)->DeepClone();
+            }
+
+            MinibatchInfo info{ false, false, 1,
+                MakeSharedObject<NDArrayView>(0.0, NDShape{}, DeviceDescriptor::CPUDevice()),
+                MakeSharedObject<NDArrayView>(0.0, NDShape{}, DeviceDescriptor::CPUDevice()) };
+            distributedLearner->Update(gradients, info);
+            numberOfSamples[rank].push_back(info.numberOfSamples);
+        }
+    });
+
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        BOOST_REQUIRE_EQUAL(numberOfParameters[rank], sizes.size());
+        BOOST_REQUIRE_EQUAL(numberOfSamples[rank].size(), numberOfSteps);
+        for (auto samples : numberOfSamples[rank])
+            BOOST_REQUIRE_EQUAL(samples, numberOfWorkers);
+
+        for (size_t p = 0; p < sizes.size(); ++p)
+        {
+            auto expected = referenceParameters[p].Value()->DataBuffer<float>();
+            auto actual = parameters[rank][p].Value()->DataBuffer<float>();
+            for (size_t i = 0; i < sizes[p]; ++i)
+                BOOST_REQUIRE_SMALL(actual[i] - expected[i], 1e-4f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BucketedAggregationMatchesUnbucketedAggregation)
+{
+    const size_t numberOfWorkers = 2;
+    const size_t numberOfSteps = 4;
+    const size_t numberOfLayers = 3;
+    const size_t inputDim = 4;
+    const size_t hiddenDim = 16;
+    const size_t minibatchSize = 5;
+
+    // Trains the same network on each worker with a data parallel learner, and returns the parameter values of each worker
+    // after the last step, together with the overlap efficiency of the last step.
+    auto train = [&](size_t bucketSizeInBytes, vector<double>& overlapEfficiency)
+    {
+        vector<Variable> inputs, labels;
+        vector<FunctionPtr> models, losses;
+        for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+        {
+            inputs.push_back(InputVariable({ inputDim }, DataType::Float, L"input"));
+            labels.push_back(InputVariable({ 1 }, DataType::Float, L"labels"));
+
+            FunctionPtr layer = inputs.back();
+            for (size_t i = 0; i < numberOfLayers; ++i)
+            {
+                auto outputDim = (i == numberOfLayers - 1) ? 1 : hiddenDim;
+                auto weights = Parameter(NDArrayView::RandomUniform<float>({ outputDim, layer->Output().Shape()[0] }, -0.5, 0.5, (unsigned long)(i + 1), DeviceDescriptor::CPUDevice()));
+                auto bias = Parameter({ outputDim }, DataType::Float, 0.1, DeviceDescriptor::CPUDevice());
+                layer = Tanh(Plus(Times(weights, layer), bias));
+            }
+            models.push_back(layer);
+            losses.push_back(SquaredError(layer, labels.back()));
+        }
+
+        // The learners take the bucket size when they are created.
+        Internal::SetGradientAggregationBucketSizeInBytes(bucketSizeInBytes);
+        vector<vector<vector<float>>> values(numberOfWorkers);
+        RunWorkers(L"BucketedAggregationTest", numberOfWorkers, 64 * 1024, [&](DistributedCommunicatorPtr communicator)
+        {
+            auto rank = communicator->CurrentWorker().m_globalRank;
+            auto learner = CreateDataParallelDistributedLearner(communicator, SGDLearner(models[rank]->Parameters(), TrainingParameterPerSampleSchedule(0.05)), 0);
+            auto trainer = CreateTrainer(models[rank], losses[rank], { learner });
+
+            // Each worker gets its own data.
+            for (size_t step = 0; step < numberOfSteps; ++step)
+            {
+                vector<float> inputData(minibatchSize * inputDim), labelData(minibatchSize);
+                for (size_t i = 0; i < inputData.size(); ++i)
+                    inputData[i] = (float)((rank * 7 + step * 3 + i) % 11) / 11 - 0.5f;
+                for (size_t i = 0; i < labelData.size(); ++i)
+                    labelData[i] = (float)((rank + step + i) % 3) / 3;
+
+                trainer->TrainMinibatch({ { inputs[rank], Value::CreateBatch(NDShape{ inputDim }, inputData, DeviceDescriptor::CPUDevice()) },
+                                          { labels[rank], Value::CreateBatch(NDShape{ 1 }, labelData, DeviceDescriptor::CPUDevice()) } }, DeviceDescriptor::CPUDevice());
+            }
+
+            for (const auto& parameter : models[rank]->Parameters())
+            {
+                auto data = parameter.Value()->DataBuffer<float>();
+                values[rank].emplace_back(data, data + parameter.Shape().TotalSize());
+            }
+            overlapEfficiency[rank] = learner->LastOverlapEfficiency();
+        });
+        Internal::SetGradientAggregationBucketSizeInBytes(0);
+
+        return values;
+    };
+
+    // Buckets of about one layer, after the first step (which records the layout) they are aggregated during backpropagation.
+    vector<double> bucketedEfficiency(numberOfWorkers), unbucketedEfficiency(numberOfWorkers);
+    auto bucketed = train(hiddenDim * hiddenDim * sizeof(float), bucketedEfficiency);
+    auto unbucketed = train(0, unbucketedEfficiency);
+
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        BOOST_TEST(unbucketedEfficiency[rank] == 0);
+        BOOST_TEST(bucketedEfficiency[rank] >= 0);
+        BOOST_TEST(bucketedEfficiency[rank] <= 1);
+
+        BOOST_REQUIRE_EQUAL(bucketed[rank].size(), 2 * numberOfLayers);
+        BOOST_REQUIRE_EQUAL(unbucketed[rank].size(), 2 * numberOfLayers);
+        for (size_t p = 0; p < bucketed[rank].size(); ++p)
+        {
+            BOOST_REQUIRE_EQUAL(bucketed[rank][p].size(), unbucketed[rank][p].size());
+            for (size_t i = 0; i < bucketed[rank][p].size(); ++i)
+            {
+                BOOST_REQUIRE_SMALL(bucketed[rank][p][i] - unbucketed[rank][p][i], 1e-6f);
+                BOOST_REQUIRE_SMALL(bucketed[rank][p][i] - bucketed[0][p][i], 1e-6f);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TrainerFailsOnAllWorkersWhenWritingACheckpointFailed)
+{
+    const size_t numberOfWorkers = 2;
+
+    // The checkpoint is to be written below a regular file, which makes the main worker fail to write it in the background.
+    auto blockingFile = "TrainerCheckpointFailureTest_" + to_string(getpid());
+    ofstream(blockingFile).put('x');
+    auto modelFile = wstring(blockingFile.begin(), blockingFile.end()) + L"/checkpoint.model";
+
+    vector<FunctionPtr> models, losses;
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        auto input = InputVariable({ 2 }, DataType::Float, L"input");
+        auto labels = InputVariable({ 1 }, DataType::Float, L"labels");
+        auto model = Times(Parameter(NDShape{ 1, 2 }, DataType::Float, 0.0, DeviceDescriptor::CPUDevice(), L"weights"), input);
+        models.push_back(model);
+        losses.push_back(SquaredError(model, labels));
+    }
+
+    vector<int> failed(numberOfWorkers);
+    RunWorkers(L"CheckpointFailureTest", numberOfWorkers, 64 * 1024, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        auto learner = SGDLearner(models[rank]->Parameters(), TrainingParameterPerSampleSchedule(0.1));
+        auto trainer = CreateTrainer(models[rank], losses[rank], { CreateDataParallelDistributedLearner(communicator, learner, 0) });
+
+        trainer->SaveCheckpointAsync(modelFile);
+
+        // The next checkpoint waits for the previous one; the worker that did not write it must fail as well, rather
+        // than wait for the main worker forever.
+        try
+        {
+            trainer->SaveCheckpoint(modelFile);
+        }
+        catch (const exception&)
+        {
+            failed[rank] = 1;
+        }
+    });
+
+    remove(blockingFile.c_str());
+    BOOST_TEST(failed == vector<int>({ 1, 1 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
+
+}}
@@ -450,6 +450,245 @@ void TestTimesReduceSequenceAxis(
     }
 }
 
+void TestContiguousParameterStorage(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 5;
+    const size_t hiddenDim = 4;
+    const size_t numOutputClasses = 3;
+    const size_t minibatchSize = 2;
+    const size_t numMinibatches = 3;
+
+    std::vector<float> featuresData(inputDim * minibatchSize);
+    for (size_t i = 0; i < featuresData.size(); ++i)
+        featuresData[i] = (float)((int)(i % 7) - 3) / 4;
+
+    std::vector<float> labelsData(numOutputClasses * minibatchSize, 0);
+    for (size_t i = 0; i < minibatchSize; ++i)
+        labelsData[(i * numOutputClasses) + (i % numOutputClasses)] = 1;
+
+    // Trains the same model with or without contiguous parameter storage. Returns the parameter values and the output of
+    // a network that was compiled before the training, which has to see the values in the contiguous storage as well.
+    auto train = [&](bool useContiguousStorage, std::vector<std::vector<float>>& parameterValues, std::vector<float>& outputData)
+    {
+        auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+        auto labels = InputVariable({ numOutputClasses }, DataType::Float, L"labels");
+
+        auto W1 = Parameter(NDArrayView::RandomUniform<float>({ hiddenDim, inputDim }, -0.5, 0.5, 1, device), L"W1");
+        auto b1 = Parameter({ hiddenDim }, DataType::Float, 0.1, device, L"b1");
+        auto W2 = Parameter(NDArrayView::RandomUniform<float>({ numOutputClasses, hiddenDim }, -0.5, 0.5, 2, device), L"W2");
+        auto b2 = Parameter({ numOutputClasses }, DataType::Float, -0.1, device, L"b2");
+        auto classifierOutput = Plus(Times(W2, Tanh(Plus(Times(W1, input), b1))), b2, L"classifierOutput");
+        auto trainingLoss = CrossEntropyWithSoftmax(classifierOutput, labels, L"lossFunction");
+        auto prediction = ClassificationError(classifierOutput, labels, L"classificationError");
+
+        auto featuresValue = Value::CreateBatch(NDShape({ inputDim }), featuresData, device, true);
+        auto labelsValue = Value::CreateBatch(NDShape({ numOutputClasses }), labelsData, device, true);
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { classifierOutput->Output(), nullptr } };
+        classifierOutput->Forward({ { input, featuresValue } }, outputs, device);
+
+        if (useContiguousStorage)
+            Internal::EnableContiguousParameterStorage();
+
+        auto learner = SGDLearner(classifierOutput->Parameters(), TrainingParameterPerSampleSchedule(0.5));
+        auto trainer = CreateTrainer(classifierOutput, trainingLoss, prediction, { learner });
+        for (size_t i = 0; i < numMinibatches; ++i)
+            trainer->TrainMinibatch({ { input, featuresValue }, { labels, labelsValue } }, device);
+
+        Internal::DisableContiguousParameterStorage();
+
+        outputs = { { classifierOutput->Output(), nullptr } };
+        classifierOutput->Forward({ { input, featuresValue } }, outputs, device);
+        auto outputValue = outputs[classifierOutput->Output()]->Data()->DeepClone(DeviceDescriptor::CPUDevice());
+        outputData.assign(outputValue->DataBuffer<float>(), outputValue->DataBuffer<float>() + outputValue->Shape().TotalSize());
+
+        parameterValues.clear();
+        std::vector<std::pair<const float*, size_t>> buffers;
+        for (auto& parameter : { W1, b1, W2, b2 })
+        {
+            auto value = parameter.Value()->DeepClone(DeviceDescriptor::CPUDevice());
+            parameterValues.push_back(std::vector<float>(value->DataBuffer<float>(), value->DataBuffer<float>() + value->Shape().TotalSize()));
+            buffers.push_back({ parameter.Value()->DataBuffer<float>(), parameter.Shape().TotalSize() });
+        }
+
+        // In the contiguous storage the parameter values are adjacent.
+        std::sort(buffers.begin(), buffers.end());
+        bool areAdjacent = true;
+        for (size_t i = 1; i < buffers.size(); ++i)
+            areAdjacent &= (buffers[i - 1].first + buffers[i - 1].second == buffers[i].first);
+
+        BOOST_REQUIRE(areAdjacent == useContiguousStorage);
+    };
+
+    std::vector<std::vector<float>> expectedParameterValues, parameterValues;
+    std::vector<float> expectedOutputData, outputData;
+    train(false, expectedParameterValues, expectedOutputData);
+    train(true, parameterValues, outputData);
+
+    for (size_t i = 0; i < parameterValues.size(); ++i)
+        FloatingPointVectorCompare(parameterValues[i], expectedParameterValues[i], "Parameters trained in the contiguous storage do not match the expected values");
+
+    FloatingPointVectorCompare(outputData, expectedOutputData, "Output of a network compiled before the Parameters were moved does not match the expected values");
+}
+
+// Records the gradients passed to it, in the order of the Uids of their Parameters in which the distributed learners aggregate them.
+class GradientRecordingLearner : public Learner
+{
+public:
+    explicit GradientRecordingLearner(const std::vector<Parameter>& parameters)
+        : Learner(parameters, TrainingParameterPerSampleSchedule(0.0))
+    {}
+
+    bool Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t /*trainingSampleCount*/, bool /*sweepEnd*/) override
+    {
+        std::vector<std::pair<Parameter, NDArrayViewPtr>> orderedGradients(gradientValues.begin(), gradientValues.end());
+        std::sort(orderedGradients.begin(), orderedGradients.end(),
+            [](const std::pair<Parameter, NDArrayViewPtr>& a, const std::pair<Parameter, NDArrayViewPtr>& b) { return a.first.Uid() < b.first.Uid(); });
+
+        m_gradients.clear();
+        for (const auto& gradient : orderedGradients)
+            m_gradients.push_back(gradient.second);
+        return true;
+    }
+
+    void ResetSmoothedGradients() override {}
+
+    std::vector<NDArrayViewPtr> m_gradients;
+};
+
+void TestContiguousParameterStorageCoalescesGradients(const DeviceDescriptor& device)
+{
+    const size_t dim = 3;
+    const size_t numLayers = 6;
+    const size_t minibatchSize = 2;
+
+    // Parameters() lists these Parameters in the order in which the graph is traversed from the output, which differs from the
+    // order of their Uids; with more than ten of them the Uids may also sort differently as strings than they were created.
+    auto input = InputVariable({ dim }, DataType::Float, L"features");
+    auto labels = InputVariable({ dim }, DataType::Float, L"labels");
+    FunctionPtr model = input;
+    for (size_t i = 0; i < numLayers; ++i)
+    {
+        auto W = Parameter(NDArrayView::RandomUniform<float>({ dim, dim }, -0.5, 0.5, (unsigned long)i + 1, device));
+        auto b = Parameter({ dim }, DataType::Float, 0.1, device);
+        model = Tanh(Plus(Times(W, model), b));
+    }
+
+    auto trainingLoss = CrossEntropyWithSoftmax(model, labels, L"lossFunction");
+    auto prediction = ClassificationError(model, labels, L"classificationError");
+
+    std::vector<float> featuresData(dim * minibatchSize, 0.5f);
+    std::vector<float> labelsData(dim * minibatchSize, 0);
+    for (size_t i = 0; i < minibatchSize; ++i)
+        labelsData[(i * dim) + i] = 1;
+
+    auto featuresValue = Value::CreateBatch(NDShape({ dim }), featuresData, device, true);
+    auto labelsValue = Value::CreateBatch(NDShape({ dim }), labelsData, device, true);
+
+    Internal::EnableContiguousParameterStorage();
+
+    auto learner = std::make_shared<GradientRecordingLearner>(model->Parameters());
+    auto trainer = CreateTrainer(model, trainingLoss, prediction, { learner });
+    trainer->TrainMinibatch({ { input, featuresValue }, { labels, labelsValue } }, device);
+    auto coalescedGradients = Internal::CoalesceContiguousValues(learner->m_gradients);
+
+    Internal::DisableContiguousParameterStorage();
+
+    // The gradients are consecutive slices of the storage in the order in which they are aggregated: one run, one allreduce.
+    BOOST_REQUIRE_EQUAL(learner->m_gradients.size(), 2 * numLayers);
+    BOOST_REQUIRE_EQUAL(coalescedGradients.size(), 1);
+    BOOST_REQUIRE_EQUAL(coalescedGradients.front()->Shape().TotalSize(), numLayers * (dim * dim + dim));
+}
+
+// Sets the inference-only memory mode of the library for the lifetime of the object,
+// and restores the previous mode when it goes out of scope, also if the test throws.
+class ScopedInferenceOnlyMemoryMode
+{
+public:
+    explicit ScopedInferenceOnlyMemoryMode(bool enable)
+        : m_wasEnabled(Internal::IsInferenceOnlyMemoryModeEnabled())
+    {
+        SetMode(enable);
+    }
+
+    ~ScopedInferenceOnlyMemoryMode()
+    {
+        SetMode(m_wasEnabled);
+    }
+
+    ScopedInferenceOnlyMemoryMode(const ScopedInferenceOnlyMemoryMode&) = delete;
+    ScopedInferenceOnlyMemoryMode& operator=(const ScopedInferenceOnlyMemoryMode&) = delete;
+
+private:
+    static void SetMode(bool enable)
+    {
+        if (enable)
+            Internal::EnableInferenceOnlyMemoryMode();
+        else
+            Internal::DisableInferenceOnlyMemoryMode();
+    }
+
+    bool m_wasEnabled;
+};
+
+void TestInferenceOnlyMemoryMode(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 20;
+    const size_t numOutputClasses = 100;
+    const size_t minibatchSize = 16;
+
+    std::vector<float> featuresData(inputDim * minibatchSize);
+    for (size_t i = 0; i < featuresData.size(); ++i)
+        featuresData[i] = (float)((int)(i % 7) - 3) / 4;
+
+    std::vector<float> labelsData(numOutputClasses * minibatchSize, 0);
+    for (size_t i = 0; i < minibatchSize; ++i)
+        labelsData[(i * numOutputClasses) + (i % numOutputClasses)] = 1;
+
+    auto featuresValue = Value::CreateBatch(NDShape({ inputDim }), featuresData, device, true);
+    auto labelsValue = Value::CreateBatch(NDShape({ numOutputClasses }), labelsData, device, true);
+
+    // The criterion nodes keep the softmax of their input for the backward pass. Only in the inference-only mode the
+    // second one can reuse the memory of the first.
+    auto evaluate = [&](bool inferenceOnly, std::vector<float>& outputData)
+    {
+        auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+        auto labels = InputVariable({ numOutputClasses }, DataType::Float, L"labels");
+        auto W = Parameter(NDArrayView::RandomUniform<float>({ numOutputClasses, inputDim }, -0.5, 0.5, 1, device), L"W");
+        auto z = Times(W, input);
+        auto firstLoss = CrossEntropyWithSoftmax(z, labels);
+        auto secondLoss = CrossEntropyWithSoftmax(Plus(z, firstLoss), labels);
+        auto model = Plus(secondLoss, Constant::Scalar(1.0f, device), L"output");
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { model->Output(), nullptr } };
+        {
+            ScopedInferenceOnlyMemoryMode inferenceOnlyMemoryMode(inferenceOnly);
+            model->Forward({ { input, featuresValue }, { labels, labelsValue } }, outputs, device);
+        }
+
+        auto outputValue = outputs[model->Output()]->Data()->DeepClone(DeviceDescriptor::CPUDevice());
+        outputData.assign(outputValue->DataBuffer<float>(), outputValue->DataBuffer<float>() + outputValue->Shape().TotalSize());
+        auto activationMemory = Internal::GetActivationMemoryInBytes(model);
+
+        // Retaining the backward state recompiles the inference-only network for training.
+        outputs = { { model->Output(), nullptr } };
+        auto backPropState = model->Forward({ { input, featuresValue }, { labels, labelsValue } }, outputs, device, { model->Output() });
+        std::unordered_map<Variable, ValuePtr> gradients = { { W, nullptr } };
+        model->Backward(backPropState, { { model->Output(), MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(1.0f, outputs[model->Output()]->Shape(), device)) } }, gradients);
+        BOOST_TEST(gradients[W] != nullptr);
+
+        return activationMemory;
+    };
+
+    std::vector<float> expectedOutputData, outputData;
+    auto expectedActivationMemory = evaluate(false, expectedOutputData);
+    auto activationMemory = evaluate(true, outputData);
+
+    FloatingPointVectorCompare(outputData, expectedOutputData, "Output in the inference-only memory mode does not match the expected values");
+    BOOST_TEST(activationMemory > 0);
+    BOOST_TEST(activationMemory < expectedActivationMemory);
+}
+
 BOOST_AUTO_TEST_SUITE(FeedForwardSuite)
 
 BOOST_AUTO_TEST_CASE(FFTimesAndPlusInCPU)
@@ -501,6 +740,33 @@ BOOST_AUTO_TEST_CASE(FFNetworkCreationInGPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ContiguousParameterStorage)
+{
+    if (ShouldRunOnCpu())
+        TestContiguousParameterStorage(DeviceDescriptor::CPUDevice());
+
+    if (ShouldRunOnGpu())
+        TestContiguousParameterStorage(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(ContiguousParameterStorageCoalescesGradients)
+{
+    if (ShouldRunOnCpu())
+        TestContiguousParameterStorageCoalescesGradients(DeviceDescriptor::CPUDevice());
+
+    if (ShouldRunOnGpu())
+        TestContiguousParameterStorageCoalescesGradients(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(InferenceOnlyMemoryMode)
+{
+    if (ShouldRunOnCpu())
+        TestInferenceOnlyMemoryMode(DeviceDescriptor::CPUDevice());
+
+    if (ShouldRunOnGpu())
+        TestInferenceOnlyMemoryMode(DeviceDescriptor::GPUDevice(0));
+}
+
 BOOST_AUTO_TEST_CASE(FFNetworkCreationInCPU)
 {
     if (ShouldRunOnCpu())
@@ -141,6 +141,122 @@ void TestUniversalLearner(size_t numParameters, size_t numMinibatches, const Dev
 
 }
 
+// Updates two copies of the same parameters with and without the fused update and compares the results.
+template <typename ElementType>
+void TestFusedUpdate(const function<LearnerPtr(const vector<Parameter>&)>& createLearner, size_t numMinibatches)
+{
+    auto device = DeviceDescriptor::CPUDevice();
+
+    // Many small parameters and one that is split into several segments.
+    vector<NDShape> shapes = { { 3, 4 }, { 7 }, { 1 }, { 5, 2, 3 }, { 200, 300 } };
+    vector<Parameter> parameters, fusedParameters;
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        auto value = NDArrayView::RandomUniform<ElementType>(shapes[i], -1.0, 1.0, (unsigned long)i, device);
+        parameters.push_back(Parameter(value->DeepClone(), L"parameter_" + to_wstring(i)));
+        fusedParameters.push_back(Parameter(value->DeepClone(), L"fused_parameter_" + to_wstring(i)));
+    }
+
+    auto learner = createLearner(parameters);
+    auto fusedLearner = createLearner(fusedParameters);
+    fusedLearner->SetFusedUpdate(true);
+
+    for (size_t minibatch = 0; minibatch < numMinibatches; minibatch++)
+    {
+        unordered_map<Parameter, NDArrayViewPtr> gradientValues, fusedGradientValues;
+        for (size_t i = 0; i < shapes.size(); i++)
+        {
+            auto gradient = NDArrayView::RandomUniform<ElementType>(shapes[i], -2.0, 2.0, (unsigned long)(100 * minibatch + i), device);
+            gradientValues[parameters[i]] = gradient->DeepClone();
+            fusedGradientValues[fusedParameters[i]] = gradient->DeepClone();
+        }
+
+        size_t minibatchSize = 1 + minibatch % 3;
+        learner->Update(gradientValues, minibatchSize, false);
+        fusedLearner->Update(fusedGradientValues, minibatchSize, false);
+    }
+
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        auto size = shapes[i].TotalSize();
+        const ElementType* value = parameters[i].Value()->DataBuffer<ElementType>();
+        const ElementType* fusedValue = fusedParameters[i].Value()->DataBuffer<ElementType>();
+        RequireClose(vector<ElementType>(fusedValue, fusedValue + size), vector<ElementType>(value, value + size), (ElementType)1e-5, (ElementType)1e-6);
+    }
+}
+
+// Returns the smoothed gradients in the checkpoint of a learner with a single parameter.
+template <typename ElementType>
+vector<ElementType> CheckpointedSmoothedGradients(const LearnerPtr& learner)
+{
+    auto checkpoint = learner->CreateCheckpoint();
+    const auto& smoothedGradients = checkpoint[L"smoothed_gradients"].Value<vector<DictionaryValue>>();
+    BOOST_REQUIRE_EQUAL(smoothedGradients.size(), 1);
+    const auto& smoothedGradient = smoothedGradients[0].Value<NDArrayView>();
+    const ElementType* data = smoothedGradient.DataBuffer<ElementType>();
+    return vector<ElementType>(data, data + smoothedGradient.Shape().TotalSize());
+}
+
+// Trains an embedding with the lazy sparse update, and a copy of it with the dense update on the same gradients.
+// The columns of the embedding skip several minibatches; once the checkpoint has flushed the pending decay,
+// the smoothed gradients of both learners are the same.
+template <typename ElementType>
+void TestLazySparseUpdate(const function<LearnerPtr(const vector<Parameter>&)>& createLearner)
+{
+    auto device = DeviceDescriptor::CPUDevice();
+    const size_t vocabularySize = 6;
+    const size_t embeddingDim = 3;
+
+    // The one-hot samples of each minibatch: column 0 skips three minibatches, column 5 is never looked up.
+    // The checkpoint is created after the fifth minibatch, the last one checks that the flush has reset the timestamps.
+    const vector<vector<size_t>> minibatches = { { 0, 1 }, { 2, 3 }, { 2, 3 }, { 1, 4 }, { 0, 4 }, { 0, 2 } };
+    const size_t checkpointMinibatch = 4;
+
+    auto input = InputVariable({ vocabularySize }, /*isSparse =*/ true, AsDataType<ElementType>(), L"input");
+    auto initialValue = NDArrayView::RandomUniform<ElementType>({ embeddingDim, vocabularySize }, -1.0, 1.0, 1, device);
+    Parameter lazyEmbedding(initialValue->DeepClone(), L"lazyEmbedding");
+    Parameter embedding(initialValue->DeepClone(), L"embedding");
+    auto lazyOutput = Times(lazyEmbedding, input);
+
+    auto lazyLearner = createLearner({ lazyEmbedding });
+    lazyLearner->SetLazySparseUpdate(true);
+    auto learner = createLearner({ embedding });
+
+    for (size_t i = 0; i < minibatches.size(); i++)
+    {
+        vector<vector<size_t>> sequences;
+        for (auto index : minibatches[i])
+            sequences.push_back({ index });
+        auto inputValue = Value::Create<ElementType>({ vocabularySize }, sequences, {}, device, true);
+
+        unordered_map<Variable, ValuePtr> outputs = { { lazyOutput->Output(), nullptr } };
+        auto backpropState = lazyOutput->Forward({ { input, inputValue } }, outputs, device, { lazyOutput->Output() });
+        auto rootGradientValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(ElementType(1), outputs[lazyOutput->Output()]->Shape(), device));
+        unordered_map<Variable, ValuePtr> gradients = { { lazyEmbedding, nullptr } };
+        lazyOutput->Backward(backpropState, { { lazyOutput->Output(), rootGradientValue } }, gradients);
+
+        // The gradient of an embedding is block sparse, the reference learner gets a dense copy of it.
+        auto sparseGradient = gradients[lazyEmbedding]->Data();
+        BOOST_REQUIRE(sparseGradient->GetStorageFormat() == StorageFormat::SparseBlockCol);
+        auto denseGradient = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), embedding.Shape(), device);
+        denseGradient->CopyFrom(*sparseGradient);
+
+        unordered_map<Parameter, NDArrayViewPtr> lazyGradientValues = { { lazyEmbedding, sparseGradient } };
+        unordered_map<Parameter, NDArrayViewPtr> gradientValues = { { embedding, denseGradient } };
+        lazyLearner->Update(lazyGradientValues, minibatches[i].size(), false);
+        learner->Update(gradientValues, minibatches[i].size(), false);
+
+        if (i == checkpointMinibatch || i + 1 == minibatches.size())
+            RequireClose(CheckpointedSmoothedGradients<ElementType>(lazyLearner), CheckpointedSmoothedGradients<ElementType>(learner), (ElementType)1e-5, (ElementType)1e-6);
+    }
+
+    // The column that is never looked up keeps its initial value.
+    const ElementType* initial = initialValue->template DataBuffer<ElementType>();
+    const ElementType* value = lazyEmbedding.Value()->DataBuffer<ElementType>();
+    for (size_t row = 0; row < embeddingDim; row++)
+        BOOST_REQUIRE_EQUAL(value[(vocabularySize - 1) * embeddingDim + row], initial[(vocabularySize - 1) * embeddingDim + row]);
+}
+
 void TestTrainingParametersSchedule()
 {
     LearningRateSchedule schedule1(0.5, 1);
@@ -477,6 +593,75 @@ BOOST_AUTO_TEST_CASE(CreateAndUpdateAdamaxLearner)
     }
 }
 
+BOOST_AUTO_TEST_CASE(FusedUpdateMatchesPerParameterUpdate)
+{
+    if (!ShouldRunOnCpu())
+        return;
+
+    AdditionalLearningOptions options;
+    options.l1RegularizationWeight = 0.001;
+    options.l2RegularizationWeight = 0.01;
+    options.gradientClippingThresholdPerSample = 1.5;
+    options.gradientClippingWithTruncation = true;
+
+    const size_t numFusedMinibatches = 5;
+    for (auto gain : unitGain)
+    {
+        TestFusedUpdate<float>([&](const vector<Parameter>& parameters)
+        {
+            return SGDLearner(parameters, TrainingParameterPerSampleSchedule(0.1), options);
+        }, numFusedMinibatches);
+
+        TestFusedUpdate<double>([&](const vector<Parameter>& parameters)
+        {
+            return MomentumSGDLearner(parameters, LearningRateSchedule({ 0.1, 0.05 }, 2), MomentumSchedule({ 0.0, 0.9, 1.0 }, 2), gain, options);
+        }, numFusedMinibatches);
+
+        TestFusedUpdate<float>([&](const vector<Parameter>& parameters)
+        {
+            return NesterovLearner(parameters, TrainingParameterPerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(10), gain, options);
+        }, numFusedMinibatches);
+
+        for (auto adamax : { false, true })
+        {
+            TestFusedUpdate<float>([&](const vector<Parameter>& parameters)
+            {
+                auto learner = AdamLearner(parameters, LearningRateSchedule(0.01), MomentumSchedule(0.9), gain, MomentumSchedule(0.999), 1e-8, adamax, options);
+                learner->SetMinibatchSize(Learner::IgnoredMinibatchSize);
+                return learner;
+            }, numFusedMinibatches);
+        }
+
+        // Learners without a fused update rule update their parameters one by one.
+        TestFusedUpdate<double>([&](const vector<Parameter>& parameters)
+        {
+            return FSAdaGradLearner(parameters, TrainingParameterPerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(10), gain, MomentumAsTimeConstantSchedule(100), options);
+        }, numFusedMinibatches);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LazySparseUpdateMatchesDenseUpdateAtCheckpoint)
+{
+    if (!ShouldRunOnCpu())
+        return;
+
+    for (auto gain : unitGain)
+    {
+        TestLazySparseUpdate<float>([&](const vector<Parameter>& parameters)
+        {
+            return MomentumSGDLearner(parameters, LearningRateSchedule(0.1), MomentumSchedule(0.9), gain);
+        });
+
+        for (auto adamax : { false, true })
+        {
+            TestLazySparseUpdate<double>([&](const vector<Parameter>& parameters)
+            {
+                return AdamLearner(parameters, LearningRateSchedule(0.01), MomentumSchedule(0.9), gain, MomentumSchedule(0.999), 1e-8, adamax);
+            });
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(TestResettingLearningRate)
 {
     NDShape shape = { 1 };
@@ -7,6 +7,7 @@
 #include <functional>
 #include "Common.h"
 #include <numeric>
+#include <thread>
 #include "CNTKLibraryC.h"
 
 using namespace CNTK;
@@ -377,6 +378,215 @@ void TestSimpleRecurrence(size_t inputDim,
     }
 }
 
+// Evaluates numRequests requests for the input of model on numThreads threads, thread t taking the requests t, t + numThreads, ...,
+// and compares the results with those of evaluating each request alone on the model. The requests have up to 3 sequences of
+// different lengths, so that batches of them need padding, and are created on requestDevice. createEvaluator is called once on
+// each thread and returns the function that evaluates a request there, returning the value of an output laid out like the output
+// of model; an exception thrown on a thread is rethrown after all threads have been joined.
+void TestConcurrentEvaluation(const FunctionPtr& model, const Variable& input, size_t numRequests, size_t numThreads, const DeviceDescriptor& requestDevice,
+                              const DeviceDescriptor& device, const std::function<std::function<ValuePtr(const ValuePtr&)>()>& createEvaluator, const char* testName)
+{
+    const size_t maxSequenceLength = 10;
+    auto output = model->Output();
+
+    std::vector<ValuePtr> requests;
+    std::vector<std::vector<std::vector<float>>> expectedOutputs(numRequests);
+    for (size_t i = 0; i < numRequests; ++i)
+    {
+        auto sequenceLengths = GenerateSequenceLengths(1 + i % 3, maxSequenceLength);
+        requests.push_back(GenerateSequences<float>(sequenceLengths, input.Shape(), requestDevice, false));
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { output, nullptr } };
+        model->Evaluate({ { input, requests.back() } }, outputs, device);
+        outputs[output]->CopyVariableValueTo(output, expectedOutputs[i]);
+    }
+
+    std::vector<std::vector<std::vector<float>>> actualOutputs(numRequests);
+    std::vector<std::exception_ptr> errors(numThreads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            try
+            {
+                auto evaluate = createEvaluator();
+                for (size_t i = t; i < numRequests; i += numThreads)
+                    evaluate(requests[i])->CopyVariableValueTo(output, actualOutputs[i]);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    const std::string message = testName + std::string(": results of concurrent evaluation do not match the results of evaluating the request alone.");
+    for (size_t i = 0; i < numRequests; ++i)
+    {
+        if (actualOutputs[i].size() != expectedOutputs[i].size())
+            ReportFailure("%s: the number of output sequences of request %d does not match.", testName, (int)i);
+
+        for (size_t j = 0; j < actualOutputs[i].size(); ++j)
+            FloatingPointVectorCompare(actualOutputs[i][j], expectedOutputs[i][j], message.c_str());
+    }
+}
+
+void TestBatchingEvaluator(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 7;
+    const size_t outputDim = 5;
+    const size_t numThreads = 8;
+    const size_t numRequests = 32;
+
+    auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto model = SimpleRecurrentLayer(input, { outputDim }, [](const Variable& x) { return PastValue(x); }, device);
+    auto output = model->Output();
+
+    auto evaluator = CreateBatchingEvaluator(model, device, /*maxBatchSize=*/ 6, /*maxLatencyInMicroseconds=*/ 2000);
+    VerifyException([&evaluator]() { evaluator->Evaluate({}); }, "Was able to evaluate a request without arguments.");
+
+    TestConcurrentEvaluation(model, input, numRequests, numThreads, DeviceDescriptor::CPUDevice(), device, [&]() {
+        return std::function<ValuePtr(const ValuePtr&)>([&](const ValuePtr& request) {
+            return evaluator->Evaluate({ { input, request } }).at(output);
+        });
+    }, "TestBatchingEvaluator");
+}
+
+void TestEvaluationSession(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 7;
+    const size_t outputDim = 5;
+    const size_t numThreads = 4;
+    const size_t numRequests = 16;
+
+    // A recurrent layer followed by a block, whose Parameters are inputs of the composite inside the block.
+    auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto recurrence = SimpleRecurrentLayer(input, { outputDim }, [](const Variable& x) { return PastValue(x); }, device);
+    auto placeholder = PlaceholderVariable();
+    auto weights = Parameter({ outputDim, outputDim }, DataType::Float, GlorotUniformInitializer(), device);
+    auto bias = Parameter({ outputDim }, DataType::Float, 0.5, device);
+    auto model = AsBlock(Plus(bias, Times(weights, placeholder)), { { placeholder, recurrence } }, L"LinearLayer");
+    auto output = model->Output();
+
+    // The weights of the session are read-only Constants on its device.
+    auto session = CreateEvaluationSession(model, device);
+    BOOST_TEST(session->Model()->Parameters().empty());
+    for (const auto& constant : session->Model()->Constants())
+        BOOST_TEST((constant.Value()->Device() == device));
+
+    BOOST_TEST((session->Model()->Arguments() == std::vector<Variable>({ input })));
+    auto sessionOutput = session->Model()->Output();
+
+    auto evaluate = [&](const EvaluationContextPtr& context, const ValuePtr& request) {
+        std::unordered_map<Variable, ValuePtr> outputs = { { sessionOutput, nullptr } };
+        context->Evaluate({ { input, request } }, outputs);
+        return outputs.at(sessionOutput);
+    };
+
+    // Each thread evaluates its requests on a context of its own.
+    TestConcurrentEvaluation(model, input, numRequests, numThreads, device, device, [&]() {
+        auto context = session->CreateContext();
+        return std::function<ValuePtr(const ValuePtr&)>([&, context](const ValuePtr& request) {
+            return evaluate(context, request);
+        });
+    }, "TestEvaluationSession");
+
+    auto request = GenerateSequences<float>(GenerateSequenceLengths(2, 10), { inputDim }, device, false);
+    auto context = session->CreateContext();
+    std::unordered_map<Variable, ValuePtr> modelOutputs = { { output, nullptr } };
+    VerifyException([&]() { context->Evaluate({ { input, request } }, modelOutputs); }, "Was able to evaluate an output that is not an output of the model of the session.");
+
+    // The Constants of the session alias the weights of the model, that are on the same device. The contexts refer to the
+    // storage of the session instead of copying it, so an update of the weights of the model is seen by all of them.
+    auto otherContext = session->CreateContext();
+    evaluate(context, request);
+    evaluate(otherContext, request);
+    bias.Value()->SetValue(1.5f);
+
+    std::vector<std::vector<float>> expectedOutput;
+    model->Evaluate({ { input, request } }, modelOutputs, device);
+    modelOutputs[output]->CopyVariableValueTo(output, expectedOutput);
+    for (const auto& sharingContext : { context, otherContext })
+    {
+        std::vector<std::vector<float>> actualOutput;
+        evaluate(sharingContext, request)->CopyVariableValueTo(output, actualOutput);
+        if (actualOutput.size() != expectedOutput.size())
+            ReportFailure("TestEvaluationSession: the number of output sequences after updating the weights does not match.");
+
+        for (size_t j = 0; j < actualOutput.size(); ++j)
+            FloatingPointVectorCompare(actualOutput[j], expectedOutput[j], "TestEvaluationSession: contexts of a session do not share the weights of the session.");
+    }
+}
+
+void TestBeamSearchDecoder(const DeviceDescriptor& device)
+{
+    // Token 0 ends a sequence and token 1 starts it. The probability of the next token depends on the token before the
+    // previous one, which the recurrent state carries as a one hot vector, so that decoding is only correct if the states
+    // follow their hypotheses.
+    const size_t vocabularySize = 4;
+    const size_t beamWidth = 3;
+    const size_t maxLength = 10;
+    const std::vector<std::vector<float>> probabilities = {
+        { 0.25f, 0.25f, 0.25f, 0.25f },
+        { 0.004f, 0.006f, 0.545f, 0.445f },
+        { 0.1f, 0.1f, 0.5f, 0.3f },
+        { 0.97f, 0.01f, 0.01f, 0.01f } };
+
+    std::vector<float> transitions(vocabularySize * vocabularySize);
+    for (size_t previous = 0; previous < vocabularySize; ++previous)
+        for (size_t next = 0; next < vocabularySize; ++next)
+            transitions[previous * vocabularySize + next] = std::log(probabilities[previous][next]);
+
+    auto transitionLogProbabilities = Constant(MakeSharedObject<NDArrayView>(NDShape({ vocabularySize, vocabularySize }), transitions)->DeepClone(device));
+    auto token = InputVariable({ 1 }, DataType::Float, L"token", { Axis::DefaultBatchAxis() });
+    auto state = InputVariable({ vocabularySize }, DataType::Float, L"state", { Axis::DefaultBatchAxis() });
+    auto logProbabilities = Times(transitionLogProbabilities, state, L"logProbabilities");
+    auto oneHotAxis = Axis(0);
+    auto nextState = Reshape(OneHotOp(token, vocabularySize, /*outputSparse =*/ false, oneHotAxis), { vocabularySize }, L"nextState");
+    auto stepFunction = Combine({ logProbabilities, nextState });
+
+    auto decoder = CreateBeamSearchDecoder(stepFunction, token, logProbabilities, { { state, nextState } }, beamWidth, /*startSymbol =*/ 1, /*endSymbol =*/ 0, /*lengthPenalty =*/ 0.0, device);
+
+    // The first input sequence starts from the start symbol, the second one from token 3, which is followed by the end symbol.
+    std::vector<float> initialStates = { 0, 1, 0, 0, 0, 0, 0, 1 };
+    auto initialStateValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(NDShape({ vocabularySize, 2 }), initialStates));
+    auto hypotheses = decoder->Decode({ { state, initialStateValue } }, maxLength);
+
+    if ((hypotheses.size() != 2) || (hypotheses[0].size() != beamWidth) || (hypotheses[1].size() != beamWidth))
+        ReportFailure("TestBeamSearchDecoder: expected %d hypotheses for each of the 2 input sequences.", (int)beamWidth);
+
+    for (const auto& sequenceHypotheses : hypotheses)
+    {
+        for (size_t i = 1; i < sequenceHypotheses.size(); ++i)
+            BOOST_TEST(sequenceHypotheses[i - 1].score >= sequenceHypotheses[i].score);
+    }
+
+    // Greedy decoding would start with token 2.
+    BOOST_TEST((hypotheses[0][0].tokens == std::vector<size_t>({ 3, 2 })));
+    FloatingPointCompare(hypotheses[0][0].logProbability, std::log(0.445 * 0.545 * 0.97), "TestBeamSearchDecoder: log probability of the best hypothesis does not match.");
+    FloatingPointCompare(hypotheses[0][0].score, hypotheses[0][0].logProbability, "TestBeamSearchDecoder: the score without length penalty does not match the log probability.");
+
+    BOOST_TEST(hypotheses[1][0].tokens.empty());
+    FloatingPointCompare(hypotheses[1][0].logProbability, std::log(0.97), "TestBeamSearchDecoder: log probability of the best hypothesis does not match.");
+
+    VerifyException([&]() {
+        CreateBeamSearchDecoder(stepFunction, token, logProbabilities, { { state, nextState } }, beamWidth, 1, vocabularySize, 0.0, device);
+    }, "Was able to create a beam search decoder with an end symbol outside of the vocabulary.");
+
+    VerifyException([&]() {
+        CreateBeamSearchDecoder(stepFunction, token, logProbabilities, { { state, logProbabilities } }, beamWidth, 1, 0, 0.0, device);
+    }, "Was able to create a beam search decoder that uses the log probabilities as a recurrent state.");
+}
+
 BOOST_AUTO_TEST_SUITE(RecurrentFunctionSuite)
 
 BOOST_AUTO_TEST_CASE(SimpleRecurrenceInCPU)
@@ -758,6 +968,42 @@ BOOST_AUTO_TEST_CASE(TestParityCandCppLSTMModel)
     CNTK_ReleaseArray(devices);
 }
 
+BOOST_AUTO_TEST_CASE(BatchingEvaluatorInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestBatchingEvaluator(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(BatchingEvaluatorInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestBatchingEvaluator(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(EvaluationSessionInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestEvaluationSession(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(EvaluationSessionInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestEvaluationSession(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(BeamSearchDecoderInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestBeamSearchDecoder(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(BeamSearchDecoderInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestBeamSearchDecoder(DeviceDescriptor::GPUDevice(0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}
@@ -13,6 +13,7 @@
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <sstream>
 
 using namespace CNTK;
 using namespace std;
@@ -462,6 +463,70 @@ void TestFunctionSerialization(const DeviceDescriptor& device)
     TestFunctionSaveAndLoad(BuildLSTMClassifierNet(inputVar, 5, device), device);
 }
 
+#ifndef _WIN32
+// Whether the address lies in a mapping of the file, according to /proc/self/maps.
+bool IsMappedFromFile(const void* address, const string& filename)
+{
+    ifstream maps("/proc/self/maps");
+    string line;
+    while (getline(maps, line))
+    {
+        uintptr_t begin = 0, end = 0;
+        char dash;
+        istringstream fields(line);
+        fields >> hex >> begin >> dash >> end;
+
+        auto value = reinterpret_cast<uintptr_t>(address);
+        if (value >= begin && value < end)
+            return line.size() >= filename.size() && line.compare(line.size() - filename.size(), filename.size(), filename) == 0;
+    }
+    return false;
+}
+#endif
+
+void TestFunctionSaveAndLoadWithExternalTensors(const DeviceDescriptor& device)
+{
+    auto file = L"TestFunctionSaveAndLoadWithExternalTensors.out";
+    auto inputVar = InputVariable({ 20 }, false, DataType::Float, L"features");
+    auto function = BuildLSTMClassifierNet(inputVar, 5, device);
+
+    function->Save(file, ModelFormat::CNTKv2, /*useExternalFilesToStoreParameters=*/true);
+
+    auto reloadedFunction = Function::Load(file, device);
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestFunctionSaveAndLoadWithExternalTensors: original and reloaded functions are not identical.");
+
+#ifndef _WIN32
+    // On the CPU the values of the parameters are used in place from the mapping of the tensor file.
+    if (device.Type() == DeviceKind::CPU)
+    {
+        for (auto& parameter : reloadedFunction->Parameters())
+        {
+            if (!IsMappedFromFile(parameter.Value()->DataBuffer<float>(), "TestFunctionSaveAndLoadWithExternalTensors.out.tensors"))
+                BOOST_ERROR("TestFunctionSaveAndLoadWithExternalTensors: the value of a loaded parameter is not mapped from the tensor file.");
+        }
+    }
+#endif
+
+    // Saving another model to the same file replaces the files, the mappings of the loaded model are not affected.
+    auto otherFunction = BuildLSTMClassifierNet(inputVar, 5, device, /*seed*/ 2);
+    otherFunction->Save(file, ModelFormat::CNTKv2, /*useExternalFilesToStoreParameters=*/true);
+
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestFunctionSaveAndLoadWithExternalTensors: overwriting the saved model has changed a loaded function.");
+
+    if (!AreEqual(otherFunction, Function::Load(file, device)))
+        BOOST_ERROR("TestFunctionSaveAndLoadWithExternalTensors: the overwritten model is not identical to the saved function.");
+
+    // Values mapped from the tensor file can be modified without affecting the file.
+    reloadedFunction = Function::Load(file, device);
+    for (auto& parameter : reloadedFunction->Parameters())
+        parameter.Value()->SetValue(1.0f);
+
+    if (!AreEqual(otherFunction, Function::Load(file, device)))
+        BOOST_ERROR("TestFunctionSaveAndLoadWithExternalTensors: modifying a loaded function has changed the saved model.");
+}
+
 TrainerPtr BuildTrainer(const FunctionPtr& function, const Variable& labels,
                      LearningRateSchedule lr = LearningRateSchedule(0.005, 1),
                      MomentumSchedule m = MomentumAsTimeConstantSchedule(0.0))
@@ -855,6 +920,45 @@ void TestCheckpointingWithStatefulNodes(const DeviceDescriptor& device)
     }
 }
 
+void TestAsynchronousCheckpointing(const DeviceDescriptor& device)
+{
+    auto featureStreamName = L"features";
+    auto labelsStreamName = L"labels";
+
+    size_t inputDim = 784;
+    size_t numOutputClasses = 10;
+    auto features = InputVariable({ inputDim }, false /*isSparse*/, DataType::Float, featureStreamName);
+    auto labels = InputVariable({ numOutputClasses }, DataType::Float, labelsStreamName);
+    auto net = BuildFFClassifierNet(features, numOutputClasses, device, 1);
+
+    auto trainer = BuildTrainer(net, labels);
+
+    const size_t minibatchSize = 50;
+    const size_t epochSize = 150;
+    auto minibatchSource = TextFormatMinibatchSource(L"Train-28x28_cntk_text.txt", { { featureStreamName, inputDim }, { labelsStreamName, numOutputClasses } }, epochSize, false);
+    auto minibatchData = minibatchSource->GetNextMinibatch(minibatchSize, device);
+    auto featureStreamInfo = minibatchSource->StreamInfo(features);
+    auto labelStreamInfo = minibatchSource->StreamInfo(labels);
+
+    // The training continues while the checkpoints are written, they must contain the state at the time they were requested.
+    vector<double> expectedLoss;
+    for (int i = 0; i < epochSize / minibatchSize; i++)
+    {
+        trainer->SaveCheckpointAsync(L"async_checkpoint.model" + std::to_wstring(i));
+        trainer->TrainMinibatch({ { features, minibatchData[featureStreamInfo] }, { labels, minibatchData[labelStreamInfo] } }, device);
+        expectedLoss.push_back(trainer->PreviousMinibatchLossAverage());
+    }
+
+    trainer->WaitForCheckpoint();
+
+    for (int i = 0; i < epochSize / minibatchSize; i++)
+    {
+        trainer->RestoreFromCheckpoint(L"async_checkpoint.model" + std::to_wstring(i));
+        trainer->TrainMinibatch({ { features, minibatchData[featureStreamInfo] }, { labels, minibatchData[labelStreamInfo] } }, device);
+        double loss = trainer->PreviousMinibatchLossAverage();
+        FloatingPointCompare(loss, expectedLoss[i], "Post checkpoint restoration training loss does not match expectation");
+    }
+}
 
 void TestCheckpointingWithStatefulNodesAndExplicitSeeds(const DeviceDescriptor& device)
 {
@@ -1024,6 +1128,11 @@ BOOST_AUTO_TEST_CASE(FunctionSerializationInCPU)
     TestFunctionSerialization(DeviceDescriptor::CPUDevice());
 }
 
+BOOST_AUTO_TEST_CASE(FunctionSaveAndLoadWithExternalTensorsInCPU)
+{
+    TestFunctionSaveAndLoadWithExternalTensors(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(ModelSerializationDuringTrainingInCPU)
 {
     TestModelSerializationDuringTraining(DeviceDescriptor::CPUDevice());
@@ -1044,6 +1153,11 @@ BOOST_AUTO_TEST_CASE(CheckpointingWithStatefulNodesInCPU)
     TestCheckpointingWithStatefulNodes(DeviceDescriptor::CPUDevice());
 }
 
+BOOST_AUTO_TEST_CASE(AsynchronousCheckpointingInCPU)
+{
+    TestAsynchronousCheckpointing(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(LearnerSerializationInGPU)
 {
     if (ShouldRunOnGpu())
@@ -1077,6 +1191,14 @@ BOOST_AUTO_TEST_CASE(FunctionSerializationInGPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(FunctionSaveAndLoadWithExternalTensorsInGPU)
+{
+    if (ShouldRunOnGpu())
+    {
+        TestFunctionSaveAndLoadWithExternalTensors(DeviceDescriptor::GPUDevice(0));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ModelSerializationDuringTrainingInGPU)
 {
     if (ShouldRunOnGpu())
@@ -0,0 +1,272 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Common.h"
+#include <future>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+using namespace CNTK;
+using namespace std;
+
+namespace CNTK { namespace Test {
+
+#ifndef _WIN32
+
+// Names of the segments of a test run, the process id makes them unique for concurrent runs of the tests.
+wstring JobName(const wstring& name)
+{
+    return name + L"_" + to_wstring(getpid());
+}
+
+void RunWorkers(const wstring& name, size_t numberOfWorkers, size_t bufferSizeInBytes, const function<void(DistributedCommunicatorPtr)>& action)
+{
+    vector<future<void>> workers;
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        workers.push_back(async(launch::async, [=]
+        {
+            action(SharedMemoryCommunicator(JobName(name), numberOfWorkers, rank, bufferSizeInBytes));
+        }));
+    }
+
+    for (auto& worker : workers)
+        worker.get();
+}
+
+BOOST_AUTO_TEST_SUITE(SharedMemoryCommunicatorSuite)
+
+BOOST_AUTO_TEST_CASE(SharedMemoryCommunicatorAggregatesValues)
+{
+    const size_t numberOfWorkers = 3;
+    const vector<size_t> sizes = { 1, 17, 5000, 40000 };
+
+    // Values of each worker, float and double for each size.
+    vector<vector<NDArrayViewPtr>> values(numberOfWorkers);
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        for (auto size : sizes)
+        {
+            auto floatValue = MakeSharedObject<NDArrayView>(DataType::Float, NDShape{ size }, DeviceDescriptor::CPUDevice());
+            auto doubleValue = MakeSharedObject<NDArrayView>(DataType::Double, NDShape{ size }, DeviceDescriptor::CPUDevice());
+            for (size_t i = 0; i < size; ++i)
+            {
+                floatValue->WritableDataBuffer<float>()[i] = (float)((rank + 1) * i);
+                doubleValue->WritableDataBuffer<double>()[i] = (double)((rank + 1) * i);
+            }
+            values[rank].push_back(floatValue);
+            values[rank].push_back(doubleValue);
+        }
+    }
+
+    // Small buffer, so that values are aggregated in several windows; aggregating twice to reuse the slots.
+    RunWorkers(L"AggregateTest", numberOfWorkers, 64 * 1024, [&](DistributedCommunicatorPtr communicator)
+    {
+        const auto& workerValues = values[communicator->CurrentWorker().m_globalRank];
+        communicator->AggregateInPlace(workerValues, communicator->Workers());
+        communicator->AggregateInPlace(workerValues, communicator->Workers());
+    });
+
+    // The sum of (rank + 1) over ranks is 6, the second aggregation multiplies it by the number of workers.
+    const double factor = 6 * numberOfWorkers;
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        for (size_t v = 0; v < sizes.size(); ++v)
+        {
+            for (size_t i = 0; i < sizes[v]; ++i)
+            {
+                BOOST_REQUIRE_EQUAL(values[rank][2 * v]->DataBuffer<float>()[i], (float)(factor * i));
+                BOOST_REQUIRE_EQUAL(values[rank][2 * v + 1]->DataBuffer<double>()[i], factor * i);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SharedMemoryCommunicatorConcatenatesAndGathers)
+{
+    const size_t numberOfWorkers = 4;
+
+    // Larger than the slot, so that the data is exchanged in several rounds.
+    const size_t size = 1000;
+    vector<vector<NDArrayViewPtr>> concatenated(numberOfWorkers);
+    vector<DictionaryPtr> gathered;
+    RunWorkers(L"ConcatenateTest", numberOfWorkers, 4096, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        auto input = MakeSharedObject<NDArrayView>(DataType::Double, NDShape{ size }, DeviceDescriptor::CPUDevice());
+        for (size_t i = 0; i < size; ++i)
+            input->WritableDataBuffer<double>()[i] = (double)(rank * size + i);
+
+        communicator->Concatenate(vector<NDArrayViewPtr>{ input }, concatenated[rank], communicator->Workers());
+
+        Dictionary state;
+        state[L"rank"] = rank;
+        vector<DictionaryPtr> result;
+        communicator->Gather(state, result, communicator->Workers());
+        if (rank == 0)
+            gathered = result;
+    });
+
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        BOOST_REQUIRE_EQUAL(concatenated[rank].size(), 1);
+        BOOST_REQUIRE_EQUAL(concatenated[rank][0]->Shape().TotalSize(), numberOfWorkers * size);
+        for (size_t i = 0; i < numberOfWorkers * size; ++i)
+            BOOST_REQUIRE_EQUAL(concatenated[rank][0]->DataBuffer<double>()[i], (double)i);
+    }
+
+    BOOST_REQUIRE_EQUAL(gathered.size(), numberOfWorkers);
+    for (size_t i = 0; i < numberOfWorkers; ++i)
+        BOOST_TEST((*gathered[i])[L"rank"].Value<size_t>() == i);
+}
+
+BOOST_AUTO_TEST_CASE(SharedMemoryCommunicatorConcatenatesValues)
+{
+    const size_t numberOfWorkers = 3;
+    const size_t sampleSize = 2;
+    const size_t maxSequenceLength = 3;
+
+    // Two sequences per worker; the sequences of the worker 1 have the same length, so its value may have no mask.
+    const vector<vector<size_t>> sequenceLengths = { { 3, 1 }, { 3, 3 }, { 2, 3 } };
+    auto element = [](size_t rank, size_t sequence, size_t step, size_t k) { return (float)(rank * 100 + sequence * 10 + step + k * 0.5); };
+
+    vector<vector<ValuePtr>> concatenated(numberOfWorkers);
+    RunWorkers(L"ConcatenateValuesTest", numberOfWorkers, 4096, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        vector<vector<float>> sequences;
+        for (size_t s = 0; s < sequenceLengths[rank].size(); ++s)
+        {
+            sequences.emplace_back();
+            for (size_t t = 0; t < sequenceLengths[rank][s]; ++t)
+            {
+                for (size_t k = 0; k < sampleSize; ++k)
+                    sequences.back().push_back(element(rank, s, t, k));
+            }
+        }
+
+        communicator->Concatenate(vector<ValuePtr>{ Value::Create(NDShape{ sampleSize }, sequences, DeviceDescriptor::CPUDevice()) }, concatenated[rank], communicator->Workers());
+    });
+
+    // Checked here rather than by the workers, the test framework is not thread-safe.
+    for (const auto& output : concatenated)
+    {
+        BOOST_REQUIRE_EQUAL(output.size(), 1);
+        const auto& value = output.front();
+        BOOST_TEST((value->Shape() == NDShape{ sampleSize, maxSequenceLength, 2 * numberOfWorkers }));
+        BOOST_REQUIRE(value->Mask() != nullptr);
+
+        auto data = value->Data()->DataBuffer<float>();
+        auto mask = value->Mask()->DataBuffer();
+        for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+        {
+            for (size_t s = 0; s < 2; ++s)
+            {
+                size_t column = rank * 2 + s;
+                for (size_t t = 0; t < maxSequenceLength; ++t)
+                {
+                    auto expectedKind = (t >= sequenceLengths[rank][s]) ? MaskKind::Invalid : ((t == 0) ? MaskKind::SequenceBegin : MaskKind::Valid);
+                    BOOST_TEST((mask[column * maxSequenceLength + t] == expectedKind));
+                    if (expectedKind == MaskKind::Invalid)
+                        continue;
+
+                    for (size_t k = 0; k < sampleSize; ++k)
+                        BOOST_REQUIRE_EQUAL(data[(column * maxSequenceLength + t) * sampleSize + k], element(rank, s, t, k));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SharedMemoryCommunicatorAggregatesInSubGroups)
+{
+    const size_t numberOfWorkers = 4;
+
+    // The workers with even and odd ranks aggregate in two subgroups.
+    vector<double> sums(numberOfWorkers);
+    vector<size_t> subGroupSizes(numberOfWorkers), subGroupRanks(numberOfWorkers);
+    RunWorkers(L"SubGroupTest", numberOfWorkers, 4096, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        unordered_set<DistributedWorkerDescriptor> subGroupWorkers;
+        for (const auto& worker : communicator->Workers())
+        {
+            if (worker.m_globalRank % 2 == rank % 2)
+                subGroupWorkers.insert(worker);
+        }
+
+        auto subGroup = communicator->SubGroup(subGroupWorkers);
+        subGroupSizes[rank] = subGroup->Workers().size();
+        subGroupRanks[rank] = subGroup->CurrentWorker().m_globalRank;
+
+        double value = (double)(rank + 1);
+        auto values = vector<NDArrayViewPtr>{ MakeSharedObject<NDArrayView>(NDShape{}, &value, 1, DeviceDescriptor::CPUDevice()) };
+        subGroup->AggregateInPlace(values, subGroup->Workers());
+        sums[rank] = value;
+    });
+
+    BOOST_TEST(subGroupSizes == vector<size_t>({ 2, 2, 2, 2 }));
+    BOOST_TEST(subGroupRanks == vector<size_t>({ 0, 0, 1, 1 }));
+    BOOST_TEST(sums == vector<double>({ 4, 6, 4, 6 }));
+}
+
+BOOST_AUTO_TEST_CASE(SharedMemoryCommunicatorRemovesStaleSegment)
+{
+    // A segment left behind by a run that crashed before its workers attached, it has neither the right size nor a header.
+    auto jobName = JobName(L"StaleSegmentTest");
+    auto segmentName = "/cntk_" + to_string(getuid()) + "_" + string(jobName.begin(), jobName.end());
+    int fd = shm_open(segmentName.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    BOOST_REQUIRE(fd >= 0);
+    BOOST_REQUIRE(ftruncate(fd, 4096) == 0);
+    close(fd);
+
+    vector<double> sums(2);
+    RunWorkers(L"StaleSegmentTest", 2, 4096, [&](DistributedCommunicatorPtr communicator)
+    {
+        double value = 1;
+        auto values = vector<NDArrayViewPtr>{ MakeSharedObject<NDArrayView>(NDShape{}, &value, 1, DeviceDescriptor::CPUDevice()) };
+        communicator->AggregateInPlace(values, communicator->Workers());
+        sums[communicator->CurrentWorker().m_globalRank] = value;
+    });
+
+    BOOST_TEST(sums == vector<double>({ 2, 2 }));
+
+    // The name is removed once all workers have attached.
+    BOOST_TEST(shm_open(segmentName.c_str(), O_RDONLY, 0) < 0);
+}
+
+BOOST_AUTO_TEST_CASE(SharedMemoryCommunicatorFailsWhenAWorkerIsGone)
+{
+    // Worker 1 destroys its communicator without entering the barrier, the others fail instead of waiting for it.
+    const size_t numberOfWorkers = 3;
+    vector<int> failed(numberOfWorkers);
+    RunWorkers(L"MissingWorkerTest", numberOfWorkers, 4096, [&](DistributedCommunicatorPtr communicator)
+    {
+        auto rank = communicator->CurrentWorker().m_globalRank;
+        if (rank == 1)
+            return;
+
+        try
+        {
+            communicator->Barrier();
+        }
+        catch (const runtime_error&)
+        {
+            failed[rank] = 1;
+        }
+    });
+
+    BOOST_TEST(failed == vector<int>({ 1, 0, 1 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
+
+}}
@@ -1118,6 +1118,62 @@ void CreateSequenceTestDense(const DeviceDescriptor device, bool readOnly)
 }
 
 
+template <typename ElementType>
+void CreateViewTestDense(const DeviceDescriptor device)
+{
+    size_t numAxes = 3;
+    size_t maxDimSize = 20;
+    NDShape sampleShape = CreateShape(numAxes, maxDimSize);
+    auto sampleSize = sampleShape.TotalSize();
+
+    size_t batchCount = 1;
+    size_t maxSequenceLen = 60;
+    auto seqLenList = GenerateSequenceLengths(batchCount, maxSequenceLen);
+    auto data = GenerateSequences<ElementType>(seqLenList, sampleShape);
+    auto& buffer = data[0];
+
+    // A view of a sequence on the CPU uses the buffer of the caller and keeps its owner alive.
+    auto bufferOwner = make_shared<int>(0);
+    weak_ptr<int> weakBufferOwner = bufferOwner;
+    auto testValue = Value::CreateSequenceView(sampleShape, buffer.data(), buffer.size(), true, device, bufferOwner);
+    bufferOwner.reset();
+    BOOST_TEST(testValue->IsReadOnly(), "A view of the buffer of the caller must be read-only.");
+    BOOST_TEST(!weakBufferOwner.expired(), "The owner of the buffer has been released while the view is alive.");
+    if (device == DeviceDescriptor::CPUDevice())
+        BOOST_TEST(testValue->Data()->template DataBuffer<ElementType>() == buffer.data(), "The buffer of the caller has been copied.");
+    CheckValue(testValue, sampleShape, data, seqLenList, { true });
+    testValue = nullptr;
+    BOOST_TEST(weakBufferOwner.expired(), "The owner of the buffer is still alive after the view has been released.");
+
+    testValue = Value::CreateSequenceView(sampleShape, buffer.data(), buffer.size(), false, device);
+    CheckValue(testValue, sampleShape, data, seqLenList, { false });
+
+    // A view of a batch has a sequence of length 1 per sample.
+    testValue = Value::CreateBatchView(sampleShape, buffer.data(), buffer.size(), device);
+    vector<vector<ElementType>> expectedResult;
+    for (size_t i = 0; i < buffer.size(); i += sampleSize)
+        expectedResult.push_back(vector<ElementType>(buffer.begin() + i, buffer.begin() + i + sampleSize));
+    CheckValue(testValue, sampleShape, expectedResult, vector<size_t>(buffer.size() / sampleSize, 1));
+
+    VerifyException([&sampleShape, &buffer, &sampleSize, &device]() {
+        Value::CreateBatchView(sampleShape, buffer.data(), sampleSize * 2 - 1, device);
+    }, "The expected exception has not been caught: The number of data is not a multiple of the sample size.");
+
+    VerifyException([&sampleShape, &buffer, &device]() {
+        Value::CreateSequenceView(sampleShape, buffer.data(), 0, true, device);
+    }, "The expected exception has not been caught: The sequence length is 0");
+
+    VerifyException([&sampleShape, &sampleSize, &device]() {
+        Value::CreateSequenceView<ElementType>(sampleShape, nullptr, sampleSize, true, device);
+    }, "The expected exception has not been caught: The buffer is null.");
+
+    VerifyException([&sampleShape, &buffer, &sampleSize, &device]() {
+        auto misaligned = reinterpret_cast<const ElementType*>(reinterpret_cast<const char*>(buffer.data()) + 1);
+        Value::CreateBatchView(sampleShape, misaligned, sampleSize, device);
+    }, "The expected exception has not been caught: The buffer is not aligned.");
+}
+
+
 template <typename ElementType>
 void CreateBatchOfSequencesTestDense(const DeviceDescriptor device, bool readOnly)
 {
@@ -1502,6 +1558,24 @@ BOOST_AUTO_TEST_CASE(CreateSequenceDenseInGPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CreateViewDenseInCPU)
+{
+    if (!ShouldRunOnCpu())
+        return;
+
+    CreateViewTestDense<float>(DeviceDescriptor::CPUDevice());
+    CreateViewTestDense<double>(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(CreateViewDenseInGPU)
+{
+    if (ShouldRunOnGpu())
+    {
+        CreateViewTestDense<float>(DeviceDescriptor::GPUDevice(0));
+        CreateViewTestDense<double>(DeviceDescriptor::GPUDevice(0));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(CreateBatchOfSequencesDenseInCPU)
 {
     if (!ShouldRunOnCpu())
@@ -236,6 +236,15 @@ IGNORE_CLASS CNTK::DistributedLearner;
 IGNORE_FUNCTION CNTK::CreateDataParallelDistributedLearner;
 IGNORE_FUNCTION CNTK::CreateQuantizedDataParallelDistributedLearner;
 IGNORE_FUNCTION CNTK::CreateBlockMomentumDistributedLearner;
+IGNORE_FUNCTION CNTK::CreateShardedDataParallelDistributedLearner;
+IGNORE_CLASS CNTK::BatchingEvaluator;
+IGNORE_FUNCTION CNTK::CreateBatchingEvaluator;
+IGNORE_CLASS CNTK::EvaluationSession;
+IGNORE_CLASS CNTK::EvaluationContext;
+IGNORE_FUNCTION CNTK::CreateEvaluationSession;
+IGNORE_CLASS CNTK::BeamSearchDecoder;
+IGNORE_STRUCT CNTK::BeamSearchHypothesis;
+IGNORE_FUNCTION CNTK::CreateBeamSearchDecoder;
 IGNORE_STRUCT std::hash<::CNTK::StreamInformation>;
 %ignore operator==(const StreamInformation& left, const StreamInformation& right);
 IGNORE_STRUCT CNTK::DistributedWorkerDescriptor;
@@ -294,6 +303,10 @@ IGNORE_FUNCTION CNTK::Internal::EnableForwardValuesSharing;
 IGNORE_FUNCTION CNTK::Internal::DisableForwardValuesSharing;
 IGNORE_FUNCTION CNTK::Internal::EnableGradientAccumulationOptimization;
 IGNORE_FUNCTION CNTK::Internal::DisableGradientAccumulationOptimization;
+IGNORE_FUNCTION CNTK::Internal::EnableContiguousParameterStorage;
+IGNORE_FUNCTION CNTK::Internal::DisableContiguousParameterStorage;
+IGNORE_FUNCTION CNTK::Internal::IsContiguousParameterStorageEnabled;
+IGNORE_FUNCTION CNTK::Internal::CoalesceContiguousValues;
 %ignore CNTK::Internal::DefaultProfilerBufferSize;
 IGNORE_FUNCTION CNTK::Internal::StartProfiler;
 IGNORE_FUNCTION CNTK::Internal::StopProfiler;
@@ -13,6 +13,8 @@
 %threadallow CNTK::Trainer::TrainMinibatch;
 %threadallow CNTK::Trainer::TestMinibatch;
 %threadallow CNTK::Trainer::SaveCheckpoint;
+%threadallow CNTK::Trainer::SaveCheckpointAsync;
+%threadallow CNTK::Trainer::WaitForCheckpoint;
 %threadallow CNTK::Trainer::RestoreFromCheckpoint;
 
 %threadallow CNTK::Evaluator::TestMinibatch;
@@ -63,6 +65,7 @@
 %rename(_next_minibatch) CNTK::SwigMinibatchSource::_GetNextMinibatch;
 %rename(_register_udf_deserialize_callback) CNTK::Internal::RegisterUDFDeserializeCallbackWrapper;
 %rename(base64_image_deserializer) CNTK::Base64ImageDeserializer;
+%rename(packed_image_deserializer) CNTK::PackedImageDeserializer;
 %rename(_none) CNTK::DictionaryValue::Type::None;
 %rename(nce_loss) CNTK::NCELoss;
 
@@ -195,6 +198,18 @@
 %ignore CNTK::Function::RegisterUDFDeserializeCallback;
 %ignore CNTK::Function::GetUDFDeserializeCallback;
 
+// Request batching and evaluation sessions are meant for multi-threaded native serving
+%ignore CNTK::BatchingEvaluator;
+%ignore CNTK::CreateBatchingEvaluator;
+%ignore CNTK::EvaluationSession;
+%ignore CNTK::EvaluationContext;
+%ignore CNTK::CreateEvaluationSession;
+
+// The beam search decoder takes recurrent state pairs and returns nested hypothesis lists, which have no typemaps yet
+%ignore CNTK::BeamSearchDecoder;
+%ignore CNTK::BeamSearchHypothesis;
+%ignore CNTK::CreateBeamSearchDecoder;
+
 %{
 #define SWIG_FILE_WITH_INIT
 %}
@@ -932,6 +932,20 @@ def Base64ImageDeserializer(filename, streams):
         'Base64ImageDeserializer')
     return cntk_py.base64_image_deserializer(*args)
 
+def PackedImageDeserializer(filename, streams):
+    '''
+    Configures the image reader that reads encoded images and corresponding
+    labels from a single packed file created by ``Scripts/map2packed.py``.
+    Consecutive images are read from disk in large chunks, which is considerably
+    faster than opening every image file separately.
+
+    Args:
+        filename (str): file name of the packed image file
+    '''
+    args = _process_image_deserializer_args(filename, streams,
+        'PackedImageDeserializer')
+    return cntk_py.packed_image_deserializer(*args)
+
 def CTFDeserializer(filename, streams):
     '''
     Configures the CNTK text-format reader that reads text-based files with
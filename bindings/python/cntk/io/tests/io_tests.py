@@ -12,7 +12,7 @@ import sys
 
 from cntk.io import MinibatchSource, CTFDeserializer, CBFDeserializer, \
     StreamDefs, StreamDef, \
-    ImageDeserializer, Base64ImageDeserializer, \
+    ImageDeserializer, Base64ImageDeserializer, PackedImageDeserializer, \
     FULL_DATA_SWEEP, INFINITELY_REPEAT, \
     DEFAULT_RANDOMIZATION_WINDOW_IN_CHUNKS, \
     sequence_to_cntk_text_format, UserMinibatchSource, StreamInformation, \
@@ -1043,6 +1043,59 @@ def test_base64_is_equal_image(tmpdir):
         images2 = mb[images2_stream].asarray()
         assert(images1 == images2).all()
 
+# Create packed and usual image deserializers
+# and check that they give equal minibatch data on
+# the same input images
+def test_packed_is_equal_image(tmpdir):
+    try:
+        import map2packed
+    except ImportError:
+        pytest.skip("map2packed not found")
+
+    import io; from PIL import Image
+    np.random.seed(1)
+
+    file_mapping_path = str(tmpdir / 'file_mapping.txt')
+    packed_path = str(tmpdir / 'images.packed')
+
+    with open(file_mapping_path, 'w') as file_mapping:
+        for i in range(10):
+            data = np.random.randint(0, 2**8, (5,7,3))
+            image = Image.fromarray(data.astype('uint8'), "RGB")
+            buf = io.BytesIO()
+            image.save(buf, format='PNG')
+
+            label = str(i)
+            file_name = label + '.png'
+            with open(str(tmpdir/file_name), 'wb') as f:
+                f.write(buf.getvalue())
+            file_mapping.write('.../%s\t%s\n' % (file_name, label))
+
+    map2packed.process(file_mapping_path, packed_path)
+
+    transforms = [xforms.scale(width=7, height=5, channels=3)]
+    packed_deserializer = PackedImageDeserializer(packed_path,
+        StreamDefs(
+            images1=StreamDef(field='image', transforms=transforms),
+            labels1=StreamDef(field='label', shape=10)))
+
+    file_image_deserializer = ImageDeserializer(file_mapping_path,
+        StreamDefs(
+            images2=StreamDef(field='image', transforms=transforms),
+            labels2=StreamDef(field='label', shape=10)))
+
+    mb_source = MinibatchSource([packed_deserializer, file_image_deserializer])
+    for j in range(20):
+        mb = mb_source.next_minibatch(1)
+
+        images1 = mb[mb_source.streams['images1']].asarray()
+        images2 = mb[mb_source.streams['images2']].asarray()
+        assert(images1 == images2).all()
+
+        labels1 = mb[mb_source.streams['labels1']].asarray()
+        labels2 = mb[mb_source.streams['labels2']].asarray()
+        assert(labels1 == labels2).all()
+
 def test_crop_dimensionality(tmpdir):
     import io; from PIL import Image
     np.random.seed(1)
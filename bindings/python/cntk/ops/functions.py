@@ -1554,7 +1554,9 @@ class Function(cntk_py.Function):
         Args:
             filename (str): model path
             use_external_files_to_store_parameters (bool, optional): whether to save model parameters 
-             to external files. This is for models larger than 2GB. Defaults to False.
+             to external files. This is for models larger than 2GB. With the CNTKv2 format, the values are
+             stored page-aligned in the file ``filename + '.tensors'``, which :func:`load_model` maps into
+             memory and uses in place on the CPU. Defaults to False.
         '''
         return super(Function, self).save(filename, format.value, use_external_files_to_store_parameters)
 
@@ -445,3 +445,64 @@ def test_save_no_junk(tmpdir):
     # Check the files can be loaded as standard ONNX files,
     # and both result in the same model.
     assert onnx.load(filename) == onnx.load(filename_new)
+
+# Initializers are exported as raw_data and used in place on import.
+INITIALIZER_DTYPES = (np.float32, np.float16, np.float64)
+@pytest.mark.parametrize("dtype", INITIALIZER_DTYPES)
+def test_load_raw_data_initializer(tmpdir, dtype):
+    data = np.asarray(np.random.uniform(-1, 1, (3, 4)), dtype=dtype)
+    c = C.constant(value=data, dtype=dtype)
+    root_node = c * 5
+
+    filename = os.path.join(str(tmpdir), R'raw_data_initializer.onnx')
+    root_node.save(filename, format=C.ModelFormat.ONNX)
+
+    try:
+        import onnx
+        model = onnx.load(filename)
+        assert len(model.graph.initializer) > 0
+        assert all(len(initializer.raw_data) > 0 for initializer in model.graph.initializer)
+    except ImportError:
+        pass
+
+    loaded_node = C.Function.load(filename, format=C.ModelFormat.ONNX, device=C.cpu())
+    assert root_node.shape == loaded_node.shape
+    assert any(np.array_equal(constant.value, data) for constant in loaded_node.constants)
+
+    # float16 can only be evaluated on a GPU.
+    if dtype != np.float16:
+        assert np.allclose(loaded_node.eval(device=C.cpu()), root_node.eval(device=C.cpu()))
+
+def test_load_initializer_with_several_consumers(tmpdir):
+    data = np.asarray(np.random.uniform(-1, 1, (3, 4)), dtype=np.float32)
+    c = C.constant(value=data)
+    root_node = C.plus(C.element_times(c, 2), C.element_times(c, 3))
+
+    filename = os.path.join(str(tmpdir), R'shared_initializer.onnx')
+    root_node.save(filename, format=C.ModelFormat.ONNX)
+
+    loaded_node = C.Function.load(filename, format=C.ModelFormat.ONNX, device=C.cpu())
+    assert len([constant for constant in loaded_node.constants if np.array_equal(constant.value, data)]) == 1
+    assert np.allclose(loaded_node.eval(device=C.cpu()), root_node.eval(device=C.cpu()))
+    assert np.allclose(loaded_node.eval(device=C.cpu()), data * 5)
+
+def test_load_double_constant_node(tmpdir):
+    try:
+        import onnx
+        from onnx import helper, numpy_helper
+    except ImportError:
+        pytest.skip('ONNX is not installed.')
+
+    # A Constant node holding raw_data doubles goes through the unpacking of its TensorProto.
+    data = np.asarray(np.random.uniform(-1, 1, (2, 3)), dtype=np.float64)
+    constant = helper.make_node('Constant', [], ['c'], value=numpy_helper.from_array(data, name='c'))
+    times = helper.make_node('Mul', ['c', 'c'], ['y'])
+    graph = helper.make_graph([constant, times], 'double_constant', [],
+                              [helper.make_tensor_value_info('y', onnx.TensorProto.DOUBLE, list(data.shape))])
+    model = helper.make_model(graph, opset_imports=[helper.make_opsetid('', 7)])
+
+    filename = os.path.join(str(tmpdir), R'double_constant.onnx')
+    onnx.save(model, filename)
+
+    loaded_node = C.Function.load(filename, format=C.ModelFormat.ONNX, device=C.cpu())
+    assert np.allclose(np.reshape(loaded_node.eval(device=C.cpu()), data.shape), data * data)
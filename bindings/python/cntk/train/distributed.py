@@ -145,6 +145,25 @@ def data_parallel_distributed_learner(learner, distributed_after=0, num_quantiza
             distributed_after,
             use_async_buffered_parameter_update)
 
+@typemap
+def sparsified_data_parallel_distributed_learner(learner, compression_ratio=100, distributed_after=0):
+    '''
+    Creates a data parallel distributed learner that only exchanges the largest entries of each gradient.
+    The entries that are not exchanged are accumulated locally and added to the gradient of the next minibatch.
+
+    Args:
+        learner: a local learner (i.e. sgd)
+        compression_ratio (float): 1 / compression_ratio of the entries of each gradient are exchanged
+        distributed_after (int): number of samples after which distributed training starts
+    Returns:
+        a distributed learner instance
+    '''
+    return cntk_py.create_sparsified_data_parallel_distributed_learner(
+        cntk_py.mpicommunicator(),
+        learner,
+        distributed_after,
+        compression_ratio)
+
 @typemap
 def block_momentum_distributed_learner(learner, block_size, block_momentum_as_time_constant=None, use_nestrov_momentum=True, reset_sgd_momentum_after_aggregation=True, block_learning_rate=1.0, distributed_after=0):
     '''
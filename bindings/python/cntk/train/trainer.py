@@ -248,6 +248,27 @@ class Trainer(cntk_py.Trainer):
 
         super(Trainer, self).save_checkpoint(filename, _py_dict_to_cntk_dict(external_state))
 
+    def save_checkpoint_async(self, filename, external_state={}):
+        '''
+        Saves a checkpoint of the model and other Trainer state at the
+        specified file location without waiting for the files to be written.
+        The state is captured before the call returns, the files are written
+        in the background. Use :meth:`wait_for_checkpoint` to wait for them.
+
+        Args:
+            filename (str): filename to store the checkpoint.
+            external_state (dict): additional external state, default is empty.
+        '''
+
+        super(Trainer, self).save_checkpoint_async(filename, _py_dict_to_cntk_dict(external_state))
+
+    def wait_for_checkpoint(self):
+        '''
+        Waits until the checkpoint that is written in the background is complete.
+        '''
+
+        super(Trainer, self).wait_for_checkpoint()
+
     def restore_from_checkpoint(self, filename):
         '''
         Restores a checkpoint of the model and Trainer state from the